@@ -25,6 +25,9 @@ namespace moe {
     template<typename... TArgs>
     using SharedPtr = std::shared_ptr<TArgs...>;
 
+    template<typename... TArgs>
+    using WeakPtr = std::weak_ptr<TArgs...>;
+
     using String = std::string;
 
     using StringView = std::string_view;
@@ -38,7 +38,7 @@ namespace Meta {
                 -> decltype(
                         // static method -> Optional<typename U::value_type>
                         U::deserialize(Meta::DeclareValue<Span<const uint8_t>>()),
-                        U::serialize(),// -> Vector<uint8_t>
+                        Meta::DeclareValue<const U&>().serialize(),// -> Vector<uint8_t>
                         Meta::TrueType{});
 
         template<typename U>
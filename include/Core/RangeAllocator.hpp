@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Core/Common.hpp"
+
+#include <limits>
+#include <map>
+#include <set>
+
+MOE_BEGIN_NAMESPACE
+
+// offset allocator over [0, capacity) in caller defined units, e.g. bytes of a gpu buffer.
+// free ranges are indexed by offset and by size: allocate() takes the smallest range that fits,
+// free() merges the range with its free neighbours, both in O(log n) of the free range count.
+// callers round sizes to their alignment, so every offset stays aligned
+struct RangeAllocator {
+public:
+    static constexpr uint64_t INVALID_OFFSET = std::numeric_limits<uint64_t>::max();
+
+    RangeAllocator() = default;
+    ~RangeAllocator() = default;
+
+    explicit RangeAllocator(uint64_t capacity) { reset(capacity); }
+
+    // forgets every allocation
+    void reset(uint64_t capacity);
+
+    // best fit, INVALID_OFFSET when no free range is large enough
+    uint64_t allocate(uint64_t size);
+
+    // lowest offset fit that ends at or before limit, INVALID_OFFSET when there is none; used for compaction
+    uint64_t allocateBelow(uint64_t size, uint64_t limit);
+
+    // size must be the one the range was allocated with
+    void free(uint64_t offset, uint64_t size);
+
+    uint64_t getCapacity() const { return m_capacity; }
+
+    uint64_t getUsed() const { return m_used; }
+
+    uint64_t getFree() const { return m_capacity - m_used; }
+
+    bool isEmpty() const { return m_used == 0; }
+
+    size_t getFreeRangeCount() const { return m_freeByOffset.size(); }
+
+    uint64_t getLargestFreeRange() const {
+        return m_freeBySize.empty() ? 0 : m_freeBySize.rbegin()->first;
+    }
+
+    // 0 when the free space is one range, towards 1 as it is split into many small ones
+    float getFragmentation() const {
+        const uint64_t free = getFree();
+        return free == 0 ? 0.0f : 1.0f - static_cast<float>(getLargestFreeRange()) / static_cast<float>(free);
+    }
+
+private:
+    uint64_t m_capacity{0};
+    uint64_t m_used{0};
+
+    // offset -> size
+    std::map<uint64_t, uint64_t> m_freeByOffset;
+    // (size, offset)
+    std::set<Pair<uint64_t, uint64_t>> m_freeBySize;
+
+    void insertFree(uint64_t offset, uint64_t size);
+
+    void eraseFree(std::map<uint64_t, uint64_t>::iterator it);
+
+    // carves [offset, offset + size) out of the free range at it
+    void take(std::map<uint64_t, uint64_t>::iterator it, uint64_t offset, uint64_t size);
+};
+
+MOE_END_NAMESPACE
\ No newline at end of file
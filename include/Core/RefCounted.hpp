@@ -3,6 +3,8 @@
 #include "Core/Common.hpp"
 #include "Core/Ref.hpp"
 
+#include <atomic>
+
 MOE_BEGIN_NAMESPACE
 
 typedef void (*RefCountedDeleterFn)(void*);
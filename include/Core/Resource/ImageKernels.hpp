@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/Common.hpp"
+
+MOE_BEGIN_NAMESPACE
+
+// cpu side image kernels for 8-bit images
+// ! note: all rgba kernels expect tightly packed, interleaved rgba8 pixels
+// vectorized paths are selected at compile time (avx2 > sse2 > neon > scalar)
+namespace ImageKernels {
+    enum class ColorSpace {
+        Linear,
+        Srgb,
+    };
+
+    struct MipLevel {
+        uint32_t width{0};
+        uint32_t height{0};
+        size_t offset{0};
+        size_t size{0};
+    };
+
+    struct MipChain {
+        Vector<uint8_t> data;
+        Vector<MipLevel> levels;
+
+        Span<const uint8_t> levelData(size_t level) const {
+            const auto& lv = levels[level];
+            return Span<const uint8_t>(data.data() + lv.offset, lv.size);
+        }
+    };
+
+    // name of the compiled simd backend, for logging
+    StringView backendName();
+
+    uint32_t mipLevelCount(uint32_t width, uint32_t height);
+
+    // src: pixelCount * 3 bytes, dst: pixelCount * 4 bytes; src and dst must not overlap
+    void expandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, uint8_t alpha = 0xff);
+
+    // whether every pixel has alpha 0xff, e.g. to tell cutout textures from opaque ones
+    bool isOpaque(const uint8_t* rgba, size_t pixelCount);
+
+    // in-place; srgb premultiplies in linear space and re-encodes
+    void premultiplyAlpha(uint8_t* rgba, size_t pixelCount, ColorSpace colorSpace);
+
+    // in-place; rescales rgb (unorm-encoded [-1, 1] vectors) to unit length, alpha is untouched
+    void renormalizeNormals(uint8_t* rgba, size_t pixelCount);
+
+    // 2x2 box filter; dst must hold max(1, w/2) * max(1, h/2) rgba pixels
+    // srgb color channels are averaged in linear space, alpha is always linear
+    void downsampleBox(
+            const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+            uint8_t* dst,
+            ColorSpace colorSpace);
+
+    // builds a full (or maxLevels-limited) mip chain, level 0 included
+    // renormalize is meant for normal maps, every generated level gets renormalized
+    MipChain buildMipChain(
+            const uint8_t* rgba, uint32_t width, uint32_t height,
+            ColorSpace colorSpace,
+            bool renormalize = false,
+            uint32_t maxLevels = 0);
+
+    namespace Scalar {
+        // reference implementations, always available
+        void expandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, uint8_t alpha = 0xff);
+        void premultiplyAlpha(uint8_t* rgba, size_t pixelCount, ColorSpace colorSpace);
+        void renormalizeNormals(uint8_t* rgba, size_t pixelCount);
+        void downsampleBox(
+                const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                uint8_t* dst,
+                ColorSpace colorSpace);
+    }// namespace Scalar
+}// namespace ImageKernels
+
+MOE_END_NAMESPACE
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Core/Ref.hpp"
 #include "Core/Resource/BinaryBuffer.hpp"
 #include "Core/Resource/Image.hpp"
+#include "Core/Resource/ImageKernels.hpp"
 
 
 MOE_BEGIN_NAMESPACE
@@ -18,6 +19,16 @@ namespace Detail {
             int& outHeight,
             int& outChannels,
             int desiredChannels);
+
+    // runs the optional rgba8 post-processing kernels in place
+    void postProcessImage(
+            Vector<uint8_t>& imageData,
+            int width,
+            int height,
+            int channels,
+            bool premultiplyAlpha,
+            bool renormalizeNormals,
+            ImageKernels::ColorSpace colorSpace);
 }// namespace Detail
 
 template<
@@ -32,6 +43,10 @@ struct ImageLoader {
 public:
     struct Pref {
         int desiredChannels{4};
+        // the following only apply to 4-channel output
+        bool premultiplyAlpha{false};
+        bool renormalizeNormals{false};
+        ImageKernels::ColorSpace colorSpace{ImageKernels::ColorSpace::Srgb};
     };
 
     using value_type = Ref<Image>;
@@ -64,6 +79,15 @@ public:
             return std::nullopt;
         }
 
+        Detail::postProcessImage(
+                imageData,
+                width,
+                height,
+                channels,
+                m_pref.premultiplyAlpha,
+                m_pref.renormalizeNormals,
+                m_pref.colorSpace);
+
         return Ref(new Image(std::move(imageData), width, height, channels));
     }
 
@@ -43,13 +43,7 @@ namespace moe {
 
         template<typename... Args, typename = EnableIfInvocable<Args...>>
         Pair<ResIdT, SharedResource<ResT>> load(Args&&... args) {
-            ResIdT id;
-            if (!recycledIds.empty()) {
-                id = recycledIds.front();
-                recycledIds.pop_front();
-            } else {
-                id = idCounter++;
-            }
+            ResIdT id = allocateId();
 
             if constexpr (Meta::IsVoidV<DeleterT>) {
                 return *resources.emplace(id, SharedResource<ResT>{LoaderFunctorT{}(std::forward<Args>(args)...)}).first;
@@ -60,13 +54,31 @@ namespace moe {
             }
         }
 
+        // the id resolves to nothing until a resource is emplaced under it
+        ResIdT reserve() {
+            ResIdT id = allocateId();
+            pendingIds.insert(id);
+            return id;
+        }
+
+        void emplace(ResIdT id, SharedResource<ResT> resource) {
+            pendingIds.erase(id);
+            resources[id] = std::move(resource);
+        }
+
+        bool isPending(ResIdT id) const {
+            return pendingIds.find(id) != pendingIds.end();
+        }
+
         void leak(ResIdT id) {
             resources.erase(id);
+            pendingIds.erase(id);
             recycledIds.push_back(id);
         }
 
         void destroy() {
             resources.clear();
+            pendingIds.clear();
             recycledIds.clear();
             idCounter = 0;
         }
@@ -74,6 +86,16 @@ namespace moe {
     private:
         ResIdT idCounter{0};
         Deque<ResIdT> recycledIds;
+        UnorderedSet<ResIdT> pendingIds;
         ResHashMap<ResIdT, ResT> resources;
+
+        ResIdT allocateId() {
+            if (!recycledIds.empty()) {
+                ResIdT id = recycledIds.front();
+                recycledIds.pop_front();
+                return id;
+            }
+            return idCounter++;
+        }
     };
 }// namespace moe
\ No newline at end of file
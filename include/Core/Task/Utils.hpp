@@ -246,4 +246,87 @@ auto whenAny(Vector<Future<T, SchedulerT>>&& futures) {
     return outFuture;
 }
 
+template<typename Fn>
+Future<void, ThreadPoolScheduler> parallelFor(size_t count, Fn&& func) {
+    // at most one task per worker, each pulls indices until none are left;
+    // nothing waits on a worker, the thread finishing the last task resolves the future
+    struct ParallelForContext {
+        std::atomic_size_t nextIndex{0};
+        std::atomic_size_t pendingTasks;
+        std::decay_t<Fn> func;
+
+        ParallelForContext(size_t taskCount, Fn&& f)
+            : pendingTasks(taskCount), func(std::forward<Fn>(f)) {}
+    };
+
+    auto promise = std::make_shared<Promise<void, ThreadPoolScheduler>>();
+    auto future = promise->getFuture();
+
+    if (count == 0) {
+        promise->setValue();
+        return future;
+    }
+
+    auto& scheduler = ThreadPoolScheduler::getInstance();
+    size_t taskCount = std::min(count, std::max<size_t>(scheduler.workerCount(), 1));
+
+    auto context = std::make_shared<ParallelForContext>(taskCount, std::forward<Fn>(func));
+    for (size_t task = 0; task < taskCount; ++task) {
+        scheduler.schedule([context, promise, count]() {
+            for (size_t i = context->nextIndex.fetch_add(1); i < count; i = context->nextIndex.fetch_add(1)) {
+                context->func(i);
+            }
+
+            if (context->pendingTasks.fetch_sub(1) == 1) {
+                promise->setValue();
+            }
+        });
+    }
+
+    return future;
+}
+
+// blocking variant; the calling thread pulls indices as well and only waits for indices already taken,
+// so helper tasks still queued behind it are never waited on. safe to call from a worker thread.
+// ! note: func is only ever invoked before this returns
+template<typename Fn>
+void parallelForInline(size_t count, Fn&& func) {
+    struct ParallelForInlineContext {
+        std::atomic_size_t nextIndex{0};
+        std::atomic_size_t completed{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    if (count == 0) {
+        return;
+    }
+
+    auto& scheduler = ThreadPoolScheduler::getInstance();
+    size_t helperCount = std::min(count - 1, scheduler.workerCount());
+
+    auto context = std::make_shared<ParallelForInlineContext>();
+    auto* fn = &func;
+    auto run = [context, fn, count]() {
+        size_t finished = 0;
+        for (size_t i = context->nextIndex.fetch_add(1); i < count; i = context->nextIndex.fetch_add(1)) {
+            (*fn)(i);
+            ++finished;
+        }
+
+        if (finished > 0 && context->completed.fetch_add(finished) + finished == count) {
+            std::lock_guard<std::mutex> lk(context->mutex);
+            context->done.notify_all();
+        }
+    };
+
+    for (size_t helper = 0; helper < helperCount; ++helper) {
+        scheduler.schedule(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lk(context->mutex);
+    context->done.wait(lk, [&context, count]() { return context->completed.load() == count; });
+}
+
 MOE_END_NAMESPACE
\ No newline at end of file
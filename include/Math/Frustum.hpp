@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Core/Common.hpp"
+#include "Math/Common.hpp"
+
+namespace moe {
+    // world space planes of a view projection with a 0..1 depth range.
+    // xyz is the inward facing normal and w the distance, a point p is inside a plane when dot(xyz, p) + w >= 0.
+    // plane normals are not normalized, only the sign of a distance is meaningful
+    struct Frustum {
+    public:
+        enum Plane : uint32_t {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            PlaneCount,
+        };
+
+        Array<glm::vec4, PlaneCount> planes{};
+
+        static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+        // conservative, boxes just outside a corner of the frustum may still pass
+        bool intersectsBox(const glm::vec3& center, const glm::vec3& extent) const;
+
+        // the local box is transformed by an affine matrix first
+        bool intersectsBox(const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localExtent) const;
+    };
+
+    // batched frustum tests of transformed boxes.
+    // lanes of boxes are transposed into structure of arrays form and tested against every plane at once.
+    // vectorized paths are selected at compile time (sse2 > neon > scalar)
+    namespace FrustumKernels {
+        // local space box, padded so it loads as two vec4
+        struct Box {
+            glm::vec3 center;
+            float padding0;
+            glm::vec3 extent;
+            float padding1;
+        };
+
+        // name of the compiled simd backend, for logging
+        StringView backendName();
+
+        // transform i is an affine glm::mat4 at transforms + i * transformStride,
+        // visible[i] is set to 1 when box i transformed by it may intersect the frustum and 0 otherwise
+        void cullBoxes(
+                const Frustum& frustum,
+                const uint8_t* transforms, size_t transformStride,
+                const Box* boxes, uint8_t* visible, size_t count);
+
+        namespace Scalar {
+            // reference implementation, always available
+            void cullBoxes(
+                    const Frustum& frustum,
+                    const uint8_t* transforms, size_t transformStride,
+                    const Box* boxes, uint8_t* visible, size_t count);
+        }// namespace Scalar
+    }// namespace FrustumKernels
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Core/Common.hpp"
+#include "Math/Common.hpp"
+
+namespace moe {
+    // a small software depth buffer for occlusion culling, rasterized on the cpu.
+    // pixels are grouped into tiles of TILE_WIDTH x TILE_HEIGHT that are stored contiguously, so a row of a tile is
+    // two simd registers, and every tile keeps the farthest depth it holds for whole-tile rejects.
+    // depth is stored as 1 / w (clip space w, the view depth of a perspective projection): it interpolates linearly
+    // in screen space, larger is nearer and 0 is infinitely far, whatever depth range the projection maps to.
+    // vectorized paths are selected at compile time (sse2 > scalar)
+    // ! note: only meaningful for perspective projections, orthographic ones have a constant w
+    struct OcclusionBuffer {
+    public:
+        static constexpr uint32_t TILE_WIDTH = 8;
+        static constexpr uint32_t TILE_HEIGHT = 4;
+        static constexpr uint32_t TILE_SIZE = TILE_WIDTH * TILE_HEIGHT;
+
+        // a box only counts as hidden behind occluders nearer than its nearest point by this fraction of its depth
+        static constexpr float DEPTH_BIAS = 1e-3f;
+        // triangles with a vertex closer than this (in clip space w) are not rasterized, boxes reaching it are visible
+        static constexpr float MIN_W = 1e-3f;
+
+        // an occluder triangle in pixel coordinates, with the pixel range its bounds cover
+        struct Triangle {
+            float x[3];
+            float y[3];
+            float invW[3];
+            int32_t minX, minY;
+            int32_t maxX, maxY;
+        };
+
+        OcclusionBuffer() = default;
+        ~OcclusionBuffer() = default;
+
+        // the size is rounded up to whole tiles, the content is undefined until clear()
+        void resize(uint32_t width, uint32_t height);
+
+        uint32_t getWidth() const { return m_width; }
+
+        uint32_t getHeight() const { return m_height; }
+
+        uint32_t getTileRows() const { return m_height / TILE_HEIGHT; }
+
+        // everything infinitely far
+        void clear();
+
+        // thread safe. projects the indexed triangles with the model-view-projection into out, which holds
+        // at least indices.size() / 3 triangles; returns how many were written. triangles crossing MIN_W are
+        // dropped, which only costs culling
+        size_t setupTriangles(
+                const glm::mat4& modelViewProjection,
+                Span<const glm::vec3> positions,
+                Span<const uint32_t> indices,
+                Triangle* out) const;
+
+        // thread safe for disjoint tile row ranges. rasterizes the parts of the triangles inside the tile rows
+        // [tileRowBegin, tileRowEnd) and refreshes the farthest depth of those tiles
+        void rasterize(Span<const Triangle> triangles, uint32_t tileRowBegin, uint32_t tileRowEnd);
+
+        // thread safe once rasterized. false when the local box, transformed by the model-view-projection,
+        // is behind occluders at every pixel it may cover
+        bool isBoxVisible(const glm::mat4& modelViewProjection, const glm::vec3& center, const glm::vec3& extent) const;
+
+        // 1 / w of a pixel, 0 where nothing was rasterized
+        float getDepth(uint32_t x, uint32_t y) const { return m_depth[pixelIndex(x, y)]; }
+
+    private:
+        uint32_t m_width{0};
+        uint32_t m_height{0};
+        uint32_t m_tilesX{0};
+
+        Vector<float> m_depth;
+        // the farthest depth of every tile
+        Vector<float> m_tileFarthest;
+
+        size_t pixelIndex(uint32_t x, uint32_t y) const {
+            const size_t tile = static_cast<size_t>(y / TILE_HEIGHT) * m_tilesX + x / TILE_WIDTH;
+            return tile * TILE_SIZE + (y % TILE_HEIGHT) * TILE_WIDTH + (x % TILE_WIDTH);
+        }
+
+        void rasterizeTriangle(const Triangle& triangle, int32_t minY, int32_t maxY);
+    };
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Core/Common.hpp"
+#include "Math/Common.hpp"
+
+namespace moe {
+    // a node hierarchy flattened into pre-order arrays. a node follows its parent, and its subtree is the contiguous
+    // range [node, subtreeEnd). local transforms are stored as translation, rotation and scale next to the matrix
+    // they compose to; world matrices are relative to the root of the hierarchy.
+    // - changing a local transform marks the node dirty, update() only recomputes the dirty subtrees
+    // - dirty subtrees never overlap and only read the world matrix of a clean parent, so they update in parallel
+    struct TransformHierarchy {
+    public:
+        using NodeIndex = uint32_t;
+        static constexpr NodeIndex NO_PARENT = std::numeric_limits<NodeIndex>::max();
+
+        // fewer nodes to recompute than this stay on the calling thread
+        static constexpr size_t MIN_PARALLEL_NODES = 4096;
+
+        TransformHierarchy() = default;
+        ~TransformHierarchy() = default;
+
+        void reserve(size_t count);
+
+        void clear();
+
+        // appends a node in pre-order: the parent is NO_PARENT or the last node added or one of its ancestors.
+        // the node starts out dirty
+        NodeIndex addNode(NodeIndex parent, const glm::mat4& localMatrix);
+
+        // whether addNode(parent, ...) keeps the pre-order, addNode asserts it
+        bool canAddNode(NodeIndex parent) const {
+            return parent == NO_PARENT || (parent < size() && m_subtreeEnds[parent] == size());
+        }
+
+        size_t size() const { return m_parents.size(); }
+
+        NodeIndex getParent(NodeIndex node) const { return m_parents[node]; }
+
+        // one past the last node of the subtree rooted at node
+        NodeIndex getSubtreeEnd(NodeIndex node) const { return m_subtreeEnds[node]; }
+
+        const glm::vec3& getTranslation(NodeIndex node) const { return m_translations[node]; }
+
+        const glm::quat& getRotation(NodeIndex node) const { return m_rotations[node]; }
+
+        const glm::vec3& getScale(NodeIndex node) const { return m_scales[node]; }
+
+        const glm::mat4& getLocalMatrix(NodeIndex node) const { return m_localMatrices[node]; }
+
+        void setLocalTransform(NodeIndex node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
+        // the matrix is kept as is, translation, rotation and scale are decomposed from it
+        // ! note: a matrix with shear does not round trip through its decomposition
+        void setLocalMatrix(NodeIndex node, const glm::mat4& localMatrix);
+
+        // relative to the hierarchy root, valid once update() ran after the last change
+        const glm::mat4& getWorldMatrix(NodeIndex node) const { return m_worldMatrices[node]; }
+
+        Span<const glm::mat4> getWorldMatrices() const { return m_worldMatrices; }
+
+        bool isDirty() const { return !m_dirtyNodes.empty(); }
+
+        // recomputes the world matrices of every dirty node and its descendants, returns how many were recomputed.
+        // not thread safe, but spreads large updates over the thread pool itself
+        size_t update();
+
+    private:
+        Vector<glm::vec3> m_translations;
+        Vector<glm::quat> m_rotations;
+        Vector<glm::vec3> m_scales;
+        Vector<glm::mat4> m_localMatrices;
+        Vector<glm::mat4> m_worldMatrices;
+        Vector<NodeIndex> m_parents;
+        Vector<NodeIndex> m_subtreeEnds;
+
+        // a bit per node, and the dirty nodes in the order they were marked
+        Vector<uint8_t> m_dirty;
+        Vector<NodeIndex> m_dirtyNodes;
+
+        // scratch for update(), node ranges recomputed as one task
+        Vector<Pair<NodeIndex, NodeIndex>> m_ranges;
+
+        void markDirty(NodeIndex node);
+    };
+
+    // matrix products of the hierarchy update and of instancing.
+    // vectorized paths are selected at compile time (sse2 > neon > scalar)
+    namespace TransformKernels {
+        // name of the compiled simd backend, for logging
+        StringView backendName();
+
+        // out = lhs * rhs, out may alias either operand
+        void multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out);
+
+        // world[i] = world[parents[i]] * local[i] for i in [begin, end), or local[i] for a root.
+        // parents precede their children, and parents outside the range are already up to date
+        void updateWorldMatrices(
+                const TransformHierarchy::NodeIndex* parents,
+                const glm::mat4* localMatrices,
+                glm::mat4* worldMatrices,
+                size_t begin, size_t end);
+
+        namespace Scalar {
+            // reference implementations, always available
+            void multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out);
+
+            void updateWorldMatrices(
+                    const TransformHierarchy::NodeIndex* parents,
+                    const glm::mat4* localMatrices,
+                    glm::mat4* worldMatrices,
+                    size_t begin, size_t end);
+        }// namespace Scalar
+    }// namespace TransformKernels
+}// namespace moe
\ No newline at end of file
@@ -7,8 +7,54 @@
 
 MOE_BEGIN_NAMESPACE
 
+// a built shape hierarchy (bounding volume trees included) in jolt's binary state format,
+// the value type of Cached<> for collider cooking.
+// ! note: restoring needs jolt's factory and registered types, same as creating bodies
+struct CookedCollisionShape {
+public:
+    static constexpr uint32_t MAGIC = 0x4c4f434d;// "MCOL"
+    static constexpr uint32_t VERSION = 1;
+
+    JPH::RefConst<JPH::Shape> shape;
+
+    static Optional<CookedCollisionShape> deserialize(Span<const uint8_t> data);
+
+    Vector<uint8_t> serialize() const;
+};
+
 struct GltfColliderFactory {
-    static JPH::Ref<JPH::StaticCompoundShapeSettings> shapeFromGltf(StringView filePath);
+    // parameters of every MeshShape, part of the cache key
+    struct MeshBuildSettings {
+        uint32_t maxTrianglesPerLeaf{8};
+        // cos of the angle below which an edge between two triangles is not treated as active
+        float activeEdgeCosThresholdAngle{0.996195f};
+    };
+
+    // generator for Cached<>, builds the compound shape of a .gltf / .glb file.
+    // the key is a content hash of the source files, the cooked format version and the build settings
+    struct ShapeCooker {
+    public:
+        using value_type = CookedCollisionShape;
+
+        explicit ShapeCooker(StringView filename, const MeshBuildSettings& settings = {});
+
+        Optional<CookedCollisionShape> generate();
+
+        uint64_t hashCode() const { return m_hash; }
+
+        String paramString() const;
+
+    private:
+        String m_filename;
+        MeshBuildSettings m_settings;
+        uint64_t m_hash{0};
+    };
+
+    // jolt builds the shapes (and their bounding volume trees) when the settings are turned into a body
+    static JPH::Ref<JPH::StaticCompoundShapeSettings> shapeFromGltf(StringView filePath, const MeshBuildSettings& settings = {});
+
+    // the built shape, restored from the cache on warm starts instead of rebuilding it
+    static JPH::RefConst<JPH::Shape> cookedShapeFromGltf(StringView filePath, const MeshBuildSettings& settings = {});
 };
 
 MOE_END_NAMESPACE
\ No newline at end of file
@@ -14,6 +14,10 @@ namespace moe {
             constexpr GltfT() = default;
         };
         static constexpr GltfT Gltf{};
+        struct GltfAsyncT {
+            constexpr GltfAsyncT() = default;
+        };
+        static constexpr GltfAsyncT GltfAsync{};
         struct ObjT {
             constexpr ObjT() = default;
         };
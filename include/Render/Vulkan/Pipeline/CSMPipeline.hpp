@@ -1,7 +1,9 @@
 #pragma once
 
+#include "Math/Frustum.hpp"
 #include "Render/Vulkan/VulkanIdTypes.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
 
 
 // fwd decl
@@ -11,6 +13,7 @@ namespace moe {
     class VulkanMaterialCache;
     class VulkanRenderPacket;
     class VulkanCamera;
+    struct VulkanGPUScene;
 }// namespace moe
 
 namespace moe {
@@ -18,6 +21,23 @@ namespace moe {
         struct CSMPipeline {
         public:
             static constexpr uint32_t SHADOW_CASCADE_COUNT = 4;
+            // casters covering fewer shadow map texels than this are skipped, except in the first cascade
+            static constexpr float DEFAULT_MIN_CASTER_SIZE_TEXELS = 2.0f;
+
+            struct Stats {
+                // per frame
+                size_t casters{0};
+                // skinned or without known bounds, drawn into every cascade
+                size_t unboundedCasters{0};
+                Array<size_t, SHADOW_CASCADE_COUNT> drawnCasters{};
+                // instanced draw calls the drawn casters took
+                Array<size_t, SHADOW_CASCADE_COUNT> draws{};
+                Array<size_t, SHADOW_CASCADE_COUNT> culledCasters{};
+                Array<size_t, SHADOW_CASCADE_COUNT> smallCasters{};
+                Array<size_t, SHADOW_CASCADE_COUNT> indexBufferBinds{};
+                // secondary command buffers a cascade was recorded into, 0 when recorded inline
+                Array<size_t, SHADOW_CASCADE_COUNT> chunks{};
+            };
 
             CSMPipeline() = default;
             ~CSMPipeline() = default;
@@ -28,8 +48,12 @@ namespace moe {
                     VkCommandBuffer cmdBuffer,
                     VulkanMeshCache& meshCache,
                     Span<VulkanRenderPacket> drawCommands,
+                    // instance i holds the transform of drawCommands[i], see VulkanInstanceBuffer
+                    VkDeviceAddress instanceBufferAddr,
                     const VulkanCamera& camera,
-                    glm::vec3 lightDir);
+                    glm::vec3 lightDir,
+                    // when enabled, every cascade is culled and drawn on the gpu instead of from the packets
+                    VulkanGPUScene* gpuScene = nullptr);
 
             void destroy();
 
@@ -41,13 +65,41 @@ namespace moe {
             // however if the scene is too large, a larger x and y may still be needed
             void setShadowMapCameraScale(glm::vec3 scale) { m_shadowMapCameraScale = scale; }
 
+            bool isInstancingEnabled() const { return m_instancingEnabled; }
+
+            void setInstancingEnabled(bool enabled) { m_instancingEnabled = enabled; }
+
+            bool isCasterCullingEnabled() const { return m_casterCullingEnabled; }
+
+            void setCasterCullingEnabled(bool enabled) { m_casterCullingEnabled = enabled; }
+
+            float getMinCasterSize() const { return m_minCasterSizeTexels; }
+
+            // projected diameter in shadow map texels, 0 keeps every caster that overlaps a cascade
+            void setMinCasterSize(float texels) { m_minCasterSizeTexels = texels; }
+
+            const Stats& getStats() const { return m_stats; }
+
             glm::mat4 m_cascadeLightTransforms[SHADOW_CASCADE_COUNT];
             float m_cascadeFarPlaneZs[SHADOW_CASCADE_COUNT];
 
         private:
+            // pushed per cascade and whenever the vertex stream changes, transforms come from the instance buffer.
+            // the object and mesh buffers are only set on the gpu driven path
             struct PushConstants {
-                glm::mat4 mvp;
+                glm::mat4 lightViewProjection;
                 VkDeviceAddress vertexBufferAddr;
+                VkDeviceAddress instanceBufferAddr;
+                VkDeviceAddress objectBufferAddr;
+                VkDeviceAddress meshBufferAddr;
+                VulkanVertexFormat vertexFormat;
+            };
+
+            // of one recorded range of casters
+            struct RecordStats {
+                size_t draws{0};
+                size_t drawnCasters{0};
+                size_t indexBufferBinds{0};
             };
 
             bool m_initialized{false};
@@ -63,6 +115,43 @@ namespace moe {
             Array<float, SHADOW_CASCADE_COUNT> m_cascadeSplitRatios;
 
             glm::vec3 m_shadowMapCameraScale{2.0f, 2.0f, 2.0f};
+
+            bool m_instancingEnabled{true};
+            bool m_casterCullingEnabled{true};
+            float m_minCasterSizeTexels{DEFAULT_MIN_CASTER_SIZE_TEXELS};
+
+            // per caster scratch, reused across frames
+            Vector<FrustumKernels::Box> m_casterBoxes;
+            Vector<float> m_casterRadii;
+            Vector<uint8_t> m_casterBounded;
+            Vector<uint8_t> m_casterVisible;
+
+            Stats m_stats;
+
+            void gatherCasterBounds(const VulkanMeshCache& meshCache, Span<VulkanRenderPacket> drawCommands);
+
+            // fills m_casterVisible for one cascade
+            void cullCasters(Span<VulkanRenderPacket> drawCommands, uint32_t cascade);
+
+            // the volume casters of a cascade must intersect, open towards the light
+            Frustum getCasterFrustum(uint32_t cascade) const;
+
+            // world space bounding radius of the smallest caster still drawn into a cascade
+            float getMinCasterRadius(uint32_t cascade) const;
+
+            // pipeline, descriptors and dynamic state; secondary command buffers inherit none of it
+            void bindState(VkCommandBuffer cmdBuffer) const;
+
+            // drawCommands[begin, end) of the cascade m_casterVisible was culled for,
+            // safe to call for disjoint ranges from several threads
+            RecordStats recordCasters(
+                    VkCommandBuffer cmdBuffer,
+                    const VulkanMeshCache& meshCache,
+                    Span<VulkanRenderPacket> drawCommands,
+                    size_t begin,
+                    size_t end,
+                    bool cullingEnabled,
+                    PushConstants pushConstants) const;
         };
     }// namespace Pipeline
 }// namespace moe
\ No newline at end of file
@@ -3,18 +3,30 @@
 #include "Render/Vulkan/VulkanIdTypes.hpp"
 #include "Render/Vulkan/VulkanRenderable.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
 
 
 namespace moe {
     class VulkanEngine;
     class VulkanMeshCache;
     class VulkanMaterialCache;
+    struct VulkanGPUScene;
 }// namespace moe
 
 
 namespace moe {
     namespace Pipeline {
         struct GBufferPipeline {
+            struct Stats {
+                // per frame
+                size_t draws{0};
+                size_t instances{0};
+                size_t indexBufferBinds{0};
+                size_t statePushes{0};
+                // secondary command buffers the packets were recorded into, 0 when recorded inline
+                size_t chunks{0};
+            };
+
             GBufferPipeline() = default;
             ~GBufferPipeline() = default;
 
@@ -27,7 +39,15 @@ namespace moe {
                     VulkanMeshCache& meshCache,
                     VulkanMaterialCache& materialCache,
                     Span<VulkanRenderPacket> drawCommands,
-                    VulkanAllocatedBuffer& sceneDataBuffer);
+                    VulkanAllocatedBuffer& sceneDataBuffer,
+                    // instance i holds the transform of drawCommands[i], see VulkanInstanceBuffer
+                    VkDeviceAddress instanceBufferAddr,
+                    // when enabled, draws its culled camera view instead of the packets
+                    VulkanGPUScene* gpuScene = nullptr);
+
+            bool isInstancingEnabled() const { return m_instancingEnabled; }
+
+            void setInstancingEnabled(bool enabled) { m_instancingEnabled = enabled; }
 
             //VulkanAllocatedImage gPosition;
             VulkanAllocatedImage gDepth;
@@ -42,13 +62,19 @@ namespace moe {
             ImageId gORMAId{NULL_IMAGE_ID};
             ImageId gEmissiveId{NULL_IMAGE_ID};
 
+            const Stats& getStats() const { return m_stats; }
+
         private:
+            // only pushed when they change between draws, transforms come from the instance buffer.
+            // the object and mesh buffers are only set on the gpu driven path
             struct PushConstants {
-                glm::mat4 transform;
-                glm::mat3 clampedInverseTransform;
                 VkDeviceAddress vertexBufferAddr;
                 VkDeviceAddress sceneDataAddress;
+                VkDeviceAddress instanceBufferAddr;
+                VkDeviceAddress objectBufferAddr;
+                VkDeviceAddress meshBufferAddr;
                 MaterialId materialId;
+                VulkanVertexFormat vertexFormat;
             };
 
             VulkanEngine* m_engine{nullptr};
@@ -57,8 +83,24 @@ namespace moe {
             VkPipelineLayout m_pipelineLayout;
             VkPipeline m_pipeline;
 
+            bool m_instancingEnabled{true};
+
+            Stats m_stats;
+
             void allocateImages();
 
+            // pipeline, descriptors and dynamic state; secondary command buffers inherit none of it
+            void bindState(VkCommandBuffer cmdBuffer) const;
+
+            // drawCommands[begin, end), safe to call for disjoint ranges from several threads
+            Stats recordPackets(
+                    VkCommandBuffer cmdBuffer,
+                    const VulkanMeshCache& meshCache,
+                    Span<VulkanRenderPacket> drawCommands,
+                    size_t begin,
+                    size_t end,
+                    PushConstants pushConstants) const;
+
             void transitionImagesForRendering(VkCommandBuffer cmdBuffer);
 
             void transitionImagesForSampling(VkCommandBuffer cmdBuffer);
@@ -3,6 +3,7 @@
 #include "Render/Vulkan/VulkanIdTypes.hpp"
 #include "Render/Vulkan/VulkanRenderable.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
 
 
 // fwd decl
@@ -36,6 +37,7 @@ namespace moe {
                 VkDeviceAddress vertexBufferAddr;
                 VkDeviceAddress sceneDataAddress;
                 MaterialId materialId;
+                VulkanVertexFormat vertexFormat;
             };
 
             bool m_initialized{false};
@@ -2,6 +2,7 @@
 
 #include "Render/Vulkan/VulkanIdTypes.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
 
 
 // fwd decl
@@ -41,6 +42,7 @@ namespace moe {
             struct PushConstants {
                 glm::mat4 mvp;
                 VkDeviceAddress vertexBufferAddr;
+                VulkanVertexFormat vertexFormat;
             };
 
             bool m_initialized{false};
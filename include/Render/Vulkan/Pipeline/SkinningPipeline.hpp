@@ -4,6 +4,7 @@
 #include "Render/Vulkan/VulkanIdTypes.hpp"
 #include "Render/Vulkan/VulkanRenderable.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
 
 namespace moe {
     class VulkanEngine;
@@ -41,6 +42,7 @@ namespace moe {
                 VkDeviceAddress outputVertexBufferAddr;
                 uint32_t jointMatrixStartIndex;
                 uint32_t vertexCount;
+                VulkanVertexFormat vertexFormat;// of the input buffers
             };
 
             struct SwapData {
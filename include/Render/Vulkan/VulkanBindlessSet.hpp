@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Render/Common.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
 
 // fwd decl
@@ -8,6 +9,9 @@ namespace moe {
 }
 
 namespace moe {
+    // one descriptor set per frame in flight, so a slot is never rewritten while a pending frame samples it.
+    // writes are queued for every set and applied in beginFrame(), once that frame's fence has been waited on;
+    // an image replaced in a slot must stay alive until FRAMES_IN_FLIGHT frames later (e.g. the frame's deletion queue)
     struct VulkanBindlessSet {
     public:
         static constexpr uint32_t MAX_BINDLESS_IMAGES = 8192;
@@ -27,11 +31,15 @@ namespace moe {
 
         void addSampler(uint32_t id, VkSampler sampler);
 
+        // main thread, after the frame's fence wait and before anything binds the set
+        void beginFrame(size_t frameIndex);
+
         void destroy();
 
         VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout; }
 
-        VkDescriptorSet getDescriptorSet() const { return m_descriptorSet; }
+        // the set of the frame being recorded
+        VkDescriptorSet getDescriptorSet() const { return m_descriptorSets[m_frameIndex]; }
 
         bool isInitialized() const { return m_initialized; }
 
@@ -39,9 +47,17 @@ namespace moe {
         VulkanEngine* m_engine;
         bool m_initialized{false};
 
+        struct PendingWrite {
+            uint32_t binding;
+            uint32_t id;
+            VkDescriptorImageInfo info;
+        };
+
         VkDescriptorPool m_descriptorPool;
         VkDescriptorSetLayout m_descriptorSetLayout;
-        VkDescriptorSet m_descriptorSet;
+        Array<VkDescriptorSet, Constants::FRAMES_IN_FLIGHT> m_descriptorSets;
+        Array<Vector<PendingWrite>, Constants::FRAMES_IN_FLIGHT> m_pendingWrites;
+        size_t m_frameIndex{0};
 
         struct {
             VkSampler nearestSampler;
@@ -49,5 +65,7 @@ namespace moe {
         } m_defaultSamplers;
 
         void initDefaultSamplers(int maxAnisotropy);
+
+        void queueWrite(uint32_t binding, uint32_t id, const VkDescriptorImageInfo& info);
     };
 }// namespace moe
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanMesh.hpp"
+#include "Render/Vulkan/VulkanSkeleton.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+namespace moe {
+    // pre-processed scene, the value type of Cached<> for scene loaders.
+    // the file is a header followed by a fixed sequence of sections, each one a byte count and a tightly packed
+    // array of trivially copyable records starting on a 16 byte boundary. a loaded scene is a set of spans into
+    // one buffer holding the whole file, so vertex, index and pixel data go to staging with a single memcpy.
+    // ! note: bump VERSION whenever the layout or the cooking itself changes, old cache files are then rejected
+    struct VulkanCookedScene {
+    public:
+        static constexpr uint32_t MAGIC = 0x53454f4d;// "MOES"
+        static constexpr uint32_t VERSION = 6;
+
+        static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+        static constexpr int32_t NO_REFERENCE = -1;
+
+        enum TextureSlot : uint32_t {
+            Diffuse,
+            Normal,
+            MetallicRoughness,
+            Emissive,
+            TextureSlotCount,
+        };
+
+        struct Range {
+            uint64_t offset{0};
+            uint64_t count{0};
+        };
+
+        struct Mesh {
+            uint32_t firstPrimitive{0};
+            uint32_t primitiveCount{0};
+        };
+
+        // primitives without geometry keep their slot with empty ranges.
+        // indices holds every lod back to back, lod ranges are relative to the primitive's first index.
+        // meshlet offsets are relative to the primitive's meshletVertices / meshletTriangles
+        struct Primitive {
+            Range vertices;
+            Range indices;
+            Range lods;
+            Range meshlets;
+            Range meshletVertices;
+            Range meshletTriangles;
+            Range skinningData;
+            glm::vec3 min{0.0f};
+            glm::vec3 max{0.0f};
+            int32_t material{NO_REFERENCE};
+        };
+
+        struct Material {
+            glm::vec4 baseColor{1.0f};
+            glm::vec4 emissiveColor{1.0f};
+            float metallic{0.0f};
+            float roughness{1.0f};
+            float emissive{0.0f};
+            int32_t textures[TextureSlotCount]{NO_REFERENCE, NO_REFERENCE, NO_REFERENCE, NO_REFERENCE};
+        };
+
+        // either embedded rgba8 pixels or a path relative to the source file
+        struct Image {
+            uint32_t width{0};
+            uint32_t height{0};
+            Range pixels;
+            Range path;
+            // every texel has alpha 1; only checked for diffuse textures, 0 when unknown
+            uint32_t opaque{0};
+        };
+
+        // pre-order, a node directly follows its parent and siblings keep their order
+        struct Node {
+            glm::mat4 localTransform{1.0f};
+            uint32_t parent{NO_PARENT};
+            SceneResourceInternalId mesh{NULL_SCENE_RESOURCE_INTERNAL_ID};
+        };
+
+        struct Skeleton {
+            Range joints;
+        };
+
+        struct Joint {
+            glm::mat4 localTransform{1.0f};
+            glm::mat4 inverseBindMatrix{1.0f};
+            Range children;
+            Range name;
+        };
+
+        struct KeyRange {
+            uint64_t keyOffset{0};
+            uint64_t timeOffset{0};
+            uint64_t count{0};
+        };
+
+        struct Track {
+            KeyRange translations;
+            KeyRange rotations;
+            KeyRange scales;
+        };
+
+        struct Animation {
+            Range tracks;
+            Range name;
+        };
+
+        // filled by a cooker, then turned into the on-disk layout by build()
+        struct Builder {
+            Vector<Mesh> meshes;
+            Vector<Primitive> primitives;
+            Vector<Vertex> vertices;
+            Vector<uint32_t> indices;
+            Vector<VulkanMeshLod> lods;
+            Vector<VulkanMeshlet> meshlets;
+            Vector<uint32_t> meshletVertices;
+            Vector<uint8_t> meshletTriangles;
+            Vector<SkinningData> skinningData;
+
+            Vector<Material> materials;
+            Vector<Image> images;
+            Vector<uint8_t> pixels;
+
+            Vector<Node> nodes;
+
+            Vector<Skeleton> skeletons;
+            Vector<Joint> joints;
+            Vector<uint32_t> jointChildren;
+
+            Vector<Animation> animations;
+            Vector<Track> tracks;
+            Vector<glm::vec3> translationKeys;
+            Vector<glm::quat> rotationKeys;
+            Vector<glm::vec3> scaleKeys;
+            Vector<float> keyTimes;
+
+            Vector<char> strings;
+
+            Range addString(StringView str);
+
+            // appends every stream of the mesh, an empty mesh gives a primitive with empty ranges
+            Primitive addPrimitive(const VulkanCPUMesh& mesh, int32_t material);
+        };
+
+        Span<const Mesh> meshes;
+        Span<const Primitive> primitives;
+        Span<const Vertex> vertices;
+        Span<const uint32_t> indices;
+        Span<const VulkanMeshLod> lods;
+        Span<const VulkanMeshlet> meshlets;
+        Span<const uint32_t> meshletVertices;
+        Span<const uint8_t> meshletTriangles;
+        Span<const SkinningData> skinningData;
+
+        Span<const Material> materials;
+        Span<const Image> images;
+        Span<const uint8_t> pixels;
+
+        Span<const Node> nodes;
+
+        Span<const Skeleton> skeletons;
+        Span<const Joint> joints;
+        Span<const uint32_t> jointChildren;
+
+        Span<const Animation> animations;
+        Span<const Track> tracks;
+        Span<const glm::vec3> translationKeys;
+        Span<const glm::quat> rotationKeys;
+        Span<const glm::vec3> scaleKeys;
+        Span<const float> keyTimes;
+
+        Span<const char> strings;
+
+        static VulkanCookedScene build(const Builder& builder);
+
+        static Optional<VulkanCookedScene> deserialize(Span<const uint8_t> data);
+
+        Vector<uint8_t> serialize() const;
+
+        // copies every section back into a builder, all ranges stay valid
+        Builder toBuilder() const;
+
+        template<typename T>
+        Span<const T> slice(Span<const T> span, Range range) const {
+            return span.subspan(range.offset, range.count);
+        }
+
+        StringView string(Range range) const {
+            return StringView(strings.data() + range.offset, range.count);
+        }
+
+        // whether the primitive may hide other objects: unskinned and drawn with a material the g-buffer pass
+        // never discards texels of, i.e. base color alpha 1 and an opaque diffuse texture (or none)
+        bool isOccluder(const Primitive& primitive) const {
+            if (primitive.skinningData.count > 0) {
+                return false;
+            }
+            if (primitive.material == NO_REFERENCE) {
+                return true;
+            }
+
+            const auto& material = materials[primitive.material];
+            if (material.baseColor.a < 1.0f) {
+                return false;
+            }
+            const int32_t diffuse = material.textures[Diffuse];
+            return diffuse == NO_REFERENCE || images[diffuse].opaque != 0;
+        }
+
+        VulkanSkeleton makeSkeleton(const Skeleton& skeleton) const;
+
+        VulkanSkeletonAnimation makeAnimation(const Animation& animation) const;
+
+    private:
+        // spans above point into this buffer, copies share it
+        SharedPtr<const Vector<uint8_t>> m_data;
+
+        static Optional<VulkanCookedScene> view(SharedPtr<const Vector<uint8_t>> data);
+    };
+}// namespace moe
\ No newline at end of file
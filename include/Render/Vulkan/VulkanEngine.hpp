@@ -16,19 +16,31 @@
 #include "Render/Vulkan/VulkanDescriptors.hpp"
 #include "Render/Vulkan/VulkanEngineDrivers.hpp"
 #include "Render/Vulkan/VulkanFont.hpp"
+#include "Render/Vulkan/VulkanFrustumCuller.hpp"
+#include "Render/Vulkan/VulkanGPUScene.hpp"
+#include "Render/Vulkan/VulkanGeometryArena.hpp"
 #include "Render/Vulkan/VulkanIm3dDriver.hpp"
 #include "Render/Vulkan/VulkanImageCache.hpp"
+#include "Render/Vulkan/VulkanInstanceBuffer.hpp"
+#include "Render/Vulkan/VulkanLodSelector.hpp"
 #include "Render/Vulkan/VulkanMaterialCache.hpp"
+#include "Render/Vulkan/VulkanMemoryTracker.hpp"
 #include "Render/Vulkan/VulkanMeshCache.hpp"
 #include "Render/Vulkan/VulkanObjectCache.hpp"
+#include "Render/Vulkan/VulkanOcclusionCuller.hpp"
+#include "Render/Vulkan/VulkanPacketGatherer.hpp"
+#include "Render/Vulkan/VulkanPacketSorter.hpp"
+#include "Render/Vulkan/VulkanParallelRecorder.hpp"
 #include "Render/Vulkan/VulkanPostFXGraph.hpp"
 #include "Render/Vulkan/VulkanRenderTarget.hpp"
 #include "Render/Vulkan/VulkanScene.hpp"
 #include "Render/Vulkan/VulkanSwapBuffer.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanUploadManager.hpp"
 
 
 #include "Core/Input.hpp"
+#include "Core/Resource/ImageKernels.hpp"
 
 
 #include <GLFW/glfw3.h>
@@ -69,6 +81,15 @@ namespace moe {
 
         DeletionQueue m_mainDeletionQueue;
         VmaAllocator m_allocator;
+        VulkanMemoryTracker m_memoryTracker;
+        VulkanUploadManager m_uploadManager;
+        VulkanGeometryArena m_geometryArena;
+        VulkanParallelRecorder m_parallelRecorder;
+        VulkanPacketGatherer m_packetGatherer;
+        VulkanLodSelector m_lodSelector;
+        VulkanFrustumCuller m_frustumCuller;
+        VulkanOcclusionCuller m_occlusionCuller;
+        VulkanPacketSorter m_packetSorter;
         VulkanDescriptorAllocator m_globalDescriptorAllocator;
 
         bool m_isInitialized{false};
@@ -84,6 +105,11 @@ namespace moe {
         // ! msaa x4; disable this if deferred rendering is implemented; use fxaa then
         bool m_enableFxaa{true};
 
+        bool m_showMemoryOverlay{false};
+
+        // meshes uploaded while set use the packed vertex format when their data fits it
+        bool m_vertexPackingEnabled{true};
+
         glm::vec3 m_shadowMapCameraScale{3.0f, 3.0f, 3.0f};
 
         GLFWwindow* m_window{nullptr};
@@ -108,6 +134,12 @@ namespace moe {
 
         VkQueue m_graphicsQueue;
         uint32_t m_graphicsQueueFamilyIndex;
+        // guards every submit/present on the graphics queue, uploads may be submitted from worker threads
+        std::mutex m_graphicsQueueMutex;
+
+        // only set when the device exposes a dedicated transfer family
+        VkQueue m_transferQueue{VK_NULL_HANDLE};
+        uint32_t m_transferQueueFamilyIndex{0};
 
         VkExtent2D m_drawExtent;
         VkFormat m_drawImageFormat{VK_FORMAT_R16G16B16A16_SFLOAT};
@@ -173,6 +205,8 @@ namespace moe {
 
             ImageId skyBoxImageId{NULL_IMAGE_ID};
             VulkanSwapBuffer sceneDataBuffer;
+            VulkanInstanceBuffer instanceBuffer;
+            VulkanGPUScene gpuScene;
         } m_pipelines;
 
         VulkanIm3dDriver m_im3dDriver;
@@ -210,8 +244,32 @@ namespace moe {
             return m_bindlessSet;
         }
 
+        VulkanMemoryTracker& getMemoryTracker() { return m_memoryTracker; }
+
+        VulkanUploadManager& getUploadManager() { return m_uploadManager; }
+
+        VulkanGeometryArena& getGeometryArena() { return m_geometryArena; }
+
+        VulkanParallelRecorder& getParallelRecorder() { return m_parallelRecorder; }
+
+        VulkanPacketGatherer& getPacketGatherer() { return m_packetGatherer; }
+
+        VulkanLodSelector& getLodSelector() { return m_lodSelector; }
+
+        VulkanFrustumCuller& getFrustumCuller() { return m_frustumCuller; }
+
+        VulkanOcclusionCuller& getOcclusionCuller() { return m_occlusionCuller; }
+
+        VulkanPacketSorter& getPacketSorter() { return m_packetSorter; }
+
+        VulkanGPUScene& getGPUScene() { return m_pipelines.gpuScene; }
+
         bool isFxaaEnabled() const { return m_enableFxaa; }
 
+        bool isVertexPackingEnabled() const { return m_vertexPackingEnabled; }
+
+        void setVertexPackingEnabled(bool enabled) { m_vertexPackingEnabled = enabled; }
+
         void setFxaaEnabled(bool enabled) { m_enableFxaa = enabled; }
 
         void immediateSubmit(Function<void(VkCommandBuffer)>&& fn, Function<void()>&& postFn = nullptr);
@@ -224,6 +282,8 @@ namespace moe {
 
         VulkanAllocatedImage allocateImage(void* data, VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap = false);
 
+        VulkanAllocatedImage allocateImage(const ImageKernels::MipChain& mipChain, VkFormat format, VkImageUsageFlags usage);
+
         VulkanAllocatedImage allocateCubeMapImage(VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap = false);
 
         VulkanAllocatedImage allocateCubeMapImage(Array<void*, 6> data, VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap = false);
@@ -236,7 +296,11 @@ namespace moe {
 
         void destroyBuffer(VulkanAllocatedBuffer& buffer);
 
-        VulkanGPUMeshBuffer uploadMesh(Span<uint32_t> indices, Span<Vertex> vertices, Span<SkinningData> skinningData = {});
+        // indices may hold several lods back to back, described by lods; no lods means a single one covering all indices.
+        // thread safe, the streams are sub-allocated from the geometry arena
+        VulkanGPUMeshBuffer uploadMesh(
+                Span<const uint32_t> indices, Span<const Vertex> vertices,
+                Span<const SkinningData> skinningData = {}, Span<const VulkanMeshLod> lods = {});
 
         FrameData& getCurrentFrame() { return m_frames[m_frameNumber % FRAMES_IN_FLIGHT]; }
 
@@ -288,6 +352,8 @@ namespace moe {
 
         void initSyncPrimitives();
 
+        void initUploadManager();
+
         void initDescriptors();
 
         void initCaches();
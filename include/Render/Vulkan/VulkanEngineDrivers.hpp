@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Core/Task/Future.hpp"
+#include "Core/Task/Scheduler.hpp"
+
 #include "Render/Common.hpp"
 #include "Render/Vulkan/VulkanLight.hpp"
+#include "Render/Vulkan/VulkanLoaders.hpp"
 #include "Render/Vulkan/VulkanRenderable.hpp"
 #include "Render/Vulkan/VulkanSprite.hpp"
 #include "Render/Vulkan/VulkanSwapBuffer.hpp"
@@ -13,22 +17,47 @@ namespace moe {
 
     struct VulkanLoader {
     public:
+        using RenderableFuture = Future<RenderableId, ThreadPoolScheduler>;
+
         RenderableId load(StringView path, Loader::GltfT);
 
+        RenderableId load(StringView path, const VkLoaders::GLTF::SceneLoadOptions& options, Loader::GltfT);
+
+        // returns right away. the id is a placeholder that draws nothing until the scene is registered,
+        // the future then resolves to the same id, or to NULL_RENDERABLE_ID if the scene failed to load
+        Pair<RenderableId, RenderableFuture> load(StringView path, Loader::GltfAsyncT);
+
+        Pair<RenderableId, RenderableFuture> load(
+                StringView path, const VkLoaders::GLTF::SceneLoadOptions& options, Loader::GltfAsyncT);
+
         ImageId load(StringView path, Loader::ImageT);
 
         FontId load(StringView path, float fontSize, StringView glyphRange, Loader::FontT);
 
+        bool isPending(RenderableId id) const;
+
         void init(VulkanEngine& engine) {
             m_engine = &engine;
         }
 
-        void destroy() {
-            m_engine = nullptr;
-        }
+        // main thread, once per frame; registers the async loads that have finished
+        void update();
+
+        // finishes every pending load, so that their resources are released with the caches
+        void destroy();
 
     private:
+        struct PendingLoad {
+            RenderableId id;
+            SharedPtr<VkLoaders::GLTF::AsyncSceneLoad> load;
+            SharedPtr<Promise<RenderableId, ThreadPoolScheduler>> promise;
+        };
+
         VulkanEngine* m_engine{nullptr};
+
+        Vector<PendingLoad> m_pendingLoads;
+
+        void finishLoad(PendingLoad& pending, VkLoaders::GLTF::SceneLoadResult&& result);
     };
 
     struct VulkanIlluminationBus {
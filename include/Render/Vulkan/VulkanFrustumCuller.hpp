@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Math/Frustum.hpp"
+#include "Render/Vulkan/VulkanRenderable.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    struct VulkanMeshCache;
+    struct VulkanCamera;
+}// namespace moe
+
+namespace moe {
+    // drops render packets whose transformed mesh bounds are outside of the camera frustum.
+    // packets are tested in chunks on the thread pool with the batched FrustumKernels.
+    // skinned packets are always kept, their bind pose bounds do not cover the animated mesh
+    struct VulkanFrustumCuller {
+    public:
+        static constexpr size_t CHUNK_SIZE = 1024;
+
+        struct Stats {
+            // per frame
+            size_t packets{0};
+            size_t culledPackets{0};
+            // skinned or without known bounds
+            size_t unboundedPackets{0};
+        };
+
+        VulkanFrustumCuller() = default;
+        ~VulkanFrustumCuller() = default;
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        // main thread, once per frame before cull()
+        void update(const VulkanCamera& camera, VkExtent2D viewportExtent);
+
+        // moves visible packets to the front keeping their relative order, culled ones follow.
+        // returns the number of visible packets
+        size_t cull(const VulkanMeshCache& meshCache, Vector<VulkanRenderPacket>& packets);
+
+        const Frustum& getFrustum() const { return m_frustum; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        bool m_enabled{true};
+        Frustum m_frustum;
+
+        // per packet scratch, reused across frames
+        Vector<FrustumKernels::Box> m_boxes;
+        Vector<uint8_t> m_visible;
+        Vector<VulkanRenderPacket> m_culled;
+
+        Stats m_stats;
+    };
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Math/Frustum.hpp"
+#include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanMesh.hpp"
+#include "Render/Vulkan/VulkanRenderable.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    class VulkanEngine;
+    class VulkanMeshCache;
+}// namespace moe
+
+namespace moe {
+    // ! note: keep in sync with GPUMesh in shaders/slang/moe/gpu_scene.slang
+    struct VulkanGPUMeshRecord {
+        VkDeviceAddress vertexBufferAddr;
+        VkDeviceAddress skinnedVertexBufferAddr;
+        glm::vec3 boundsCenter;
+        VulkanVertexFormat vertexFormat;
+        glm::vec3 boundsExtent;
+        uint32_t lodCount;
+        // first index into the mesh's geometry arena index block, index count
+        Array<glm::uvec2, MAX_MESH_LODS> lods;
+        uint32_t indexBlock;
+        uint32_t reserved;
+    };
+
+    // ! note: keep in sync with GPUObject in shaders/slang/moe/gpu_scene.slang
+    struct VulkanGPUObjectData {
+        static constexpr uint32_t INVALID_MESH_INDEX = std::numeric_limits<uint32_t>::max();
+
+        static constexpr uint32_t FLAG_UNBOUNDED = 1u << 0;
+        static constexpr uint32_t FLAG_SKINNED = 1u << 1;
+
+        uint32_t meshIndex;
+        uint32_t materialId;
+        uint32_t lod;
+        uint32_t flags;
+    };
+
+    // ! note: keep in sync with GPUCullView in shaders/slang/moe/gpu_scene.slang
+    struct VulkanGPUCullView {
+        Array<glm::vec4, Frustum::PlaneCount> planes;
+        float minRadius;
+        uint32_t reserved[3];
+    };
+
+    // scene state for the gpu driven path, where a compute pass culls every object per view and writes
+    // the surviving draws as VkDrawIndexedIndirectCommands plus a count, drawn with one vkCmdDrawIndexedIndirectCount
+    // per geometry arena index block (usually a single one).
+    // - meshes get a record the first time they are drawn, pointing at their ranges of the geometry arena;
+    //   the records are rebuilt when the mesh cache version changes (disposals, compaction)
+    // - object i describes packet i (mesh record, material, lod), its transform is instance i of the VulkanInstanceBuffer
+    // recording cost no longer depends on the object count, only the object records are still written per frame
+    struct VulkanGPUScene {
+    public:
+        static constexpr size_t INITIAL_OBJECT_CAPACITY = 1024;
+        static constexpr size_t INITIAL_MESH_CAPACITY = 256;
+        static constexpr size_t CHUNK_SIZE = 1024;
+        // the camera and every shadow cascade
+        static constexpr uint32_t MAX_VIEWS = 8;
+        static constexpr uint32_t CAMERA_VIEW = 0;
+
+        struct Stats {
+            // per frame
+            size_t objects{0};
+            size_t dispatches{0};
+            size_t indirectDraws{0};
+
+            // persistent
+            size_t meshes{0};
+            size_t indexBlocks{0};
+        };
+
+        VulkanGPUScene() = default;
+        ~VulkanGPUScene() = default;
+
+        void init(VulkanEngine& engine);
+
+        void destroy();
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        // main thread, after the instance buffer has been updated with the same packets and before any cull().
+        // registers new meshes and clears the draw counts
+        void update(
+                VkCommandBuffer cmdBuffer,
+                const VulkanMeshCache& meshCache,
+                Span<const VulkanRenderPacket> packets,
+                size_t frameIndex);
+
+        // outside of rendering. frustum and minRadius are those of the view, the near plane may be opened up by the caller
+        void cull(
+                VkCommandBuffer cmdBuffer,
+                uint32_t view,
+                VkDeviceAddress instanceBufferAddr,
+                const Frustum& frustum,
+                float minRadius = 0.0f);
+
+        // inside rendering, with the pipeline bound and push constants pointing at getObjectBufferAddr() / getMeshBufferAddr()
+        void draw(VkCommandBuffer cmdBuffer, uint32_t view);
+
+        // of the frame passed to the last update()
+        VkDeviceAddress getObjectBufferAddr() const { return m_frames[m_currentFrame].objects.address; }
+
+        VkDeviceAddress getMeshBufferAddr() const { return m_meshBuffer.address; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        struct PushConstants {
+            VkDeviceAddress instanceBufferAddr;
+            VkDeviceAddress objectBufferAddr;
+            VkDeviceAddress meshBufferAddr;
+            VkDeviceAddress viewBufferAddr;
+            VkDeviceAddress commandBufferAddr;
+            VkDeviceAddress drawCountBufferAddr;
+            uint32_t viewIndex;
+            uint32_t objectCount;
+            uint32_t commandCapacity;
+            uint32_t blockCount;
+        };
+
+        struct Frame {
+            VulkanAllocatedBuffer objects{};
+            VulkanAllocatedBuffer views{};
+            // MAX_VIEWS * blockCount regions of capacity commands each, region = view * blockCount + index block
+            VulkanAllocatedBuffer commands{};
+            // MAX_VIEWS * VulkanGeometryArena::MAX_BLOCKS counts, by region
+            VulkanAllocatedBuffer drawCounts{};
+            size_t capacity{0};
+            uint32_t blockCount{0};
+        };
+
+        bool m_initialized{false};
+        bool m_enabled{false};
+        VulkanEngine* m_engine{nullptr};
+
+        VkPipelineLayout m_pipelineLayout;
+        VkPipeline m_pipeline;
+
+        Vector<Frame> m_frames;
+        size_t m_currentFrame{0};
+        size_t m_objectCount{0};
+
+        UnorderedMap<MeshId, uint32_t> m_meshIndices;
+        Vector<VulkanGPUMeshRecord> m_meshRecords;
+        VulkanAllocatedBuffer m_meshBuffer{};
+        size_t m_meshCapacity{0};
+        uint64_t m_meshVersion{0};
+
+        Stats m_stats;
+
+        uint32_t registerMesh(MeshId meshId, const VulkanGPUMesh& mesh);
+
+        // drops every record, the old buffer is released once the frames in flight are done with it
+        void resetMeshes();
+
+        void reserveFrame(Frame& frame, size_t objectCount, uint32_t blockCount);
+
+        void reserveMeshes(size_t meshCount);
+    };
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Core/RangeAllocator.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanUploadManager.hpp"
+
+#include <mutex>
+
+// fwd decl
+namespace moe {
+    class VulkanEngine;
+}// namespace moe
+
+namespace moe {
+    enum class VulkanGeometryPool : uint32_t {
+        // uint32 indices, bound as index buffers
+        Index = 0,
+        // vertices, skinning data and skinned vertices, read through buffer device addresses
+        Vertex = 1,
+        Count,
+    };
+
+    // a range of one block of a VulkanGeometryArena pool
+    struct VulkanGeometryAllocation {
+        static constexpr uint32_t INVALID_BLOCK = std::numeric_limits<uint32_t>::max();
+
+        VulkanGeometryPool pool{VulkanGeometryPool::Vertex};
+        uint32_t block{INVALID_BLOCK};
+        // in bytes
+        uint64_t offset{0};
+        uint64_t size{0};
+
+        bool isValid() const { return block != INVALID_BLOCK; }
+    };
+
+    // sub-allocates mesh data from a few large device buffers instead of one vma buffer per stream and primitive.
+    // every pool is a list of blocks with a RangeAllocator each; new ranges go to the first block they fit,
+    // ranges larger than a block get a block of their own, blocks other than the first are released once empty.
+    // - indices are addressed by firstIndex into their block, so draws only rebind when the block changes
+    // - vertex streams keep a device address (block address + offset) and are pulled by the shaders
+    // freed ranges are reused once the frames in flight are done with them. after unloads, live ranges can be
+    // compacted towards the front of their pool with move(), which records the copies into the frame command buffer
+    struct VulkanGeometryArena {
+    public:
+        static constexpr uint64_t INDEX_BLOCK_SIZE = 64ull * 1024 * 1024;
+        static constexpr uint64_t VERTEX_BLOCK_SIZE = 128ull * 1024 * 1024;
+        static constexpr uint64_t VERTEX_ALIGNMENT = 16;
+        static constexpr uint32_t MAX_BLOCKS = 8;// per pool
+        static constexpr uint64_t DEFAULT_DEFRAGMENTATION_BUDGET = 16ull * 1024 * 1024;// bytes moved per frame
+
+        struct Stats {
+            Array<size_t, static_cast<size_t>(VulkanGeometryPool::Count)> blocks{};
+            Array<uint64_t, static_cast<size_t>(VulkanGeometryPool::Count)> capacityBytes{};
+            Array<uint64_t, static_cast<size_t>(VulkanGeometryPool::Count)> usedBytes{};
+            size_t allocations{0};
+
+            // per frame
+            size_t movedAllocations{0};
+            uint64_t movedBytes{0};
+        };
+
+        VulkanGeometryArena() = default;
+        ~VulkanGeometryArena() = default;
+
+        void init(VulkanEngine& engine);
+
+        // releases every block, live allocations included
+        void destroy();
+
+        // main thread, at the start of a frame after its fence has been waited on.
+        // returns ranges freed at least FRAMES_IN_FLIGHT frames ago to their blocks
+        void update();
+
+        // thread safe, an invalid allocation for size 0
+        VulkanGeometryAllocation allocate(VulkanGeometryPool pool, uint64_t size);
+
+        // thread safe. queues the upload through the upload manager,
+        // the range is not moved before the upload landed
+        void upload(const VulkanGeometryAllocation& allocation, const void* data, size_t size);
+
+        // main thread, the range is reused once the frames in flight are done with it
+        void free(const VulkanGeometryAllocation& allocation);
+
+        // thread safe
+        VkBuffer getBuffer(const VulkanGeometryAllocation& allocation) const;
+
+        // thread safe, vertex pool only
+        VkDeviceAddress getAddress(const VulkanGeometryAllocation& allocation) const;
+
+        // of an index pool allocation into its block
+        static uint32_t getFirstIndex(const VulkanGeometryAllocation& allocation) {
+            return static_cast<uint32_t>(allocation.offset / sizeof(uint32_t));
+        }
+
+        // thread safe, null for a released or unused block
+        VkBuffer getBlockBuffer(VulkanGeometryPool pool, uint32_t block) const;
+
+        // thread safe, one past the last block in use
+        uint32_t getBlockCount(VulkanGeometryPool pool) const;
+
+        // whether frees left enough holes in a pool that compaction is worth it
+        bool isDefragmentationNeeded() const;
+
+        // main thread, before the first move() of a frame; resets the per frame budget
+        void beginDefragmentation(VkCommandBuffer cmdBuffer, uint64_t budget = DEFAULT_DEFRAGMENTATION_BUDGET);
+
+        // main thread. moves the range to the lowest free spot before it, in its own or an earlier block,
+        // and records the copy; the old range is freed like free() does.
+        // false when the range stays, because there is no better spot, its upload is pending or the budget is spent
+        bool move(VkCommandBuffer cmdBuffer, VulkanGeometryAllocation& allocation);
+
+        // main thread, makes the copies visible to everything recorded after it
+        void endDefragmentation(VkCommandBuffer cmdBuffer);
+
+        Stats getStats() const;
+
+    private:
+        struct Block {
+            VulkanAllocatedBuffer buffer{};
+            RangeAllocator allocator;
+        };
+
+        struct Pool {
+            Array<Block, MAX_BLOCKS> blocks{};
+            uint64_t blockSize{0};
+            uint64_t alignment{0};
+            VkBufferUsageFlags usage{0};
+        };
+
+        bool m_initialized{false};
+        VulkanEngine* m_engine{nullptr};
+
+        mutable std::mutex m_mutex;
+        Array<Pool, static_cast<size_t>(VulkanGeometryPool::Count)> m_pools;
+        size_t m_allocationCount{0};
+
+        // uploads that may still be in flight, by block buffer and offset
+        UnorderedMap<VkBuffer, UnorderedMap<uint64_t, VulkanUploadManager::UploadFuture>> m_pendingUploads;
+
+        // freed ranges with the frame number they were freed in, main thread only
+        Deque<Pair<uint64_t, VulkanGeometryAllocation>> m_pendingReleases;
+
+        // emptied blocks an upload may still write into, released by update() once those landed
+        Vector<Pair<VulkanGeometryPool, uint32_t>> m_emptyBlocks;
+
+        uint64_t m_defragmentationBudget{0};
+        size_t m_movedAllocations{0};
+        uint64_t m_movedBytes{0};
+
+        Pool& getPool(VulkanGeometryPool pool) { return m_pools[static_cast<size_t>(pool)]; }
+
+        const Pool& getPool(VulkanGeometryPool pool) const { return m_pools[static_cast<size_t>(pool)]; }
+
+        // m_mutex held
+        void createBlock(VulkanGeometryPool pool, uint32_t block, uint64_t size);
+
+        // m_mutex held, returns the range to its block and releases the block once it is empty,
+        // or queues it for update() while an upload into it is pending
+        void release(const VulkanGeometryAllocation& allocation);
+
+        // m_mutex held, false while an upload into the block is pending
+        bool releaseBlock(VulkanGeometryPool pool, uint32_t block);
+
+        // m_mutex held
+        bool isUploadPending(const VulkanGeometryAllocation& allocation);
+
+        uint64_t getFrameNumber() const;
+    };
+}// namespace moe
\ No newline at end of file
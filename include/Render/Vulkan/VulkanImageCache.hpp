@@ -2,6 +2,7 @@
 
 #include "Render/Vulkan/VulkanCacheUtils.hpp"
 #include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanTextureStreamer.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
 
 // fwd decl
@@ -32,6 +33,17 @@ namespace moe {
 
         ImageId loadImageFromMemory(Span<uint8_t> imageData, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap = false);
 
+        // rgba8 only; falls back to a regular mipmapped load when streaming is disabled
+        ImageId loadStreamedImageFromFile(StringView filename, VkFormat format, VkImageUsageFlags usage);
+
+        ImageId loadStreamedImageFromMemory(Span<uint8_t> imageData, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage);
+
+        // replaces the gpu image behind id and queues its bindless slot rewrite; returns the previous image, if any.
+        // frames in flight may still sample the previous one, destroy it through the frame's deletion queue
+        Optional<VulkanAllocatedImage> swapImage(ImageId id, VulkanAllocatedImage&& image);
+
+        VulkanTextureStreamer& getStreamer() { return m_streamer; }
+
         ImageId loadCubeMapFromFiles(Array<StringView, 6> filenames, VkFormat format, VkImageUsageFlags usage, bool mipmap = false);
 
         void disposeImage(ImageId id);
@@ -68,6 +80,8 @@ namespace moe {
         UnorderedMap<ImageId, VulkanAllocatedImage> m_images;
         VulkanCacheIdAllocator<ImageId> m_idAllocator;
 
+        VulkanTextureStreamer m_streamer;
+
         void initDefaults();
     };
 }// namespace moe
\ No newline at end of file
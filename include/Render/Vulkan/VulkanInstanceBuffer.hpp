@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanRenderable.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    class VulkanEngine;
+}// namespace moe
+
+namespace moe {
+    // ! note: keep in sync with InstanceData in shaders/slang/moe/instance.slang
+    struct VulkanGPUInstanceData {
+        glm::mat4 transform;
+        // only the upper 3x3 is read, transposed it is the normal matrix
+        glm::mat4 inverseTransform;
+    };
+
+    // per frame instance data of every render packet, read by the shaders through a buffer device address.
+    // instance i belongs to packet i, so a run of consecutive packets drawing the same thing becomes one
+    // instanced draw with firstInstance set to the index of the run's first packet.
+    // every frame in flight owns a persistently mapped buffer that grows with the packet count
+    struct VulkanInstanceBuffer {
+    public:
+        static constexpr size_t INITIAL_CAPACITY = 1024;
+        static constexpr size_t CHUNK_SIZE = 1024;
+
+        struct Stats {
+            // per frame
+            size_t instances{0};
+            size_t capacity{0};
+        };
+
+        VulkanInstanceBuffer() = default;
+        ~VulkanInstanceBuffer() = default;
+
+        void init(VulkanEngine& engine);
+
+        void destroy();
+
+        // whether b can be drawn as another instance of a's draw; materials are ignored by depth only passes
+        static bool canInstance(const VulkanRenderPacket& a, const VulkanRenderPacket& b, bool compareMaterial = true) {
+            return !a.skinned && !b.skinned &&
+                   a.meshId == b.meshId &&
+                   a.lod == b.lod &&
+                   (!compareMaterial || a.materialId == b.materialId);
+        }
+
+        // main thread, after the packets reached their final order for the frame.
+        // the frame's previous buffer is only replaced here, its fence has been waited on by then
+        void update(Span<const VulkanRenderPacket> packets, size_t frameIndex);
+
+        // of the frame passed to the last update()
+        VkDeviceAddress getAddress() const { return m_frames[m_currentFrame].buffer.address; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        struct Frame {
+            VulkanAllocatedBuffer buffer{};
+            size_t capacity{0};
+        };
+
+        bool m_initialized{false};
+        VulkanEngine* m_engine{nullptr};
+
+        Vector<Frame> m_frames;
+        size_t m_currentFrame{0};
+
+        Stats m_stats;
+
+        void reserve(Frame& frame, size_t instanceCount);
+    };
+}// namespace moe
\ No newline at end of file
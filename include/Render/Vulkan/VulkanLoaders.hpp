@@ -1,13 +1,21 @@
 #pragma once
 
+#include "Render/Vulkan/VulkanCookedScene.hpp"
 #include "Render/Vulkan/VulkanMesh.hpp"
+#include "Render/Vulkan/VulkanScene.hpp"
+#include "Render/Vulkan/VulkanStaticBatcher.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
 
 #include <stb_image.h>
 
+#include <mutex>
+
+namespace tinygltf {
+    class Model;
+}// namespace tinygltf
+
 namespace moe {
     class VulkanEngine;
-    struct VulkanScene;
 
     namespace VkLoaders {
         struct StbiImageDeleter {
@@ -21,7 +29,119 @@ namespace moe {
         UniqueRawImage loadImage(StringView filename, int* width, int* height, int* channels, int desiredChannels = 0);
 
         namespace GLTF {
-            Optional<VulkanScene> loadSceneFromFile(VulkanEngine& engine, StringView filename);
-        }
+            // a parsed glTF document, shared by every consumer of the same file (the scene cooker, GltfColliderFactory).
+            // primitives are decoded on first use, in file order with the primitives of each mesh back to back.
+            // the asset, including its decoded meshes, lives as long as some consumer still holds it
+            struct Asset {
+            public:
+                explicit Asset(StringView filename);
+                ~Asset();
+
+                Asset(const Asset&) = delete;
+                Asset& operator=(const Asset&) = delete;
+
+                const String& getFilename() const { return m_filename; }
+
+                const tinygltf::Model& getModel() const { return *m_model; }
+
+                // false when the file could not be read or parsed, the model is empty then
+                bool isLoaded() const { return m_loaded; }
+
+                // a .glb embeds its images, a .gltf references them
+                bool isBinary() const { return m_binary; }
+
+                // still encoded, empty for images of a .gltf
+                Span<const uint8_t> getEncodedImage(size_t imageIdx) const;
+
+                size_t getPrimitiveCount() const { return m_primitives.size(); }
+
+                size_t getFirstPrimitive(size_t meshIdx) const { return m_firstPrimitives[meshIdx]; }
+
+                // thread safe, the raw decode without any attribute repair or optimization
+                const VulkanCPUMesh& getPrimitive(size_t primitiveIdx) const;
+
+            private:
+                String m_filename;
+                bool m_loaded{false};
+                bool m_binary{false};
+                UniquePtr<tinygltf::Model> m_model;
+                Vector<Vector<uint8_t>> m_encodedImages;
+
+                Vector<size_t> m_firstPrimitives;
+                mutable UniquePtr<std::once_flag[]> m_decodeOnce;
+                mutable Vector<VulkanCPUMesh> m_primitives;
+            };
+
+            // parses the file unless a live asset for it exists; thread safe, concurrent calls for one file parse once.
+            // nullptr when the file cannot be read or parsed
+            SharedPtr<const Asset> acquireAsset(StringView filename);
+
+            // content hash of the file (and of the buffer files a .gltf references), seeded with the parameters of
+            // whatever is cooked from it (its version, build settings); the key of Cached<> generators reading glTF
+            uint64_t hashSourceFiles(StringView filename, Span<const uint8_t> parameters);
+
+            // generator for Cached<>, turns a .gltf / .glb file into a VulkanCookedScene.
+            // the key is a content hash of the file (and of the buffer files a .gltf references) and the cooker version,
+            // so warm starts read the cooked file and never touch tinygltf.
+            // ! note: external images of a .gltf are not part of the key, they are streamed from their files anyway
+            // (only their cooked opacity flag can go stale, editing a texture's alpha needs a touch of the .gltf)
+            struct SceneCooker {
+            public:
+                using value_type = VulkanCookedScene;
+
+                explicit SceneCooker(StringView filename);
+
+                Optional<VulkanCookedScene> generate();
+
+                uint64_t hashCode() const { return m_hash; }
+
+                String paramString() const;
+
+            private:
+                String m_filename;
+                uint64_t m_hash{0};
+            };
+
+            struct SceneLoadOptions {
+                // opt-in, only for scenes whose nodes never move; see StaticBatching
+                bool mergeStaticGeometry{false};
+                StaticBatching::Options staticBatching{};
+            };
+
+            Optional<VulkanScene> loadSceneFromFile(VulkanEngine& engine, StringView filename, const SceneLoadOptions& options = {});
+
+            // reading (or cooking) the scene and mesh uploads run on the thread pool;
+            // materials, images and the scene itself are registered on the main thread by pollSceneLoad
+            struct AsyncSceneLoad;
+
+            SharedPtr<AsyncSceneLoad> loadSceneFromFileAsync(VulkanEngine& engine, StringView filename, const SceneLoadOptions& options = {});
+
+            struct SceneLoadResult {
+                enum class Status {
+                    Pending,
+                    Loaded,
+                    Failed,
+                };
+
+                Status status{Status::Pending};
+                // set once loaded
+                Optional<VulkanScene> scene;
+                // set on failure
+                String error;
+
+                static SceneLoadResult loaded(VulkanScene&& scene) {
+                    return {Status::Loaded, std::move(scene), {}};
+                }
+
+                static SceneLoadResult failed(String error) {
+                    return {Status::Failed, std::nullopt, std::move(error)};
+                }
+            };
+
+            // main thread only. the scene is returned once every upload it references has completed, a file that
+            // cannot be read, parsed or cooked fails right after the load task; with block set it waits for the
+            // remaining stages instead. a load is finished after it returned Loaded or Failed
+            SceneLoadResult pollSceneLoad(VulkanEngine& engine, const SharedPtr<AsyncSceneLoad>& load, bool block = false);
+        }// namespace GLTF
     }// namespace VkLoaders
 }// namespace moe
\ No newline at end of file
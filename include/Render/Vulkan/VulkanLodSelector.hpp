@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    struct VulkanMeshCache;
+    struct VulkanCamera;
+}// namespace moe
+
+namespace moe {
+    struct VulkanLodStats {
+        size_t packets{0};
+        size_t reducedPackets{0};
+        size_t fullDetailTriangles{0};
+        size_t selectedTriangles{0};
+
+        VulkanLodStats& operator+=(const VulkanLodStats& other) {
+            packets += other.packets;
+            reducedPackets += other.reducedPackets;
+            fullDetailTriangles += other.fullDetailTriangles;
+            selectedTriangles += other.selectedTriangles;
+            return *this;
+        }
+    };
+
+    // picks a mesh lod per render packet from the screen space size of the lod's simplification error.
+    // packets are gathered with the selector in their draw context, every pass (including shadows) then draws that lod
+    struct VulkanLodSelector {
+    public:
+        // a lod is acceptable while its error covers at most this many pixels
+        static constexpr float DEFAULT_ERROR_THRESHOLD_PIXELS = 1.0f;
+        // switching to a coarser lod needs the error to drop below this fraction of the threshold,
+        // so objects sitting right at a boundary do not flip between two lods every frame
+        static constexpr float HYSTERESIS = 0.75f;
+        // currentLod of a caller that keeps no lod across frames, selects without hysteresis
+        static constexpr uint32_t NO_CURRENT_LOD = std::numeric_limits<uint32_t>::max();
+
+        // per frame
+        using Stats = VulkanLodStats;
+
+        VulkanLodSelector() = default;
+        ~VulkanLodSelector() = default;
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        float getErrorThreshold() const { return m_errorThresholdPixels; }
+
+        void setErrorThreshold(float pixels) { m_errorThresholdPixels = pixels; }
+
+        // main thread, once per frame before render packets are gathered
+        void update(const VulkanMeshCache& meshCache, const VulkanCamera& camera, VkExtent2D viewportExtent);
+
+        // thread safe. currentLod is the lod the caller drew last frame, NO_CURRENT_LOD when it keeps no history,
+        // stats are counted into the caller's accumulator and handed back with addStats()
+        uint32_t select(MeshId meshId, const glm::mat4& transform, uint32_t currentLod, Stats& stats) const;
+
+        // main thread
+        void addStats(const Stats& stats) { m_stats += stats; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        const VulkanMeshCache* m_meshCache{nullptr};
+
+        bool m_enabled{true};
+        float m_errorThresholdPixels{DEFAULT_ERROR_THRESHOLD_PIXELS};
+
+        glm::vec3 m_cameraPos{0.0f};
+        float m_nearZ{0.1f};
+        float m_pixelsPerUnit{1.0f};
+
+        Stats m_stats;
+    };
+}// namespace moe
\ No newline at end of file
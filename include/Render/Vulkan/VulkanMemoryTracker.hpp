@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+#include <mutex>
+
+namespace moe {
+    class VulkanEngine;
+
+    enum class VulkanMemoryCategory : uint8_t {
+        Other,
+        Mesh,
+        Texture,
+        StreamedTexture,
+        Font,
+        RenderTarget,
+        Dynamic,
+        Staging,
+        Count,
+    };
+
+    // accounting for every allocation made through VulkanEngine::allocateBuffer/allocateImage.
+    // allocations are tagged with the category of the innermost ScopedCategory on the calling thread;
+    // transfer-src only buffers are always counted as staging.
+    struct VulkanMemoryTracker {
+    public:
+        static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(VulkanMemoryCategory::Count);
+
+        struct CategoryStats {
+            size_t liveBytes{0};
+            size_t peakBytes{0};
+            size_t allocationCount{0};
+        };
+
+        struct HeapBudget {
+            bool deviceLocal{false};
+            size_t usage{0};
+            size_t budget{0};
+        };
+
+        // categories that can give memory back register a handler;
+        // it is called every update with the amount of memory the category may hold to keep the total within budget
+        using BudgetHandler = Function<void(size_t categoryBudget)>;
+
+        struct ScopedCategory {
+            explicit ScopedCategory(VulkanMemoryCategory category);
+            ~ScopedCategory();
+
+            ScopedCategory(const ScopedCategory&) = delete;
+            ScopedCategory& operator=(const ScopedCategory&) = delete;
+
+        private:
+            VulkanMemoryCategory m_previous;
+        };
+
+        VulkanMemoryTracker() = default;
+        ~VulkanMemoryTracker() = default;
+
+        void init(VulkanEngine& engine);
+
+        void destroy();
+
+        static VulkanMemoryCategory currentCategory();
+
+        static StringView categoryName(VulkanMemoryCategory category);
+
+        void trackAllocation(VmaAllocation allocation, VulkanMemoryCategory category);
+
+        void untrackAllocation(VmaAllocation allocation);
+
+        // 0 follows the vma heap budget of all device local heaps
+        void setBudget(size_t bytes) { m_budget = bytes; }
+
+        size_t getBudget() const;
+
+        void setBudgetHandler(VulkanMemoryCategory category, BudgetHandler&& handler);
+
+        CategoryStats getCategoryStats(VulkanMemoryCategory category) const;
+
+        // everything except staging, which is transient
+        size_t getResidentBytes() const;
+
+        Vector<HeapBudget> queryHeapBudgets() const;
+
+        // once per frame, before anything that reacts to budget changes records its work
+        void update();
+
+        void drawOverlay(bool* open = nullptr);
+
+    private:
+        struct Allocation {
+            VulkanMemoryCategory category;
+            size_t size;
+        };
+
+        bool m_initialized{false};
+        VulkanEngine* m_engine{nullptr};
+
+        size_t m_budget{0};
+        bool m_overBudgetReported{false};
+
+        mutable std::mutex m_mutex;
+        UnorderedMap<VmaAllocation, Allocation> m_allocations;
+        Array<CategoryStats, CATEGORY_COUNT> m_categories{};
+
+        Array<BudgetHandler, CATEGORY_COUNT> m_budgetHandlers{};
+    };
+}// namespace moe
\ No newline at end of file
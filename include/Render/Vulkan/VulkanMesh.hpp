@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Render/Vulkan/VulkanGeometryArena.hpp"
 #include "Render/Vulkan/VulkanSkeleton.hpp"
 #include "Render/Vulkan/VulkanTypes.hpp"
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
+
+#include <algorithm>
 
 
 namespace moe {
@@ -10,26 +14,105 @@ namespace moe {
         uint32_t indexCount;
     };
 
+    static constexpr uint32_t MAX_MESH_LODS = 8;
+
+    // a range of the mesh index buffer; every lod indexes the same vertices
+    struct VulkanMeshLod {
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        // object space deviation from the full detail surface
+        float error{0.0f};
+    };
+
+    static constexpr uint32_t MAX_MESHLET_VERTICES = 64;
+    // multiple of 4, so the local triangle list of a full meshlet fills whole words
+    static constexpr uint32_t MAX_MESHLET_TRIANGLES = 124;
+
+    // a cluster of at most MAX_MESHLET_VERTICES vertices and MAX_MESHLET_TRIANGLES triangles of lod 0.
+    // offsets are relative to the owning mesh's meshletVertices / meshletTriangles
+    struct VulkanMeshlet {
+        uint32_t vertexOffset{0};
+        uint32_t vertexCount{0};
+        uint32_t triangleOffset{0};// in bytes, 3 local vertex indices per triangle
+        uint32_t triangleCount{0};
+
+        glm::vec3 center{0.0f};
+        float radius{0.0f};
+
+        glm::vec3 aabbMin{0.0f};
+        // cosine of the normal cone's culling angle, the cluster faces away from a viewpoint v when
+        // dot(normalize(coneApex - v), coneAxis) > coneCutoff; 1 disables the test
+        float coneCutoff{1.0f};
+        glm::vec3 aabbMax{0.0f};
+        float reserved{0.0f};
+
+        glm::vec3 coneApex{0.0f};
+        float reserved2{0.0f};
+        glm::vec3 coneAxis{0.0f, 0.0f, 1.0f};
+        float reserved3{0.0f};
+
+        bool isBackfacing(const glm::vec3& viewpoint) const {
+            return glm::dot(glm::normalize(coneApex - viewpoint), coneAxis) > coneCutoff;
+        }
+    };
+
+    // ranges of the engine's VulkanGeometryArena, the handles and addresses below are derived from them
+    // and refreshed when the arena moves the ranges
     struct VulkanGPUMeshBuffer {
-        VulkanAllocatedBuffer vertexBuffer;
-        VulkanAllocatedBuffer indexBuffer;
-        VulkanAllocatedBuffer skinningDataBuffer;
-        VulkanAllocatedBuffer skinnedVertexBuffer;
+        VulkanGeometryAllocation vertexAllocation;
+        VulkanGeometryAllocation indexAllocation;
+        VulkanGeometryAllocation skinningDataAllocation;
+        VulkanGeometryAllocation skinnedVertexAllocation;
+
+        // the arena block holding the indices, bound at offset 0; lod ranges are relative to firstIndex
+        VkBuffer indexBuffer{VK_NULL_HANDLE};
+        uint32_t firstIndex{0};
 
         VkDeviceAddress vertexBufferAddr;
         VkDeviceAddress skinningDataBufferAddr;
         VkDeviceAddress skinnedVertexBufferAddr;
 
-        uint32_t indexCount;
+        uint32_t indexCount;// of lod 0
         uint32_t vertexCount;
 
+        // of the vertex and skinning data streams, the skinned vertex stream is always full
+        VulkanVertexFormat vertexFormat{VulkanVertexFormat::Full};
+
+        Array<VulkanMeshLod, MAX_MESH_LODS> lods{};
+        uint32_t lodCount{1};
+
         bool hasSkinningData;
+
+        VkDeviceAddress getVertexBufferAddr(bool skinned) const {
+            return skinned ? skinnedVertexBufferAddr : vertexBufferAddr;
+        }
+
+        VulkanVertexFormat getVertexFormat(bool skinned) const {
+            return skinned ? VulkanVertexFormat::Full : vertexFormat;
+        }
+
+        const VulkanMeshLod& getLod(uint32_t lod) const {
+            return lods[std::min(lod, lodCount - 1)];
+        }
+
+        // into indexBuffer
+        uint32_t getFirstIndex(uint32_t lod) const {
+            return firstIndex + getLod(lod).firstIndex;
+        }
     };
 
     struct VulkanCPUMesh {
         Vector<Vertex> vertices;
         Vector<uint32_t> indices;
         Vector<SkinningData> skinningData;
+        // empty means a single lod covering all indices, otherwise indices holds every lod back to back
+        Vector<VulkanMeshLod> lods;
+
+        // clusters of lod 0, see MeshOptimizer::buildMeshlets
+        Vector<VulkanMeshlet> meshlets;
+        Vector<uint32_t> meshletVertices; // -> vertices
+        Vector<uint8_t> meshletTriangles; // -> meshletVertices, relative to the meshlet's vertexOffset
+
         bool hasSkeleton{false};
 
         glm::vec3 min;
@@ -42,6 +125,9 @@ namespace moe {
             vertices.shrink_to_fit();
             indices.clear();
             indices.shrink_to_fit();
+            meshlets = {};
+            meshletVertices = {};
+            meshletTriangles = {};
             discarded = true;
         }
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanMesh.hpp"
+
+namespace moe {
+    // import-time generation and repair of vertex attributes the source file left out or got wrong
+    namespace MeshAttributes {
+        enum class NormalMode {
+            // one normal per triangle, the vertices are split; what glTF asks for when normals are missing
+            Flat,
+            // angle weighted average over every triangle sharing a position, seams stay closed
+            Smooth,
+        };
+
+        struct RepairOptions {
+            bool generateNormals{false};
+            NormalMode normalMode{NormalMode::Flat};
+            bool generateTangents{false};
+        };
+
+        struct RepairReport {
+            bool generatedIndices{false};
+            bool generatedNormals{false};
+            bool generatedTangents{false};
+            // normals or tangents that were zero, not finite or not unit length
+            size_t repairedVectors{0};
+            // vertices duplicated for flat normals or mirrored uvs
+            size_t splitVertices{0};
+
+            RepairReport& operator+=(const RepairReport& other) {
+                generatedIndices |= other.generatedIndices;
+                generatedNormals |= other.generatedNormals;
+                generatedTangents |= other.generatedTangents;
+                repairedVectors += other.repairedVectors;
+                splitVertices += other.splitVertices;
+                return *this;
+            }
+        };
+
+        // non-indexed triangle lists get a sequential index buffer
+        bool generateIndices(VulkanCPUMesh& mesh);
+
+        void generateNormals(VulkanCPUMesh& mesh, NormalMode mode);
+
+        // mikktspace conventions: per-triangle tangents from the uv gradient, projected onto the vertex normal plane
+        // and accumulated with corner angle weights; w is the bitangent sign. a vertex shared by triangles of
+        // opposite uv winding (mirrored uvs) is split so each side keeps its own handedness
+        void generateTangents(VulkanCPUMesh& mesh);
+
+        // normalizes normals and (optionally) tangents, replaces unusable ones and forces tangent.w to +-1.
+        // returns the number of vectors that had to be touched
+        size_t normalizeAttributes(VulkanCPUMesh& mesh, bool tangents = true);
+
+        RepairReport repairMesh(VulkanCPUMesh& mesh, const RepairOptions& options);
+    }// namespace MeshAttributes
+}// namespace moe
\ No newline at end of file
@@ -20,10 +20,29 @@ namespace moe {
 
         void init(VulkanEngine& engine);
 
-        MeshId loadMesh(VulkanCPUMesh cpuMesh);
+        // occluder registers the mesh with the occlusion culler, only for meshes drawn with opaque materials
+        // (a cutout texture would hide what shows through it)
+        MeshId loadMesh(VulkanCPUMesh cpuMesh, bool occluder = false);
+
+        // for meshes uploaded elsewhere (e.g. by an async loader), the cache takes ownership of the buffers
+        MeshId addMesh(VulkanGPUMesh&& mesh);
 
         Optional<VulkanGPUMesh> getMesh(MeshId id) const;
 
+        // no copy, for per-packet lookups; null if the mesh is unknown.
+        // the pointer is invalidated by the next loadMesh / addMesh / disposeMesh
+        const VulkanGPUMesh* findMesh(MeshId id) const;
+
+        // main thread, the geometry is reused once the frames in flight are done with it
+        void disposeMesh(MeshId id);
+
+        // main thread, at the start of the frame command buffer.
+        // after disposals, compacts the geometry arena within its per frame budget and refreshes the moved meshes
+        void update(VkCommandBuffer cmdBuffer);
+
+        // bumped whenever a mesh is disposed or its geometry moved, for users that keep derived copies
+        uint64_t getVersion() const { return m_version; }
+
         void destroy();
 
         struct {
@@ -36,5 +55,8 @@ namespace moe {
 
         UnorderedMap<MeshId, VulkanGPUMesh> m_meshes;
         VulkanCacheIdAllocator<MeshId> m_idAllocator;
+
+        uint64_t m_version{0};
+        bool m_defragmentationPending{false};
     };
 }// namespace moe
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanMesh.hpp"
+
+namespace moe {
+    // import-time reordering of triangle list meshes for the post-transform cache, overdraw and vertex fetch.
+    // every pass keeps the set of triangles (and their winding) intact, only the order of indices and vertices changes
+    namespace MeshOptimizer {
+        static constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+        // overdraw ordering may cost at most this much acmr relative to the cache optimized order
+        static constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+        // fifo post-transform cache simulation
+        struct CacheStats {
+            size_t triangleCount{0};
+            size_t vertexCount{0};
+            size_t cacheMisses{0};
+
+            // average cache miss ratio, transformed vertices per triangle; 0.5 is the lower bound
+            float acmr() const {
+                return triangleCount > 0 ? static_cast<float>(cacheMisses) / static_cast<float>(triangleCount) : 0.0f;
+            }
+
+            // average transform to vertex ratio; 1.0 is optimal
+            float atvr() const {
+                return vertexCount > 0 ? static_cast<float>(cacheMisses) / static_cast<float>(vertexCount) : 0.0f;
+            }
+
+            CacheStats& operator+=(const CacheStats& other) {
+                triangleCount += other.triangleCount;
+                vertexCount += other.vertexCount;
+                cacheMisses += other.cacheMisses;
+                return *this;
+            }
+        };
+
+        struct Report {
+            CacheStats before;
+            CacheStats after;
+            size_t weldedVertices{0};
+
+            Report& operator+=(const Report& other) {
+                before += other.before;
+                after += other.after;
+                weldedVertices += other.weldedVertices;
+                return *this;
+            }
+        };
+
+        CacheStats analyzeVertexCache(Span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+        // merges bitwise identical vertices (skinning data included), returns the number of removed vertices
+        size_t weldVertices(VulkanCPUMesh& mesh);
+
+        // tipsify (Sander et al. 2007), linear time
+        void optimizeVertexCache(Span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+        // splits the cache optimized order into clusters at cache flushes and draws outward facing clusters first;
+        // the new order is only kept if its acmr stays within threshold of the input order
+        void optimizeOverdraw(
+                Span<uint32_t> indices, Span<const Vertex> vertices,
+                uint32_t cacheSize = DEFAULT_CACHE_SIZE,
+                float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+        // renumbers vertices in order of first use and drops unreferenced ones
+        void optimizeVertexFetch(VulkanCPUMesh& mesh);
+
+        // weld, vertex cache, overdraw, vertex fetch; meshes that are not triangle lists are left untouched
+        Report optimizeMesh(VulkanCPUMesh& mesh);
+
+        // each lod keeps at most this fraction of the previous one's triangles
+        static constexpr float LOD_REDUCTION_RATIO = 0.5f;
+        // lods stop once a level would have fewer triangles than this
+        static constexpr size_t MIN_LOD_TRIANGLES = 32;
+        // largest error a single simplification step may introduce, relative to the mesh bounds diagonal
+        static constexpr float MAX_LOD_STEP_ERROR = 0.05f;
+
+        // quadric error metric edge collapse (Garland and Heckbert 1997) onto existing vertices, so attributes are
+        // never interpolated. open edges (borders and attribute seams) are locked. stops at targetIndexCount or once
+        // the next collapse would exceed targetError; outError receives the largest error introduced
+        Vector<uint32_t> simplify(
+                Span<const uint32_t> indices, Span<const Vertex> vertices,
+                size_t targetIndexCount, float targetError,
+                float* outError = nullptr);
+
+        // appends progressively simplified index lists to mesh.indices and fills mesh.lods, lod 0 being the input;
+        // returns the number of lods (1 if the mesh could not be simplified)
+        uint32_t buildLodChain(VulkanCPUMesh& mesh, uint32_t maxLods = MAX_MESH_LODS);
+
+        // greedy clustering: a meshlet grows by the adjacent triangle adding the fewest new vertices, continuing with the
+        // next unassigned triangle in index order once its neighbourhood runs out; the output only depends on the input.
+        // appends to the output vectors, meshlet offsets are relative to them
+        void buildMeshlets(
+                Span<const uint32_t> indices, Span<const Vertex> vertices,
+                Vector<VulkanMeshlet>& outMeshlets,
+                Vector<uint32_t>& outMeshletVertices,
+                Vector<uint8_t>& outMeshletTriangles,
+                uint32_t maxVertices = MAX_MESHLET_VERTICES,
+                uint32_t maxTriangles = MAX_MESHLET_TRIANGLES);
+
+        // bounding sphere, aabb and normal cone of a finished meshlet
+        void computeMeshletBounds(
+                VulkanMeshlet& meshlet,
+                Span<const uint32_t> meshletVertices, Span<const uint8_t> meshletTriangles,
+                Span<const Vertex> vertices);
+
+        // clusters lod 0 of a triangle list mesh into mesh.meshlets, returns the meshlet count
+        size_t buildMeshlets(VulkanCPUMesh& mesh);
+    }// namespace MeshOptimizer
+}// namespace moe
\ No newline at end of file
@@ -13,8 +13,10 @@ namespace moe {
         struct GltfT {};
         static constexpr GltfT Gltf{};
 
-        SharedResource<VulkanRenderable> operator()(VulkanEngine* engine, StringView filename, GltfT) {
-            return std::make_shared<VulkanScene>(VkLoaders::GLTF::loadSceneFromFile(*engine, filename).value());
+        SharedResource<VulkanRenderable> operator()(
+                VulkanEngine* engine, StringView filename, GltfT,
+                const VkLoaders::GLTF::SceneLoadOptions& options = {}) {
+            return std::make_shared<VulkanScene>(VkLoaders::GLTF::loadSceneFromFile(*engine, filename, options).value());
         };
     };
 
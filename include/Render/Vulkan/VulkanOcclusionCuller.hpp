@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Math/OcclusionBuffer.hpp"
+#include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanMesh.hpp"
+#include "Render/Vulkan/VulkanRenderable.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    struct VulkanMeshCache;
+    struct VulkanCamera;
+}// namespace moe
+
+namespace moe {
+    // drops render packets hidden behind occluders, after frustum culling and before the camera passes.
+    // meshes registered as occluders are rasterized from a cpu side proxy into a small OcclusionBuffer
+    // on the thread pool (the nearest ones first, up to a triangle budget), then the transformed mesh bounds
+    // of the frustum visible packets are tested against it in chunks.
+    // skinned packets are always kept, their bind pose bounds do not cover the animated mesh
+    struct VulkanOcclusionCuller {
+    public:
+        static constexpr uint32_t DEFAULT_BUFFER_WIDTH = 320;
+        static constexpr size_t MAX_OCCLUDER_TRIANGLES = 64 * 1024;
+        static constexpr size_t CHUNK_SIZE = 1024;
+        // raster bands per thread, bands with many triangles take longer than the others
+        static constexpr size_t BANDS_PER_THREAD = 2;
+        // setMeshOccluder() skips meshes whose proxy lod is larger than this
+        static constexpr size_t MAX_PROXY_TRIANGLES = 2048;
+        // of the mesh bounds diagonal. simplification moves the surface both ways, a coarser lod hides
+        // objects near silhouettes the mesh does not have
+        static constexpr float MAX_PROXY_ERROR = 0.01f;
+
+        struct Stats {
+            // per frame
+            size_t occluders{0};
+            size_t occluderTriangles{0};
+            // after clipping and setup
+            size_t rasterizedTriangles{0};
+            size_t testedPackets{0};
+            size_t occludedPackets{0};
+        };
+
+        VulkanOcclusionCuller() = default;
+        ~VulkanOcclusionCuller() = default;
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        uint32_t getBufferWidth() const { return m_bufferWidth; }
+
+        // the height follows the viewport aspect
+        void setBufferWidth(uint32_t width) { m_bufferWidth = width; }
+
+        // registers a mesh as an occluder, positions and triangle indices are in the mesh's local space.
+        // the proxy (e.g. a coarse lod or a few boxes) must lie inside the surface of the mesh, or it hides
+        // objects the mesh does not
+        void setOccluder(MeshId meshId, Span<const glm::vec3> positions, Span<const uint32_t> indices);
+
+        // registers the coarsest lod within MAX_PROXY_ERROR as the mesh's occluder, if it is small enough.
+        // vertices, indices and lods as uploaded, empty lods for a single one over all indices.
+        // skinned meshes are not occluders, callers leave them out
+        void setMeshOccluder(MeshId meshId, Span<const Vertex> vertices, Span<const uint32_t> indices, Span<const VulkanMeshLod> lods);
+
+        void removeOccluder(MeshId meshId) { m_occluders.erase(meshId); }
+
+        bool isOccluder(MeshId meshId) const { return m_occluders.find(meshId) != m_occluders.end(); }
+
+        // main thread, once per frame before cull()
+        void update(const VulkanCamera& camera, VkExtent2D viewportExtent);
+
+        // packets [0, visibleCount) are the ones the frustum kept. moves the occluded ones behind the
+        // remaining visible ones keeping their relative order, and returns the new visible count
+        size_t cull(const VulkanMeshCache& meshCache, Vector<VulkanRenderPacket>& packets, size_t visibleCount);
+
+        // the depth of the last cull(), for debugging
+        const OcclusionBuffer& getBuffer() const { return m_buffer; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        struct Occluder {
+            Vector<glm::vec3> positions;
+            Vector<uint32_t> indices;
+            // bounding sphere of the proxy, to rank occluders by their size on screen
+            glm::vec3 center;
+            float radius;
+        };
+
+        struct Candidate {
+            size_t packet;
+            const Occluder* occluder;
+            float score;
+        };
+
+        bool m_enabled{true};
+        uint32_t m_bufferWidth{DEFAULT_BUFFER_WIDTH};
+        // orthographic projections are not culled
+        bool m_perspective{false};
+
+        glm::mat4 m_viewProjection{1.0f};
+        glm::vec3 m_cameraPos{0.0f};
+
+        UnorderedMap<MeshId, Occluder> m_occluders;
+        OcclusionBuffer m_buffer;
+
+        // per frame scratch, reused across frames
+        Vector<Candidate> m_candidates;
+        Vector<size_t> m_triangleOffsets;
+        Vector<size_t> m_triangleCounts;
+        Vector<OcclusionBuffer::Triangle> m_triangles;
+        Vector<uint8_t> m_visible;
+        Vector<VulkanRenderPacket> m_culled;
+
+        Stats m_stats;
+
+        // returns how many triangles are in m_triangles
+        size_t setupOccluders(const Vector<VulkanRenderPacket>& packets, size_t visibleCount);
+    };
+}// namespace moe
\ No newline at end of file
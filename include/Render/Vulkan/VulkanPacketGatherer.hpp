@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanLodSelector.hpp"
+#include "Render/Vulkan/VulkanRenderable.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+namespace moe {
+    // gathers the render packets of a frame's render commands on the thread pool.
+    // commands are split into contiguous chunks, every chunk appends into a packet buffer of its own;
+    // the buffers are then merged at their prefix-summed offsets, so the packets end up in the order
+    // a sequential loop over the commands would produce, whatever thread gathered them.
+    // ! note: chunk buffers keep their capacity across frames, the merged array only grows on a new peak
+    struct VulkanPacketGatherer {
+    public:
+        // fewer commands than this per chunk are not worth a task
+        static constexpr size_t MIN_COMMANDS_PER_CHUNK = 32;
+        // more chunks than threads, so a few heavy renderables do not leave the other threads idle
+        static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+        // what a chunk gathers into
+        struct Output {
+            Vector<VulkanRenderPacket> packets;
+            VulkanLodStats lodStats;
+        };
+
+        struct Stats {
+            // per frame
+            size_t commands{0};
+            size_t chunks{0};
+            size_t packets{0};
+            size_t maxChunkPackets{0};
+
+            // capacity planning, over the lifetime of the gatherer
+            size_t peakPackets{0};
+            size_t capacity{0};
+            // times the merged array had to grow
+            size_t reallocations{0};
+        };
+
+        VulkanPacketGatherer() = default;
+        ~VulkanPacketGatherer() = default;
+
+        bool isEnabled() const { return m_enabled; }
+
+        // disabled, every command is gathered on the calling thread
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        // main thread. runs fn(command, output) for every command in [0, commandCount) and replaces the content
+        // of packets with what was gathered, in command order. lod stats of the chunks are added to lodSelector.
+        // fn runs on the workers and the calling thread, for different commands at the same time
+        void gather(
+                size_t commandCount,
+                const Function<void(size_t, Output&)>& fn,
+                Vector<VulkanRenderPacket>& packets,
+                VulkanLodSelector* lodSelector = nullptr);
+
+        // main thread, before gather(). counts the commands submitting each renderable this frame
+        void countSubmissions(size_t commandCount, const Function<RenderableId(size_t)>& renderableOf);
+
+        // thread safe during gather(). more than one means the commands are instances sharing the renderable
+        uint32_t getSubmissionCount(RenderableId id) const {
+            const auto it = m_submissions.find(id);
+            return it == m_submissions.end() ? 0 : it->second;
+        }
+
+        // every renderable submitted this frame once, in the order of its first command. the caller updates their
+        // transforms from this before gather(), so fn only reads the hierarchies and needs no lock
+        const Vector<RenderableId>& getSubmittedRenderables() const { return m_renderables; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        bool m_enabled{true};
+
+        // per chunk, reused across frames
+        Vector<Output> m_outputs;
+        Vector<size_t> m_offsets;
+
+        // keeps its buckets across frames
+        UnorderedMap<RenderableId, uint32_t> m_submissions;
+        Vector<RenderableId> m_renderables;
+
+        Stats m_stats;
+    };
+}// namespace moe
\ No newline at end of file
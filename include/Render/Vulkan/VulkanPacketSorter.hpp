@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanRenderable.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    struct VulkanCamera;
+}// namespace moe
+
+namespace moe {
+    // orders render packets so consecutive draws share as much state as possible.
+    // the key is compared as one unsigned integer, most significant field first:
+    // | pass 4 | pipeline 4 | material 20 | mesh 20 | depth 16 |
+    // ids wider than their field are truncated, which only costs grouping, never correctness.
+    // packets are sorted by an lsd radix sort over (key, index) pairs, scratch is kept between frames
+    struct VulkanPacketSorter {
+    public:
+        static constexpr uint32_t PASS_BITS = 4;
+        static constexpr uint32_t PIPELINE_BITS = 4;
+        static constexpr uint32_t MATERIAL_BITS = 20;
+        static constexpr uint32_t MESH_BITS = 20;
+        static constexpr uint32_t DEPTH_BITS = 16;
+        static_assert(PASS_BITS + PIPELINE_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64, "sort key must fill 64 bits");
+
+        enum class Pass : uint32_t {
+            Opaque = 0,
+        };
+
+        struct Stats {
+            // per frame
+            size_t sortedPackets{0};
+            // 8 bit digits that were not shared by every key
+            size_t radixPasses{0};
+        };
+
+        VulkanPacketSorter() = default;
+        ~VulkanPacketSorter() = default;
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        // main thread, once per frame before sort()
+        void update(const VulkanCamera& camera);
+
+        // nearer packets get smaller depth values, so equal state draws front to back
+        uint64_t makeKey(const VulkanRenderPacket& packet, Pass pass) const;
+
+        // writes the sort key of every packet, then reorders them by it; equal keys keep their order
+        void sort(Span<VulkanRenderPacket> packets, Pass pass = Pass::Opaque);
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        bool m_enabled{true};
+
+        glm::vec3 m_cameraPos{0.0f};
+        float m_invFarZ{0.01f};
+
+        Vector<uint64_t> m_keys;
+        Vector<uint64_t> m_keysScratch;
+        Vector<uint32_t> m_indices;
+        Vector<uint32_t> m_indicesScratch;
+        Vector<VulkanRenderPacket> m_packetsScratch;
+
+        Stats m_stats;
+    };
+}// namespace moe
\ No newline at end of file
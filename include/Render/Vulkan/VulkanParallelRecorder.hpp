@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+// fwd decl
+namespace moe {
+    class VulkanEngine;
+}// namespace moe
+
+namespace moe {
+    // records chunks of a dynamic rendering pass into secondary command buffers on the ThreadPoolScheduler,
+    // then executes them in chunk order from the primary buffer.
+    // - every recording slot owns one command pool per frame in flight; a slot is held by one thread
+    //   while it records a chunk, so pools never need more synchronization than that
+    // - there is a slot per worker plus one for the calling thread, the pools of a frame are reset in beginFrame()
+    // ! note: secondary buffers inherit no state, every chunk binds its pipeline, descriptors and dynamic state
+    struct VulkanParallelRecorder {
+    public:
+        // fewer items than this per chunk cost more in secondary buffer overhead than they save
+        static constexpr size_t DEFAULT_MIN_ITEMS_PER_CHUNK = 256;
+
+        // the attachment formats the pass begins rendering with
+        struct RenderingFormats {
+            Span<const VkFormat> colorFormats;
+            VkFormat depthFormat{VK_FORMAT_UNDEFINED};
+        };
+
+        struct Stats {
+            // per frame
+            size_t passes{0};
+            size_t chunks{0};
+
+            // persistent
+            size_t slots{0};
+            size_t commandBuffers{0};
+        };
+
+        VulkanParallelRecorder() = default;
+        ~VulkanParallelRecorder() = default;
+
+        void init(VulkanEngine& engine);
+
+        void destroy();
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        size_t getMinItemsPerChunk() const { return m_minItemsPerChunk; }
+
+        void setMinItemsPerChunk(size_t count) { m_minItemsPerChunk = std::max<size_t>(count, 1); }
+
+        // main thread, once the frame's fence has been waited on
+        void beginFrame(size_t frameIndex);
+
+        // how many chunks a pass over itemCount items is split into; 1 means it is recorded inline
+        size_t getChunkCount(size_t itemCount) const;
+
+        // splits [0, count) into chunkCount ranges of about the same size, returned as chunkCount + 1 boundaries.
+        // a boundary b only lands where canSplit(b) holds (e.g. not inside a run of instanced packets),
+        // otherwise it moves forward, so some ranges may end up empty
+        template<typename Fn>
+        static Vector<size_t> split(size_t count, size_t chunkCount, Fn&& canSplit) {
+            Vector<size_t> boundaries(chunkCount + 1, count);
+            boundaries[0] = 0;
+            for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+                size_t boundary = std::max(boundaries[chunk - 1], count * chunk / chunkCount);
+                while (boundary < count && boundary > 0 && !canSplit(boundary)) {
+                    ++boundary;
+                }
+                boundaries[chunk] = boundary;
+            }
+            return boundaries;
+        }
+
+        // main thread, inside a vkCmdBeginRendering with VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT.
+        // fn(secondary, chunk) runs on the workers and the calling thread, it returns before record() does
+        void record(
+                VkCommandBuffer cmdBuffer,
+                const RenderingFormats& formats,
+                size_t chunkCount,
+                const Function<void(VkCommandBuffer, size_t)>& fn);
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        struct SlotFrame {
+            VkCommandPool pool{VK_NULL_HANDLE};
+            Vector<VkCommandBuffer> buffers;
+            size_t used{0};
+        };
+
+        struct Slot {
+            std::mutex mutex;
+            Array<SlotFrame, Constants::FRAMES_IN_FLIGHT> frames;
+        };
+
+        bool m_initialized{false};
+        bool m_enabled{true};
+        VulkanEngine* m_engine{nullptr};
+
+        size_t m_minItemsPerChunk{DEFAULT_MIN_ITEMS_PER_CHUNK};
+        size_t m_currentFrame{0};
+
+        Vector<UniquePtr<Slot>> m_slots;
+
+        Stats m_stats;
+
+        // blocks until a slot is free, returned locked
+        Slot& acquireSlot();
+
+        // slot held
+        VkCommandBuffer nextCommandBuffer(Slot& slot);
+    };
+}// namespace moe
\ No newline at end of file
@@ -39,6 +39,9 @@ namespace moe {
 
         void setCullMode(VkCullModeFlags mode, VkFrontFace frontFace);
 
+        // fragments outside the depth range are clamped instead of clipped, needs the depthClamp feature
+        void setDepthClamp(bool enabled);
+
         // todo: multisampling
         void disableMultisampling();
 
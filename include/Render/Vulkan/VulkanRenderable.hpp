@@ -5,32 +5,42 @@
 
 
 namespace moe {
-    struct VulkanSceneMesh;
+    struct VulkanLodSelector;
+    struct VulkanLodStats;
 
     constexpr size_t INVALID_JOINT_MATRIX_START_INDEX = std::numeric_limits<size_t>::max();
 
     struct VulkanRenderPacket {
-        static constexpr uint32_t INVALID_SORT_KEY = std::numeric_limits<uint32_t>::max();
+        static constexpr uint64_t INVALID_SORT_KEY = std::numeric_limits<uint64_t>::max();
 
         MeshId meshId;
         MaterialId materialId;
         glm::mat4 transform;
-        uint32_t sortKey{INVALID_SORT_KEY};// todo: add sorting key
+        uint64_t sortKey{INVALID_SORT_KEY};// written by VulkanPacketSorter
 
         bool skinned{false};
         size_t jointMatrixStartIndex{INVALID_JOINT_MATRIX_START_INDEX};// for skinned meshes
+
+        uint32_t lod{0};// -> VulkanGPUMeshBuffer::lods
     };
 
     struct VulkanDrawContext {
-        const VulkanDrawContext* lastContext{nullptr};
-        Vector<VulkanSceneMesh>* sceneMeshes{nullptr};
+        // of the instance being gathered, applied on top of the renderable's own hierarchy
+        glm::mat4 transform{1.0f};
 
         size_t jointMatrixStartIndex{INVALID_JOINT_MATRIX_START_INDEX};
 
-        bool isNull() const { return lastContext == nullptr && sceneMeshes == nullptr; }
+        // null draws every packet at full detail
+        const VulkanLodSelector* lodSelector{nullptr};
+        // required with a lod selector, one per gathering thread
+        VulkanLodStats* lodStats{nullptr};
+
+        // the renderable is submitted more than once this frame. its instances would overwrite each other's
+        // per node state, so lods are selected without hysteresis and nothing is written back
+        bool instanced{false};
     };
 
-    const static VulkanDrawContext NULL_DRAW_CONTEXT = {nullptr, nullptr, INVALID_JOINT_MATRIX_START_INDEX};
+    const static VulkanDrawContext NULL_DRAW_CONTEXT = {glm::mat4(1.0f), INVALID_JOINT_MATRIX_START_INDEX, nullptr, nullptr, false};
 
     enum class VulkanRenderableFeature : uint32_t {
         None = 0,
@@ -68,7 +78,8 @@ namespace moe {
     struct VulkanRenderable {
         virtual ~VulkanRenderable() = default;
 
-        virtual void updateTransform(const glm::mat4& parentTransform) = 0;
+        // recomputes the world matrices of nodes whose local transforms changed since the last call
+        virtual void updateTransforms() = 0;
         virtual void gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) = 0;
 
         virtual VulkanRenderableFeature getFeatures() const { return VulkanRenderableFeature::None; }
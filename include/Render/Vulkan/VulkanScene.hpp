@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Math/TransformHierarchy.hpp"
 #include "Render/Vulkan/VulkanIdTypes.hpp"
 #include "Render/Vulkan/VulkanRenderable.hpp"
 #include "Render/Vulkan/VulkanSkeleton.hpp"
@@ -7,27 +8,6 @@
 
 
 namespace moe {
-    struct VulkanRenderNode : public VulkanRenderable {
-        VulkanRenderNode* parent{nullptr};
-        Vector<UniquePtr<VulkanRenderNode>> children;
-
-        glm::mat4 localTransform{1.0f};
-        glm::mat4 worldTransform{1.0f};
-
-        void updateTransform(const glm::mat4& parentTransform) override;
-
-        void gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) override = 0;
-
-        VulkanRenderableFeature getFeatures() const override { return VulkanRenderableFeature::HasHierarchy; }
-    };
-
-    struct VulkanSceneNode : public VulkanRenderNode {
-        SceneResourceInternalId resourceInternalId{NULL_SCENE_RESOURCE_INTERNAL_ID};// -> VulkanScene::meshes
-        uint32_t sortKey{VulkanRenderPacket::INVALID_SORT_KEY};
-
-        void gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) override;
-    };
-
     struct VulkanSceneMesh {
         Vector<MeshId> primitives;
         Vector<MaterialId> primitiveMaterials;
@@ -40,18 +20,33 @@ namespace moe {
         virtual const Vector<VulkanSkeleton>& getSkeletons() const = 0;
     };
 
-    struct VulkanScene : public VulkanRenderNode, public VulkanSkeletalAnimation {
+    // nodes live in a flattened TransformHierarchy, their world matrices are relative to the scene.
+    // every render command of the scene is an instance, its transform is applied to the packets when gathering,
+    // so instances share the hierarchy without overwriting each other's world matrices
+    struct VulkanScene : public VulkanRenderable, public VulkanSkeletalAnimation {
         Vector<VulkanSceneMesh> meshes;
         Vector<VulkanSkeleton> skeletons;
         UnorderedMap<String, AnimationId> animations;
 
+        // per node, in hierarchy order
+        TransformHierarchy hierarchy;
+        Vector<SceneResourceInternalId> nodeMeshes;// -> meshes
+        Vector<uint32_t> nodeLodOffsets;           // -> primitiveLods
+
+        // lod each primitive of a node was drawn with last frame, for the selector's hysteresis.
+        // only kept while the scene is submitted once per frame, see VulkanDrawContext::instanced
+        Vector<uint8_t> primitiveLods;
+
+        // in pre-order, see TransformHierarchy::addNode. the mesh has to be in meshes already
+        TransformHierarchy::NodeIndex addNode(
+                TransformHierarchy::NodeIndex parent,
+                const glm::mat4& localTransform,
+                SceneResourceInternalId mesh);
+
+        void updateTransforms() override;
+
         void gatherRenderPackets(Vector<VulkanRenderPacket>& packets) {
-            VulkanDrawContext drawContext{
-                    .lastContext = nullptr,
-                    .sceneMeshes = &meshes,
-                    .jointMatrixStartIndex = INVALID_JOINT_MATRIX_START_INDEX,
-            };
-            gatherRenderPackets(packets, drawContext);
+            gatherRenderPackets(packets, NULL_DRAW_CONTEXT);
         }
 
         void gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) override;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanCookedScene.hpp"
+
+namespace moe {
+    // load-time merging of static geometry: every primitive instance of an unskinned node is pre-transformed into
+    // one combined primitive per material and spatial cell, so a level made of many small props sharing a handful of
+    // materials turns into a handful of draws per cell. cells keep the batches small enough to be culled.
+    // ! note: merged nodes lose their mesh, moving them afterwards no longer moves their geometry
+    namespace StaticBatching {
+        struct Options {
+            // edge length of the cubic cells in scene units, an instance goes to the cell holding its bounds center
+            float cellSize{32.0f};
+            // a cell/material group that grows beyond this is split into several batches
+            uint32_t maxVerticesPerBatch{1u << 18};
+            // simplify the merged batches into lod chains, costs load time
+            bool buildLods{true};
+        };
+
+        struct Report {
+            size_t mergedInstances{0};
+            size_t batches{0};
+            // primitives whose every instance got merged, their geometry is no longer uploaded
+            size_t releasedPrimitives{0};
+        };
+
+        // scene units are the scene root's space, merged batches become identity-transformed root nodes
+        VulkanCookedScene mergeStaticGeometry(const VulkanCookedScene& cooked, const Options& options, Report* outReport = nullptr);
+    }// namespace StaticBatching
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Core/Resource/ImageKernels.hpp"
+#include "Core/Task/Future.hpp"
+#include "Core/Task/Scheduler.hpp"
+
+#include "Render/Vulkan/VulkanIdTypes.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+// fwd decl
+namespace moe {
+    class VulkanEngine;
+    struct VulkanImageCache;
+    struct VulkanMeshCache;
+    struct VulkanMaterialCache;
+    struct VulkanCamera;
+    struct VulkanRenderPacket;
+    struct DeletionQueue;
+}// namespace moe
+
+namespace moe {
+    // mip residency manager for the image cache.
+    // only the mip tail is resident right after decoding, more detailed levels are promoted when the per-frame
+    // feedback asks for them. no cpu mips are kept once uploaded: a promotion decodes its missing levels again
+    // from the source (the file, or the pixels handed to addImageFromMemory).
+    // ! note: a residency change re-creates the image with a different base level and swaps the bindless slot;
+    // ! the levels both images share are copied on the gpu, the old image is released FRAMES_IN_FLIGHT frames later
+    struct VulkanTextureStreamer {
+    public:
+        static constexpr uint32_t MIP_TAIL_MAX_SIZE = 128;
+        static constexpr size_t DEFAULT_VRAM_BUDGET = 1024ull * 1024 * 1024;
+        static constexpr size_t DEFAULT_UPLOAD_BUDGET_PER_FRAME = 64ull * 1024 * 1024;
+        // in mip levels, the requested size must leave the resident level by this much before it changes
+        static constexpr float MIP_DEAD_BAND = 0.25f;
+        // frames a level stays resident before it may be demoted (the budget aside)
+        static constexpr uint64_t MIN_RESIDENT_FRAMES = 60;
+
+        struct Stats {
+            size_t streamedImages{0};
+            size_t pendingDecodes{0};
+            size_t residentBytes{0};
+            size_t fullResidencyBytes{0};
+            size_t budgetBytes{0};
+
+            // per frame
+            size_t promotions{0};
+            size_t demotions{0};
+            size_t uploadedBytes{0};
+        };
+
+        VulkanTextureStreamer() = default;
+        ~VulkanTextureStreamer() = default;
+
+        void init(VulkanEngine& engine, VulkanImageCache& imageCache);
+
+        void destroy();
+
+        bool isEnabled() const { return m_enabled; }
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        void setVramBudget(size_t bytes) { m_vramBudget = bytes; }
+
+        void setUploadBudgetPerFrame(size_t bytes) { m_uploadBudgetPerFrame = bytes; }
+
+        // positive values prefer sharper mips
+        void setMipBias(float bias) { m_mipBias = bias; }
+
+        // decoding and mip generation run on the thread pool; the id shows a placeholder until the tail is resident
+        void addImageFromFile(ImageId id, StringView filename, VkFormat format, VkImageUsageFlags usage);
+
+        void addImageFromMemory(ImageId id, Vector<uint8_t>&& rgba, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage);
+
+        bool isStreamed(ImageId id) const { return m_images.find(id) != m_images.end(); }
+
+        bool isResident(ImageId id) const;
+
+        void removeImage(ImageId id);
+
+        // screenPixels is the approximate on-screen size of the surface sampling the image
+        void requestScreenSize(ImageId id, float screenPixels);
+
+        // cpu feedback from projected packet bounds
+        void gatherFeedback(
+                const Vector<VulkanRenderPacket>& packets,
+                const VulkanMeshCache& meshCache,
+                VulkanMaterialCache& materialCache,
+                const VulkanCamera& camera,
+                VkExtent2D viewportExtent);
+
+        // records residency changes into cmd; replaced images and staging buffers go to the frame's deletionQueue
+        void update(VkCommandBuffer cmd, DeletionQueue& deletionQueue);
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        static constexpr uint32_t NOT_RESIDENT = std::numeric_limits<uint32_t>::max();
+
+        using MipChainFuture = Future<SharedPtr<ImageKernels::MipChain>, ThreadPoolScheduler>;
+
+        struct Source {
+            // empty for memory sources
+            String filename;
+            SharedPtr<const Vector<uint8_t>> pixels;
+            VkExtent2D extent{0, 0};
+            ImageKernels::ColorSpace colorSpace{ImageKernels::ColorSpace::Linear};
+        };
+
+        struct StreamedImage {
+            VkFormat format{VK_FORMAT_UNDEFINED};
+            VkImageUsageFlags usage{0};
+            Source source;
+
+            // layout of the full chain, known after the first decode
+            Vector<ImageKernels::MipLevel> levels;
+
+            // levels [0, loaded->levels.size()) decoded from the source, dropped once uploaded or no longer wanted
+            Optional<MipChainFuture> pendingLoad;
+            SharedPtr<ImageKernels::MipChain> loaded;
+
+            uint32_t tailLevel{0};
+            uint32_t residentLevel{NOT_RESIDENT};
+            uint64_t residentSinceFrame{0};
+            // the source could not be decoded again, stays at its resident level
+            bool failed{false};
+
+            float requestedScreenSize{0.0f};
+            uint64_t lastRequestedFrame{0};
+        };
+
+        bool m_initialized{false};
+        bool m_enabled{true};
+        VulkanEngine* m_engine{nullptr};
+        VulkanImageCache* m_imageCache{nullptr};
+
+        size_t m_vramBudget{DEFAULT_VRAM_BUDGET};
+        // set by the memory tracker, the effective budget is the smaller one
+        size_t m_budgetLimit{std::numeric_limits<size_t>::max()};
+        size_t m_uploadBudgetPerFrame{DEFAULT_UPLOAD_BUDGET_PER_FRAME};
+        float m_mipBias{0.0f};
+
+        uint64_t m_frame{1};
+        size_t m_residentBytes{0};
+
+        UnorderedMap<ImageId, StreamedImage> m_images;
+
+        Stats m_stats;
+
+        void addStreamed(ImageId id, VkFormat format, VkImageUsageFlags usage, Source&& source);
+
+        // decodes the source on the thread pool, up to maxLevels levels (0 for the whole chain)
+        static MipChainFuture loadLevels(const Source& source, uint32_t maxLevels);
+
+        void pollPendingLoads();
+
+        // the level the feedback asks for, or the resident one while inside the dead band
+        uint32_t wantedLevel(const StreamedImage& image) const;
+
+        // whether the loaded levels cover a promotion from the resident level to level
+        static bool hasLoadedLevels(const StreamedImage& image, uint32_t level);
+
+        static size_t residentSize(const StreamedImage& image, uint32_t level);
+
+        void setResidentLevel(
+                ImageId id, StreamedImage& image, uint32_t level,
+                VkCommandBuffer cmd, DeletionQueue& deletionQueue);
+    };
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Core/Resource/ImageKernels.hpp"
+#include "Core/Task/Future.hpp"
+#include "Core/Task/Scheduler.hpp"
+
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+#include <mutex>
+
+namespace moe {
+    class VulkanEngine;
+
+    // batches buffer and image uploads into as few submissions as possible.
+    // data is copied into a persistently mapped staging ring when queued, so callers may free it right away;
+    // completion is tracked with a timeline semaphore and resolves the returned future.
+    // ! note: uploaded resources are visible to the frame command buffer once update() has been recorded into it
+    // and the frame's submission waits on getFrameWait(); they must not be used by other submissions
+    // (e.g. immediateSubmit) before their future resolves
+    struct VulkanUploadManager {
+    public:
+        static constexpr size_t DEFAULT_STAGING_RING_SIZE = 64ull * 1024 * 1024;
+        static constexpr size_t STAGING_ALIGNMENT = 16;
+
+        using UploadFuture = Future<void, ThreadPoolScheduler>;
+
+        struct ImageRegion {
+            size_t dataOffset{0};
+            uint32_t mipLevel{0};
+            uint32_t arrayLayer{0};
+            VkExtent3D extent{0, 0, 1};
+        };
+
+        struct Stats {
+            size_t ringSize{0};
+            size_t ringUsedBytes{0};
+            size_t batchesInFlight{0};
+
+            size_t submittedBatches{0};
+            size_t uploadedBytes{0};
+        };
+
+        VulkanUploadManager() = default;
+        ~VulkanUploadManager() = default;
+
+        void init(VulkanEngine& engine, bool useTransferQueue = true, size_t stagingRingSize = DEFAULT_STAGING_RING_SIZE);
+
+        void destroy();
+
+        bool usesDedicatedTransferQueue() const { return m_ownershipTransfer; }
+
+        // all upload* functions are thread safe
+        UploadFuture uploadBuffer(VkBuffer dst, size_t dstOffset, const void* data, size_t size);
+
+        // the image goes from undefined to shader read only; regions must cover every subresource
+        UploadFuture uploadImage(
+                VkImage image, uint32_t mipLevels, uint32_t layerCount,
+                const void* data, size_t size,
+                Span<const ImageRegion> regions);
+
+        UploadFuture uploadImage(VkImage image, const ImageKernels::MipChain& mipChain);
+
+        // resolves once everything queued before the call has completed
+        UploadFuture fence();
+
+        // submits everything queued so far without waiting
+        void flush();
+
+        // blocks until everything queued so far has completed
+        void waitIdle();
+
+        // main thread, at the start of the frame command buffer.
+        // on a dedicated transfer queue this records the acquire half of every batch submitted so far
+        void update(VkCommandBuffer cmd);
+
+        // the wait the frame submission needs for the batches acquired by the last update(), if any
+        Optional<VkSemaphoreSubmitInfo> getFrameWait() const;
+
+        Stats getStats() const;
+
+    private:
+        using UploadPromise = SharedPtr<Promise<void, ThreadPoolScheduler>>;
+
+        struct BufferCopy {
+            VkBuffer src;
+            VkBuffer dst;
+            VkBufferCopy region;
+        };
+
+        struct ImageCopy {
+            VkBuffer src;
+            VkImage dst;
+            uint32_t mipLevels;
+            uint32_t layerCount;
+            Vector<VkBufferImageCopy> regions;
+        };
+
+        struct Batch {
+            Vector<BufferCopy> bufferCopies;
+            Vector<ImageCopy> imageCopies;
+            Vector<UploadPromise> promises;
+            // uploads larger than the ring get their own staging buffer
+            Vector<VulkanAllocatedBuffer> dedicatedStaging;
+
+            uint64_t ringEnd{0};
+            uint64_t timelineValue{0};
+            VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+
+            bool empty() const { return promises.empty(); }
+        };
+
+        bool m_initialized{false};
+        VulkanEngine* m_engine{nullptr};
+
+        bool m_ownershipTransfer{false};
+        VkQueue m_queue{VK_NULL_HANDLE};
+        uint32_t m_queueFamilyIndex{0};
+
+        VkCommandPool m_commandPool{VK_NULL_HANDLE};
+        Vector<VkCommandBuffer> m_freeCommandBuffers;
+
+        VkSemaphore m_timeline{VK_NULL_HANDLE};
+        uint64_t m_timelineValue{0};
+
+        VulkanAllocatedBuffer m_ring{};
+        size_t m_ringSize{0};
+        // monotonic byte counters, the offset into the ring is counter % m_ringSize
+        uint64_t m_ringHead{0};
+        uint64_t m_ringTail{0};
+
+        mutable std::mutex m_mutex;
+        Batch m_recording;
+        Deque<Batch> m_inFlight;
+        bool m_submittedSinceUpdate{false};
+
+        // acquire halves of every submitted batch, recorded by the next update() whether or not the batch has completed
+        Vector<VkBufferMemoryBarrier2> m_pendingAcquireBuffers;
+        Vector<VkImageMemoryBarrier2> m_pendingAcquireImages;
+        // timeline value of the last batch acquired by update(), 0 when the frame has nothing to wait for
+        uint64_t m_frameWaitValue{0};
+
+        Stats m_stats;
+
+        // the following require m_mutex to be held
+        // batches retired while waiting for ring space add their promises to completed, to be fulfilled after unlocking
+        VkBuffer stageLocked(const void* data, size_t size, size_t& outOffset, Vector<UploadPromise>& completed);
+
+        Optional<size_t> allocateRingLocked(size_t size, Vector<UploadPromise>& completed);
+
+        void submitLocked();
+
+        void pollLocked(Vector<UploadPromise>& completed);
+
+        void waitForBatchLocked(const Batch& batch);
+    };
+}// namespace moe
\ No newline at end of file
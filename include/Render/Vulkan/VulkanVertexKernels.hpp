@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+namespace moe {
+    // bulk conversion of vertex attribute streams (e.g. glTF accessors) into the interleaved Vertex layout.
+    // every Vertex is assembled in registers and written with full 16 byte stores, one pass for all attributes.
+    // vectorized paths are selected at compile time (sse2 > neon > scalar)
+    namespace VertexKernels {
+        // element i starts at data + i * stride
+        struct Stream {
+            const uint8_t* data{nullptr};
+            size_t stride{0};
+            size_t count{0};
+
+            bool empty() const { return data == nullptr; }
+        };
+
+        // float components; missing optional streams are written as zero
+        struct VertexStreams {
+            Stream positions;// vec3, required
+            Stream normals;  // vec3
+            Stream tangents; // vec4
+            Stream uvs;      // vec2
+        };
+
+        // name of the compiled simd backend, for logging
+        StringView backendName();
+
+        // every non-empty stream must hold at least count elements
+        void interleaveVertices(Vertex* dst, const VertexStreams& streams, size_t count);
+
+        void widenIndices(const uint16_t* src, uint32_t* dst, size_t count);
+
+        void widenIndices(const uint8_t* src, uint32_t* dst, size_t count);
+
+        namespace Scalar {
+            // reference implementations, always available
+            void interleaveVertices(Vertex* dst, const VertexStreams& streams, size_t count);
+            void widenIndices(const uint16_t* src, uint32_t* dst, size_t count);
+            void widenIndices(const uint8_t* src, uint32_t* dst, size_t count);
+        }// namespace Scalar
+    }// namespace VertexKernels
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Render/Vulkan/VulkanSkeleton.hpp"
+#include "Render/Vulkan/VulkanTypes.hpp"
+
+namespace moe {
+    // layout of a mesh's vertex (and skinning data) buffer, pushed to every shader that fetches vertices.
+    // ! note: keep in sync with VERTEX_FORMAT_* in shaders/slang/moe/vertex.slang
+    enum class VulkanVertexFormat : uint32_t {
+        Full = 0,  // Vertex, SkinningData
+        Packed = 1,// PackedVertexHeader followed by PackedVertex, PackedSkinningData
+    };
+
+    // position decode parameters, at the start of a packed vertex buffer
+    struct PackedVertexHeader {
+        glm::vec3 positionOffset;
+        uint32_t vertexCount;
+        glm::vec3 positionScale;// (max - min) / 65535 per axis
+        uint32_t reserved;
+    };
+
+    // 20 bytes instead of 48
+    struct PackedVertex {
+        uint32_t positionXY;// unorm16 x2, relative to the header bounds
+        uint32_t positionZ; // unorm16 z, bit 31 set when tangent.w is negative
+        uint32_t normal;    // octahedral, snorm16 x2
+        uint32_t tangent;   // octahedral, snorm16 x2
+        uint32_t uv;        // half x2
+    };
+
+    // 12 bytes instead of 32; only for skeletons with at most 256 joints
+    struct PackedSkinningData {
+        uint32_t jointIds;  // uint8 x4
+        uint32_t weights[2];// unorm16 x4, summing to exactly 65535
+    };
+
+    static_assert(sizeof(PackedVertexHeader) == 32, "PackedVertexHeader must match the shader layout");
+    static_assert(sizeof(PackedVertex) == 20, "PackedVertex must match the shader layout");
+    static_assert(sizeof(PackedSkinningData) == 12, "PackedSkinningData must match the shader layout");
+
+    // cpu side encode/decode of the packed vertex format, decoding mirrors the shaders bit for bit where it can.
+    // worst case errors: positions half a quantization step of the bounds (extent / 131070 per axis),
+    // normals and tangents about 0.04 degrees, uvs 11 bit mantissa, weights about 1 / 65535
+    namespace VertexPacking {
+        static constexpr uint32_t MAX_PACKED_JOINTS = 256;
+        // largest finite half, uvs beyond it cannot be packed
+        static constexpr float MAX_PACKED_UV = 65504.0f;
+
+        // false if some attribute is out of the packed range (non-finite values, huge uvs, too many joints)
+        bool canPack(Span<const Vertex> vertices, Span<const SkinningData> skinningData = {});
+
+        // bounds of the vertices, with a scale that never divides by zero
+        PackedVertexHeader makeHeader(Span<const Vertex> vertices);
+
+        PackedVertex packVertex(const Vertex& vertex, const PackedVertexHeader& header);
+
+        Vertex unpackVertex(const PackedVertex& vertex, const PackedVertexHeader& header);
+
+        // weights are renormalized before quantization
+        PackedSkinningData packSkinningData(const SkinningData& skinningData);
+
+        SkinningData unpackSkinningData(const PackedSkinningData& skinningData);
+
+        // header followed by the packed vertices, the layout the shaders read
+        Vector<uint8_t> packVertexBuffer(Span<const Vertex> vertices);
+
+        Vector<PackedSkinningData> packSkinningBuffer(Span<const SkinningData> skinningData);
+
+        // unit vector <-> two components in [-1, 1]
+        glm::vec2 octEncode(const glm::vec3& n);
+
+        glm::vec3 octDecode(const glm::vec2& p);
+    }// namespace VertexPacking
+}// namespace moe
\ No newline at end of file
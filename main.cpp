@@ -505,7 +505,7 @@ int main() {
     JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
 
     //auto floorShape = new JPH::BoxShape({10.0f, 0.1f, 10.0f});
-    auto floorShape = moe::GltfColliderFactory::shapeFromGltf("phy/complex-scene/scene.gltf");
+    auto floorShape = moe::GltfColliderFactory::cookedShapeFromGltf("phy/complex-scene/scene.gltf");
     auto floorSettings = JPH::BodyCreationSettings(
             floorShape,
             JPH::RVec3(0.0f, 0.0f, 0.0f),
@@ -622,7 +622,8 @@ int main() {
     float animationTime = 0.0f;
     int animationIndex = 0;
 
-    auto plane = loader.load("phy/complex-scene/scene.gltf", moe::Loader::Gltf);
+    // streamed in while the main loop runs, the id draws nothing until the scene is ready
+    auto plane = loader.load("phy/complex-scene/scene.gltf", moe::Loader::GltfAsync).first;
     auto sphere = loader.load("phy/sphere/sphere.gltf", moe::Loader::Gltf);
 
     auto spriteImageId = loader.load("test_sprite.jpg", moe::Loader::Image);
@@ -698,6 +699,7 @@ int main() {
             if (ImGui::Begin("Settings")) {
                 // draw set fxaa enabled
                 ImGui::Checkbox("Enable FXAA", &engine.m_enableFxaa);
+                ImGui::Checkbox("Show GPU Memory", &engine.m_showMemoryOverlay);
 
                 // shadow map cam scale
                 ImGui::BeginGroup();
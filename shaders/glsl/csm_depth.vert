@@ -1,16 +1,27 @@
 #version 450
 
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
 #extension GL_GOOGLE_include_directive : require
 
+#include "instance.glsl"
 #include "vertex.glsl"
 
-layout(push_constant) uniform CSM_PCS {
-    mat4 mvp;
+// ! note: keep in sync with CSMPipeline::PushConstants
+layout(push_constant, scalar) uniform CSM_PCS {
+    mat4 lightViewProjection;
     VertexBuffer vertexBuffer;
+    InstanceBuffer instances;
+    // gpu driven path only, unused here
+    uint64_t objects;
+    uint64_t meshes;
+    uint vertexFormat;
 }
 u_csmPushConstants;
 
 void main() {
-    Vertex inVertex = u_csmPushConstants.vertexBuffer.vertices[gl_VertexIndex];
-    gl_Position = u_csmPushConstants.mvp * vec4(inVertex.position, 1.0);
+    Vertex inVertex = loadVertex(u_csmPushConstants.vertexBuffer, u_csmPushConstants.vertexFormat, gl_VertexIndex);
+    mat4 transform = u_csmPushConstants.instances.instances[gl_InstanceIndex].transform;
+    gl_Position = u_csmPushConstants.lightViewProjection * transform * vec4(inVertex.position, 1.0);
 }
\ No newline at end of file
@@ -4,7 +4,7 @@
 #extension GL_GOOGLE_include_directive : require
 #extension GL_EXT_debug_printf : enable
 
-#include "mesh_pcs.glsl"
+#include "gbuffer_pcs.glsl"
 #include "sampler.glsl"
 
 layout(location = 0) in vec3 inNormal;
@@ -13,6 +13,7 @@ layout(location = 2) in vec2 inUV;
 layout(location = 3) in vec3 inTangent;
 layout(location = 4) in vec3 inWorldPos;
 layout(location = 5) in mat3 inTBN;
+layout(location = 8) flat in uint inMaterialIndex;
 
 // this should map that in the GBuffer pipeline attachment locations
 layout(location = 0) out vec4 outFragAlbedo;
@@ -25,7 +26,7 @@ layout(location = 3) out vec4 outFragEmissive;
 void main() {
     vec2 uv = inUV;
 
-    Material material = u_meshPushConstants.sceneData.materialBuffer.materials[u_meshPushConstants.materialIndex];
+    Material material = u_gbufferPushConstants.sceneData.materialBuffer.materials[inMaterialIndex];
 
     vec4 sampledDiffuse = sampleTextureLinear(material.diffuseImageIndex, uv);
     vec4 sampledMetallicRoughness = sampleTextureLinear(material.metallicRoughnessImageIndex, uv);
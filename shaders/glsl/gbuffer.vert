@@ -4,7 +4,7 @@
 #extension GL_GOOGLE_include_directive : require
 #extension GL_EXT_debug_printf : require
 
-#include "mesh_pcs.glsl"
+#include "gbuffer_pcs.glsl"
 
 layout(location = 0) out vec3 outNormal;
 layout(location = 1) out vec3 outColor;
@@ -12,22 +12,27 @@ layout(location = 2) out vec2 outUV;
 layout(location = 3) out vec3 outTangent;
 layout(location = 4) out vec3 outWorldPos;
 layout(location = 5) out mat3 outTBN;
+layout(location = 8) flat out uint outMaterialIndex;
 
 void main() {
-    Vertex inVertex = u_meshPushConstants.vertexBuffer.vertices[gl_VertexIndex];
+    InstanceData instance = u_gbufferPushConstants.instances.instances[gl_InstanceIndex];
+    mat4 transform = instance.transform;
+    mat3 inverseTransform = mat3(instance.inverseTransform);
 
-    gl_Position = u_meshPushConstants.sceneData.viewProjection * u_meshPushConstants.transform * vec4(inVertex.position, 1.0);
+    Vertex inVertex = loadVertex(u_gbufferPushConstants.vertexBuffer, u_gbufferPushConstants.vertexFormat, gl_VertexIndex);
+    outMaterialIndex = u_gbufferPushConstants.materialIndex;
 
-    // ! fixme: performing this in the vertex shader is not optimal
-    outNormal = transpose(inverse(mat3(u_meshPushConstants.transform))) * inVertex.normal;
+    gl_Position = u_gbufferPushConstants.sceneData.viewProjection * transform * vec4(inVertex.position, 1.0);
+
+    outNormal = transpose(inverseTransform) * inVertex.normal;
 
     // ! fixme
     outColor = vec3(1.0, 1.0, 1.0);
     outUV = vec2(inVertex.uv_x, inVertex.uv_y);
     outTangent = inVertex.tangent.xyz;
-    outWorldPos = (u_meshPushConstants.transform * vec4(inVertex.position, 1.0)).xyz;
+    outWorldPos = (transform * vec4(inVertex.position, 1.0)).xyz;
 
-    vec3 T = normalize(vec3(u_meshPushConstants.transform * vec4(inVertex.tangent.xyz, 0.0)));
+    vec3 T = normalize(vec3(transform * vec4(inVertex.tangent.xyz, 0.0)));
     vec3 N = normalize(outNormal);
     vec3 B = cross(N, T) * inVertex.tangent.w;
     outTBN = mat3(T, B, N);
@@ -0,0 +1,27 @@
+#ifndef MOE_GBUFFER_PCS_GLSL
+#define MOE_GBUFFER_PCS_GLSL
+
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "instance.glsl"
+#include "scene_data.glsl"
+#include "vertex.glsl"
+
+// ! note: keep in sync with GBufferPipeline::PushConstants
+// the transform of a draw comes from its instance
+layout(push_constant, scalar) uniform GBuffer_PCS {
+    VertexBuffer vertexBuffer;
+    SceneDataBuffer sceneData;
+    InstanceBuffer instances;
+    // gpu driven path only, unused here
+    uint64_t objects;
+    uint64_t meshes;
+    uint materialIndex;
+    uint vertexFormat;
+}
+u_gbufferPushConstants;
+
+#endif// MOE_GBUFFER_PCS_GLSL
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef MOE_INSTANCE_GLSL
+#define MOE_INSTANCE_GLSL
+
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+
+// ! note: keep in sync with VulkanGPUInstanceData / VulkanInstanceBuffer.hpp
+struct InstanceData {
+    mat4 transform;
+    // only the upper 3x3 is read, transposed it is the normal matrix
+    mat4 inverseTransform;
+};
+
+layout(buffer_reference, scalar) readonly buffer InstanceBuffer {
+    InstanceData instances[];
+};
+
+#endif// MOE_INSTANCE_GLSL
\ No newline at end of file
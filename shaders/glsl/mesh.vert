@@ -14,7 +14,7 @@ layout(location = 4) out vec3 outWorldPos;
 layout(location = 5) out mat3 outTBN;
 
 void main() {
-    Vertex inVertex = u_meshPushConstants.vertexBuffer.vertices[gl_VertexIndex];
+    Vertex inVertex = loadVertex(u_meshPushConstants.vertexBuffer, u_meshPushConstants.vertexFormat, gl_VertexIndex);
 
     /*if (gl_VertexIndex == 0) {
         debugPrintfEXT("Vertex Position: %v4f, %v4f, %v4f, %v4f\n",
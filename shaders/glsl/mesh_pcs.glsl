@@ -14,6 +14,7 @@ layout(push_constant, scalar) uniform Mesh_PCS {
     VertexBuffer vertexBuffer;
     SceneDataBuffer sceneData;
     uint materialIndex;
+    uint vertexFormat;
 }
 u_meshPushConstants;
 
@@ -7,10 +7,14 @@
 layout(push_constant) uniform ShadowMap_PCS {
     mat4 mvp;
     VertexBuffer vertexBuffer;
+    uint vertexFormat;
 }
 u_shadowMapPushConstants;
 
 void main() {
-    Vertex inVertex = u_shadowMapPushConstants.vertexBuffer.vertices[gl_VertexIndex];
+    Vertex inVertex = loadVertex(
+            u_shadowMapPushConstants.vertexBuffer,
+            u_shadowMapPushConstants.vertexFormat,
+            gl_VertexIndex);
     gl_Position = u_shadowMapPushConstants.mvp * vec4(inVertex.position, 1.0);
 }
\ No newline at end of file
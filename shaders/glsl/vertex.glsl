@@ -20,4 +20,66 @@ layout(buffer_reference, std430) writeonly buffer OutputVertexBuffer {
     Vertex outVertices[];
 };
 
+// ! note: keep in sync with VulkanVertexFormat / VulkanVertexPacking.hpp
+const uint VERTEX_FORMAT_FULL = 0;
+const uint VERTEX_FORMAT_PACKED = 1;
+
+struct PackedVertexHeader {
+    vec3 positionOffset;
+    uint vertexCount;
+    vec3 positionScale;
+    uint reserved;
+};
+
+struct PackedVertex {
+    uint positionXY;
+    uint positionZ;
+    uint normal;
+    uint tangent;
+    uint uv;
+};
+
+layout(buffer_reference, scalar) readonly buffer PackedVertexBuffer {
+    PackedVertexHeader header;
+    PackedVertex vertices[];
+};
+
+const uint TANGENT_SIGN_BIT = 0x80000000u;
+
+vec3 octDecode(vec2 p) {
+    vec3 n = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+Vertex unpackVertex(PackedVertex packed, PackedVertexHeader header) {
+    vec3 q = vec3(
+            float(packed.positionXY & 0xffffu),
+            float(packed.positionXY >> 16),
+            float(packed.positionZ & 0xffffu));
+
+    vec2 uv = unpackHalf2x16(packed.uv);
+
+    Vertex vertex;
+    vertex.position = header.positionOffset + q * header.positionScale;
+    vertex.normal = octDecode(unpackSnorm2x16(packed.normal));
+    vertex.tangent = vec4(
+            octDecode(unpackSnorm2x16(packed.tangent)),
+            (packed.positionZ & TANGENT_SIGN_BIT) != 0u ? -1.0 : 1.0);
+    vertex.uv_x = uv.x;
+    vertex.uv_y = uv.y;
+    return vertex;
+}
+
+// format is uniform across a draw, the branch does not diverge
+Vertex loadVertex(VertexBuffer buffer, uint format, uint index) {
+    if (format == VERTEX_FORMAT_PACKED) {
+        PackedVertexBuffer packedBuffer = PackedVertexBuffer(buffer);
+        return unpackVertex(packedBuffer.vertices[index], packedBuffer.header);
+    }
+    return buffer.vertices[index];
+}
+
 #endif// MOE_VERTEX_GLSL
\ No newline at end of file
@@ -252,6 +252,9 @@ def compile_all_parallel(desc: BuildDescription):
     for result in results:
         print(result)
 
+    if any(result.startswith("ERROR") for result in results):
+        sys.exit(1)
+
 def clean_build(desc: BuildDescription):
     cleaned_files = 0
     
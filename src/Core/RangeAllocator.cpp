@@ -0,0 +1,98 @@
+#include "Core/RangeAllocator.hpp"
+
+MOE_BEGIN_NAMESPACE
+
+void RangeAllocator::reset(uint64_t capacity) {
+    m_capacity = capacity;
+    m_used = 0;
+    m_freeByOffset.clear();
+    m_freeBySize.clear();
+    if (capacity > 0) {
+        insertFree(0, capacity);
+    }
+}
+
+uint64_t RangeAllocator::allocate(uint64_t size) {
+    if (size == 0) {
+        return INVALID_OFFSET;
+    }
+
+    const auto fit = m_freeBySize.lower_bound({size, 0});
+    if (fit == m_freeBySize.end()) {
+        return INVALID_OFFSET;
+    }
+
+    const uint64_t offset = fit->second;
+    take(m_freeByOffset.find(offset), offset, size);
+    return offset;
+}
+
+uint64_t RangeAllocator::allocateBelow(uint64_t size, uint64_t limit) {
+    if (size == 0) {
+        return INVALID_OFFSET;
+    }
+
+    for (auto it = m_freeByOffset.begin(); it != m_freeByOffset.end() && it->first + size <= limit; ++it) {
+        if (it->second >= size) {
+            const uint64_t offset = it->first;
+            take(it, offset, size);
+            return offset;
+        }
+    }
+    return INVALID_OFFSET;
+}
+
+void RangeAllocator::free(uint64_t offset, uint64_t size) {
+    MOE_ASSERT(size > 0 && offset + size <= m_capacity, "Freed range out of bounds");
+    MOE_ASSERT(size <= m_used, "Freed more than was allocated");
+
+    m_used -= size;
+
+    // merge with the free ranges right after and right before
+    auto next = m_freeByOffset.lower_bound(offset);
+    MOE_ASSERT(next == m_freeByOffset.end() || next->first >= offset + size, "Freed range overlaps a free range");
+    if (next != m_freeByOffset.end() && next->first == offset + size) {
+        size += next->second;
+        next = std::next(next);
+        eraseFree(std::prev(next));
+    }
+
+    if (next != m_freeByOffset.begin()) {
+        auto prev = std::prev(next);
+        MOE_ASSERT(prev->first + prev->second <= offset, "Freed range overlaps a free range");
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            eraseFree(prev);
+        }
+    }
+
+    insertFree(offset, size);
+}
+
+void RangeAllocator::insertFree(uint64_t offset, uint64_t size) {
+    m_freeByOffset.emplace(offset, size);
+    m_freeBySize.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFree(std::map<uint64_t, uint64_t>::iterator it) {
+    m_freeBySize.erase({it->second, it->first});
+    m_freeByOffset.erase(it);
+}
+
+void RangeAllocator::take(std::map<uint64_t, uint64_t>::iterator it, uint64_t offset, uint64_t size) {
+    const uint64_t rangeOffset = it->first;
+    const uint64_t rangeSize = it->second;
+    MOE_ASSERT(offset >= rangeOffset && offset + size <= rangeOffset + rangeSize, "Range does not fit the free range");
+
+    eraseFree(it);
+    if (offset > rangeOffset) {
+        insertFree(rangeOffset, offset - rangeOffset);
+    }
+    if (offset + size < rangeOffset + rangeSize) {
+        insertFree(offset + size, rangeOffset + rangeSize - offset - size);
+    }
+    m_used += size;
+}
+
+MOE_END_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,537 @@
+#include "Core/Resource/ImageKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MOE_IMAGE_KERNELS_AVX2
+#define MOE_IMAGE_KERNELS_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MOE_IMAGE_KERNELS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MOE_IMAGE_KERNELS_NEON
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#define MOE_IMAGE_KERNELS_SSSE3
+#endif
+
+MOE_BEGIN_NAMESPACE
+
+namespace ImageKernels {
+    namespace Detail {
+        constexpr uint32_t LINEAR_TO_SRGB_LUT_SIZE = 4096;
+
+        struct SrgbTables {
+            float toLinear[256];
+            uint8_t fromLinear[LINEAR_TO_SRGB_LUT_SIZE];
+
+            SrgbTables() {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    float c = static_cast<float>(i) / 255.0f;
+                    toLinear[i] =
+                            c <= 0.04045f
+                                    ? c / 12.92f
+                                    : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                for (uint32_t i = 0; i < LINEAR_TO_SRGB_LUT_SIZE; ++i) {
+                    float l = static_cast<float>(i) / static_cast<float>(LINEAR_TO_SRGB_LUT_SIZE - 1);
+                    float s =
+                            l <= 0.0031308f
+                                    ? l * 12.92f
+                                    : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                    fromLinear[i] = static_cast<uint8_t>(std::lround(std::min(std::max(s, 0.0f), 1.0f) * 255.0f));
+                }
+            }
+        };
+
+        const SrgbTables& srgbTables() {
+            static const SrgbTables tables;
+            return tables;
+        }
+
+        inline uint8_t encodeSrgb(const SrgbTables& tables, float linear) {
+            linear = std::min(std::max(linear, 0.0f), 1.0f);
+            auto idx = static_cast<uint32_t>(linear * static_cast<float>(LINEAR_TO_SRGB_LUT_SIZE - 1) + 0.5f);
+            return tables.fromLinear[idx];
+        }
+
+        // exact round(c * a / 255) for 8-bit c and a
+        inline uint8_t mulDiv255(uint32_t c, uint32_t a) {
+            uint32_t t = c * a + 128;
+            return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+        }
+
+        inline void renormalizePixel(uint8_t* px) {
+            float x = static_cast<float>(px[0]) * (2.0f / 255.0f) - 1.0f;
+            float y = static_cast<float>(px[1]) * (2.0f / 255.0f) - 1.0f;
+            float z = static_cast<float>(px[2]) * (2.0f / 255.0f) - 1.0f;
+            float len2 = x * x + y * y + z * z;
+            if (len2 < 1e-12f) {
+                // degenerate, fall back to a flat normal
+                px[0] = 128;
+                px[1] = 128;
+                px[2] = 255;
+                return;
+            }
+            float inv = 1.0f / std::sqrt(len2);
+            auto encode = [](float v) {
+                float e = (v * 0.5f + 0.5f) * 255.0f;
+                return static_cast<uint8_t>(std::lround(std::min(std::max(e, 0.0f), 255.0f)));
+            };
+            px[0] = encode(x * inv);
+            px[1] = encode(y * inv);
+            px[2] = encode(z * inv);
+        }
+
+        void downsampleBoxRow(
+                const uint8_t* row0, const uint8_t* row1,
+                uint32_t srcWidth, uint32_t dstWidth,
+                uint32_t dstBegin,
+                uint8_t* dst) {
+            const uint32_t xStep = srcWidth > 1 ? 1 : 0;
+            for (uint32_t dx = dstBegin; dx < dstWidth; ++dx) {
+                const uint8_t* p00 = row0 + static_cast<size_t>(dx * 2) * 4;
+                const uint8_t* p01 = p00 + xStep * 4;
+                const uint8_t* p10 = row1 + static_cast<size_t>(dx * 2) * 4;
+                const uint8_t* p11 = p10 + xStep * 4;
+                for (uint32_t c = 0; c < 4; ++c) {
+                    uint32_t sum = p00[c] + p01[c] + p10[c] + p11[c];
+                    dst[dx * 4 + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+
+        void downsampleBoxRowSrgb(
+                const SrgbTables& tables,
+                const uint8_t* row0, const uint8_t* row1,
+                uint32_t srcWidth, uint32_t dstWidth,
+                uint8_t* dst) {
+            const uint32_t xStep = srcWidth > 1 ? 1 : 0;
+            for (uint32_t dx = 0; dx < dstWidth; ++dx) {
+                const uint8_t* p00 = row0 + static_cast<size_t>(dx * 2) * 4;
+                const uint8_t* p01 = p00 + xStep * 4;
+                const uint8_t* p10 = row1 + static_cast<size_t>(dx * 2) * 4;
+                const uint8_t* p11 = p10 + xStep * 4;
+                for (uint32_t c = 0; c < 3; ++c) {
+                    float sum =
+                            tables.toLinear[p00[c]] + tables.toLinear[p01[c]] +
+                            tables.toLinear[p10[c]] + tables.toLinear[p11[c]];
+                    dst[dx * 4 + c] = encodeSrgb(tables, sum * 0.25f);
+                }
+                uint32_t alphaSum = p00[3] + p01[3] + p10[3] + p11[3];
+                dst[dx * 4 + 3] = static_cast<uint8_t>((alphaSum + 2) >> 2);
+            }
+        }
+    }// namespace Detail
+
+    namespace Scalar {
+        void expandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, uint8_t alpha) {
+            for (size_t i = 0; i < pixelCount; ++i) {
+                dst[i * 4 + 0] = src[i * 3 + 0];
+                dst[i * 4 + 1] = src[i * 3 + 1];
+                dst[i * 4 + 2] = src[i * 3 + 2];
+                dst[i * 4 + 3] = alpha;
+            }
+        }
+
+        void premultiplyAlpha(uint8_t* rgba, size_t pixelCount, ColorSpace colorSpace) {
+            if (colorSpace == ColorSpace::Linear) {
+                for (size_t i = 0; i < pixelCount; ++i) {
+                    uint8_t* px = rgba + i * 4;
+                    px[0] = Detail::mulDiv255(px[0], px[3]);
+                    px[1] = Detail::mulDiv255(px[1], px[3]);
+                    px[2] = Detail::mulDiv255(px[2], px[3]);
+                }
+                return;
+            }
+
+            const auto& tables = Detail::srgbTables();
+            for (size_t i = 0; i < pixelCount; ++i) {
+                uint8_t* px = rgba + i * 4;
+                if (px[3] == 0xff) {
+                    continue;
+                }
+                float a = static_cast<float>(px[3]) / 255.0f;
+                px[0] = Detail::encodeSrgb(tables, tables.toLinear[px[0]] * a);
+                px[1] = Detail::encodeSrgb(tables, tables.toLinear[px[1]] * a);
+                px[2] = Detail::encodeSrgb(tables, tables.toLinear[px[2]] * a);
+            }
+        }
+
+        void renormalizeNormals(uint8_t* rgba, size_t pixelCount) {
+            for (size_t i = 0; i < pixelCount; ++i) {
+                Detail::renormalizePixel(rgba + i * 4);
+            }
+        }
+
+        void downsampleBox(
+                const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                uint8_t* dst,
+                ColorSpace colorSpace) {
+            const uint32_t dstWidth = std::max(1u, srcWidth / 2);
+            const uint32_t dstHeight = std::max(1u, srcHeight / 2);
+            const size_t srcStride = static_cast<size_t>(srcWidth) * 4;
+            const size_t dstStride = static_cast<size_t>(dstWidth) * 4;
+
+            for (uint32_t dy = 0; dy < dstHeight; ++dy) {
+                const uint8_t* row0 = src + static_cast<size_t>(dy * 2) * srcStride;
+                const uint8_t* row1 = srcHeight > 1 ? row0 + srcStride : row0;
+                uint8_t* out = dst + dy * dstStride;
+                if (colorSpace == ColorSpace::Srgb) {
+                    Detail::downsampleBoxRowSrgb(Detail::srgbTables(), row0, row1, srcWidth, dstWidth, out);
+                } else {
+                    Detail::downsampleBoxRow(row0, row1, srcWidth, dstWidth, 0, out);
+                }
+            }
+        }
+    }// namespace Scalar
+
+    StringView backendName() {
+#if defined(MOE_IMAGE_KERNELS_AVX2)
+        return "avx2";
+#elif defined(MOE_IMAGE_KERNELS_SSE2)
+        return "sse2";
+#elif defined(MOE_IMAGE_KERNELS_NEON)
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+    uint32_t mipLevelCount(uint32_t width, uint32_t height) {
+        // matches the level count used by VulkanEngine::allocateImage
+        uint32_t size = std::max(width, height);
+        uint32_t levels = 1;
+        while (size > 1) {
+            size >>= 1;
+            ++levels;
+        }
+        return levels;
+    }
+
+    bool isOpaque(const uint8_t* rgba, size_t pixelCount) {
+        for (size_t i = 0; i < pixelCount; ++i) {
+            if (rgba[i * 4 + 3] != 0xff) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void expandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, uint8_t alpha) {
+        size_t i = 0;
+#if defined(MOE_IMAGE_KERNELS_SSSE3)
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+        // each iteration reads 16 bytes but consumes 12, keep the last load in bounds
+        for (; i + 6 <= pixelCount; i += 4) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            __m128i out = _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alphaMask);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), out);
+        }
+#elif defined(MOE_IMAGE_KERNELS_NEON)
+        const uint8x16_t alphaVec = vdupq_n_u8(alpha);
+        for (; i + 16 <= pixelCount; i += 16) {
+            uint8x16x3_t in = vld3q_u8(src + i * 3);
+            uint8x16x4_t out;
+            out.val[0] = in.val[0];
+            out.val[1] = in.val[1];
+            out.val[2] = in.val[2];
+            out.val[3] = alphaVec;
+            vst4q_u8(dst + i * 4, out);
+        }
+#endif
+        Scalar::expandRGBToRGBA(src + i * 3, dst + i * 4, pixelCount - i, alpha);
+    }
+
+    void premultiplyAlpha(uint8_t* rgba, size_t pixelCount, ColorSpace colorSpace) {
+        if (colorSpace == ColorSpace::Srgb) {
+            // lut bound, the simd paths would only gather from the tables
+            Scalar::premultiplyAlpha(rgba, pixelCount, colorSpace);
+            return;
+        }
+
+        size_t i = 0;
+#if defined(MOE_IMAGE_KERNELS_AVX2)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i bias = _mm256_set1_epi16(128);
+            // alpha lanes multiply by 255 so they survive the divide unchanged
+            const __m256i alphaLanes = _mm256_set1_epi64x(static_cast<int64_t>(0xffff000000000000ull));
+            const __m256i alphaOne = _mm256_set1_epi64x(static_cast<int64_t>(0x00ff000000000000ull));
+            for (; i + 8 <= pixelCount; i += 8) {
+                __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + i * 4));
+                __m256i lo = _mm256_unpacklo_epi8(px, zero);
+                __m256i hi = _mm256_unpackhi_epi8(px, zero);
+
+                auto mul = [&](__m256i c) {
+                    __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                    a = _mm256_or_si256(_mm256_andnot_si256(alphaLanes, a), alphaOne);
+                    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(c, a), bias);
+                    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+                };
+
+                _mm256_storeu_si256(
+                        reinterpret_cast<__m256i*>(rgba + i * 4),
+                        _mm256_packus_epi16(mul(lo), mul(hi)));
+            }
+        }
+#elif defined(MOE_IMAGE_KERNELS_SSE2)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i bias = _mm_set1_epi16(128);
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+            for (; i + 4 <= pixelCount; i += 4) {
+                __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+                __m128i lo = _mm_unpacklo_epi8(px, zero);
+                __m128i hi = _mm_unpackhi_epi8(px, zero);
+
+                auto mul = [&](__m128i c) {
+                    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                    a = _mm_or_si128(_mm_andnot_si128(alphaLanes, a), alphaOne);
+                    __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), bias);
+                    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+                };
+
+                _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(rgba + i * 4),
+                        _mm_packus_epi16(mul(lo), mul(hi)));
+            }
+        }
+#elif defined(MOE_IMAGE_KERNELS_NEON)
+        for (; i + 16 <= pixelCount; i += 16) {
+            uint8x16x4_t px = vld4q_u8(rgba + i * 4);
+            for (int c = 0; c < 3; ++c) {
+                uint16x8_t tLo = vmlal_u8(vdupq_n_u16(128), vget_low_u8(px.val[c]), vget_low_u8(px.val[3]));
+                uint16x8_t tHi = vmlal_u8(vdupq_n_u16(128), vget_high_u8(px.val[c]), vget_high_u8(px.val[3]));
+                // (t + (t >> 8)) >> 8
+                px.val[c] = vcombine_u8(vaddhn_u16(tLo, vshrq_n_u16(tLo, 8)), vaddhn_u16(tHi, vshrq_n_u16(tHi, 8)));
+            }
+            vst4q_u8(rgba + i * 4, px);
+        }
+#endif
+        Scalar::premultiplyAlpha(rgba + i * 4, pixelCount - i, colorSpace);
+    }
+
+    void renormalizeNormals(uint8_t* rgba, size_t pixelCount) {
+        size_t i = 0;
+        // soa over 32-bit pixels: each lane holds one pixel, channels are split by shifts
+#if defined(MOE_IMAGE_KERNELS_AVX2)
+        {
+            const __m256i byteMask = _mm256_set1_epi32(0xff);
+            const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+            const __m256 scale = _mm256_set1_ps(2.0f / 255.0f);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 half = _mm256_set1_ps(127.5f);
+            const __m256 eps = _mm256_set1_ps(1e-12f);
+            const __m256i flat = _mm256_set1_epi32(0x00ff8080);
+            for (; i + 8 <= pixelCount; i += 8) {
+                __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + i * 4));
+                __m256 x = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(px, byteMask)), scale), one);
+                __m256 y = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 8), byteMask)), scale), one);
+                __m256 z = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 16), byteMask)), scale), one);
+
+                __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+                __m256 degenerate = _mm256_cmp_ps(len2, eps, _CMP_LT_OQ);
+                __m256 inv = _mm256_div_ps(half, _mm256_sqrt_ps(_mm256_max_ps(len2, eps)));
+
+                // (v / len * 0.5 + 0.5) * 255 == v * (127.5 / len) + 127.5
+                __m256i r = _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(x, inv), half));
+                __m256i g = _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(y, inv), half));
+                __m256i b = _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(z, inv), half));
+                r = _mm256_min_epi32(_mm256_max_epi32(r, _mm256_setzero_si256()), byteMask);
+                g = _mm256_min_epi32(_mm256_max_epi32(g, _mm256_setzero_si256()), byteMask);
+                b = _mm256_min_epi32(_mm256_max_epi32(b, _mm256_setzero_si256()), byteMask);
+
+                __m256i rgb = _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(b, 16)));
+                rgb = _mm256_blendv_epi8(rgb, flat, _mm256_castps_si256(degenerate));
+                __m256i out = _mm256_or_si256(rgb, _mm256_and_si256(px, alphaMask));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4), out);
+            }
+        }
+#elif defined(MOE_IMAGE_KERNELS_SSE2)
+        {
+            const __m128i byteMask = _mm_set1_epi32(0xff);
+            const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+            const __m128 scale = _mm_set1_ps(2.0f / 255.0f);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 half = _mm_set1_ps(127.5f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 maxByte = _mm_set1_ps(255.0f);
+            const __m128 eps = _mm_set1_ps(1e-12f);
+            const __m128i flat = _mm_set1_epi32(0x00ff8080);
+            for (; i + 4 <= pixelCount; i += 4) {
+                __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+                __m128 x = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(px, byteMask)), scale), one);
+                __m128 y = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 8), byteMask)), scale), one);
+                __m128 z = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), byteMask)), scale), one);
+
+                __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+                __m128i degenerate = _mm_castps_si128(_mm_cmplt_ps(len2, eps));
+                __m128 inv = _mm_div_ps(half, _mm_sqrt_ps(_mm_max_ps(len2, eps)));
+
+                // clamp in float, sse2 has no 32-bit integer min/max
+                auto encode = [&](__m128 v) {
+                    __m128 e = _mm_add_ps(_mm_mul_ps(v, inv), half);
+                    return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(e, zero), maxByte));
+                };
+                __m128i rgb = _mm_or_si128(
+                        encode(x),
+                        _mm_or_si128(_mm_slli_epi32(encode(y), 8), _mm_slli_epi32(encode(z), 16)));
+                rgb = _mm_or_si128(_mm_andnot_si128(degenerate, rgb), _mm_and_si128(degenerate, flat));
+                __m128i out = _mm_or_si128(rgb, _mm_and_si128(px, alphaMask));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), out);
+            }
+        }
+#elif defined(MOE_IMAGE_KERNELS_NEON)
+        {
+            const uint32x4_t byteMask = vdupq_n_u32(0xff);
+            const uint32x4_t alphaMask = vdupq_n_u32(0xff000000u);
+            const float32x4_t scale = vdupq_n_f32(2.0f / 255.0f);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t half = vdupq_n_f32(127.5f);
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t maxByte = vdupq_n_f32(255.0f);
+            const float32x4_t eps = vdupq_n_f32(1e-12f);
+            const uint32x4_t flat = vdupq_n_u32(0x00ff8080);
+            for (; i + 4 <= pixelCount; i += 4) {
+                uint32x4_t px = vld1q_u32(reinterpret_cast<const uint32_t*>(rgba + i * 4));
+                float32x4_t x = vsubq_f32(vmulq_f32(vcvtq_f32_u32(vandq_u32(px, byteMask)), scale), one);
+                float32x4_t y = vsubq_f32(vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px, 8), byteMask)), scale), one);
+                float32x4_t z = vsubq_f32(vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px, 16), byteMask)), scale), one);
+
+                float32x4_t len2 = vaddq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), vmulq_f32(z, z));
+                uint32x4_t degenerate = vcltq_f32(len2, eps);
+                float32x4_t inv = vdivq_f32(half, vsqrtq_f32(vmaxq_f32(len2, eps)));
+
+                auto encode = [&](float32x4_t v) {
+                    float32x4_t e = vaddq_f32(vmulq_f32(v, inv), half);
+                    return vcvtnq_u32_f32(vminq_f32(vmaxq_f32(e, zero), maxByte));
+                };
+                uint32x4_t rgb = vorrq_u32(
+                        encode(x),
+                        vorrq_u32(vshlq_n_u32(encode(y), 8), vshlq_n_u32(encode(z), 16)));
+                rgb = vbslq_u32(degenerate, flat, rgb);
+                vst1q_u32(reinterpret_cast<uint32_t*>(rgba + i * 4), vorrq_u32(rgb, vandq_u32(px, alphaMask)));
+            }
+        }
+#endif
+        Scalar::renormalizeNormals(rgba + i * 4, pixelCount - i);
+    }
+
+    void downsampleBox(
+            const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+            uint8_t* dst,
+            ColorSpace colorSpace) {
+        if (colorSpace == ColorSpace::Srgb || srcWidth < 2 || srcHeight < 2) {
+            // srgb goes through the lookup tables, degenerate rows are not worth vectorizing
+            Scalar::downsampleBox(src, srcWidth, srcHeight, dst, colorSpace);
+            return;
+        }
+
+        const uint32_t dstWidth = srcWidth / 2;
+        const uint32_t dstHeight = srcHeight / 2;
+        const size_t srcStride = static_cast<size_t>(srcWidth) * 4;
+        const size_t dstStride = static_cast<size_t>(dstWidth) * 4;
+
+        for (uint32_t dy = 0; dy < dstHeight; ++dy) {
+            const uint8_t* row0 = src + static_cast<size_t>(dy * 2) * srcStride;
+            const uint8_t* row1 = row0 + srcStride;
+            uint8_t* out = dst + dy * dstStride;
+
+            uint32_t dx = 0;
+#if defined(MOE_IMAGE_KERNELS_SSE2)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i round = _mm_set1_epi16(2);
+                // 4 source pixels of two rows -> 2 destination pixels
+                for (; dx + 2 <= dstWidth; dx += 2) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + dx * 8));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + dx * 8));
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                    lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                    hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                    __m128i sum = _mm_unpacklo_epi64(lo, hi);
+                    sum = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + dx * 4), _mm_packus_epi16(sum, sum));
+                }
+            }
+#elif defined(MOE_IMAGE_KERNELS_NEON)
+            // 16 source pixels of two rows -> 8 destination pixels
+            for (; dx + 8 <= dstWidth; dx += 8) {
+                uint8x16x4_t a = vld4q_u8(row0 + dx * 8);
+                uint8x16x4_t b = vld4q_u8(row1 + dx * 8);
+                uint8x8x4_t o;
+                for (int c = 0; c < 4; ++c) {
+                    // pairwise widen-add horizontally, then accumulate the second row
+                    uint16x8_t sum = vpaddlq_u8(a.val[c]);
+                    sum = vpadalq_u8(sum, b.val[c]);
+                    o.val[c] = vrshrn_n_u16(sum, 2);
+                }
+                vst4_u8(out + dx * 4, o);
+            }
+#endif
+            Detail::downsampleBoxRow(row0, row1, srcWidth, dstWidth, dx, out);
+        }
+    }
+
+    MipChain buildMipChain(
+            const uint8_t* rgba, uint32_t width, uint32_t height,
+            ColorSpace colorSpace,
+            bool renormalize,
+            uint32_t maxLevels) {
+        MipChain chain;
+
+        uint32_t levelCount = mipLevelCount(width, height);
+        if (maxLevels != 0) {
+            levelCount = std::min(levelCount, maxLevels);
+        }
+
+        chain.levels.reserve(levelCount);
+        size_t totalSize = 0;
+        {
+            uint32_t w = width;
+            uint32_t h = height;
+            for (uint32_t level = 0; level < levelCount; ++level) {
+                MipLevel lv;
+                lv.width = w;
+                lv.height = h;
+                lv.offset = totalSize;
+                lv.size = static_cast<size_t>(w) * h * 4;
+                chain.levels.push_back(lv);
+
+                totalSize += lv.size;
+                w = std::max(1u, w / 2);
+                h = std::max(1u, h / 2);
+            }
+        }
+
+        chain.data.resize(totalSize);
+        std::memcpy(chain.data.data(), rgba, chain.levels[0].size);
+
+        for (uint32_t level = 1; level < levelCount; ++level) {
+            const auto& prev = chain.levels[level - 1];
+            const auto& curr = chain.levels[level];
+            uint8_t* dst = chain.data.data() + curr.offset;
+            downsampleBox(
+                    chain.data.data() + prev.offset, prev.width, prev.height,
+                    dst,
+                    colorSpace);
+            if (renormalize) {
+                renormalizeNormals(dst, static_cast<size_t>(curr.width) * curr.height);
+            }
+        }
+
+        return chain;
+    }
+}// namespace ImageKernels
+
+MOE_END_NAMESPACE
\ No newline at end of file
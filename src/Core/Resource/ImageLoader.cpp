@@ -13,6 +13,15 @@ namespace Detail {
             int& outHeight,
             int& outChannels,
             int desiredChannels) {
+        int sourceChannels = 0;
+        int infoWidth, infoHeight;
+        bool expandRGB =
+                desiredChannels == 4 &&
+                stbi_info_from_memory(data, static_cast<int>(size), &infoWidth, &infoHeight, &sourceChannels) &&
+                sourceChannels == 3;
+
+        // ! note: rgb sources are decoded as-is and expanded with the simd kernel,
+        // which replaces both stb's scalar conversion and the extra copy
         int width, height, channels;
         uint8_t* imgData = stbi_load_from_memory(
                 data,
@@ -20,7 +29,7 @@ namespace Detail {
                 &width,
                 &height,
                 &channels,
-                desiredChannels);
+                expandRGB ? 3 : desiredChannels);
         if (!imgData) {
             Logger::error(
                     "Failed to load image from memory: {}",
@@ -31,15 +40,46 @@ namespace Detail {
         outWidth = width;
         outHeight = height;
         outChannels = desiredChannels > 0 ? desiredChannels : channels;
-        size_t dataSize =
+        size_t pixelCount =
                 static_cast<size_t>(width) *
-                static_cast<size_t>(height) *
-                static_cast<size_t>(outChannels);
-        outImageData.resize(dataSize);
-        std::memcpy(outImageData.data(), imgData, dataSize);
+                static_cast<size_t>(height);
+        outImageData.resize(pixelCount * static_cast<size_t>(outChannels));
+        if (expandRGB) {
+            ImageKernels::expandRGBToRGBA(imgData, outImageData.data(), pixelCount);
+        } else {
+            std::memcpy(outImageData.data(), imgData, outImageData.size());
+        }
         stbi_image_free(imgData);
         return true;
     }
+
+    void postProcessImage(
+            Vector<uint8_t>& imageData,
+            int width,
+            int height,
+            int channels,
+            bool premultiplyAlpha,
+            bool renormalizeNormals,
+            ImageKernels::ColorSpace colorSpace) {
+        if (!premultiplyAlpha && !renormalizeNormals) {
+            return;
+        }
+
+        if (channels != 4) {
+            Logger::warn("Image post-processing requires 4 channels, got {}; skipping", channels);
+            return;
+        }
+
+        size_t pixelCount =
+                static_cast<size_t>(width) *
+                static_cast<size_t>(height);
+        if (renormalizeNormals) {
+            ImageKernels::renormalizeNormals(imageData.data(), pixelCount);
+        }
+        if (premultiplyAlpha) {
+            ImageKernels::premultiplyAlpha(imageData.data(), pixelCount, colorSpace);
+        }
+    }
 }// namespace Detail
 
 MOE_END_NAMESPACE
\ No newline at end of file
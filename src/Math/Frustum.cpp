@@ -0,0 +1,253 @@
+#include "Math/Frustum.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MOE_FRUSTUM_KERNELS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MOE_FRUSTUM_KERNELS_NEON
+#endif
+
+namespace moe {
+    Frustum Frustum::fromViewProjection(const glm::mat4& viewProjection) {
+        // glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+        auto row = [&](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+
+        Frustum frustum;
+        frustum.planes[Left] = row(3) + row(0);
+        frustum.planes[Right] = row(3) - row(0);
+        frustum.planes[Bottom] = row(3) + row(1);
+        frustum.planes[Top] = row(3) - row(1);
+        // 0 <= z, not -w <= z
+        frustum.planes[Near] = row(2);
+        frustum.planes[Far] = row(3) - row(2);
+        return frustum;
+    }
+
+    bool Frustum::intersectsBox(const glm::vec3& center, const glm::vec3& extent) const {
+        for (const auto& plane: planes) {
+            const glm::vec3 normal = glm::vec3(plane);
+            // distance of the box corner furthest along the normal
+            if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extent) < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::intersectsBox(const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localExtent) const {
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+        const glm::vec3 extent =
+                glm::abs(glm::vec3(transform[0])) * localExtent.x +
+                glm::abs(glm::vec3(transform[1])) * localExtent.y +
+                glm::abs(glm::vec3(transform[2])) * localExtent.z;
+        return intersectsBox(center, extent);
+    }
+
+    namespace FrustumKernels {
+        namespace Detail {
+            static_assert(sizeof(Box) == 32, "Box is loaded as two vec4");
+            static_assert(sizeof(glm::mat4) == 64, "transforms are loaded as four vec4 columns");
+
+            inline const float* transformAt(const uint8_t* transforms, size_t stride, size_t i) {
+                return reinterpret_cast<const float*>(transforms + i * stride);
+            }
+        }// namespace Detail
+
+        namespace Scalar {
+            void cullBoxes(
+                    const Frustum& frustum,
+                    const uint8_t* transforms, size_t transformStride,
+                    const Box* boxes, uint8_t* visible, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    glm::mat4 transform;
+                    std::memcpy(&transform, Detail::transformAt(transforms, transformStride, i), sizeof(transform));
+                    visible[i] = frustum.intersectsBox(transform, boxes[i].center, boxes[i].extent) ? 1 : 0;
+                }
+            }
+        }// namespace Scalar
+
+        StringView backendName() {
+#if defined(MOE_FRUSTUM_KERNELS_SSE2)
+            return "sse2";
+#elif defined(MOE_FRUSTUM_KERNELS_NEON)
+            return "neon";
+#else
+            return "scalar";
+#endif
+        }
+
+#if defined(MOE_FRUSTUM_KERNELS_SSE2)
+        namespace Detail {
+            inline __m128 abs(__m128 v) {
+                return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+            }
+
+            inline __m128 madd(__m128 a, __m128 b, __m128 c) {
+                return _mm_add_ps(_mm_mul_ps(a, b), c);
+            }
+
+            // loads four vec4 and splits their x, y and z components into one register each
+            inline void transposeXyz(
+                    const float* src0, const float* src1, const float* src2, const float* src3,
+                    __m128& x, __m128& y, __m128& z) {
+                __m128 r0 = _mm_loadu_ps(src0);
+                __m128 r1 = _mm_loadu_ps(src1);
+                __m128 r2 = _mm_loadu_ps(src2);
+                __m128 r3 = _mm_loadu_ps(src3);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                x = r0;
+                y = r1;
+                z = r2;
+            }
+        }// namespace Detail
+
+        void cullBoxes(
+                const Frustum& frustum,
+                const uint8_t* transforms, size_t transformStride,
+                const Box* boxes, uint8_t* visible, size_t count) {
+            __m128 planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+            __m128 planeAbsX[Frustum::PlaneCount], planeAbsY[Frustum::PlaneCount], planeAbsZ[Frustum::PlaneCount];
+            for (uint32_t p = 0; p < Frustum::PlaneCount; ++p) {
+                planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+                planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+                planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+                planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+                planeAbsX[p] = Detail::abs(planeX[p]);
+                planeAbsY[p] = Detail::abs(planeY[p]);
+                planeAbsZ[p] = Detail::abs(planeZ[p]);
+            }
+            const __m128 zero = _mm_setzero_ps();
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const float* m[4];
+                const float* b[4];
+                for (int lane = 0; lane < 4; ++lane) {
+                    m[lane] = Detail::transformAt(transforms, transformStride, i + lane);
+                    b[lane] = reinterpret_cast<const float*>(boxes + i + lane);
+                }
+
+                // column c of the four transforms, one register per row
+                __m128 c0x, c0y, c0z, c1x, c1y, c1z, c2x, c2y, c2z, c3x, c3y, c3z;
+                Detail::transposeXyz(m[0] + 0, m[1] + 0, m[2] + 0, m[3] + 0, c0x, c0y, c0z);
+                Detail::transposeXyz(m[0] + 4, m[1] + 4, m[2] + 4, m[3] + 4, c1x, c1y, c1z);
+                Detail::transposeXyz(m[0] + 8, m[1] + 8, m[2] + 8, m[3] + 8, c2x, c2y, c2z);
+                Detail::transposeXyz(m[0] + 12, m[1] + 12, m[2] + 12, m[3] + 12, c3x, c3y, c3z);
+
+                __m128 lx, ly, lz, ex, ey, ez;
+                Detail::transposeXyz(b[0] + 0, b[1] + 0, b[2] + 0, b[3] + 0, lx, ly, lz);
+                Detail::transposeXyz(b[0] + 4, b[1] + 4, b[2] + 4, b[3] + 4, ex, ey, ez);
+
+                const __m128 cx = Detail::madd(c0x, lx, Detail::madd(c1x, ly, Detail::madd(c2x, lz, c3x)));
+                const __m128 cy = Detail::madd(c0y, lx, Detail::madd(c1y, ly, Detail::madd(c2y, lz, c3y)));
+                const __m128 cz = Detail::madd(c0z, lx, Detail::madd(c1z, ly, Detail::madd(c2z, lz, c3z)));
+
+                const __m128 wx = Detail::madd(Detail::abs(c0x), ex, Detail::madd(Detail::abs(c1x), ey, _mm_mul_ps(Detail::abs(c2x), ez)));
+                const __m128 wy = Detail::madd(Detail::abs(c0y), ex, Detail::madd(Detail::abs(c1y), ey, _mm_mul_ps(Detail::abs(c2y), ez)));
+                const __m128 wz = Detail::madd(Detail::abs(c0z), ex, Detail::madd(Detail::abs(c1z), ey, _mm_mul_ps(Detail::abs(c2z), ez)));
+
+                __m128 outside = _mm_setzero_ps();
+                for (uint32_t p = 0; p < Frustum::PlaneCount; ++p) {
+                    const __m128 distance = Detail::madd(planeX[p], cx, Detail::madd(planeY[p], cy, Detail::madd(planeZ[p], cz, planeW[p])));
+                    const __m128 radius = Detail::madd(planeAbsX[p], wx, Detail::madd(planeAbsY[p], wy, _mm_mul_ps(planeAbsZ[p], wz)));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+                }
+
+                const int mask = _mm_movemask_ps(outside);
+                visible[i + 0] = (mask & 1) ? 0 : 1;
+                visible[i + 1] = (mask & 2) ? 0 : 1;
+                visible[i + 2] = (mask & 4) ? 0 : 1;
+                visible[i + 3] = (mask & 8) ? 0 : 1;
+            }
+            Scalar::cullBoxes(
+                    frustum,
+                    transforms + i * transformStride, transformStride,
+                    boxes + i, visible + i, count - i);
+        }
+#elif defined(MOE_FRUSTUM_KERNELS_NEON)
+        namespace Detail {
+            inline void transposeXyz(
+                    const float* src0, const float* src1, const float* src2, const float* src3,
+                    float32x4_t& x, float32x4_t& y, float32x4_t& z) {
+                float32x4_t r0 = vld1q_f32(src0);
+                float32x4_t r1 = vld1q_f32(src1);
+                float32x4_t r2 = vld1q_f32(src2);
+                float32x4_t r3 = vld1q_f32(src3);
+                // (x0 x1 y0 y1), (z0 z1 w0 w1), (x2 x3 y2 y3), (z2 z3 w2 w3)
+                float32x4_t lo01 = vzip1q_f32(r0, r1);
+                float32x4_t hi01 = vzip2q_f32(r0, r1);
+                float32x4_t lo23 = vzip1q_f32(r2, r3);
+                float32x4_t hi23 = vzip2q_f32(r2, r3);
+                x = vreinterpretq_f32_f64(vzip1q_f64(vreinterpretq_f64_f32(lo01), vreinterpretq_f64_f32(lo23)));
+                y = vreinterpretq_f32_f64(vzip2q_f64(vreinterpretq_f64_f32(lo01), vreinterpretq_f64_f32(lo23)));
+                z = vreinterpretq_f32_f64(vzip1q_f64(vreinterpretq_f64_f32(hi01), vreinterpretq_f64_f32(hi23)));
+            }
+        }// namespace Detail
+
+        void cullBoxes(
+                const Frustum& frustum,
+                const uint8_t* transforms, size_t transformStride,
+                const Box* boxes, uint8_t* visible, size_t count) {
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const float* m[4];
+                const float* b[4];
+                for (int lane = 0; lane < 4; ++lane) {
+                    m[lane] = Detail::transformAt(transforms, transformStride, i + lane);
+                    b[lane] = reinterpret_cast<const float*>(boxes + i + lane);
+                }
+
+                float32x4_t c0x, c0y, c0z, c1x, c1y, c1z, c2x, c2y, c2z, c3x, c3y, c3z;
+                Detail::transposeXyz(m[0] + 0, m[1] + 0, m[2] + 0, m[3] + 0, c0x, c0y, c0z);
+                Detail::transposeXyz(m[0] + 4, m[1] + 4, m[2] + 4, m[3] + 4, c1x, c1y, c1z);
+                Detail::transposeXyz(m[0] + 8, m[1] + 8, m[2] + 8, m[3] + 8, c2x, c2y, c2z);
+                Detail::transposeXyz(m[0] + 12, m[1] + 12, m[2] + 12, m[3] + 12, c3x, c3y, c3z);
+
+                float32x4_t lx, ly, lz, ex, ey, ez;
+                Detail::transposeXyz(b[0] + 0, b[1] + 0, b[2] + 0, b[3] + 0, lx, ly, lz);
+                Detail::transposeXyz(b[0] + 4, b[1] + 4, b[2] + 4, b[3] + 4, ex, ey, ez);
+
+                const float32x4_t cx = vfmaq_f32(vfmaq_f32(vfmaq_f32(c3x, c2x, lz), c1x, ly), c0x, lx);
+                const float32x4_t cy = vfmaq_f32(vfmaq_f32(vfmaq_f32(c3y, c2y, lz), c1y, ly), c0y, lx);
+                const float32x4_t cz = vfmaq_f32(vfmaq_f32(vfmaq_f32(c3z, c2z, lz), c1z, ly), c0z, lx);
+
+                const float32x4_t wx = vfmaq_f32(vfmaq_f32(vmulq_f32(vabsq_f32(c2x), ez), vabsq_f32(c1x), ey), vabsq_f32(c0x), ex);
+                const float32x4_t wy = vfmaq_f32(vfmaq_f32(vmulq_f32(vabsq_f32(c2y), ez), vabsq_f32(c1y), ey), vabsq_f32(c0y), ex);
+                const float32x4_t wz = vfmaq_f32(vfmaq_f32(vmulq_f32(vabsq_f32(c2z), ez), vabsq_f32(c1z), ey), vabsq_f32(c0z), ex);
+
+                uint32x4_t outside = vdupq_n_u32(0);
+                for (const auto& plane: frustum.planes) {
+                    const float32x4_t distance = vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(vdupq_n_f32(plane.w), cz, plane.z), cy, plane.y), cx, plane.x);
+                    const float32x4_t radius = vfmaq_n_f32(vfmaq_n_f32(vmulq_n_f32(wz, std::abs(plane.z)), wy, std::abs(plane.y)), wx, std::abs(plane.x));
+                    outside = vorrq_u32(outside, vcltq_f32(vaddq_f32(distance, radius), zero));
+                }
+
+                // 0 or ~0 per lane, narrowed to one byte each
+                const uint16x4_t narrowed = vmovn_u32(vmvnq_u32(outside));
+                const uint8x8_t bytes = vmovn_u16(vcombine_u16(narrowed, narrowed));
+                uint32_t packed = vget_lane_u32(vreinterpret_u32_u8(vand_u8(bytes, vdup_n_u8(1))), 0);
+                std::memcpy(visible + i, &packed, 4);
+            }
+            Scalar::cullBoxes(
+                    frustum,
+                    transforms + i * transformStride, transformStride,
+                    boxes + i, visible + i, count - i);
+        }
+#else
+        void cullBoxes(
+                const Frustum& frustum,
+                const uint8_t* transforms, size_t transformStride,
+                const Box* boxes, uint8_t* visible, size_t count) {
+            Scalar::cullBoxes(frustum, transforms, transformStride, boxes, visible, count);
+        }
+#endif
+    }// namespace FrustumKernels
+}// namespace moe
\ No newline at end of file
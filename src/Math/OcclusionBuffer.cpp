@@ -0,0 +1,276 @@
+#include "Math/OcclusionBuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MOE_OCCLUSION_BUFFER_SSE2
+#endif
+
+namespace moe {
+    namespace Detail {
+        // edge (a, b) as e(p) = a * p.x + b * p.y + c, positive on the inner side of a counter-clockwise triangle
+        struct Edge {
+            float a, b, c;
+        };
+
+        inline Edge makeEdge(float ax, float ay, float bx, float by) {
+            Edge edge{};
+            edge.a = ay - by;
+            edge.b = bx - ax;
+            edge.c = -(edge.a * ax + edge.b * ay);
+            return edge;
+        }
+    }// namespace Detail
+
+    void OcclusionBuffer::resize(uint32_t width, uint32_t height) {
+        m_width = std::max<uint32_t>((width + TILE_WIDTH - 1) / TILE_WIDTH, 1) * TILE_WIDTH;
+        m_height = std::max<uint32_t>((height + TILE_HEIGHT - 1) / TILE_HEIGHT, 1) * TILE_HEIGHT;
+        m_tilesX = m_width / TILE_WIDTH;
+
+        m_depth.resize(static_cast<size_t>(m_width) * m_height);
+        m_tileFarthest.resize(m_depth.size() / TILE_SIZE);
+    }
+
+    void OcclusionBuffer::clear() {
+        std::fill(m_depth.begin(), m_depth.end(), 0.0f);
+        std::fill(m_tileFarthest.begin(), m_tileFarthest.end(), 0.0f);
+    }
+
+    size_t OcclusionBuffer::setupTriangles(
+            const glm::mat4& modelViewProjection,
+            Span<const glm::vec3> positions,
+            Span<const uint32_t> indices,
+            Triangle* out) const {
+        const float halfWidth = 0.5f * static_cast<float>(m_width);
+        const float halfHeight = 0.5f * static_cast<float>(m_height);
+
+        size_t count = 0;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            Triangle triangle{};
+            bool clipped = false;
+            for (int k = 0; k < 3; ++k) {
+                MOE_ASSERT(indices[i + k] < positions.size(), "Occluder index out of range");
+                const glm::vec4 clip = modelViewProjection * glm::vec4(positions[indices[i + k]], 1.0f);
+                if (clip.w < MIN_W) {
+                    clipped = true;
+                    break;
+                }
+                const float invW = 1.0f / clip.w;
+                triangle.x[k] = (clip.x * invW + 1.0f) * halfWidth;
+                triangle.y[k] = (clip.y * invW + 1.0f) * halfHeight;
+                triangle.invW[k] = invW;
+            }
+            if (clipped) {
+                continue;
+            }
+
+            const float area =
+                    (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+                    (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+            if (!(std::abs(area) > 1e-6f)) {
+                continue;
+            }
+
+            // pixels whose centers lie inside the bounds
+            const float minX = std::min({triangle.x[0], triangle.x[1], triangle.x[2]});
+            const float maxX = std::max({triangle.x[0], triangle.x[1], triangle.x[2]});
+            const float minY = std::min({triangle.y[0], triangle.y[1], triangle.y[2]});
+            const float maxY = std::max({triangle.y[0], triangle.y[1], triangle.y[2]});
+            triangle.minX = std::max(static_cast<int32_t>(std::ceil(std::max(minX, -1.0f) - 0.5f)), 0);
+            triangle.maxX = std::min(static_cast<int32_t>(std::floor(std::min(maxX, static_cast<float>(m_width) + 1.0f) - 0.5f)), static_cast<int32_t>(m_width) - 1);
+            triangle.minY = std::max(static_cast<int32_t>(std::ceil(std::max(minY, -1.0f) - 0.5f)), 0);
+            triangle.maxY = std::min(static_cast<int32_t>(std::floor(std::min(maxY, static_cast<float>(m_height) + 1.0f) - 0.5f)), static_cast<int32_t>(m_height) - 1);
+            if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+                continue;
+            }
+
+            out[count++] = triangle;
+        }
+        return count;
+    }
+
+    void OcclusionBuffer::rasterize(Span<const Triangle> triangles, uint32_t tileRowBegin, uint32_t tileRowEnd) {
+        MOE_ASSERT(tileRowEnd <= getTileRows(), "Tile rows out of range");
+        if (tileRowBegin >= tileRowEnd) {
+            return;
+        }
+
+        const auto bandMinY = static_cast<int32_t>(tileRowBegin * TILE_HEIGHT);
+        const auto bandMaxY = static_cast<int32_t>(tileRowEnd * TILE_HEIGHT) - 1;
+        for (const auto& triangle: triangles) {
+            const int32_t minY = std::max(triangle.minY, bandMinY);
+            const int32_t maxY = std::min(triangle.maxY, bandMaxY);
+            if (minY <= maxY) {
+                rasterizeTriangle(triangle, minY, maxY);
+            }
+        }
+
+        for (size_t tile = static_cast<size_t>(tileRowBegin) * m_tilesX; tile < static_cast<size_t>(tileRowEnd) * m_tilesX; ++tile) {
+            const float* depth = m_depth.data() + tile * TILE_SIZE;
+            m_tileFarthest[tile] = *std::min_element(depth, depth + TILE_SIZE);
+        }
+    }
+
+    void OcclusionBuffer::rasterizeTriangle(const Triangle& triangle, int32_t minY, int32_t maxY) {
+        // counter-clockwise, so every edge is positive inside
+        int v1 = 1;
+        int v2 = 2;
+        const float area =
+                (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+                (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+        if (area < 0.0f) {
+            std::swap(v1, v2);
+        }
+        const float invArea = 1.0f / std::abs(area);
+
+        // e12 weights vertex 0, e20 vertex 1 and e01 vertex 2
+        const auto e12 = Detail::makeEdge(triangle.x[v1], triangle.y[v1], triangle.x[v2], triangle.y[v2]);
+        const auto e20 = Detail::makeEdge(triangle.x[v2], triangle.y[v2], triangle.x[0], triangle.y[0]);
+        const auto e01 = Detail::makeEdge(triangle.x[0], triangle.y[0], triangle.x[v1], triangle.y[v1]);
+
+        // depth plane from the barycentric weights
+        const float w0 = triangle.invW[0] * invArea;
+        const float w1 = triangle.invW[v1] * invArea;
+        const float w2 = triangle.invW[v2] * invArea;
+        const float da = e12.a * w0 + e20.a * w1 + e01.a * w2;
+        const float db = e12.b * w0 + e20.b * w1 + e01.b * w2;
+        const float dc = e12.c * w0 + e20.c * w1 + e01.c * w2;
+
+        // spans of four pixels start at a multiple of four, inside one tile row
+        const int32_t spanBegin = triangle.minX & ~3;
+        const int32_t spanEnd = triangle.maxX;
+
+#if defined(MOE_OCCLUSION_BUFFER_SSE2)
+        const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 e12a = _mm_set1_ps(e12.a);
+        const __m128 e20a = _mm_set1_ps(e20.a);
+        const __m128 e01a = _mm_set1_ps(e01.a);
+        const __m128 dA = _mm_set1_ps(da);
+
+        for (int32_t y = minY; y <= maxY; ++y) {
+            const float py = static_cast<float>(y) + 0.5f;
+            const __m128 row12 = _mm_set1_ps(e12.b * py + e12.c);
+            const __m128 row20 = _mm_set1_ps(e20.b * py + e20.c);
+            const __m128 row01 = _mm_set1_ps(e01.b * py + e01.c);
+            const __m128 rowDepth = _mm_set1_ps(db * py + dc);
+
+            for (int32_t x = spanBegin; x <= spanEnd; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                const __m128 inside = _mm_and_ps(
+                        _mm_and_ps(
+                                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e12a, px), row12), zero),
+                                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e20a, px), row20), zero)),
+                        _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e01a, px), row01), zero));
+                if (_mm_movemask_ps(inside) == 0) {
+                    continue;
+                }
+
+                float* dst = m_depth.data() + pixelIndex(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+                const __m128 stored = _mm_loadu_ps(dst);
+                const __m128 depth = _mm_max_ps(stored, _mm_add_ps(_mm_mul_ps(dA, px), rowDepth));
+                _mm_storeu_ps(dst, _mm_or_ps(_mm_and_ps(inside, depth), _mm_andnot_ps(inside, stored)));
+            }
+        }
+#else
+        for (int32_t y = minY; y <= maxY; ++y) {
+            const float py = static_cast<float>(y) + 0.5f;
+            for (int32_t x = spanBegin; x <= spanEnd; x += 4) {
+                float* dst = m_depth.data() + pixelIndex(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+                for (int lane = 0; lane < 4; ++lane) {
+                    const float px = static_cast<float>(x + lane) + 0.5f;
+                    if (e12.a * px + e12.b * py + e12.c >= 0.0f &&
+                        e20.a * px + e20.b * py + e20.c >= 0.0f &&
+                        e01.a * px + e01.b * py + e01.c >= 0.0f) {
+                        dst[lane] = std::max(dst[lane], da * px + db * py + dc);
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    bool OcclusionBuffer::isBoxVisible(const glm::mat4& modelViewProjection, const glm::vec3& center, const glm::vec3& extent) const {
+        const float halfWidth = 0.5f * static_cast<float>(m_width);
+        const float halfHeight = 0.5f * static_cast<float>(m_height);
+
+        float minX = std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxX = std::numeric_limits<float>::lowest();
+        float maxY = std::numeric_limits<float>::lowest();
+        float nearest = 0.0f;
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec3 sign{
+                    (corner & 1) ? 1.0f : -1.0f,
+                    (corner & 2) ? 1.0f : -1.0f,
+                    (corner & 4) ? 1.0f : -1.0f,
+            };
+            const glm::vec4 clip = modelViewProjection * glm::vec4(center + sign * extent, 1.0f);
+            if (clip.w < MIN_W) {
+                return true;
+            }
+
+            const float invW = 1.0f / clip.w;
+            const float x = (clip.x * invW + 1.0f) * halfWidth;
+            const float y = (clip.y * invW + 1.0f) * halfHeight;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            nearest = std::max(nearest, invW);
+        }
+
+        // pixels the box may touch, grown by one against rounding in either rasterization
+        const int32_t x0 = std::max(static_cast<int32_t>(std::floor(std::max(minX, -1.0f))) - 1, 0);
+        const int32_t x1 = std::min(static_cast<int32_t>(std::ceil(std::min(maxX, static_cast<float>(m_width)))), static_cast<int32_t>(m_width) - 1);
+        const int32_t y0 = std::max(static_cast<int32_t>(std::floor(std::max(minY, -1.0f))) - 1, 0);
+        const int32_t y1 = std::min(static_cast<int32_t>(std::ceil(std::min(maxY, static_cast<float>(m_height)))), static_cast<int32_t>(m_height) - 1);
+        if (x0 > x1 || y0 > y1) {
+            // off screen, the frustum decides about those
+            return true;
+        }
+
+        // hidden at a pixel when the occluder there is nearer than the box's nearest point by the bias
+        const float threshold = nearest * (1.0f + DEPTH_BIAS);
+
+        for (int32_t tileY = y0 / static_cast<int32_t>(TILE_HEIGHT); tileY <= y1 / static_cast<int32_t>(TILE_HEIGHT); ++tileY) {
+            for (int32_t tileX = x0 / static_cast<int32_t>(TILE_WIDTH); tileX <= x1 / static_cast<int32_t>(TILE_WIDTH); ++tileX) {
+                const size_t tile = static_cast<size_t>(tileY) * m_tilesX + tileX;
+                if (m_tileFarthest[tile] > threshold) {
+                    continue;
+                }
+
+                const int32_t rowBegin = std::max(y0, tileY * static_cast<int32_t>(TILE_HEIGHT));
+                const int32_t rowEnd = std::min(y1, tileY * static_cast<int32_t>(TILE_HEIGHT) + static_cast<int32_t>(TILE_HEIGHT) - 1);
+                const int32_t columnBegin = std::max(x0, tileX * static_cast<int32_t>(TILE_WIDTH));
+                const int32_t columnEnd = std::min(x1, tileX * static_cast<int32_t>(TILE_WIDTH) + static_cast<int32_t>(TILE_WIDTH) - 1);
+
+                for (int32_t y = rowBegin; y <= rowEnd; ++y) {
+                    for (int32_t x = columnBegin & ~3; x <= columnEnd; x += 4) {
+                        // lanes of the span inside [columnBegin, columnEnd]
+                        int laneMask = 0;
+                        for (int lane = 0; lane < 4; ++lane) {
+                            laneMask |= (x + lane >= columnBegin && x + lane <= columnEnd) ? (1 << lane) : 0;
+                        }
+
+                        const float* depth = m_depth.data() + pixelIndex(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+#if defined(MOE_OCCLUSION_BUFFER_SSE2)
+                        const int uncovered = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(depth), _mm_set1_ps(threshold)));
+#else
+                        int uncovered = 0;
+                        for (int lane = 0; lane < 4; ++lane) {
+                            uncovered |= depth[lane] <= threshold ? (1 << lane) : 0;
+                        }
+#endif
+                        if (uncovered & laneMask) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "Math/TransformHierarchy.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MOE_TRANSFORM_KERNELS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MOE_TRANSFORM_KERNELS_NEON
+#endif
+
+namespace moe {
+    void TransformHierarchy::reserve(size_t count) {
+        m_translations.reserve(count);
+        m_rotations.reserve(count);
+        m_scales.reserve(count);
+        m_localMatrices.reserve(count);
+        m_worldMatrices.reserve(count);
+        m_parents.reserve(count);
+        m_subtreeEnds.reserve(count);
+        m_dirty.reserve(count);
+    }
+
+    void TransformHierarchy::clear() {
+        m_translations.clear();
+        m_rotations.clear();
+        m_scales.clear();
+        m_localMatrices.clear();
+        m_worldMatrices.clear();
+        m_parents.clear();
+        m_subtreeEnds.clear();
+        m_dirty.clear();
+        m_dirtyNodes.clear();
+    }
+
+    TransformHierarchy::NodeIndex TransformHierarchy::addNode(NodeIndex parent, const glm::mat4& localMatrix) {
+        const auto node = static_cast<NodeIndex>(m_parents.size());
+        MOE_ASSERT(parent == NO_PARENT || parent < node, "Parent must be added before its children");
+        // the subtree of the parent ends at the new node, so does the subtree of every ancestor
+        MOE_ASSERT(canAddNode(parent), "Nodes must be added in pre-order");
+
+        // the node extends the subtree of every ancestor, which only stays contiguous in pre-order
+        for (NodeIndex ancestor = parent; ancestor != NO_PARENT; ancestor = m_parents[ancestor]) {
+            m_subtreeEnds[ancestor] = node + 1;
+        }
+
+        m_translations.emplace_back(0.0f);
+        m_rotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
+        m_scales.emplace_back(1.0f);
+        m_localMatrices.emplace_back(1.0f);
+        m_worldMatrices.emplace_back(1.0f);
+        m_parents.push_back(parent);
+        m_subtreeEnds.push_back(node + 1);
+        m_dirty.push_back(0);
+
+        setLocalMatrix(node, localMatrix);
+        return node;
+    }
+
+    void TransformHierarchy::setLocalTransform(
+            NodeIndex node, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+        m_translations[node] = translation;
+        m_rotations[node] = rotation;
+        m_scales[node] = scale;
+
+        // T * R * S
+        glm::mat4 local = glm::mat4_cast(rotation);
+        local[0] *= scale.x;
+        local[1] *= scale.y;
+        local[2] *= scale.z;
+        local[3] = glm::vec4(translation, 1.0f);
+        m_localMatrices[node] = local;
+
+        markDirty(node);
+    }
+
+    void TransformHierarchy::setLocalMatrix(NodeIndex node, const glm::mat4& localMatrix) {
+        m_localMatrices[node] = localMatrix;
+
+        glm::vec3 skew;
+        glm::vec4 perspective;
+        if (!glm::decompose(localMatrix, m_scales[node], m_rotations[node], m_translations[node], skew, perspective)) {
+            // degenerate, e.g. a zero scale
+            m_translations[node] = glm::vec3(localMatrix[3]);
+            m_rotations[node] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            m_scales[node] = glm::vec3(0.0f);
+        }
+
+        markDirty(node);
+    }
+
+    void TransformHierarchy::markDirty(NodeIndex node) {
+        if (!m_dirty[node]) {
+            m_dirty[node] = 1;
+            m_dirtyNodes.push_back(node);
+        }
+    }
+
+    size_t TransformHierarchy::update() {
+        if (m_dirtyNodes.empty()) {
+            return 0;
+        }
+
+        // in pre-order a dirty node inside another dirty subtree comes after the root of that subtree,
+        // only the outermost dirty subtrees are recomputed
+        std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+
+        m_ranges.clear();
+        size_t nodeCount = 0;
+        NodeIndex coveredEnd = 0;
+        for (auto node: m_dirtyNodes) {
+            m_dirty[node] = 0;
+            if (node < coveredEnd) {
+                continue;
+            }
+            coveredEnd = m_subtreeEnds[node];
+            m_ranges.emplace_back(node, coveredEnd);
+            nodeCount += coveredEnd - node;
+        }
+        m_dirtyNodes.clear();
+
+        if (nodeCount < MIN_PARALLEL_NODES) {
+            for (const auto& [begin, end]: m_ranges) {
+                TransformKernels::updateWorldMatrices(
+                        m_parents.data(), m_localMatrices.data(), m_worldMatrices.data(), begin, end);
+            }
+            return nodeCount;
+        }
+
+        // scenes often hang everything below one root. a range larger than a thread's share is split:
+        // its root is recomputed right away, and runs of its child subtrees, contiguous in pre-order,
+        // become ranges of about that share. a single child larger than that is split again later on
+        const size_t threadCount = ThreadPoolScheduler::getInstance().workerCount() + 1;
+        const size_t splitSize = std::max<size_t>(nodeCount / threadCount, 1);
+        for (size_t i = 0; i < m_ranges.size(); ++i) {
+            const auto [begin, end] = m_ranges[i];
+            if (end - begin <= splitSize) {
+                continue;
+            }
+
+            TransformKernels::updateWorldMatrices(
+                    m_parents.data(), m_localMatrices.data(), m_worldMatrices.data(), begin, begin + 1);
+            m_ranges[i] = {begin + 1, begin + 1};
+
+            NodeIndex runBegin = begin + 1;
+            for (NodeIndex child = begin + 1; child < end; child = m_subtreeEnds[child]) {
+                if (child > runBegin && m_subtreeEnds[child] - runBegin > splitSize) {
+                    m_ranges.emplace_back(runBegin, child);
+                    runBegin = child;
+                }
+            }
+            if (runBegin < end) {
+                m_ranges.emplace_back(runBegin, end);
+            }
+        }
+
+        const size_t taskCount = std::min(m_ranges.size(), threadCount * 4);
+        parallelForInline(taskCount, [&](size_t task) {
+            const size_t first = m_ranges.size() * task / taskCount;
+            const size_t last = m_ranges.size() * (task + 1) / taskCount;
+            for (size_t i = first; i < last; ++i) {
+                TransformKernels::updateWorldMatrices(
+                        m_parents.data(), m_localMatrices.data(), m_worldMatrices.data(),
+                        m_ranges[i].first, m_ranges[i].second);
+            }
+        });
+
+        return nodeCount;
+    }
+
+    namespace TransformKernels {
+        namespace Detail {
+            static_assert(sizeof(glm::mat4) == 64, "matrices are loaded as four vec4 columns");
+        }// namespace Detail
+
+        namespace Scalar {
+            void multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+                out = lhs * rhs;
+            }
+
+            void updateWorldMatrices(
+                    const TransformHierarchy::NodeIndex* parents,
+                    const glm::mat4* localMatrices,
+                    glm::mat4* worldMatrices,
+                    size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const auto parent = parents[i];
+                    worldMatrices[i] = parent == TransformHierarchy::NO_PARENT
+                                               ? localMatrices[i]
+                                               : worldMatrices[parent] * localMatrices[i];
+                }
+            }
+        }// namespace Scalar
+
+        StringView backendName() {
+#if defined(MOE_TRANSFORM_KERNELS_SSE2)
+            return "sse2";
+#elif defined(MOE_TRANSFORM_KERNELS_NEON)
+            return "neon";
+#else
+            return "scalar";
+#endif
+        }
+
+#if defined(MOE_TRANSFORM_KERNELS_SSE2)
+        namespace Detail {
+            // column c of the product is lhs * rhs[c], a sum of the lhs columns weighted by the components of rhs[c].
+            // the operands are read completely before out is written, so out may alias them
+            inline void multiply(const float* lhs, const float* rhs, float* out) {
+                const __m128 l0 = _mm_loadu_ps(lhs + 0);
+                const __m128 l1 = _mm_loadu_ps(lhs + 4);
+                const __m128 l2 = _mm_loadu_ps(lhs + 8);
+                const __m128 l3 = _mm_loadu_ps(lhs + 12);
+
+                __m128 columns[4];
+                for (int c = 0; c < 4; ++c) {
+                    const __m128 r = _mm_loadu_ps(rhs + c * 4);
+                    __m128 column = _mm_mul_ps(l0, _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)));
+                    column = _mm_add_ps(column, _mm_mul_ps(l1, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+                    column = _mm_add_ps(column, _mm_mul_ps(l2, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2))));
+                    column = _mm_add_ps(column, _mm_mul_ps(l3, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3))));
+                    columns[c] = column;
+                }
+                for (int c = 0; c < 4; ++c) {
+                    _mm_storeu_ps(out + c * 4, columns[c]);
+                }
+            }
+        }// namespace Detail
+#elif defined(MOE_TRANSFORM_KERNELS_NEON)
+        namespace Detail {
+            inline void multiply(const float* lhs, const float* rhs, float* out) {
+                const float32x4_t l0 = vld1q_f32(lhs + 0);
+                const float32x4_t l1 = vld1q_f32(lhs + 4);
+                const float32x4_t l2 = vld1q_f32(lhs + 8);
+                const float32x4_t l3 = vld1q_f32(lhs + 12);
+
+                float32x4_t columns[4];
+                for (int c = 0; c < 4; ++c) {
+                    const float32x4_t r = vld1q_f32(rhs + c * 4);
+                    float32x4_t column = vmulq_laneq_f32(l0, r, 0);
+                    column = vfmaq_laneq_f32(column, l1, r, 1);
+                    column = vfmaq_laneq_f32(column, l2, r, 2);
+                    column = vfmaq_laneq_f32(column, l3, r, 3);
+                    columns[c] = column;
+                }
+                for (int c = 0; c < 4; ++c) {
+                    vst1q_f32(out + c * 4, columns[c]);
+                }
+            }
+        }// namespace Detail
+#endif
+
+#if defined(MOE_TRANSFORM_KERNELS_SSE2) || defined(MOE_TRANSFORM_KERNELS_NEON)
+        void multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+            Detail::multiply(glm::value_ptr(lhs), glm::value_ptr(rhs), glm::value_ptr(out));
+        }
+
+        void updateWorldMatrices(
+                const TransformHierarchy::NodeIndex* parents,
+                const glm::mat4* localMatrices,
+                glm::mat4* worldMatrices,
+                size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto parent = parents[i];
+                if (parent == TransformHierarchy::NO_PARENT) {
+                    worldMatrices[i] = localMatrices[i];
+                } else {
+                    Detail::multiply(
+                            glm::value_ptr(worldMatrices[parent]),
+                            glm::value_ptr(localMatrices[i]),
+                            glm::value_ptr(worldMatrices[i]));
+                }
+            }
+        }
+#else
+        void multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+            Scalar::multiply(lhs, rhs, out);
+        }
+
+        void updateWorldMatrices(
+                const TransformHierarchy::NodeIndex* parents,
+                const glm::mat4* localMatrices,
+                glm::mat4* worldMatrices,
+                size_t begin, size_t end) {
+            Scalar::updateWorldMatrices(parents, localMatrices, worldMatrices, begin, end);
+        }
+#endif
+    }// namespace TransformKernels
+}// namespace moe
\ No newline at end of file
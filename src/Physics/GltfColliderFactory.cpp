@@ -1,18 +1,23 @@
 #include "Physics/GltfColliderFactory.hpp"
-#include "Core/FileReader.hpp"
+#include "Core/Resource/Cached.hpp"
 #include "Math/Common.hpp"
+#include "Render/Vulkan/VulkanLoaders.hpp"
 
+#include <Jolt/Core/StreamIn.h>
+#include <Jolt/Core/StreamOut.h>
 #include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include <Jolt/Physics/Collision/Shape/ScaledShape.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
 #include <filesystem>
 #include <tiny_gltf.h>
 
 MOE_BEGIN_NAMESPACE
 
 namespace Details {
-    static const String GLTF_POSITIONS_ACCESSOR{"POSITION"};
-
     static const String GLTF_SAMPLER_PATH_TRANSLATION{"translation"};
     static const String GLTF_SAMPLER_PATH_ROTATION{"rotation"};
     static const String GLTF_SAMPLER_PATH_SCALE{"scale"};
@@ -55,69 +60,6 @@ namespace Details {
         return {T, R, S};
     }
 
-    void loadGltfFile(tinygltf::Model& model, std::filesystem::path path, std::filesystem::path parentDir) {
-        tinygltf::TinyGLTF loader;
-        String err;
-        String warn;
-
-        size_t bufSize = 0;
-        auto fileBuf = FileReader::s_instance->readFile(path.string(), bufSize);
-        bool success = loader.LoadASCIIFromString(
-                &model, &err, &warn,
-                reinterpret_cast<const char*>(fileBuf->data()),
-                bufSize, parentDir.string());
-        if (!warn.empty()) {
-            Logger::warn("GLTF loader warning: {}", warn);
-        }
-
-        if (!success) {
-            Logger::error("Failed to load glTF: {}", err);
-            MOE_ASSERT(false, "Failed to load glTF");
-        }
-    }
-
-    int findAttributeAccessor(const tinygltf::Primitive& primitive, StringView attributeName) {
-        for (const auto& [accessorName, accessorID]: primitive.attributes) {
-            if (accessorName == attributeName) {
-                return accessorID;
-            }
-        }
-        return -1;
-    }
-
-    bool hasAccessor(const tinygltf::Primitive& primitive, StringView attributeName) {
-        const auto accessorIndex = findAttributeAccessor(primitive, attributeName);
-        return accessorIndex != -1;
-    }
-
-    template<typename T>
-    Span<const T> getPackedBufferSpan(
-            const tinygltf::Model& model,
-            const tinygltf::Accessor& accessor) {
-        const auto& bv = model.bufferViews[accessor.bufferView];
-        const int bs = accessor.ByteStride(bv);
-        if (bs != sizeof(T)) {
-            Logger::error("Accessor buffer is not tightly packed, expected {}, got {}", sizeof(T), bs);
-            MOE_ASSERT(false, "Accessor buffer is not tightly packed");
-        }
-
-        const auto& buf = model.buffers[bv.buffer];
-        const auto* data =
-                reinterpret_cast<const T*>(&buf.data.at(0) + bv.byteOffset + accessor.byteOffset);
-        return Span<const T>{data, accessor.count};
-    }
-
-    template<typename T>
-    Span<const T> getPackedBufferSpan(
-            const tinygltf::Model& model,
-            const tinygltf::Primitive& primitive,
-            const StringView attributeName) {
-        const auto accessorIndex = findAttributeAccessor(primitive, attributeName);
-        assert(accessorIndex != -1 && "Accessor not found");
-        const auto& accessor = model.accessors[accessorIndex];
-        return getPackedBufferSpan<T>(model, accessor);
-    }
-
     glm::mat4 loadTransform(const tinygltf::Node& node) {
         glm::mat4 transform(1.0f);
 
@@ -186,15 +128,155 @@ namespace Details {
             outNodes[currentNodeIndex].childrenIndices.push_back(childStartIndex);
         }
     }
+
+    struct CookedShapeHeader {
+        uint32_t magic;
+        uint32_t version;
+    };
+
+    class VectorStreamOut final : public JPH::StreamOut {
+    public:
+        explicit VectorStreamOut(Vector<uint8_t>& data) : m_data(data) {}
+
+        void WriteBytes(const void* inData, size_t inNumBytes) override {
+            const auto* bytes = static_cast<const uint8_t*>(inData);
+            m_data.insert(m_data.end(), bytes, bytes + inNumBytes);
+        }
+
+        bool IsFailed() const override { return false; }
+
+    private:
+        Vector<uint8_t>& m_data;
+    };
+
+    class SpanStreamIn final : public JPH::StreamIn {
+    public:
+        explicit SpanStreamIn(Span<const uint8_t> data) : m_data(data) {}
+
+        void ReadBytes(void* outData, size_t inNumBytes) override {
+            // a truncated file fails the stream instead of reading past the end
+            if (m_failed || inNumBytes > m_data.size() - m_cursor) {
+                m_failed = true;
+                std::memset(outData, 0, inNumBytes);
+                return;
+            }
+            std::memcpy(outData, m_data.data() + m_cursor, inNumBytes);
+            m_cursor += inNumBytes;
+        }
+
+        bool IsEOF() const override { return m_cursor >= m_data.size(); }
+
+        bool IsFailed() const override { return m_failed; }
+
+    private:
+        Span<const uint8_t> m_data;
+        size_t m_cursor{0};
+        bool m_failed{false};
+    };
 }// namespace Details
 
-JPH::Ref<JPH::StaticCompoundShapeSettings> GltfColliderFactory::shapeFromGltf(StringView filePath) {
-    tinygltf::Model model;
+Optional<CookedCollisionShape> CookedCollisionShape::deserialize(Span<const uint8_t> data) {
+    Details::CookedShapeHeader header{};
+    if (data.size() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) {
+        return std::nullopt;
+    }
+
+    Details::SpanStreamIn stream(data.subspan(sizeof(header)));
+    JPH::Shape::IDToShapeMap shapeMap;
+    JPH::Shape::IDToMaterialMap materialMap;
+    auto result = JPH::Shape::sRestoreWithChildren(stream, shapeMap, materialMap);
+    if (stream.IsFailed() || result.HasError()) {
+        Logger::error("Failed to restore cooked collision shape: {}", result.HasError() ? result.GetError().c_str() : "truncated data");
+        return std::nullopt;
+    }
 
-    std::filesystem::path pathStr{filePath.data()};
-    std::filesystem::path parentDir = pathStr.parent_path();
+    CookedCollisionShape cooked;
+    cooked.shape = result.Get();
+    return cooked;
+}
 
-    Details::loadGltfFile(model, pathStr, parentDir);
+Vector<uint8_t> CookedCollisionShape::serialize() const {
+    MOE_ASSERT(shape != nullptr, "Cooked collision shape is empty");
+
+    Vector<uint8_t> data(sizeof(Details::CookedShapeHeader));
+    Details::CookedShapeHeader header{MAGIC, VERSION};
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    Details::VectorStreamOut stream(data);
+    JPH::Shape::ShapeToIDMap shapeMap;
+    JPH::Shape::MaterialToIDMap materialMap;
+    shape->SaveWithChildren(stream, shapeMap, materialMap);
+    return data;
+}
+
+GltfColliderFactory::ShapeCooker::ShapeCooker(StringView filename, const MeshBuildSettings& settings)
+    : m_filename(filename), m_settings(settings) {
+    // jolt's binary state layout may change between its versions and with double precision
+    struct KeyParameters {
+        uint32_t version;
+        uint32_t maxTrianglesPerLeaf;
+        float activeEdgeCosThresholdAngle;
+        uint32_t joltVersion;
+        uint32_t doublePrecision;
+    };
+
+    KeyParameters parameters{};
+    parameters.version = CookedCollisionShape::VERSION;
+    parameters.maxTrianglesPerLeaf = settings.maxTrianglesPerLeaf;
+    parameters.activeEdgeCosThresholdAngle = settings.activeEdgeCosThresholdAngle;
+#ifdef JPH_VERSION_MAJOR
+    parameters.joltVersion = (JPH_VERSION_MAJOR << 16) | (JPH_VERSION_MINOR << 8) | JPH_VERSION_PATCH;
+#endif
+#ifdef JPH_DOUBLE_PRECISION
+    parameters.doublePrecision = 1;
+#endif
+
+    m_hash = VkLoaders::GLTF::hashSourceFiles(
+            m_filename,
+            Span<const uint8_t>(reinterpret_cast<const uint8_t*>(&parameters), sizeof(parameters)));
+}
+
+Optional<CookedCollisionShape> GltfColliderFactory::ShapeCooker::generate() {
+    auto settings = shapeFromGltf(m_filename, m_settings);
+    if (!settings) {
+        return std::nullopt;
+    }
+
+    // builds every mesh shape's bounding volume tree, the expensive part the cache skips
+    auto result = settings->Create();
+    if (result.HasError()) {
+        Logger::error("Failed to build collision shape of {}: {}", m_filename, result.GetError().c_str());
+        return std::nullopt;
+    }
+
+    Logger::info("Cooked collision shape: {}", m_filename);
+    CookedCollisionShape cooked;
+    cooked.shape = result.Get();
+    return cooked;
+}
+
+String GltfColliderFactory::ShapeCooker::paramString() const {
+    // the parameter becomes part of the cache file name
+    String param = fmt::format("gltf_collider_{}", m_filename);
+    std::replace_if(
+            param.begin(), param.end(),
+            [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); },
+            '_');
+    return param;
+}
+
+JPH::Ref<JPH::StaticCompoundShapeSettings> GltfColliderFactory::shapeFromGltf(StringView filePath, const MeshBuildSettings& settings) {
+    // parsed and decoded once for every consumer, the renderer's cooker included
+    const auto asset = VkLoaders::GLTF::acquireAsset(filePath);
+    if (!asset) {
+        Logger::error("Failed to load glTF for collision shape: {}", filePath);
+        return nullptr;
+    }
+    const auto& model = asset->getModel();
 
     struct PerPrimitiveData {
         JPH::VertexList vertices;
@@ -207,7 +289,9 @@ JPH::Ref<JPH::StaticCompoundShapeSettings> GltfColliderFactory::shapeFromGltf(St
 
     Vector<PerMeshData> meshesData;
     meshesData.reserve(model.meshes.size());
-    for (const auto& mesh: model.meshes) {
+    for (size_t mi = 0; mi < model.meshes.size(); ++mi) {
+        const auto& mesh = model.meshes[mi];
+
         PerMeshData meshData{};
         meshData.primitives.resize(mesh.primitives.size());
         for (size_t pi = 0; pi < mesh.primitives.size(); ++pi) {
@@ -221,57 +305,26 @@ JPH::Ref<JPH::StaticCompoundShapeSettings> GltfColliderFactory::shapeFromGltf(St
                 continue;
             }
 
+            const auto& decoded = asset->getPrimitive(asset->getFirstPrimitive(mi) + pi);
+
             // load positions
             JPH::VertexList vertices;
-            const auto positions =
-                    Details::getPackedBufferSpan<glm::vec3>(
-                            model, primitive,
-                            Details::GLTF_POSITIONS_ACCESSOR);
-            for (const auto& pos: positions) {
-                JPH::Float3 vertex;
-                vertex = JPH::Float3(pos.x, pos.y, pos.z);
-                vertices.push_back(vertex);
+            vertices.reserve(decoded.vertices.size());
+            for (const auto& vertex: decoded.vertices) {
+                vertices.push_back(JPH::Float3(vertex.pos.x, vertex.pos.y, vertex.pos.z));
             }
 
             // load indices
-            Vector<uint32_t> triangleIndices;
-            if (primitive.indices != -1) {
-                const auto& indexAccessor = model.accessors[primitive.indices];
-                switch (indexAccessor.componentType) {
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                        MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
-                        {
-                            const auto indices = Details::getPackedBufferSpan<std::uint32_t>(model, indexAccessor);
-                            triangleIndices.assign(indices.begin(), indices.end());
-                        }
-                        break;
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                        MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
-                        {
-                            const auto indices = Details::getPackedBufferSpan<std::uint16_t>(model, indexAccessor);
-                            triangleIndices.assign(indices.begin(), indices.end());
-                        }
-                        break;
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                        MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
-                        {
-                            const auto indices = Details::getPackedBufferSpan<std::uint8_t>(model, indexAccessor);
-                            triangleIndices.assign(indices.begin(), indices.end());
-                        }
-                        break;
-                    default:
-                        MOE_ASSERT(false, "Unsupported index component type");
-                }
-            }
+            Vector<uint32_t> triangleIndices = decoded.indices;
 
             if (triangleIndices.empty()) {
                 // no indices: generate sequential triangles if possible
-                if ((positions.size() % 3) != 0) {
+                if ((vertices.size() % 3) != 0) {
                     Logger::error("No indices and POSITION count is not multiple of 3");
                     MOE_ASSERT(false, "Cannot build triangles without indices");
                 } else {
-                    triangleIndices.reserve(positions.size());
-                    for (uint32_t vi = 0; vi < static_cast<uint32_t>(positions.size()); ++vi) {
+                    triangleIndices.reserve(vertices.size());
+                    for (uint32_t vi = 0; vi < static_cast<uint32_t>(vertices.size()); ++vi) {
                         triangleIndices.push_back(vi);
                     };
                 }
@@ -308,6 +361,8 @@ JPH::Ref<JPH::StaticCompoundShapeSettings> GltfColliderFactory::shapeFromGltf(St
                     new JPH::MeshShapeSettings(
                             primitiveData.vertices,
                             primitiveData.triangles);
+            meshShapeSettings->mMaxTrianglesPerLeaf = settings.maxTrianglesPerLeaf;
+            meshShapeSettings->mActiveEdgeCosThresholdAngle = settings.activeEdgeCosThresholdAngle;
 
             // mesh primitive itself is not mutable
             // (at least let's assume so here anyway)
@@ -365,5 +420,14 @@ JPH::Ref<JPH::StaticCompoundShapeSettings> GltfColliderFactory::shapeFromGltf(St
     return rootCompoundShapeSettings;
 }
 
+JPH::RefConst<JPH::Shape> GltfColliderFactory::cookedShapeFromGltf(StringView filePath, const MeshBuildSettings& settings) {
+    auto cooked = Cached<ShapeCooker>(filePath, settings).get();
+    if (!cooked) {
+        Logger::error("Failed to load collision shape: {}", filePath);
+        return nullptr;
+    }
+    return cooked->shape;
+}
+
 
 MOE_END_NAMESPACE
\ No newline at end of file
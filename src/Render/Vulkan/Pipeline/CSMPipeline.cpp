@@ -1,19 +1,33 @@
 #include "Render/Vulkan/Pipeline/CSMPipeline.hpp"
 #include "Render/Vulkan/VulkanCamera.hpp"
 #include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanGPUScene.hpp"
 #include "Render/Vulkan/VulkanInitializers.hpp"
+#include "Render/Vulkan/VulkanInstanceBuffer.hpp"
 #include "Render/Vulkan/VulkanMaterialCache.hpp"
 #include "Render/Vulkan/VulkanMeshCache.hpp"
+#include "Render/Vulkan/VulkanParallelRecorder.hpp"
 #include "Render/Vulkan/VulkanPipeline.hpp"
 #include "Render/Vulkan/VulkanRenderable.hpp"
 #include "Render/Vulkan/VulkanUtils.hpp"
 
+#include <algorithm>
+#include <cstddef>
+
 
 namespace moe {
     namespace Pipeline {
+        static_assert(VulkanGPUScene::CAMERA_VIEW + CSMPipeline::SHADOW_CASCADE_COUNT < VulkanGPUScene::MAX_VIEWS,
+                      "every cascade needs a gpu scene view");
+
         void CSMPipeline::init(VulkanEngine& engine, Array<float, SHADOW_CASCADE_COUNT> cascadeSplitRatios) {
             MOE_ASSERT(!m_initialized, "CSMPipeline is already initialized");
 
+            // CsmDepthPCS in shaders/slang/csm_depth.slang, scalar layout
+            static_assert(offsetof(PushConstants, vertexBufferAddr) == 64, "PushConstants must match CsmDepthPCS");
+            static_assert(offsetof(PushConstants, meshBufferAddr) == 88, "PushConstants must match CsmDepthPCS");
+            static_assert(offsetof(PushConstants, vertexFormat) == 96, "PushConstants must match CsmDepthPCS");
+
             m_engine = &engine;
             // Ensure cascadeSplitRatios are monotonic and normalized (values between 0 and 1, increasing)
             for (size_t i = 0; i < SHADOW_CASCADE_COUNT; ++i) {
@@ -54,6 +68,8 @@ namespace moe {
             builder.setPolygonMode(VK_POLYGON_MODE_FILL);
             // ! use front face culling for shadow map
             builder.setCullMode(VK_CULL_MODE_FRONT_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+            // casters between the light and a cascade are kept by the culling, clamp them onto the near plane
+            builder.setDepthClamp(true);
             builder.disableMultisampling();
             builder.disableBlending();
             builder.enableDepthTesting(true, VK_COMPARE_OP_LESS);
@@ -70,6 +86,7 @@ namespace moe {
             csmImageInfo.mipLevels = 1;
             csmImageInfo.arrayLayers = SHADOW_CASCADE_COUNT;
 
+            VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::RenderTarget);
             auto image = engine.allocateImage(csmImageInfo);
             m_shadowMapImageId = engine.m_caches.imageCache.addImage(std::move(image));
             // ! fixme: this will add a independent 1-layer image view to the descriptor set,
@@ -104,8 +121,10 @@ namespace moe {
                 VkCommandBuffer cmdBuffer,
                 VulkanMeshCache& meshCache,
                 Span<VulkanRenderPacket> drawCommands,
+                VkDeviceAddress instanceBufferAddr,
                 const VulkanCamera& camera,
-                glm::vec3 lightDir) {
+                glm::vec3 lightDir,
+                VulkanGPUScene* gpuScene) {
             MOE_ASSERT(m_initialized, "CSMPipeline is not initialized");
 
             vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
@@ -130,6 +149,14 @@ namespace moe {
             float nearZ = camera.getNearZ();
             float farZ = camera.getFarZ();
 
+            m_stats = {};
+            m_stats.casters = drawCommands.size();
+            const bool gpuDriven = gpuScene && gpuScene->isEnabled();
+            const bool cullingEnabled = m_casterCullingEnabled && !gpuDriven && !drawCommands.empty();
+            if (cullingEnabled) {
+                gatherCasterBounds(meshCache, drawCommands);
+            }
+
             for (int i = 0; i < SHADOW_CASCADE_COUNT; ++i) {
                 float cascadeNearZ = i == 0 ? nearZ : m_cascadeFarPlaneZs[i - 1];
                 float cascadeFarZ = farZ * m_cascadeSplitRatios[i];
@@ -148,6 +175,23 @@ namespace moe {
                 auto corners = subFrustumCamera.getFrustumCornersWorldSpace(aspect);
                 m_cascadeLightTransforms[i] = VulkanCamera::getCSMCamera(corners, lightDir, m_csmShadowMapSize, m_shadowMapCameraScale).viewProj;
 
+                if (cullingEnabled) {
+                    cullCasters(drawCommands, i);
+                }
+
+                const uint32_t gpuView = VulkanGPUScene::CAMERA_VIEW + 1 + i;
+                if (gpuDriven) {
+                    // an unbounded frustum keeps every caster when culling is off
+                    Frustum frustum;
+                    frustum.planes.fill(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+                    float minRadius = 0.0f;
+                    if (m_casterCullingEnabled) {
+                        frustum = getCasterFrustum(i);
+                        minRadius = getMinCasterRadius(i);
+                    }
+                    gpuScene->cull(cmdBuffer, gpuView, instanceBufferAddr, frustum, minRadius);
+                }
+
                 auto depthClearValue = VkClearValue{.depthStencil = {1.0f, 0}};
                 auto depthAttachment = VkInit::renderingAttachmentInfo(
                         m_shadowMapImageViews[i],
@@ -158,46 +202,78 @@ namespace moe {
                         nullptr,
                         &depthAttachment);
 
+                auto& recorder = m_engine->getParallelRecorder();
+                size_t chunkCount = 1;
+                if (!gpuDriven) {
+                    const size_t drawnCasters = cullingEnabled
+                                                        ? static_cast<size_t>(std::count(m_casterVisible.begin(), m_casterVisible.end(), 1))
+                                                        : drawCommands.size();
+                    chunkCount = recorder.getChunkCount(drawnCasters);
+                }
+                if (chunkCount > 1) {
+                    renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+                }
+
                 vkCmdBeginRendering(cmdBuffer, &renderingInfo);
 
-                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+                if (gpuDriven) {
+                    bindState(cmdBuffer);
 
-                auto bindlessSet = m_engine->getBindlessSet().getDescriptorSet();
-                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &bindlessSet, 0, nullptr);
+                    const auto pushConstants = PushConstants{
+                            .lightViewProjection = m_cascadeLightTransforms[i],
+                            .instanceBufferAddr = instanceBufferAddr,
+                            .objectBufferAddr = gpuScene->getObjectBufferAddr(),
+                            .meshBufferAddr = gpuScene->getMeshBufferAddr(),
+                    };
+                    vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+                    gpuScene->draw(cmdBuffer, gpuView);
+                    m_stats.draws[i]++;
+                    m_stats.indexBufferBinds[i]++;
 
-                const auto viewport = VkViewport{
-                        .x = 0,
-                        .y = 0,
-                        .width = (float) m_csmShadowMapSize,
-                        .height = (float) m_csmShadowMapSize,
-                        .minDepth = 0.f,
-                        .maxDepth = 1.f,
-                };
-                vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+                    vkCmdEndRendering(cmdBuffer);
+                    continue;
+                }
 
-                const auto scissor = VkRect2D{
-                        .offset = {},
-                        .extent = {m_csmShadowMapSize, m_csmShadowMapSize},
+                const auto pushConstants = PushConstants{
+                        .lightViewProjection = m_cascadeLightTransforms[i],
+                        .instanceBufferAddr = instanceBufferAddr,
                 };
-                vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
-
-                for (auto& drawCommand: drawCommands) {
-                    auto mesh = m_engine->m_caches.meshCache.getMesh(drawCommand.meshId).value();
-                    vkCmdBindIndexBuffer(cmdBuffer, mesh.gpuBuffer.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-
-                    auto pushConstants = PushConstants{
-                            .mvp = m_cascadeLightTransforms[i] * drawCommand.transform,
-                            .vertexBufferAddr =
-                                    drawCommand.skinned
-                                            ? mesh.gpuBuffer.skinnedVertexBufferAddr
-                                            : mesh.gpuBuffer.vertexBufferAddr,
+
+                if (chunkCount == 1) {
+                    bindState(cmdBuffer);
+                    const auto stats = recordCasters(cmdBuffer, meshCache, drawCommands, 0, drawCommands.size(), cullingEnabled, pushConstants);
+                    m_stats.draws[i] += stats.draws;
+                    m_stats.drawnCasters[i] += stats.drawnCasters;
+                    m_stats.indexBufferBinds[i] += stats.indexBufferBinds;
+                } else {
+                    // chunks end between instanced runs, so the draws are the same as recorded inline
+                    const auto boundaries = VulkanParallelRecorder::split(drawCommands.size(), chunkCount, [&](size_t b) {
+                        return !m_instancingEnabled ||
+                               (cullingEnabled && (!m_casterVisible[b - 1] || !m_casterVisible[b])) ||
+                               !VulkanInstanceBuffer::canInstance(drawCommands[b - 1], drawCommands[b], false);
+                    });
+
+                    const auto formats = VulkanParallelRecorder::RenderingFormats{
+                            .colorFormats = {},
+                            .depthFormat = VK_FORMAT_D32_SFLOAT,
                     };
 
-                    vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
-                    vkCmdDrawIndexed(cmdBuffer, mesh.gpuBuffer.indexCount, 1, 0, 0, 0);
+                    Vector<RecordStats> chunkStats(chunkCount);
+                    recorder.record(cmdBuffer, formats, chunkCount, [&](VkCommandBuffer secondary, size_t chunk) {
+                        bindState(secondary);
+                        chunkStats[chunk] = recordCasters(
+                                secondary, meshCache, drawCommands,
+                                boundaries[chunk], boundaries[chunk + 1], cullingEnabled, pushConstants);
+                    });
+
+                    for (const auto& stats: chunkStats) {
+                        m_stats.draws[i] += stats.draws;
+                        m_stats.drawnCasters[i] += stats.drawnCasters;
+                        m_stats.indexBufferBinds[i] += stats.indexBufferBinds;
+                    }
+                    m_stats.chunks[i] = chunkCount;
                 }
 
-
                 vkCmdEndRendering(cmdBuffer);
             }
 
@@ -208,6 +284,180 @@ namespace moe {
                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
         }
 
+        void CSMPipeline::bindState(VkCommandBuffer cmdBuffer) const {
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+
+            auto bindlessSet = m_engine->getBindlessSet().getDescriptorSet();
+            vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &bindlessSet, 0, nullptr);
+
+            const auto viewport = VkViewport{
+                    .x = 0,
+                    .y = 0,
+                    .width = (float) m_csmShadowMapSize,
+                    .height = (float) m_csmShadowMapSize,
+                    .minDepth = 0.f,
+                    .maxDepth = 1.f,
+            };
+            vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+
+            const auto scissor = VkRect2D{
+                    .offset = {},
+                    .extent = {m_csmShadowMapSize, m_csmShadowMapSize},
+            };
+            vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+        }
+
+        CSMPipeline::RecordStats CSMPipeline::recordCasters(
+                VkCommandBuffer cmdBuffer,
+                const VulkanMeshCache& meshCache,
+                Span<VulkanRenderPacket> drawCommands,
+                size_t begin,
+                size_t end,
+                bool cullingEnabled,
+                PushConstants pushConstants) const {
+            RecordStats stats;
+
+            // runs of visible casters with the same mesh and lod become one instanced draw,
+            // the vertex stream is only pushed again when it changes
+            VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+            bool streamPushed = false;
+
+            auto isDrawn = [&](size_t c) {
+                return !cullingEnabled || m_casterVisible[c];
+            };
+
+            for (size_t first = begin; first < end;) {
+                if (!isDrawn(first)) {
+                    ++first;
+                    continue;
+                }
+
+                const auto& drawCommand = drawCommands[first];
+                size_t runEnd = first + 1;
+                if (m_instancingEnabled) {
+                    while (runEnd < end && isDrawn(runEnd) &&
+                           VulkanInstanceBuffer::canInstance(drawCommand, drawCommands[runEnd], false)) {
+                        ++runEnd;
+                    }
+                }
+                const size_t instanceCount = runEnd - first;
+                const size_t firstInstance = first;
+                first = runEnd;
+
+                const auto* mesh = meshCache.findMesh(drawCommand.meshId);
+                MOE_ASSERT(mesh != nullptr, "Invalid mesh id in render packet");
+
+                const auto indexBuffer = mesh->gpuBuffer.indexBuffer;
+                if (indexBuffer != boundIndexBuffer) {
+                    vkCmdBindIndexBuffer(cmdBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                    boundIndexBuffer = indexBuffer;
+                    stats.indexBufferBinds++;
+                }
+
+                const auto vertexBufferAddr = mesh->gpuBuffer.getVertexBufferAddr(drawCommand.skinned);
+                const auto vertexFormat = mesh->gpuBuffer.getVertexFormat(drawCommand.skinned);
+                if (!streamPushed ||
+                    pushConstants.vertexBufferAddr != vertexBufferAddr ||
+                    pushConstants.vertexFormat != vertexFormat) {
+                    pushConstants.vertexBufferAddr = vertexBufferAddr;
+                    pushConstants.vertexFormat = vertexFormat;
+                    vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+                    streamPushed = true;
+                }
+
+                const auto& lod = mesh->gpuBuffer.getLod(drawCommand.lod);
+                vkCmdDrawIndexed(
+                        cmdBuffer,
+                        lod.indexCount, static_cast<uint32_t>(instanceCount),
+                        mesh->gpuBuffer.getFirstIndex(drawCommand.lod), 0, static_cast<uint32_t>(firstInstance));
+                stats.draws++;
+                stats.drawnCasters += instanceCount;
+            }
+
+            return stats;
+        }
+
+        void CSMPipeline::gatherCasterBounds(const VulkanMeshCache& meshCache, Span<VulkanRenderPacket> drawCommands) {
+            const size_t count = drawCommands.size();
+            m_casterBoxes.resize(count);
+            m_casterRadii.resize(count);
+            m_casterBounded.resize(count);
+            m_casterVisible.resize(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                const auto& drawCommand = drawCommands[i];
+                // bind pose bounds do not cover an animated mesh
+                const auto* mesh = drawCommand.skinned ? nullptr : meshCache.findMesh(drawCommand.meshId);
+
+                auto& box = m_casterBoxes[i];
+                if (!mesh) {
+                    box.center = glm::vec3(0.0f);
+                    box.extent = glm::vec3(0.0f);
+                    m_casterRadii[i] = 0.0f;
+                    m_casterBounded[i] = 0;
+                    m_stats.unboundedCasters++;
+                    continue;
+                }
+
+                box.center = (mesh->min + mesh->max) * 0.5f;
+                box.extent = (mesh->max - mesh->min) * 0.5f;
+
+                const auto& transform = drawCommand.transform;
+                const glm::vec3 worldExtent =
+                        glm::abs(glm::vec3(transform[0])) * box.extent.x +
+                        glm::abs(glm::vec3(transform[1])) * box.extent.y +
+                        glm::abs(glm::vec3(transform[2])) * box.extent.z;
+                m_casterRadii[i] = glm::length(worldExtent);
+                m_casterBounded[i] = 1;
+            }
+        }
+
+        void CSMPipeline::cullCasters(Span<VulkanRenderPacket> drawCommands, uint32_t cascade) {
+            const size_t count = drawCommands.size();
+
+            FrustumKernels::cullBoxes(
+                    getCasterFrustum(cascade),
+                    reinterpret_cast<const uint8_t*>(&drawCommands[0].transform), sizeof(VulkanRenderPacket),
+                    m_casterBoxes.data(), m_casterVisible.data(), count);
+
+            const float minRadius = getMinCasterRadius(cascade);
+
+            for (size_t i = 0; i < count; ++i) {
+                if (!m_casterBounded[i]) {
+                    m_casterVisible[i] = 1;
+                    continue;
+                }
+                if (!m_casterVisible[i]) {
+                    m_stats.culledCasters[cascade]++;
+                    continue;
+                }
+                if (m_casterRadii[i] < minRadius) {
+                    m_casterVisible[i] = 0;
+                    m_stats.smallCasters[cascade]++;
+                }
+            }
+        }
+
+        Frustum CSMPipeline::getCasterFrustum(uint32_t cascade) const {
+            auto frustum = Frustum::fromViewProjection(m_cascadeLightTransforms[cascade]);
+            // the volume is open towards the light, casters in front of the cascade still shadow it
+            frustum.planes[Frustum::Near] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            return frustum;
+        }
+
+        float CSMPipeline::getMinCasterRadius(uint32_t cascade) const {
+            if (cascade == 0) {
+                return 0.0f;
+            }
+
+            // the light view is rigid, so the ortho x scale alone maps world units to clip space
+            const auto& lightTransform = m_cascadeLightTransforms[cascade];
+            const float texelsPerUnit =
+                    0.5f * static_cast<float>(m_csmShadowMapSize) *
+                    glm::length(glm::vec3(lightTransform[0][0], lightTransform[1][0], lightTransform[2][0]));
+            return 0.5f * m_minCasterSizeTexels / texelsPerUnit;
+        }
+
         void CSMPipeline::destroy() {
             MOE_ASSERT(m_initialized, "CSMPipeline is not initialized");
 
@@ -1,16 +1,26 @@
 #include "Render/Vulkan/Pipeline/GBufferPipeline.hpp"
 #include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanGPUScene.hpp"
 #include "Render/Vulkan/VulkanInitializers.hpp"
+#include "Render/Vulkan/VulkanInstanceBuffer.hpp"
 #include "Render/Vulkan/VulkanMaterialCache.hpp"
 #include "Render/Vulkan/VulkanMeshCache.hpp"
+#include "Render/Vulkan/VulkanParallelRecorder.hpp"
 #include "Render/Vulkan/VulkanPipeline.hpp"
 #include "Render/Vulkan/VulkanUtils.hpp"
 
+#include <cstddef>
+
 namespace moe {
     namespace Pipeline {
         void GBufferPipeline::init(VulkanEngine& engine) {
             MOE_ASSERT(!m_initialized, "GBufferPipeline already initialized");
 
+            // MeshPCS in shaders/slang/gbuffer.slang, scalar layout
+            static_assert(offsetof(PushConstants, meshBufferAddr) == 32, "PushConstants must match MeshPCS");
+            static_assert(offsetof(PushConstants, materialId) == 40, "PushConstants must match MeshPCS");
+            static_assert(offsetof(PushConstants, vertexFormat) == 44, "PushConstants must match MeshPCS");
+
             m_initialized = true;
             m_engine = &engine;
 
@@ -72,7 +82,9 @@ namespace moe {
                 VulkanMeshCache& meshCache,
                 VulkanMaterialCache& materialCache,
                 Span<VulkanRenderPacket> drawCommands,
-                VulkanAllocatedBuffer& sceneDataBuffer) {
+                VulkanAllocatedBuffer& sceneDataBuffer,
+                VkDeviceAddress instanceBufferAddr,
+                VulkanGPUScene* gpuScene) {
             MOE_ASSERT(m_initialized, "GBufferPipeline not initialized");
 
             transitionImagesForRendering(cmdBuffer);
@@ -116,57 +128,29 @@ namespace moe {
             renderingInfo.colorAttachmentCount = colorAttachments.size();
             renderingInfo.pColorAttachments = colorAttachments.data();
 
-            vkCmdBeginRendering(cmdBuffer, &renderingInfo);
-
-            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
-
-            auto bindlessDescriptorSet = m_engine->getBindlessSet().getDescriptorSet();
-            vkCmdBindDescriptorSets(
-                    cmdBuffer,
-                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    m_pipelineLayout,
-                    0, 1, &bindlessDescriptorSet,
-                    0, nullptr);
-
-            for (auto& cmd: drawCommands) {
-                auto mesh = meshCache.getMesh(cmd.meshId);
-                if (!mesh.has_value()) {
-                    Logger::warn("Invalid mesh id {}, skipping draw command", cmd.meshId);
-                    continue;
-                }
-
-                auto& meshAsset = mesh.value();
-                MOE_ASSERT(sceneDataBuffer.address != 0, "Invalid scene data buffer");
+            m_stats = {};
 
-                const auto viewport = VkViewport{
-                        .x = 0,
-                        .y = 0,
-                        .width = (float) m_engine->m_drawExtent.width,
-                        .height = (float) m_engine->m_drawExtent.height,
-                        .minDepth = 0.f,
-                        .maxDepth = 1.f,
-                };
-                vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+            const bool gpuDriven = gpuScene && gpuScene->isEnabled();
+            auto& recorder = m_engine->getParallelRecorder();
+            const size_t chunkCount = gpuDriven ? 1 : recorder.getChunkCount(drawCommands.size());
+            if (chunkCount > 1) {
+                renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+            }
 
-                VkRect2D scissor = {.offset = {0, 0}, .extent = m_engine->m_drawExtent};
-                vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+            vkCmdBeginRendering(cmdBuffer, &renderingInfo);
 
-                vkCmdBindIndexBuffer(cmdBuffer, meshAsset.gpuBuffer.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+            MOE_ASSERT(sceneDataBuffer.address != 0, "Invalid scene data buffer");
 
-                auto vertexBufferAddr =
-                        cmd.skinned
-                                ? meshAsset.gpuBuffer.skinnedVertexBufferAddr
-                                : meshAsset.gpuBuffer.vertexBufferAddr;
+            if (gpuDriven) {
+                bindState(cmdBuffer);
 
+                // the camera view was culled on the gpu, every object draws through the one indirect draw
                 const auto pushConstants = PushConstants{
-                        .transform = cmd.transform,
-                        .clampedInverseTransform =
-                                glm::mat3(glm::inverse(cmd.transform)),
-                        .vertexBufferAddr = vertexBufferAddr,
                         .sceneDataAddress = sceneDataBuffer.address,
-                        .materialId = cmd.materialId,
+                        .instanceBufferAddr = instanceBufferAddr,
+                        .objectBufferAddr = gpuScene->getObjectBufferAddr(),
+                        .meshBufferAddr = gpuScene->getMeshBufferAddr(),
                 };
-
                 vkCmdPushConstants(
                         cmdBuffer,
                         m_pipelineLayout,
@@ -174,8 +158,57 @@ namespace moe {
                         0,
                         sizeof(PushConstants),
                         &pushConstants);
+                gpuScene->draw(cmdBuffer, VulkanGPUScene::CAMERA_VIEW);
+                m_stats.statePushes++;
+                m_stats.indexBufferBinds++;
+                m_stats.draws++;
+
+                vkCmdEndRendering(cmdBuffer);
+
+                transitionImagesForSampling(cmdBuffer);
+                return;
+            }
+
+            const auto pushConstants = PushConstants{
+                    .sceneDataAddress = sceneDataBuffer.address,
+                    .instanceBufferAddr = instanceBufferAddr,
+            };
+
+            if (chunkCount == 1) {
+                bindState(cmdBuffer);
+                m_stats = recordPackets(cmdBuffer, meshCache, drawCommands, 0, drawCommands.size(), pushConstants);
+            } else {
+                // chunks end between instanced runs, so the draws are the same as recorded inline
+                const auto boundaries = VulkanParallelRecorder::split(drawCommands.size(), chunkCount, [&](size_t b) {
+                    return !m_instancingEnabled || !VulkanInstanceBuffer::canInstance(drawCommands[b - 1], drawCommands[b]);
+                });
+
+                const auto colorFormats = Array<VkFormat, 4>{
+                        gAlbedo.imageFormat,
+                        gNormal.imageFormat,
+                        gORMA.imageFormat,
+                        gEmissive.imageFormat,
+                };
+                const auto formats = VulkanParallelRecorder::RenderingFormats{
+                        .colorFormats = colorFormats,
+                        .depthFormat = gDepth.imageFormat,
+                };
 
-                vkCmdDrawIndexed(cmdBuffer, meshAsset.gpuBuffer.indexCount, 1, 0, 0, 0);
+                Vector<Stats> chunkStats(chunkCount);
+                recorder.record(cmdBuffer, formats, chunkCount, [&](VkCommandBuffer secondary, size_t chunk) {
+                    bindState(secondary);
+                    chunkStats[chunk] = recordPackets(
+                            secondary, meshCache, drawCommands,
+                            boundaries[chunk], boundaries[chunk + 1], pushConstants);
+                });
+
+                for (const auto& stats: chunkStats) {
+                    m_stats.draws += stats.draws;
+                    m_stats.instances += stats.instances;
+                    m_stats.indexBufferBinds += stats.indexBufferBinds;
+                    m_stats.statePushes += stats.statePushes;
+                }
+                m_stats.chunks = chunkCount;
             }
 
             vkCmdEndRendering(cmdBuffer);
@@ -183,6 +216,103 @@ namespace moe {
             transitionImagesForSampling(cmdBuffer);
         }
 
+        void GBufferPipeline::bindState(VkCommandBuffer cmdBuffer) const {
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+
+            auto bindlessDescriptorSet = m_engine->getBindlessSet().getDescriptorSet();
+            vkCmdBindDescriptorSets(
+                    cmdBuffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_pipelineLayout,
+                    0, 1, &bindlessDescriptorSet,
+                    0, nullptr);
+
+            const auto viewport = VkViewport{
+                    .x = 0,
+                    .y = 0,
+                    .width = (float) m_engine->m_drawExtent.width,
+                    .height = (float) m_engine->m_drawExtent.height,
+                    .minDepth = 0.f,
+                    .maxDepth = 1.f,
+            };
+            vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+
+            VkRect2D scissor = {.offset = {0, 0}, .extent = m_engine->m_drawExtent};
+            vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+        }
+
+        GBufferPipeline::Stats GBufferPipeline::recordPackets(
+                VkCommandBuffer cmdBuffer,
+                const VulkanMeshCache& meshCache,
+                Span<VulkanRenderPacket> drawCommands,
+                size_t begin,
+                size_t end,
+                PushConstants pushConstants) const {
+            Stats stats;
+
+            // sorted packets mostly share state with the previous one, only what changed is bound or pushed.
+            // runs of packets with the same mesh, lod and material become one instanced draw
+            VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+            bool statePushed = false;
+
+            for (size_t first = begin; first < end;) {
+                const auto& cmd = drawCommands[first];
+                size_t runEnd = first + 1;
+                if (m_instancingEnabled) {
+                    while (runEnd < end && VulkanInstanceBuffer::canInstance(cmd, drawCommands[runEnd])) {
+                        ++runEnd;
+                    }
+                }
+                const size_t instanceCount = runEnd - first;
+                const size_t firstInstance = first;
+                first = runEnd;
+
+                const auto* meshAsset = meshCache.findMesh(cmd.meshId);
+                if (!meshAsset) {
+                    Logger::warn("Invalid mesh id {}, skipping draw command", cmd.meshId);
+                    continue;
+                }
+
+                const auto indexBuffer = meshAsset->gpuBuffer.indexBuffer;
+                if (indexBuffer != boundIndexBuffer) {
+                    vkCmdBindIndexBuffer(cmdBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                    boundIndexBuffer = indexBuffer;
+                    stats.indexBufferBinds++;
+                }
+
+                const auto vertexBufferAddr = meshAsset->gpuBuffer.getVertexBufferAddr(cmd.skinned);
+                const auto vertexFormat = meshAsset->gpuBuffer.getVertexFormat(cmd.skinned);
+                if (!statePushed ||
+                    pushConstants.vertexBufferAddr != vertexBufferAddr ||
+                    pushConstants.materialId != cmd.materialId ||
+                    pushConstants.vertexFormat != vertexFormat) {
+                    pushConstants.vertexBufferAddr = vertexBufferAddr;
+                    pushConstants.materialId = cmd.materialId;
+                    pushConstants.vertexFormat = vertexFormat;
+
+                    vkCmdPushConstants(
+                            cmdBuffer,
+                            m_pipelineLayout,
+                            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                            0,
+                            sizeof(PushConstants),
+                            &pushConstants);
+                    statePushed = true;
+                    stats.statePushes++;
+                }
+
+                const auto& lod = meshAsset->gpuBuffer.getLod(cmd.lod);
+                vkCmdDrawIndexed(
+                        cmdBuffer,
+                        lod.indexCount, static_cast<uint32_t>(instanceCount),
+                        meshAsset->gpuBuffer.getFirstIndex(cmd.lod), 0, static_cast<uint32_t>(firstInstance));
+                stats.draws++;
+                stats.instances += instanceCount;
+            }
+
+            return stats;
+        }
+
         void GBufferPipeline::destroy() {
             MOE_ASSERT(m_initialized, "GBufferPipeline not initialized");
 
@@ -200,6 +330,7 @@ namespace moe {
                     .depth = 1,
             };
 
+            VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::RenderTarget);
             auto depth = m_engine->allocateImage(
                     extent,
                     VK_FORMAT_D32_SFLOAT,
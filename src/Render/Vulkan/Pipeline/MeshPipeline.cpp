@@ -104,15 +104,13 @@ namespace moe {
                 VkRect2D scissor = {.offset = {0, 0}, .extent = m_engine->m_drawExtent};
                 vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
 
-                vkCmdBindIndexBuffer(cmdBuffer, meshAsset.gpuBuffer.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdBindIndexBuffer(cmdBuffer, meshAsset.gpuBuffer.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
                 const auto pushConstants = PushConstants{
                         .transform = cmd.transform,
-                        .vertexBufferAddr =
-                                cmd.skinned
-                                        ? meshAsset.gpuBuffer.skinnedVertexBufferAddr
-                                        : meshAsset.gpuBuffer.vertexBufferAddr,
+                        .vertexBufferAddr = meshAsset.gpuBuffer.getVertexBufferAddr(cmd.skinned),
                         .sceneDataAddress = sceneDataBuffer.address,
                         .materialId = cmd.materialId,
+                        .vertexFormat = meshAsset.gpuBuffer.getVertexFormat(cmd.skinned),
                 };
 
                 vkCmdPushConstants(
@@ -123,7 +121,8 @@ namespace moe {
                         sizeof(PushConstants),
                         &pushConstants);
 
-                vkCmdDrawIndexed(cmdBuffer, meshAsset.gpuBuffer.indexCount, 1, 0, 0, 0);
+                const auto& lod = meshAsset.gpuBuffer.getLod(cmd.lod);
+                vkCmdDrawIndexed(cmdBuffer, lod.indexCount, 1, meshAsset.gpuBuffer.getFirstIndex(cmd.lod), 0, 0);
             }
         }
 
@@ -59,6 +59,7 @@ namespace moe {
                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                             {m_shadowMapSize, m_shadowMapSize, 1});
 
+            VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::RenderTarget);
             auto image = engine.allocateImage(shadowMapImageInfo);
             m_shadowMapImageId = engine.m_caches.imageCache.addImage(std::move(image));
 
@@ -137,18 +138,17 @@ namespace moe {
 
             for (auto& drawCommand: drawCommands) {
                 auto mesh = m_engine->m_caches.meshCache.getMesh(drawCommand.meshId).value();
-                vkCmdBindIndexBuffer(cmdBuffer, mesh.gpuBuffer.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdBindIndexBuffer(cmdBuffer, mesh.gpuBuffer.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
                 auto pushConstants = PushConstants{
                         .mvp = m_shadowMapLightTransform * drawCommand.transform,
-                        .vertexBufferAddr =
-                                drawCommand.skinned
-                                        ? mesh.gpuBuffer.skinnedVertexBufferAddr
-                                        : mesh.gpuBuffer.vertexBufferAddr,
+                        .vertexBufferAddr = mesh.gpuBuffer.getVertexBufferAddr(drawCommand.skinned),
+                        .vertexFormat = mesh.gpuBuffer.getVertexFormat(drawCommand.skinned),
                 };
 
                 vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstants), &pushConstants);
-                vkCmdDrawIndexed(cmdBuffer, mesh.gpuBuffer.indexCount, 1, 0, 0, 0);
+                const auto& lod = mesh.gpuBuffer.getLod(drawCommand.lod);
+                vkCmdDrawIndexed(cmdBuffer, lod.indexCount, 1, mesh.gpuBuffer.getFirstIndex(drawCommand.lod), 0, 0);
             }
 
 
@@ -34,6 +34,7 @@ namespace moe {
 
             vkDestroyShaderModule(engine.m_device, shader, nullptr);
 
+            VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Dynamic);
             for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++) {
                 m_swapData[i].jointMatrixBuffer =
                         engine.allocateBuffer(
@@ -118,6 +119,7 @@ namespace moe {
                         .outputVertexBufferAddr = mesh.gpuBuffer.skinnedVertexBufferAddr,
                         .jointMatrixStartIndex = (uint32_t) packet.jointMatrixStartIndex,
                         .vertexCount = mesh.gpuBuffer.vertexCount,
+                        .vertexFormat = mesh.gpuBuffer.vertexFormat,
                 };
 
                 vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
@@ -137,8 +137,8 @@ namespace moe {
                         sizeof(PushConstants),
                         &pushConstantsTransform);
 
-                vkCmdBindIndexBuffer(cmdBuffer, mesh.gpuBuffer.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-                vkCmdDrawIndexed(cmdBuffer, mesh.gpuBuffer.indexCount, 1, 0, 0, 0);
+                vkCmdBindIndexBuffer(cmdBuffer, mesh.gpuBuffer.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexed(cmdBuffer, mesh.gpuBuffer.indexCount, 1, mesh.gpuBuffer.firstIndex, 0, 0);
             }
 
             vkCmdEndRendering(cmdBuffer);
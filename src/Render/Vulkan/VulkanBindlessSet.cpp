@@ -12,18 +12,18 @@ namespace moe {
             auto poolSizes = Array<VkDescriptorPoolSize, 2>{
                     VkDescriptorPoolSize{
                             .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-                            .descriptorCount = MAX_BINDLESS_IMAGES,
+                            .descriptorCount = MAX_BINDLESS_IMAGES * Constants::FRAMES_IN_FLIGHT,
                     },
                     VkDescriptorPoolSize{
                             .type = VK_DESCRIPTOR_TYPE_SAMPLER,
-                            .descriptorCount = MAX_BINDLESS_SAMPLERS,
+                            .descriptorCount = MAX_BINDLESS_SAMPLERS * Constants::FRAMES_IN_FLIGHT,
                     },
             };
 
             VkDescriptorPoolCreateInfo poolInfo{};
             poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
             poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
-            poolInfo.maxSets = 1;
+            poolInfo.maxSets = Constants::FRAMES_IN_FLIGHT;
             poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
             poolInfo.pPoolSizes = poolSizes.data();
 
@@ -71,12 +71,15 @@ namespace moe {
         }
 
         {
+            Array<VkDescriptorSetLayout, Constants::FRAMES_IN_FLIGHT> layouts;
+            layouts.fill(m_descriptorSetLayout);
+
             const auto allocInfo =
                     VkDescriptorSetAllocateInfo{
                             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
                             .descriptorPool = m_descriptorPool,
-                            .descriptorSetCount = 1,
-                            .pSetLayouts = &m_descriptorSetLayout,
+                            .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+                            .pSetLayouts = layouts.data(),
                     };
 
             /*
@@ -89,7 +92,7 @@ namespace moe {
                     };
             */
 
-            MOE_VK_CHECK(vkAllocateDescriptorSets(m_engine->m_device, &allocInfo, &m_descriptorSet));
+            MOE_VK_CHECK(vkAllocateDescriptorSets(m_engine->m_device, &allocInfo, m_descriptorSets.data()));
         }
 
         initDefaultSamplers(maxAnisotropy);
@@ -125,46 +128,65 @@ namespace moe {
         MOE_ASSERT(m_initialized, "VulkanBindlessSet not initialized");
         MOE_ASSERT(id < MAX_BINDLESS_IMAGES, "Invalid image ID");
 
-        const auto imageInfo = VkDescriptorImageInfo{
-                .sampler = VK_NULL_HANDLE,
-                .imageView = imageView,
-                .imageLayout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
-        };
-
-        const auto writeSet = VkWriteDescriptorSet{
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = m_descriptorSet,
-                .dstBinding = IMAGE_BINDING_INDEX,
-                .dstArrayElement = id,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-                .pImageInfo = &imageInfo,
-        };
-
-        vkUpdateDescriptorSets(m_engine->m_device, 1, &writeSet, 0, nullptr);
+        queueWrite(
+                IMAGE_BINDING_INDEX, id,
+                VkDescriptorImageInfo{
+                        .sampler = VK_NULL_HANDLE,
+                        .imageView = imageView,
+                        .imageLayout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
+                });
     }
 
     void VulkanBindlessSet::addSampler(uint32_t id, VkSampler sampler) {
         MOE_ASSERT(m_initialized, "VulkanBindlessSet not initialized");
         MOE_ASSERT(id < MAX_BINDLESS_SAMPLERS, "Invalid sampler ID");
 
-        const auto imageInfo = VkDescriptorImageInfo{
-                .sampler = sampler,
-                .imageView = VK_NULL_HANDLE,
-                .imageLayout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
-        };
-
-        const auto writeSet = VkWriteDescriptorSet{
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = m_descriptorSet,
-                .dstBinding = SAMPLER_BINDING_INDEX,
-                .dstArrayElement = id,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
-                .pImageInfo = &imageInfo,
-        };
-
-        vkUpdateDescriptorSets(m_engine->m_device, 1, &writeSet, 0, nullptr);
+        queueWrite(
+                SAMPLER_BINDING_INDEX, id,
+                VkDescriptorImageInfo{
+                        .sampler = sampler,
+                        .imageView = VK_NULL_HANDLE,
+                        .imageLayout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
+                });
+    }
+
+    void VulkanBindlessSet::queueWrite(uint32_t binding, uint32_t id, const VkDescriptorImageInfo& info) {
+        // ! note: a set may still be sampled by a pending frame, it is only written once that frame has retired
+        for (auto& writes: m_pendingWrites) {
+            writes.push_back({binding, id, info});
+        }
+    }
+
+    void VulkanBindlessSet::beginFrame(size_t frameIndex) {
+        MOE_ASSERT(m_initialized, "VulkanBindlessSet not initialized");
+        MOE_ASSERT(frameIndex < Constants::FRAMES_IN_FLIGHT, "Invalid frame index");
+
+        m_frameIndex = frameIndex;
+
+        auto& pending = m_pendingWrites[frameIndex];
+        if (pending.empty()) {
+            return;
+        }
+
+        // later writes to the same slot win, vkUpdateDescriptorSets applies them in order
+        Vector<VkWriteDescriptorSet> writeSets;
+        writeSets.reserve(pending.size());
+        for (const auto& write: pending) {
+            writeSets.push_back(VkWriteDescriptorSet{
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstSet = m_descriptorSets[frameIndex],
+                    .dstBinding = write.binding,
+                    .dstArrayElement = write.id,
+                    .descriptorCount = 1,
+                    .descriptorType = write.binding == IMAGE_BINDING_INDEX
+                                              ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+                                              : VK_DESCRIPTOR_TYPE_SAMPLER,
+                    .pImageInfo = &write.info,
+            });
+        }
+
+        vkUpdateDescriptorSets(m_engine->m_device, static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+        pending.clear();
     }
 
     void VulkanBindlessSet::destroy() {
@@ -176,6 +198,10 @@ namespace moe {
         vkDestroyDescriptorSetLayout(m_engine->m_device, m_descriptorSetLayout, nullptr);
         vkDestroyDescriptorPool(m_engine->m_device, m_descriptorPool, nullptr);
 
+        for (auto& writes: m_pendingWrites) {
+            writes.clear();
+        }
+
         m_engine = nullptr;
         m_initialized = false;
     }
@@ -0,0 +1,418 @@
+#include "Render/Vulkan/VulkanCookedScene.hpp"
+
+#include <algorithm>
+
+namespace moe {
+    namespace Detail {
+        constexpr size_t COOKED_SECTION_ALIGNMENT = 16;
+
+        constexpr size_t alignCookedOffset(size_t offset) {
+            return (offset + COOKED_SECTION_ALIGNMENT - 1) / COOKED_SECTION_ALIGNMENT * COOKED_SECTION_ALIGNMENT;
+        }
+
+        struct CookedFileHeader {
+            uint32_t magic;
+            uint32_t version;
+        };
+
+        struct CookedWriter {
+            Vector<uint8_t> data;
+
+            template<typename T>
+            void write(Span<const T> section) {
+                static_assert(std::is_trivially_copyable_v<T>, "Cooked sections must be trivially copyable");
+
+                uint64_t byteCount = section.size() * sizeof(T);
+                append(&byteCount, sizeof(byteCount));
+                append(section.data(), byteCount);
+            }
+
+            template<typename T>
+            void write(const Vector<T>& section) {
+                write(Span<const T>(section.data(), section.size()));
+            }
+
+        private:
+            void append(const void* src, size_t size) {
+                size_t offset = data.size();
+                data.resize(alignCookedOffset(offset + size), 0);
+                if (size > 0) {
+                    std::memcpy(data.data() + offset, src, size);
+                }
+            }
+        };
+
+        struct CookedReader {
+            Span<const uint8_t> data;
+            size_t cursor{0};
+
+            template<typename T>
+            bool read(Span<const T>& outSection) {
+                uint64_t byteCount;
+                if (data.size() - cursor < sizeof(byteCount)) {
+                    return false;
+                }
+                std::memcpy(&byteCount, data.data() + cursor, sizeof(byteCount));
+                cursor = alignCookedOffset(cursor + sizeof(byteCount));
+
+                if (cursor > data.size() || byteCount > data.size() - cursor || byteCount % sizeof(T) != 0) {
+                    return false;
+                }
+
+                outSection = Span<const T>(
+                        reinterpret_cast<const T*>(data.data() + cursor),
+                        static_cast<size_t>(byteCount / sizeof(T)));
+                cursor = std::min(alignCookedOffset(cursor + byteCount), data.size());
+                return true;
+            }
+        };
+
+        bool isCookedRangeValid(VulkanCookedScene::Range range, size_t size) {
+            return range.offset <= size && range.count <= size - range.offset;
+        }
+
+        bool isCookedReferenceValid(int32_t reference, size_t size) {
+            return reference == VulkanCookedScene::NO_REFERENCE ||
+                   (reference >= 0 && static_cast<size_t>(reference) < size);
+        }
+
+        bool isCookedIndexDataValid(Span<const uint32_t> indices, uint64_t vertexCount) {
+            return std::all_of(indices.begin(), indices.end(), [vertexCount](uint32_t index) {
+                return index < vertexCount;
+            });
+        }
+
+        bool isCookedKeyRangeValid(const VulkanCookedScene::KeyRange& range, size_t keyCount, size_t timeCount) {
+            return isCookedRangeValid({range.keyOffset, range.count}, keyCount) &&
+                   isCookedRangeValid({range.timeOffset, range.count}, timeCount);
+        }
+
+        template<typename T>
+        void assignCookedKeys(
+                Vector<T>& outKeys, Vector<float>& outTimes,
+                Span<const T> keys, Span<const float> times,
+                const VulkanCookedScene::KeyRange& range) {
+            auto keySpan = keys.subspan(range.keyOffset, range.count);
+            auto timeSpan = times.subspan(range.timeOffset, range.count);
+            outKeys.assign(keySpan.begin(), keySpan.end());
+            outTimes.assign(timeSpan.begin(), timeSpan.end());
+        }
+    }// namespace Detail
+
+    VulkanCookedScene::Range VulkanCookedScene::Builder::addString(StringView str) {
+        Range range{strings.size(), str.size()};
+        strings.insert(strings.end(), str.begin(), str.end());
+        return range;
+    }
+
+    VulkanCookedScene::Primitive VulkanCookedScene::Builder::addPrimitive(const VulkanCPUMesh& mesh, int32_t material) {
+        Primitive primitive{};
+        primitive.material = material;
+
+        if (mesh.indices.empty() || mesh.vertices.empty()) {
+            return primitive;
+        }
+
+        primitive.vertices = {vertices.size(), mesh.vertices.size()};
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+
+        primitive.indices = {indices.size(), mesh.indices.size()};
+        indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+
+        primitive.lods = {lods.size(), mesh.lods.size()};
+        lods.insert(lods.end(), mesh.lods.begin(), mesh.lods.end());
+
+        primitive.meshlets = {meshlets.size(), mesh.meshlets.size()};
+        meshlets.insert(meshlets.end(), mesh.meshlets.begin(), mesh.meshlets.end());
+
+        primitive.meshletVertices = {meshletVertices.size(), mesh.meshletVertices.size()};
+        meshletVertices.insert(meshletVertices.end(), mesh.meshletVertices.begin(), mesh.meshletVertices.end());
+
+        primitive.meshletTriangles = {meshletTriangles.size(), mesh.meshletTriangles.size()};
+        meshletTriangles.insert(meshletTriangles.end(), mesh.meshletTriangles.begin(), mesh.meshletTriangles.end());
+
+        primitive.skinningData = {skinningData.size(), mesh.skinningData.size()};
+        skinningData.insert(skinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
+
+        primitive.min = mesh.min;
+        primitive.max = mesh.max;
+
+        return primitive;
+    }
+
+    VulkanCookedScene VulkanCookedScene::build(const Builder& builder) {
+        Detail::CookedWriter writer;
+
+        Detail::CookedFileHeader header{MAGIC, VERSION};
+        writer.write(Span<const Detail::CookedFileHeader>(&header, 1));
+
+        writer.write(builder.meshes);
+        writer.write(builder.primitives);
+        writer.write(builder.vertices);
+        writer.write(builder.indices);
+        writer.write(builder.lods);
+        writer.write(builder.meshlets);
+        writer.write(builder.meshletVertices);
+        writer.write(builder.meshletTriangles);
+        writer.write(builder.skinningData);
+
+        writer.write(builder.materials);
+        writer.write(builder.images);
+        writer.write(builder.pixels);
+
+        writer.write(builder.nodes);
+
+        writer.write(builder.skeletons);
+        writer.write(builder.joints);
+        writer.write(builder.jointChildren);
+
+        writer.write(builder.animations);
+        writer.write(builder.tracks);
+        writer.write(builder.translationKeys);
+        writer.write(builder.rotationKeys);
+        writer.write(builder.scaleKeys);
+        writer.write(builder.keyTimes);
+
+        writer.write(builder.strings);
+
+        auto scene = view(std::make_shared<const Vector<uint8_t>>(std::move(writer.data)));
+        MOE_ASSERT(scene.has_value(), "Cooked scene does not read back");
+        return std::move(*scene);
+    }
+
+    Optional<VulkanCookedScene> VulkanCookedScene::deserialize(Span<const uint8_t> data) {
+        return view(std::make_shared<const Vector<uint8_t>>(data.begin(), data.end()));
+    }
+
+    Vector<uint8_t> VulkanCookedScene::serialize() const {
+        MOE_ASSERT(m_data != nullptr, "Cooked scene is empty");
+        return *m_data;
+    }
+
+    VulkanCookedScene::Builder VulkanCookedScene::toBuilder() const {
+        auto copy = [](auto span, auto& out) {
+            out.assign(span.begin(), span.end());
+        };
+
+        Builder builder;
+        copy(meshes, builder.meshes);
+        copy(primitives, builder.primitives);
+        copy(vertices, builder.vertices);
+        copy(indices, builder.indices);
+        copy(lods, builder.lods);
+        copy(meshlets, builder.meshlets);
+        copy(meshletVertices, builder.meshletVertices);
+        copy(meshletTriangles, builder.meshletTriangles);
+        copy(skinningData, builder.skinningData);
+
+        copy(materials, builder.materials);
+        copy(images, builder.images);
+        copy(pixels, builder.pixels);
+
+        copy(nodes, builder.nodes);
+
+        copy(skeletons, builder.skeletons);
+        copy(joints, builder.joints);
+        copy(jointChildren, builder.jointChildren);
+
+        copy(animations, builder.animations);
+        copy(tracks, builder.tracks);
+        copy(translationKeys, builder.translationKeys);
+        copy(rotationKeys, builder.rotationKeys);
+        copy(scaleKeys, builder.scaleKeys);
+        copy(keyTimes, builder.keyTimes);
+
+        copy(strings, builder.strings);
+        return builder;
+    }
+
+    Optional<VulkanCookedScene> VulkanCookedScene::view(SharedPtr<const Vector<uint8_t>> data) {
+        Detail::CookedReader reader{Span<const uint8_t>(data->data(), data->size())};
+
+        Span<const Detail::CookedFileHeader> header;
+        if (!reader.read(header) || header.size() != 1) {
+            return std::nullopt;
+        }
+        if (header[0].magic != MAGIC || header[0].version != VERSION) {
+            Logger::info("Cooked scene version {} is outdated, expected {}", header[0].version, VERSION);
+            return std::nullopt;
+        }
+
+        VulkanCookedScene scene;
+        bool complete =
+                reader.read(scene.meshes) &&
+                reader.read(scene.primitives) &&
+                reader.read(scene.vertices) &&
+                reader.read(scene.indices) &&
+                reader.read(scene.lods) &&
+                reader.read(scene.meshlets) &&
+                reader.read(scene.meshletVertices) &&
+                reader.read(scene.meshletTriangles) &&
+                reader.read(scene.skinningData) &&
+                reader.read(scene.materials) &&
+                reader.read(scene.images) &&
+                reader.read(scene.pixels) &&
+                reader.read(scene.nodes) &&
+                reader.read(scene.skeletons) &&
+                reader.read(scene.joints) &&
+                reader.read(scene.jointChildren) &&
+                reader.read(scene.animations) &&
+                reader.read(scene.tracks) &&
+                reader.read(scene.translationKeys) &&
+                reader.read(scene.rotationKeys) &&
+                reader.read(scene.scaleKeys) &&
+                reader.read(scene.keyTimes) &&
+                reader.read(scene.strings);
+        if (!complete) {
+            return std::nullopt;
+        }
+
+        // records index into the arrays above, a truncated or corrupted file must not reach the loaders
+        for (auto& mesh: scene.meshes) {
+            if (!Detail::isCookedRangeValid({mesh.firstPrimitive, mesh.primitiveCount}, scene.primitives.size())) {
+                return std::nullopt;
+            }
+        }
+        for (auto& primitive: scene.primitives) {
+            if (!Detail::isCookedRangeValid(primitive.vertices, scene.vertices.size()) ||
+                !Detail::isCookedRangeValid(primitive.indices, scene.indices.size()) ||
+                !Detail::isCookedRangeValid(primitive.skinningData, scene.skinningData.size()) ||
+                !Detail::isCookedRangeValid(primitive.lods, scene.lods.size()) ||
+                !Detail::isCookedRangeValid(primitive.meshlets, scene.meshlets.size()) ||
+                !Detail::isCookedRangeValid(primitive.meshletVertices, scene.meshletVertices.size()) ||
+                !Detail::isCookedRangeValid(primitive.meshletTriangles, scene.meshletTriangles.size()) ||
+                !Detail::isCookedReferenceValid(primitive.material, scene.materials.size())) {
+                return std::nullopt;
+            }
+            // both index the primitive's own vertices
+            if (!Detail::isCookedIndexDataValid(scene.slice(scene.indices, primitive.indices), primitive.vertices.count) ||
+                !Detail::isCookedIndexDataValid(scene.slice(scene.meshletVertices, primitive.meshletVertices), primitive.vertices.count)) {
+                return std::nullopt;
+            }
+            for (auto& lod: scene.slice(scene.lods, primitive.lods)) {
+                if (!Detail::isCookedRangeValid({lod.firstIndex, lod.indexCount}, primitive.indices.count)) {
+                    return std::nullopt;
+                }
+            }
+            for (auto& meshlet: scene.slice(scene.meshlets, primitive.meshlets)) {
+                if (!Detail::isCookedRangeValid({meshlet.vertexOffset, meshlet.vertexCount}, primitive.meshletVertices.count) ||
+                    !Detail::isCookedRangeValid({meshlet.triangleOffset, meshlet.triangleCount * 3ull}, primitive.meshletTriangles.count)) {
+                    return std::nullopt;
+                }
+            }
+        }
+        for (auto& material: scene.materials) {
+            for (auto texture: material.textures) {
+                if (!Detail::isCookedReferenceValid(texture, scene.images.size())) {
+                    return std::nullopt;
+                }
+            }
+        }
+        for (auto& image: scene.images) {
+            if (!Detail::isCookedRangeValid(image.pixels, scene.pixels.size()) ||
+                !Detail::isCookedRangeValid(image.path, scene.strings.size()) ||
+                (image.pixels.count != 0 && image.pixels.count != static_cast<uint64_t>(image.width) * image.height * 4)) {
+                return std::nullopt;
+            }
+        }
+        // nodes are instantiated into a pre-order hierarchy, a parent has to be the previous node or one of its ancestors
+        Vector<uint32_t> ancestors;
+        for (size_t i = 0; i < scene.nodes.size(); ++i) {
+            auto& node = scene.nodes[i];
+            if ((node.parent != NO_PARENT && node.parent >= i) ||
+                (node.mesh != NULL_SCENE_RESOURCE_INTERNAL_ID && node.mesh >= scene.meshes.size())) {
+                return std::nullopt;
+            }
+
+            while (!ancestors.empty() && ancestors.back() != node.parent) {
+                ancestors.pop_back();
+            }
+            if (node.parent != NO_PARENT && ancestors.empty()) {
+                return std::nullopt;
+            }
+            ancestors.push_back(static_cast<uint32_t>(i));
+        }
+        for (auto& skeleton: scene.skeletons) {
+            if (!Detail::isCookedRangeValid(skeleton.joints, scene.joints.size())) {
+                return std::nullopt;
+            }
+            for (auto& joint: scene.slice(scene.joints, skeleton.joints)) {
+                if (!Detail::isCookedRangeValid(joint.children, scene.jointChildren.size()) ||
+                    !Detail::isCookedRangeValid(joint.name, scene.strings.size())) {
+                    return std::nullopt;
+                }
+                for (auto child: scene.slice(scene.jointChildren, joint.children)) {
+                    if (child >= skeleton.joints.count) {
+                        return std::nullopt;
+                    }
+                }
+            }
+        }
+        for (auto& animation: scene.animations) {
+            if (!Detail::isCookedRangeValid(animation.tracks, scene.tracks.size()) ||
+                !Detail::isCookedRangeValid(animation.name, scene.strings.size())) {
+                return std::nullopt;
+            }
+            for (auto& track: scene.slice(scene.tracks, animation.tracks)) {
+                if (!Detail::isCookedKeyRangeValid(track.translations, scene.translationKeys.size(), scene.keyTimes.size()) ||
+                    !Detail::isCookedKeyRangeValid(track.rotations, scene.rotationKeys.size(), scene.keyTimes.size()) ||
+                    !Detail::isCookedKeyRangeValid(track.scales, scene.scaleKeys.size(), scene.keyTimes.size())) {
+                    return std::nullopt;
+                }
+            }
+        }
+
+        scene.m_data = std::move(data);
+        return scene;
+    }
+
+    VulkanSkeleton VulkanCookedScene::makeSkeleton(const Skeleton& skeleton) const {
+        auto cookedJoints = slice(joints, skeleton.joints);
+
+        VulkanSkeleton result{};
+        result.joints.reserve(cookedJoints.size());
+        result.inverseBindMatrices.reserve(cookedJoints.size());
+        result.jointNames.reserve(cookedJoints.size());
+        result.hierarchy.resize(cookedJoints.size());
+
+        for (JointId jointId = 0; jointId < cookedJoints.size(); ++jointId) {
+            const auto& joint = cookedJoints[jointId];
+            result.joints.push_back(VulkanSkeleton::Joint{
+                    .id = jointId,
+                    .localTransform = joint.localTransform,
+            });
+            result.inverseBindMatrices.push_back(joint.inverseBindMatrix);
+            result.jointNames.emplace_back(string(joint.name));
+
+            auto children = slice(jointChildren, joint.children);
+            result.hierarchy[jointId].children.assign(children.begin(), children.end());
+        }
+
+        return result;
+    }
+
+    VulkanSkeletonAnimation VulkanCookedScene::makeAnimation(const Animation& animation) const {
+        auto cookedTracks = slice(tracks, animation.tracks);
+
+        VulkanSkeletonAnimation result{};
+        result.name = String(string(animation.name));
+        result.tracks.resize(cookedTracks.size());
+
+        for (size_t i = 0; i < cookedTracks.size(); ++i) {
+            const auto& track = cookedTracks[i];
+            auto& outTrack = result.tracks[i];
+
+            Detail::assignCookedKeys(
+                    outTrack.translations, outTrack.keyTimes.translations,
+                    translationKeys, keyTimes, track.translations);
+            Detail::assignCookedKeys(
+                    outTrack.rotations, outTrack.keyTimes.rotations,
+                    rotationKeys, keyTimes, track.rotations);
+            Detail::assignCookedKeys(
+                    outTrack.scales, outTrack.keyTimes.scales,
+                    scaleKeys, keyTimes, track.scales);
+        }
+
+        return result;
+    }
+}// namespace moe
\ No newline at end of file
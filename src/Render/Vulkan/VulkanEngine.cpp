@@ -49,6 +49,7 @@ namespace moe {
         initSwapchain();
         initCommands();
         initSyncPrimitives();
+        initUploadManager();
         initDescriptors();
 
         initBindlessSet();
@@ -146,6 +147,9 @@ namespace moe {
             m_resizeRequested = false;
         }
 
+        // register finished async loads before anything is submitted for this frame
+        m_resourceLoader.update();
+
         // reset all shared dynamic states
         resetDynamicState();
 
@@ -170,6 +174,10 @@ namespace moe {
             m_imguiDrawQueue.pop();
         }
 
+        if (m_showMemoryOverlay) {
+            m_memoryTracker.drawOverlay(&m_showMemoryOverlay);
+        }
+
         ImGui::Render();
 
         draw();
@@ -191,7 +199,10 @@ namespace moe {
         auto commandSubmitInfo = VkInit::commandBufferSubmitInfo(commandBuffer);
         auto submitInfo = VkInit::submitInfo(&commandSubmitInfo, nullptr, nullptr);
 
-        MOE_VK_CHECK(vkQueueSubmit2(m_graphicsQueue, 1, &submitInfo, m_immediateModeFence));
+        {
+            std::lock_guard<std::mutex> queueLock(m_graphicsQueueMutex);
+            MOE_VK_CHECK(vkQueueSubmit2(m_graphicsQueue, 1, &submitInfo, m_immediateModeFence));
+        }
 
         MOE_VK_CHECK(vkWaitForFences(m_device, 1, &m_immediateModeFence, VK_TRUE, UINT64_MAX));
 
@@ -225,6 +236,12 @@ namespace moe {
                         &buffer.vmaAllocation,
                         &buffer.vmaAllocationInfo));
 
+        m_memoryTracker.trackAllocation(
+                buffer.vmaAllocation,
+                usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                        ? VulkanMemoryCategory::Staging
+                        : VulkanMemoryTracker::currentCategory());
+
         if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
             VkBufferDeviceAddressInfo deviceAddrInfo{};
             deviceAddrInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
@@ -254,6 +271,7 @@ namespace moe {
 
         MOE_VK_CHECK(
                 vmaCreateImage(g_engineInstance->m_allocator, &imageInfo, &allocInfo, &image.image, &image.vmaAllocation, nullptr));
+        m_memoryTracker.trackAllocation(image.vmaAllocation, VulkanMemoryTracker::currentCategory());
 
         VkImageViewCreateInfo imageViewInfo = VkInit::imageViewCreateInfo(image.imageFormat, image.image, aspect);
         imageViewInfo.subresourceRange.levelCount = imageInfo.mipLevels;
@@ -290,6 +308,7 @@ namespace moe {
 
         MOE_VK_CHECK(
                 vmaCreateImage(m_allocator, &imageInfo, &allocInfo, &image.image, &image.vmaAllocation, nullptr));
+        m_memoryTracker.trackAllocation(image.vmaAllocation, VulkanMemoryTracker::currentCategory());
 
         VkImageAspectFlags aspect =
                 format == VK_FORMAT_D32_SFLOAT
@@ -304,14 +323,35 @@ namespace moe {
     }
 
     VulkanAllocatedImage VulkanEngine::allocateImage(void* data, VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap) {
+        if (mipmap && extent.depth == 1 &&
+            (format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R8G8B8A8_UNORM)) {
+            // ! note: rgba8 mips are built on cpu, so srgb textures are filtered in linear space
+            auto mipChain = ImageKernels::buildMipChain(
+                    static_cast<const uint8_t*>(data),
+                    extent.width, extent.height,
+                    format == VK_FORMAT_R8G8B8A8_SRGB
+                            ? ImageKernels::ColorSpace::Srgb
+                            : ImageKernels::ColorSpace::Linear);
+            return allocateImage(mipChain, format, usage);
+        }
+
         size_t imageSize = extent.width * extent.height * extent.depth * VkUtils::getChannelsFromFormat(format);
-        VulkanAllocatedBuffer stagingBuffer = allocateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        std::memcpy(stagingBuffer.vmaAllocationInfo.pMappedData, data, imageSize);
 
         VulkanAllocatedImage image = allocateImage(
                 extent, format,
                 usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
                 mipmap);
+
+        if (!mipmap) {
+            VulkanUploadManager::ImageRegion region{0, 0, 0, extent};
+            m_uploadManager.uploadImage(image.image, 1, 1, data, imageSize, {&region, 1});
+            return image;
+        }
+
+        // ! mips of other formats are blitted on the graphics queue, which the upload manager does not do
+        VulkanAllocatedBuffer stagingBuffer = allocateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        std::memcpy(stagingBuffer.vmaAllocationInfo.pMappedData, data, imageSize);
+
         immediateSubmit([&](VkCommandBuffer cmd) {
             VkUtils::transitionImage(
                     cmd, image.image,
@@ -335,14 +375,7 @@ namespace moe {
                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                     1,
                     &copyRegion);
-            if (mipmap) {
-                VkUtils::generateMipmaps(cmd, image.image, VkExtent2D{extent.width, extent.height});
-            } else {
-                VkUtils::transitionImage(
-                        cmd, image.image,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-            }
+            VkUtils::generateMipmaps(cmd, image.image, VkExtent2D{extent.width, extent.height});
         });
 
         destroyBuffer(stagingBuffer);
@@ -350,6 +383,25 @@ namespace moe {
         return image;
     }
 
+    VulkanAllocatedImage VulkanEngine::allocateImage(const ImageKernels::MipChain& mipChain, VkFormat format, VkImageUsageFlags usage) {
+        MOE_ASSERT(!mipChain.levels.empty(), "Mip chain has no levels");
+        MOE_ASSERT(VkUtils::getBytesPerPixelFromFormat(format) == 4, "Mip chain upload expects 4 bytes per pixel");
+
+        const auto& baseLevel = mipChain.levels.front();
+        VkExtent3D extent{baseLevel.width, baseLevel.height, 1};
+
+        VkImageCreateInfo imageInfo = VkInit::imageCreateInfo(
+                format,
+                usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                extent);
+        imageInfo.mipLevels = static_cast<uint32_t>(mipChain.levels.size());
+        VulkanAllocatedImage image = allocateImage(imageInfo);
+
+        m_uploadManager.uploadImage(image.image, mipChain);
+
+        return image;
+    }
+
     VulkanAllocatedImage VulkanEngine::allocateCubeMapImage(VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap) {
         VkImageCreateInfo imageInfo = VkInit::imageCreateInfo(format, usage, extent);
         imageInfo.arrayLayers = 6;
@@ -372,6 +424,7 @@ namespace moe {
 
         MOE_VK_CHECK(
                 vmaCreateImage(m_allocator, &imageInfo, &allocInfo, &image.image, &image.vmaAllocation, nullptr));
+        m_memoryTracker.trackAllocation(image.vmaAllocation, VulkanMemoryTracker::currentCategory());
 
         VkImageAspectFlags aspect =
                 format == VK_FORMAT_D32_SFLOAT
@@ -486,137 +539,90 @@ namespace moe {
 
     void VulkanEngine::destroyImage(VulkanAllocatedImage& image) {
         vkDestroyImageView(m_device, image.imageView, nullptr);
+        m_memoryTracker.untrackAllocation(image.vmaAllocation);
         vmaDestroyImage(m_allocator, image.image, image.vmaAllocation);
     }
 
     void VulkanEngine::destroyBuffer(VulkanAllocatedBuffer& buffer) {
+        m_memoryTracker.untrackAllocation(buffer.vmaAllocation);
         vmaDestroyBuffer(m_allocator, buffer.buffer, buffer.vmaAllocation);
     }
 
-    VulkanGPUMeshBuffer VulkanEngine::uploadMesh(Span<uint32_t> indices, Span<Vertex> vertices, Span<SkinningData> skinningData) {
-        const size_t vertBufferSize = vertices.size() * sizeof(Vertex);
+    VulkanGPUMeshBuffer VulkanEngine::uploadMesh(
+            Span<const uint32_t> indices, Span<const Vertex> vertices,
+            Span<const SkinningData> skinningData, Span<const VulkanMeshLod> lods) {
+        // packed copies, the upload manager stages the data right away so they only live for this call
+        Vector<uint8_t> packedVertices;
+        Vector<PackedSkinningData> packedSkinningData;
+        const bool packed = m_vertexPackingEnabled && VertexPacking::canPack(vertices, skinningData);
+        if (packed) {
+            packedVertices = VertexPacking::packVertexBuffer(vertices);
+            packedSkinningData = VertexPacking::packSkinningBuffer(skinningData);
+        }
+
+        const void* vertData = packed ? static_cast<const void*>(packedVertices.data()) : vertices.data();
+        const void* skinningDataData = packed ? static_cast<const void*>(packedSkinningData.data()) : skinningData.data();
+
+        const size_t vertBufferSize = packed ? packedVertices.size() : vertices.size() * sizeof(Vertex);
+        const size_t skinnedVertBufferSize = vertices.size() * sizeof(Vertex);
         const size_t indexBufferSize = indices.size() * sizeof(uint32_t);
-        const size_t skinningDataBufferSize = skinningData.size() * sizeof(SkinningData);
+        const size_t skinningDataBufferSize =
+                skinningData.size() * (packed ? sizeof(PackedSkinningData) : sizeof(SkinningData));
 
         VulkanGPUMeshBuffer surface;
-        surface.indexCount = static_cast<uint32_t>(indices.size());
         surface.vertexCount = static_cast<uint32_t>(vertices.size());
+        surface.vertexFormat = packed ? VulkanVertexFormat::Packed : VulkanVertexFormat::Full;
 
-        surface.vertexBuffer = allocateBuffer(
-                vertBufferSize,
-                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                        VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-                        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                VMA_MEMORY_USAGE_GPU_ONLY);
-
-        {
-            VkBufferDeviceAddressInfo deviceAddrInfo{};
-            deviceAddrInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-            deviceAddrInfo.buffer = surface.vertexBuffer.buffer;
-
-            surface.vertexBufferAddr = vkGetBufferDeviceAddress(m_device, &deviceAddrInfo);
+        if (lods.empty()) {
+            surface.lods[0] = {0, static_cast<uint32_t>(indices.size()), 0.0f};
+            surface.lodCount = 1;
+        } else {
+            if (lods.size() > MAX_MESH_LODS) {
+                Logger::warn("Mesh has {} lods, only the first {} are kept", lods.size(), MAX_MESH_LODS);
+            }
+            surface.lodCount = static_cast<uint32_t>(std::min<size_t>(lods.size(), MAX_MESH_LODS));
+            std::copy_n(lods.begin(), surface.lodCount, surface.lods.begin());
         }
-
-        surface.indexBuffer = allocateBuffer(
-                indexBufferSize,
-                VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
-                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                VMA_MEMORY_USAGE_GPU_ONLY);
+        surface.indexCount = surface.lods[0].indexCount;
 
         bool hasSkinningData = !skinningData.empty();
         surface.hasSkinningData = hasSkinningData;
 
-        size_t stagingBufferSize = 0;
+        surface.vertexAllocation = m_geometryArena.allocate(VulkanGeometryPool::Vertex, vertBufferSize);
+        surface.vertexBufferAddr = m_geometryArena.getAddress(surface.vertexAllocation);
+
+        surface.indexAllocation = m_geometryArena.allocate(VulkanGeometryPool::Index, indexBufferSize);
+        if (surface.indexAllocation.isValid()) {
+            surface.indexBuffer = m_geometryArena.getBuffer(surface.indexAllocation);
+            surface.firstIndex = VulkanGeometryArena::getFirstIndex(surface.indexAllocation);
+        }
 
         if (hasSkinningData) {
             Logger::info("Mesh has skinning data, size {} bytes", skinningDataBufferSize);
 
             // no need to initialize skinned vertex buffer here, will be done in skinning pipeline
-            stagingBufferSize = indexBufferSize + vertBufferSize + skinningDataBufferSize;
-
-            surface.skinningDataBuffer = allocateBuffer(
-                    skinningDataBufferSize,
-                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                            VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-                            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                    VMA_MEMORY_USAGE_GPU_ONLY);
-            {
-                VkBufferDeviceAddressInfo deviceAddrInfo{};
-                deviceAddrInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-                deviceAddrInfo.buffer = surface.skinningDataBuffer.buffer;
-                surface.skinningDataBufferAddr = vkGetBufferDeviceAddress(m_device, &deviceAddrInfo);
-            }
+            surface.skinningDataAllocation = m_geometryArena.allocate(VulkanGeometryPool::Vertex, skinningDataBufferSize);
+            surface.skinningDataBufferAddr = m_geometryArena.getAddress(surface.skinningDataAllocation);
 
-            surface.skinnedVertexBuffer = allocateBuffer(
-                    vertBufferSize,
-                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                            VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-                            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                    VMA_MEMORY_USAGE_GPU_ONLY);
-            {
-                VkBufferDeviceAddressInfo deviceAddrInfo{};
-                deviceAddrInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-                deviceAddrInfo.buffer = surface.skinnedVertexBuffer.buffer;
-                surface.skinnedVertexBufferAddr = vkGetBufferDeviceAddress(m_device, &deviceAddrInfo);
-            }
+            surface.skinnedVertexAllocation = m_geometryArena.allocate(VulkanGeometryPool::Vertex, skinnedVertBufferSize);
+            surface.skinnedVertexBufferAddr = m_geometryArena.getAddress(surface.skinnedVertexAllocation);
         } else {
-            stagingBufferSize = indexBufferSize + vertBufferSize;
-
-            surface.skinningDataBuffer = {};
             surface.skinningDataBufferAddr = 0;
-
-            surface.skinnedVertexBuffer = {};
             surface.skinnedVertexBufferAddr = 0;
         }
 
-        VulkanAllocatedBuffer stagingBuffer = allocateBuffer(
-                stagingBufferSize,
-                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                VMA_MEMORY_USAGE_CPU_ONLY);
-
-        void* data = stagingBuffer.vmaAllocationInfo.pMappedData;
-
-        std::memcpy(data, vertices.data(), vertBufferSize);
-        std::memcpy(static_cast<uint8_t*>(data) + vertBufferSize,
-                    indices.data(), indexBufferSize);
-
-        if (hasSkinningData) {
-            std::memcpy(static_cast<uint8_t*>(data) + vertBufferSize + indexBufferSize,
-                        skinningData.data(), skinningDataBufferSize);
+        // ! note: queued, not waited on. the next draw() submits every queued upload in m_uploadManager.update()
+        // ! before recording, with a barrier (or the acquire barriers and the timeline wait on a transfer queue)
+        // ! ahead of every read; meshes are registered on the main thread between frames, so none is drawn earlier
+        if (surface.vertexAllocation.isValid()) {
+            m_geometryArena.upload(surface.vertexAllocation, vertData, vertBufferSize);
+        }
+        if (surface.indexAllocation.isValid()) {
+            m_geometryArena.upload(surface.indexAllocation, indices.data(), indexBufferSize);
+        }
+        if (surface.skinningDataAllocation.isValid()) {
+            m_geometryArena.upload(surface.skinningDataAllocation, skinningDataData, skinningDataBufferSize);
         }
-
-        immediateSubmit([&, hasSkinningData](VkCommandBuffer cmdBuffer) {
-            VkBufferCopy vertCopy{};
-            vertCopy.srcOffset = 0;
-            vertCopy.dstOffset = 0;
-            vertCopy.size = vertBufferSize;
-
-            vkCmdCopyBuffer(cmdBuffer,
-                            stagingBuffer.buffer, surface.vertexBuffer.buffer,
-                            1, &vertCopy);
-
-            VkBufferCopy indexCopy{};
-            indexCopy.srcOffset = vertBufferSize;
-            indexCopy.dstOffset = 0;
-            indexCopy.size = indexBufferSize;
-
-            vkCmdCopyBuffer(cmdBuffer,
-                            stagingBuffer.buffer, surface.indexBuffer.buffer,
-                            1, &indexCopy);
-
-            if (hasSkinningData) {
-                VkBufferCopy skinningCopy{};
-                skinningCopy.srcOffset = vertBufferSize + indexBufferSize;
-                skinningCopy.dstOffset = 0;
-                skinningCopy.size = skinningDataBufferSize;
-
-                vkCmdCopyBuffer(cmdBuffer,
-                                stagingBuffer.buffer, surface.skinningDataBuffer.buffer,
-                                1, &skinningCopy);
-            }
-        });
-
-        destroyBuffer(stagingBuffer);
 
         return surface;
     }
@@ -633,7 +639,11 @@ namespace moe {
                         VkUtils::secsToNanoSecs(1.0f)),
                 "Failed to wait for fence");
 
+        // rewrites this frame's bindless slots before the images they pointed at are destroyed below
+        m_bindlessSet.beginFrame(currentFrameIndex);
         currentFrame.deletionQueue.flush();
+        m_geometryArena.update();
+        m_parallelRecorder.beginFrame(currentFrameIndex);
 
         currentFrame.descriptorAllocator.clearPools(m_device);
 
@@ -668,6 +678,11 @@ namespace moe {
 
         MOE_VK_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
 
+        // ! make finished uploads visible before anything reads them
+        m_uploadManager.update(commandBuffer);
+        // compacts the geometry arena after unloads, before this frame's draws record the new ranges
+        m_caches.meshCache.update(commandBuffer);
+
         // ! begin skinning. as we need to upload joint matrices from cpu to gpu, we do it first.
         m_pipelines.skinningPipeline.beginFrame(currentFrameIndex);
 
@@ -684,7 +699,9 @@ namespace moe {
 
             auto renderable = m_caches.objectCache.get(command.renderableId);
             if (!renderable.has_value()) {
-                Logger::warn("Renderable with id {} not found in cache", command.renderableId);
+                if (!m_caches.objectCache.isPending(command.renderableId)) {
+                    Logger::warn("Renderable with id {} not found in cache", command.renderableId);
+                }
                 continue;
             }
 
@@ -731,30 +748,91 @@ namespace moe {
         renderTarget.resetDynamicState();
         auto& packets = renderTarget.renderPackets;
 
-        static constexpr size_t MAX_EXPECTED_RENDER_PACKETS = 2048;
-        if (packets.size() > MAX_EXPECTED_RENDER_PACKETS) {
-            Logger::warn("Render packets size {} exceeds max expected {}, is this normal or is the packets vector not cleared properly?",
-                         packets.size(), MAX_EXPECTED_RENDER_PACKETS);
-        }
+        m_lodSelector.update(m_caches.meshCache, getDefaultCamera(), m_drawExtent);
 
-        for (auto& renderCommands: m_renderBus.getRenderCommands()) {
-            auto id = renderCommands.renderableId;
-            if (auto renderable = m_caches.objectCache.get(id)) {
-                // todo: upload skeleton matrices if present, and set the values in render packets
-                size_t offset = INVALID_JOINT_MATRIX_START_INDEX;
-                if (renderCommands.computeHandle != NULL_COMPUTE_SKIN_HANDLE_ID) {
-                    offset = m_renderBus.getComputeSkinMatrix(renderCommands.computeHandle);
-                }
-                VulkanDrawContext ctx = NULL_DRAW_CONTEXT;
-                ctx.jointMatrixStartIndex = offset;
-                renderable->get()->updateTransform(renderCommands.transform.getMatrix());
-                renderable->get()->gatherRenderPackets(packets, ctx);
-            } else {
-                Logger::warn("Renderable with id {} not found in cache", id);
-                continue;
+        // gathered on the workers in chunks of commands, the packets still come out in command order
+        auto& renderCommands = m_renderBus.getRenderCommands();
+        m_packetGatherer.countSubmissions(
+                renderCommands.size(),
+                [&](size_t index) { return renderCommands[index].renderableId; });
+
+        // once per renderable however many instances it has, the gather below only reads the world matrices.
+        // large hierarchies spread their update over the workers themselves
+        for (const auto id: m_packetGatherer.getSubmittedRenderables()) {
+            if (auto renderable = m_caches.objectCache.getRaw(id)) {
+                renderable.value()->updateTransforms();
             }
         }
 
+        m_packetGatherer.gather(
+                renderCommands.size(),
+                [&](size_t index, VulkanPacketGatherer::Output& output) {
+                    const auto& renderCommand = renderCommands[index];
+                    auto id = renderCommand.renderableId;
+                    auto renderable = m_caches.objectCache.getRaw(id);
+                    if (!renderable) {
+                        if (!m_caches.objectCache.isPending(id)) {
+                            Logger::warn("Renderable with id {} not found in cache", id);
+                        }
+                        return;
+                    }
+
+                    // todo: upload skeleton matrices if present, and set the values in render packets
+                    size_t offset = INVALID_JOINT_MATRIX_START_INDEX;
+                    if (renderCommand.computeHandle != NULL_COMPUTE_SKIN_HANDLE_ID) {
+                        offset = m_renderBus.getComputeSkinMatrix(renderCommand.computeHandle);
+                    }
+                    VulkanDrawContext ctx = NULL_DRAW_CONTEXT;
+                    ctx.transform = renderCommand.transform.getMatrix();
+                    ctx.jointMatrixStartIndex = offset;
+                    ctx.lodSelector = &m_lodSelector;
+                    ctx.lodStats = &output.lodStats;
+                    ctx.instanced = m_packetGatherer.getSubmissionCount(id) > 1;
+
+                    renderable.value()->gatherRenderPackets(output.packets, ctx);
+                },
+                packets,
+                &m_lodSelector);
+
+        auto& gpuScene = m_pipelines.gpuScene;
+        const bool gpuDriven = gpuScene.isEnabled();
+
+        // only the camera passes draw the visible prefix, shadow casters and skinning still see every packet.
+        // the gpu driven path culls and orders its draws on the gpu, the packets stay as gathered
+        m_frustumCuller.update(getDefaultCamera(), m_drawExtent);
+        size_t visiblePacketCount = packets.size();
+        if (!gpuDriven) {
+            visiblePacketCount = m_frustumCuller.cull(m_caches.meshCache, packets);
+
+            // occluded packets join the culled tail, they may still cast visible shadows
+            m_occlusionCuller.update(getDefaultCamera(), m_drawExtent);
+            visiblePacketCount = m_occlusionCuller.cull(m_caches.meshCache, packets, visiblePacketCount);
+
+            // both halves are sorted on their own, the culled tail is still drawn into the shadow cascades
+            m_packetSorter.update(getDefaultCamera());
+            m_packetSorter.sort(Span<VulkanRenderPacket>(packets.data(), visiblePacketCount));
+            m_packetSorter.sort(Span<VulkanRenderPacket>(packets.data() + visiblePacketCount, packets.size() - visiblePacketCount));
+        }
+
+        // packets keep this order from here on, instance i is packet i
+        m_pipelines.instanceBuffer.update(packets, currentFrameIndex);
+        if (gpuDriven) {
+            gpuScene.update(commandBuffer, m_caches.meshCache, packets, currentFrameIndex);
+        }
+
+        // ! texture streaming, residency changes are recorded ahead of every pass that samples them
+        {
+            // budget handlers (e.g. the streamer's) react in the update below
+            m_memoryTracker.update();
+
+            auto& streamer = m_caches.imageCache.getStreamer();
+            streamer.gatherFeedback(
+                    packets,
+                    m_caches.meshCache, m_caches.materialCache,
+                    getDefaultCamera(), m_drawExtent);
+            streamer.update(commandBuffer, currentFrame.deletionQueue);
+        }
+
         // ! compute
 
         {
@@ -805,8 +883,10 @@ namespace moe {
                 commandBuffer,
                 m_caches.meshCache,
                 packets,
+                m_pipelines.instanceBuffer.getAddress(),
                 defaultCamera,
-                m_illuminationBus.getSunlight().direction);
+                m_illuminationBus.getSunlight().direction,
+                &gpuScene);
 
         // ! initialize scene data
 
@@ -862,11 +942,21 @@ namespace moe {
                     VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
         }
 
+        if (gpuDriven) {
+            gpuScene.cull(
+                    commandBuffer, VulkanGPUScene::CAMERA_VIEW,
+                    m_pipelines.instanceBuffer.getAddress(),
+                    m_frustumCuller.getFrustum());
+        }
+
         // todo: sync with last read
         m_pipelines.gBufferPipeline.draw(
                 commandBuffer,
                 m_caches.meshCache, m_caches.materialCache,
-                packets, m_pipelines.sceneDataBuffer.getBuffer());
+                Span<VulkanRenderPacket>(packets.data(), visiblePacketCount),
+                m_pipelines.sceneDataBuffer.getBuffer(),
+                m_pipelines.instanceBuffer.getAddress(),
+                &gpuScene);
 
         auto clearColor = renderView.clearColor;
         VkClearValue clearValue = {
@@ -1019,6 +1109,16 @@ namespace moe {
                         VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT);
 
         VkSubmitInfo2 submitInfo2 = VkInit::submitInfo(&submitInfo, &waitInfo, &signalInfo);
+
+        // uploads acquired at the top of the frame must have left the transfer queue
+        Array<VkSemaphoreSubmitInfo, 2> waitInfos{waitInfo};
+        if (auto uploadWait = m_uploadManager.getFrameWait()) {
+            waitInfos[1] = *uploadWait;
+            submitInfo2.pWaitSemaphoreInfos = waitInfos.data();
+            submitInfo2.waitSemaphoreInfoCount = 2;
+        }
+
+        std::unique_lock<std::mutex> queueLock(m_graphicsQueueMutex);
         MOE_VK_CHECK(vkQueueSubmit2(m_graphicsQueue, 1, &submitInfo2, currentFrame.inFlightFence));
 
         VkPresentInfoKHR presentInfo{};
@@ -1034,6 +1134,8 @@ namespace moe {
         presentInfo.pImageIndices = &swapchainImageIndex;
 
         VkResult presentResult = vkQueuePresentKHR(m_graphicsQueue, &presentInfo);
+        queueLock.unlock();
+
         if (presentResult == VK_ERROR_OUT_OF_DATE_KHR) {
             // ! note that with resize event hooked, no need to set resize flag here.
             Logger::warn("vkQueuePresentKHR returned VK_ERROR_OUT_OF_DATE_KHR, forcing resize.");
@@ -1242,6 +1344,8 @@ namespace moe {
         VkPhysicalDeviceFeatures vkPhysicalDeviceFeatures = {
                 .imageCubeArray = VK_TRUE,
                 .geometryShader = VK_TRUE,
+                .multiDrawIndirect = VK_TRUE,
+                .drawIndirectFirstInstance = VK_TRUE,
                 .depthClamp = VK_TRUE,
                 .samplerAnisotropy = VK_TRUE,
                 .shaderStorageImageMultisample = VK_TRUE,
@@ -1255,6 +1359,8 @@ namespace moe {
 
         VkPhysicalDeviceVulkan12Features vkPhysicalDeviceVulkan12Features = {
                 .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+                // gpu driven draws
+                .drawIndirectCount = VK_TRUE,
                 .descriptorIndexing = VK_TRUE,
                 // used for bindless descriptors
                 .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
@@ -1263,6 +1369,7 @@ namespace moe {
                 .descriptorBindingVariableDescriptorCount = VK_TRUE,
                 .runtimeDescriptorArray = VK_TRUE,
                 .scalarBlockLayout = VK_TRUE,
+                .timelineSemaphore = VK_TRUE,
                 .bufferDeviceAddress = VK_TRUE,
         };
 
@@ -1286,6 +1393,8 @@ namespace moe {
 
         Logger::info("Using GPU: {}", vkbPhysicalDevice.properties.deviceName);
 
+        bool memoryBudgetSupported = vkbPhysicalDevice.enable_extension_if_present(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
         vkb::DeviceBuilder deviceBuilder{vkbPhysicalDevice};
         auto deviceResult = deviceBuilder.build();
 
@@ -1300,12 +1409,22 @@ namespace moe {
         m_graphicsQueue = deviceResult->get_queue(vkb::QueueType::graphics).value();
         m_graphicsQueueFamilyIndex = deviceResult->get_queue_index(vkb::QueueType::graphics).value();
 
+        if (auto transferQueue = deviceResult->get_dedicated_queue(vkb::QueueType::transfer)) {
+            m_transferQueue = transferQueue.value();
+            m_transferQueueFamilyIndex = deviceResult->get_dedicated_queue_index(vkb::QueueType::transfer).value();
+            Logger::info("Found dedicated transfer queue family {}", m_transferQueueFamilyIndex);
+        }
+
         Logger::info("Creating VMA instance...");
         VmaAllocatorCreateInfo allocatorInfo{};
         allocatorInfo.physicalDevice = m_physicalDevice;
         allocatorInfo.device = m_device;
         allocatorInfo.instance = m_instance;
         allocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        if (memoryBudgetSupported) {
+            // without it vma estimates the budget from the heap sizes
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
 
         // pass in necessary function ptrs
         VmaVulkanFunctions vulkanFunctions{};
@@ -1318,6 +1437,11 @@ namespace moe {
         m_mainDeletionQueue.pushFunction([&] {
             vmaDestroyAllocator(m_allocator);
         });
+
+        m_memoryTracker.init(*this);
+        m_mainDeletionQueue.pushFunction([&] {
+            m_memoryTracker.destroy();
+        });
     }
 
     void VulkanEngine::initImGUI() {
@@ -1476,6 +1600,12 @@ namespace moe {
         m_mainDeletionQueue.pushFunction([=] {
             vkDestroyCommandPool(m_device, m_immediateModeCommandPool, nullptr);
         });
+
+        // secondary command buffers recorded on the thread pool
+        m_parallelRecorder.init(*this);
+        m_mainDeletionQueue.pushFunction([&] {
+            m_parallelRecorder.destroy();
+        });
     }
 
     void VulkanEngine::initSyncPrimitives() {
@@ -1505,7 +1635,16 @@ namespace moe {
         });
     }
 
+    void VulkanEngine::initUploadManager() {
+        m_uploadManager.init(*this);
+        m_mainDeletionQueue.pushFunction([&] {
+            m_uploadManager.destroy();
+        });
+    }
+
     void VulkanEngine::initCaches() {
+        m_geometryArena.init(*this);
+
         m_caches.imageCache.init(*this);
         m_caches.meshCache.init(*this);
         m_caches.materialCache.init(*this);
@@ -1515,6 +1654,8 @@ namespace moe {
             m_caches.meshCache.destroy();
             m_caches.imageCache.destroy();
 
+            m_geometryArena.destroy();
+
             m_caches.fontCache.destroy();
         });
     }
@@ -1562,6 +1703,9 @@ namespace moe {
         m_illuminationBus.init(*this);
         m_renderBus.init(*this);
         m_resourceLoader.init(*this);
+        m_mainDeletionQueue.pushFunction([&] {
+            m_resourceLoader.destroy();
+        });
 
         m_pipelines.skinningPipeline.init(*this);
         //m_pipelines.meshPipeline.init(*this);
@@ -1607,9 +1751,13 @@ namespace moe {
                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                 sizeof(VulkanGPUSceneData),
                 FRAMES_IN_FLIGHT);
+        m_pipelines.instanceBuffer.init(*this);
+        m_pipelines.gpuScene.init(*this);
 
         m_mainDeletionQueue.pushFunction([&] {
             m_pipelines.sceneDataBuffer.destroy();
+            m_pipelines.instanceBuffer.destroy();
+            m_pipelines.gpuScene.destroy();
 
             m_pipelines.postFxGraph.destroy();
 
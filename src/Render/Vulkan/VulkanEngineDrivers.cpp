@@ -7,8 +7,33 @@ namespace moe {
     constexpr uint32_t BUS_LIGHT_WARNING_LIMIT = 128;
 
     RenderableId VulkanLoader::load(StringView path, Loader::GltfT) {
+        return load(path, VkLoaders::GLTF::SceneLoadOptions{}, Loader::Gltf);
+    }
+
+    RenderableId VulkanLoader::load(StringView path, const VkLoaders::GLTF::SceneLoadOptions& options, Loader::GltfT) {
+        MOE_ASSERT(m_engine, "VulkanLoader not initialized");
+        return m_engine->m_caches.objectCache.load(m_engine, path, ObjectLoader::Gltf, options).first;
+    }
+
+    Pair<RenderableId, VulkanLoader::RenderableFuture> VulkanLoader::load(StringView path, Loader::GltfAsyncT) {
+        return load(path, VkLoaders::GLTF::SceneLoadOptions{}, Loader::GltfAsync);
+    }
+
+    Pair<RenderableId, VulkanLoader::RenderableFuture> VulkanLoader::load(
+            StringView path, const VkLoaders::GLTF::SceneLoadOptions& options, Loader::GltfAsyncT) {
         MOE_ASSERT(m_engine, "VulkanLoader not initialized");
-        return m_engine->m_caches.objectCache.load(m_engine, path, ObjectLoader::Gltf).first;
+
+        auto promise = std::make_shared<Promise<RenderableId, ThreadPoolScheduler>>();
+        auto future = promise->getFuture();
+
+        RenderableId id = m_engine->m_caches.objectCache.reserve();
+        m_pendingLoads.push_back({
+                id,
+                VkLoaders::GLTF::loadSceneFromFileAsync(*m_engine, path, options),
+                std::move(promise),
+        });
+
+        return {id, std::move(future)};
     }
 
     ImageId VulkanLoader::load(StringView path, Loader::ImageT) {
@@ -40,6 +65,49 @@ namespace moe {
         return m_engine->m_caches.fontCache.load(std::move(font)).first;
     }
 
+    bool VulkanLoader::isPending(RenderableId id) const {
+        MOE_ASSERT(m_engine, "VulkanLoader not initialized");
+        return m_engine->m_caches.objectCache.isPending(id);
+    }
+
+    void VulkanLoader::update() {
+        MOE_ASSERT(m_engine, "VulkanLoader not initialized");
+
+        for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end();) {
+            auto result = VkLoaders::GLTF::pollSceneLoad(*m_engine, it->load);
+            if (result.status == VkLoaders::GLTF::SceneLoadResult::Status::Pending) {
+                ++it;
+                continue;
+            }
+
+            finishLoad(*it, std::move(result));
+            it = m_pendingLoads.erase(it);
+        }
+    }
+
+    void VulkanLoader::destroy() {
+        for (auto& pending: m_pendingLoads) {
+            finishLoad(pending, VkLoaders::GLTF::pollSceneLoad(*m_engine, pending.load, true));
+        }
+        m_pendingLoads.clear();
+
+        m_engine = nullptr;
+    }
+
+    void VulkanLoader::finishLoad(PendingLoad& pending, VkLoaders::GLTF::SceneLoadResult&& result) {
+        auto& objectCache = m_engine->m_caches.objectCache;
+        if (result.status != VkLoaders::GLTF::SceneLoadResult::Status::Loaded) {
+            // the placeholder id is given back, the future resolves to NULL_RENDERABLE_ID
+            Logger::error("{}", result.error);
+            objectCache.leak(pending.id);
+            pending.promise->setValue(NULL_RENDERABLE_ID);
+            return;
+        }
+
+        objectCache.emplace(pending.id, std::make_shared<VulkanScene>(std::move(*result.scene)));
+        pending.promise->setValue(pending.id);
+    }
+
     void VulkanIlluminationBus::init(VulkanEngine& engine) {
         m_engine = &engine;
 
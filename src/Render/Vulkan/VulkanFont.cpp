@@ -128,6 +128,7 @@ namespace moe {
         loadFontInternal(face, defaultGlyphRange);
 
         // create GPU image for this face
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Font);
         face.fontImageBufferGPU.init(*m_engine,
                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                                      static_cast<size_t>(face.fontImageBufferCPU->widthInPixels * face.fontImageBufferCPU->heightInPixels),
@@ -189,6 +190,7 @@ namespace moe {
         if (!loadFontInternal(face, defaultGlyphRange)) return false;
 
         // create GPU image for this face
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Font);
         face.fontImageBufferGPU.init(*m_engine,
                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                                      static_cast<size_t>(face.fontImageBufferCPU->widthInPixels * face.fontImageBufferCPU->heightInPixels),
@@ -0,0 +1,95 @@
+#include "Render/Vulkan/VulkanFrustumCuller.hpp"
+#include "Render/Vulkan/VulkanCamera.hpp"
+#include "Render/Vulkan/VulkanMeshCache.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+
+namespace moe {
+    void VulkanFrustumCuller::update(const VulkanCamera& camera, VkExtent2D viewportExtent) {
+        const float aspect = static_cast<float>(viewportExtent.width) / static_cast<float>(viewportExtent.height);
+        m_frustum = Frustum::fromViewProjection(camera.projectionMatrix(aspect) * camera.viewMatrix());
+
+        m_stats = {};
+    }
+
+    size_t VulkanFrustumCuller::cull(const VulkanMeshCache& meshCache, Vector<VulkanRenderPacket>& packets) {
+        const size_t count = packets.size();
+        m_stats.packets = count;
+        if (!m_enabled || count == 0) {
+            return count;
+        }
+
+        m_boxes.resize(count);
+        m_visible.resize(count);
+
+        std::atomic_size_t culled{0};
+        std::atomic_size_t unbounded{0};
+
+        const size_t chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        parallelForInline(chunkCount, [&](size_t chunk) {
+            const size_t begin = chunk * CHUNK_SIZE;
+            const size_t end = std::min(begin + CHUNK_SIZE, count);
+
+            // packets without usable bounds get an empty box and are forced visible after the test
+            uint8_t forceVisible[CHUNK_SIZE];
+            size_t chunkUnbounded = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const auto& packet = packets[i];
+                const auto* mesh = packet.skinned ? nullptr : meshCache.findMesh(packet.meshId);
+
+                auto& box = m_boxes[i];
+                if (mesh) {
+                    box.center = (mesh->min + mesh->max) * 0.5f;
+                    box.extent = (mesh->max - mesh->min) * 0.5f;
+                    forceVisible[i - begin] = 0;
+                } else {
+                    box.center = glm::vec3(0.0f);
+                    box.extent = glm::vec3(0.0f);
+                    forceVisible[i - begin] = 1;
+                    chunkUnbounded++;
+                }
+            }
+
+            FrustumKernels::cullBoxes(
+                    m_frustum,
+                    reinterpret_cast<const uint8_t*>(&packets[begin].transform), sizeof(VulkanRenderPacket),
+                    m_boxes.data() + begin, m_visible.data() + begin, end - begin);
+
+            size_t chunkCulled = 0;
+            for (size_t i = begin; i < end; ++i) {
+                m_visible[i] |= forceVisible[i - begin];
+                chunkCulled += m_visible[i] ? 0 : 1;
+            }
+
+            culled.fetch_add(chunkCulled, std::memory_order_relaxed);
+            unbounded.fetch_add(chunkUnbounded, std::memory_order_relaxed);
+        });
+
+        m_stats.culledPackets = culled.load();
+        m_stats.unboundedPackets = unbounded.load();
+        if (m_stats.culledPackets == 0) {
+            return count;
+        }
+
+        // stable partition, visible packets keep the order they were gathered in
+        m_culled.clear();
+        size_t visibleCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (m_visible[i]) {
+                if (visibleCount != i) {
+                    packets[visibleCount] = packets[i];
+                }
+                visibleCount++;
+            } else {
+                m_culled.push_back(packets[i]);
+            }
+        }
+        std::copy(m_culled.begin(), m_culled.end(), packets.begin() + visibleCount);
+
+        return visibleCount;
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,403 @@
+#include "Render/Vulkan/VulkanGPUScene.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanInitializers.hpp"
+#include "Render/Vulkan/VulkanInstanceBuffer.hpp"
+#include "Render/Vulkan/VulkanMeshCache.hpp"
+#include "Render/Vulkan/VulkanPipeline.hpp"
+#include "Render/Vulkan/VulkanUtils.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+
+namespace moe {
+    namespace Detail {
+        static constexpr uint32_t CULL_WORKGROUP_SIZE = 64;
+        static constexpr uint32_t MAX_REGIONS = VulkanGPUScene::MAX_VIEWS * VulkanGeometryArena::MAX_BLOCKS;
+
+        // shaders/slang/moe/gpu_scene.slang and moe/instance.slang, compiled with scalar layout
+        static_assert(sizeof(VulkanGPUMeshRecord) == 120, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, skinnedVertexBufferAddr) == 8, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, boundsCenter) == 16, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, vertexFormat) == 28, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, boundsExtent) == 32, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, lodCount) == 44, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, lods) == 48, "VulkanGPUMeshRecord must match GPUMesh");
+        static_assert(offsetof(VulkanGPUMeshRecord, indexBlock) == 112, "VulkanGPUMeshRecord must match GPUMesh");
+
+        static_assert(sizeof(VulkanGPUObjectData) == 16, "VulkanGPUObjectData must match GPUObject");
+        static_assert(offsetof(VulkanGPUObjectData, flags) == 12, "VulkanGPUObjectData must match GPUObject");
+
+        static_assert(sizeof(VulkanGPUCullView) == 112, "VulkanGPUCullView must match GPUCullView");
+        static_assert(offsetof(VulkanGPUCullView, minRadius) == 96, "VulkanGPUCullView must match GPUCullView");
+
+        static_assert(sizeof(VulkanGPUInstanceData) == 128, "VulkanGPUInstanceData must match InstanceData");
+
+        // the cull shader writes GPUDrawCommand, the draw reads it as VkDrawIndexedIndirectCommand
+        static_assert(sizeof(VkDrawIndexedIndirectCommand) == 20, "GPUDrawCommand must match VkDrawIndexedIndirectCommand");
+        static_assert(offsetof(VkDrawIndexedIndirectCommand, vertexOffset) == 12, "GPUDrawCommand must match VkDrawIndexedIndirectCommand");
+        static_assert(offsetof(VkDrawIndexedIndirectCommand, firstInstance) == 16, "GPUDrawCommand must match VkDrawIndexedIndirectCommand");
+
+        static void transferBarrier(VkCommandBuffer cmdBuffer) {
+            const auto barrier = VkMemoryBarrier2{
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                    .srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                    .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    .dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+            };
+            const auto dependencyInfo = VkDependencyInfo{
+                    .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .memoryBarrierCount = 1,
+                    .pMemoryBarriers = &barrier,
+            };
+            vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+        }
+    }// namespace Detail
+
+    void VulkanGPUScene::init(VulkanEngine& engine) {
+        MOE_ASSERT(!m_initialized, "VulkanGPUScene already initialized");
+
+        // CullPCS in shaders/slang/gpu_cull.slang
+        static_assert(sizeof(PushConstants) == 64, "PushConstants must match CullPCS");
+        static_assert(offsetof(PushConstants, drawCountBufferAddr) == 40, "PushConstants must match CullPCS");
+        static_assert(offsetof(PushConstants, viewIndex) == 48, "PushConstants must match CullPCS");
+        static_assert(offsetof(PushConstants, blockCount) == 60, "PushConstants must match CullPCS");
+
+        m_engine = &engine;
+
+        auto shader = VkUtils::createShaderModuleFromFile(engine.m_device, "shaders/gpu_cull.comp.spv");
+
+        auto pushRange = VkPushConstantRange{
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0,
+                .size = sizeof(PushConstants),
+        };
+
+        auto pushRanges = Array<VkPushConstantRange, 1>{pushRange};
+        auto pipelineLayoutInfo = VkInit::pipelineLayoutCreateInfo({}, pushRanges);
+        MOE_VK_CHECK(vkCreatePipelineLayout(engine.m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout));
+
+        auto builder = VulkanComputePipelineBuilder{m_pipelineLayout};
+        builder.setShader(shader);
+        m_pipeline = builder.build(engine.m_device);
+
+        vkDestroyShaderModule(engine.m_device, shader, nullptr);
+
+        m_frames.resize(FRAMES_IN_FLIGHT);
+        for (auto& frame: m_frames) {
+            VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Dynamic);
+            frame.views = engine.allocateBuffer(
+                    MAX_VIEWS * sizeof(VulkanGPUCullView),
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                    VMA_MEMORY_USAGE_CPU_TO_GPU);
+            frame.drawCounts = engine.allocateBuffer(
+                    Detail::MAX_REGIONS * sizeof(uint32_t),
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                            VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                    VMA_MEMORY_USAGE_GPU_ONLY);
+            reserveFrame(frame, INITIAL_OBJECT_CAPACITY, 1);
+        }
+
+        reserveMeshes(INITIAL_MESH_CAPACITY);
+
+        m_initialized = true;
+    }
+
+    void VulkanGPUScene::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanGPUScene not initialized");
+
+        for (auto& frame: m_frames) {
+            m_engine->destroyBuffer(frame.objects);
+            m_engine->destroyBuffer(frame.views);
+            m_engine->destroyBuffer(frame.commands);
+            m_engine->destroyBuffer(frame.drawCounts);
+        }
+        m_frames.clear();
+
+        m_engine->destroyBuffer(m_meshBuffer);
+
+        m_meshIndices.clear();
+        m_meshRecords.clear();
+        m_meshCapacity = 0;
+
+        vkDestroyPipeline(m_engine->m_device, m_pipeline, nullptr);
+        vkDestroyPipelineLayout(m_engine->m_device, m_pipelineLayout, nullptr);
+
+        m_engine = nullptr;
+        m_initialized = false;
+    }
+
+    void VulkanGPUScene::update(
+            VkCommandBuffer cmdBuffer,
+            const VulkanMeshCache& meshCache,
+            Span<const VulkanRenderPacket> packets,
+            size_t frameIndex) {
+        MOE_ASSERT(m_initialized, "VulkanGPUScene not initialized");
+        MOE_ASSERT(frameIndex < m_frames.size(), "Frame index out of range");
+        MOE_ASSERT(packets.size() <= std::numeric_limits<uint32_t>::max(), "Too many render packets for the gpu scene");
+
+        m_currentFrame = frameIndex;
+        auto& frame = m_frames[frameIndex];
+        const uint32_t blockCount = std::max(m_engine->getGeometryArena().getBlockCount(VulkanGeometryPool::Index), 1u);
+        reserveFrame(frame, packets.size(), blockCount);
+        m_objectCount = packets.size();
+
+        m_stats.objects = packets.size();
+        m_stats.dispatches = 0;
+        m_stats.indirectDraws = 0;
+        m_stats.indexBlocks = blockCount;
+
+        // disposed or moved meshes invalidate the ids and ranges the records were built from
+        if (meshCache.getVersion() != m_meshVersion) {
+            resetMeshes();
+            m_meshVersion = meshCache.getVersion();
+        }
+
+        // new meshes first, the parallel pass below only reads the index map
+        MeshId lastMeshId = NULL_MESH_ID;
+        for (const auto& packet: packets) {
+            if (packet.meshId == lastMeshId || m_meshIndices.count(packet.meshId)) {
+                lastMeshId = packet.meshId;
+                continue;
+            }
+            if (const auto* mesh = meshCache.findMesh(packet.meshId)) {
+                registerMesh(packet.meshId, *mesh);
+                lastMeshId = packet.meshId;
+            }
+        }
+
+        auto* objects = static_cast<VulkanGPUObjectData*>(frame.objects.vmaAllocationInfo.pMappedData);
+        const size_t chunkCount = (packets.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        parallelForInline(chunkCount, [&](size_t chunk) {
+            const size_t begin = chunk * CHUNK_SIZE;
+            const size_t end = std::min(begin + CHUNK_SIZE, packets.size());
+            for (size_t i = begin; i < end; ++i) {
+                const auto& packet = packets[i];
+                const auto it = m_meshIndices.find(packet.meshId);
+
+                // bind pose bounds do not cover an animated mesh
+                uint32_t flags = 0;
+                if (packet.skinned) {
+                    flags |= VulkanGPUObjectData::FLAG_SKINNED | VulkanGPUObjectData::FLAG_UNBOUNDED;
+                }
+
+                // written whole, the mapping is write combined
+                objects[i] = VulkanGPUObjectData{
+                        .meshIndex = it != m_meshIndices.end() ? it->second : VulkanGPUObjectData::INVALID_MESH_INDEX,
+                        .materialId = packet.materialId,
+                        .lod = packet.lod,
+                        .flags = flags,
+                };
+            }
+        });
+
+        vkCmdFillBuffer(cmdBuffer, frame.drawCounts.buffer, 0, Detail::MAX_REGIONS * sizeof(uint32_t), 0);
+
+        // the cleared counts before the cull dispatches
+        Detail::transferBarrier(cmdBuffer);
+    }
+
+    void VulkanGPUScene::cull(
+            VkCommandBuffer cmdBuffer,
+            uint32_t view,
+            VkDeviceAddress instanceBufferAddr,
+            const Frustum& frustum,
+            float minRadius) {
+        MOE_ASSERT(m_initialized, "VulkanGPUScene not initialized");
+        MOE_ASSERT(view < MAX_VIEWS, "View index out of range");
+
+        if (m_objectCount == 0) {
+            return;
+        }
+
+        auto& frame = m_frames[m_currentFrame];
+        auto* views = static_cast<VulkanGPUCullView*>(frame.views.vmaAllocationInfo.pMappedData);
+        views[view] = VulkanGPUCullView{
+                .planes = frustum.planes,
+                .minRadius = minRadius,
+                .reserved = {},
+        };
+
+        auto pushConstants = PushConstants{
+                .instanceBufferAddr = instanceBufferAddr,
+                .objectBufferAddr = frame.objects.address,
+                .meshBufferAddr = m_meshBuffer.address,
+                .viewBufferAddr = frame.views.address,
+                .commandBufferAddr = frame.commands.address,
+                .drawCountBufferAddr = frame.drawCounts.address,
+                .viewIndex = view,
+                .objectCount = static_cast<uint32_t>(m_objectCount),
+                .commandCapacity = static_cast<uint32_t>(frame.capacity),
+                .blockCount = frame.blockCount,
+        };
+
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+
+        const auto groupCount = static_cast<uint32_t>((m_objectCount + Detail::CULL_WORKGROUP_SIZE - 1) / Detail::CULL_WORKGROUP_SIZE);
+        vkCmdDispatch(cmdBuffer, groupCount, 1, 1);
+        m_stats.dispatches++;
+
+        // the draw commands and count are consumed by the indirect draw of this view
+        const auto barrier = VkMemoryBarrier2{
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                .srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                .dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+        };
+        const auto dependencyInfo = VkDependencyInfo{
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .memoryBarrierCount = 1,
+                .pMemoryBarriers = &barrier,
+        };
+        vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+    }
+
+    void VulkanGPUScene::draw(VkCommandBuffer cmdBuffer, uint32_t view) {
+        MOE_ASSERT(m_initialized, "VulkanGPUScene not initialized");
+        MOE_ASSERT(view < MAX_VIEWS, "View index out of range");
+
+        if (m_objectCount == 0) {
+            return;
+        }
+
+        const auto& frame = m_frames[m_currentFrame];
+        const auto& arena = m_engine->getGeometryArena();
+        for (uint32_t block = 0; block < frame.blockCount; ++block) {
+            const VkBuffer indexBuffer = arena.getBlockBuffer(VulkanGeometryPool::Index, block);
+            if (indexBuffer == VK_NULL_HANDLE) {
+                continue;
+            }
+
+            const size_t region = view * frame.blockCount + block;
+            vkCmdBindIndexBuffer(cmdBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexedIndirectCount(
+                    cmdBuffer,
+                    frame.commands.buffer, region * frame.capacity * sizeof(VkDrawIndexedIndirectCommand),
+                    frame.drawCounts.buffer, region * sizeof(uint32_t),
+                    static_cast<uint32_t>(m_objectCount),
+                    sizeof(VkDrawIndexedIndirectCommand));
+            m_stats.indirectDraws++;
+        }
+    }
+
+    uint32_t VulkanGPUScene::registerMesh(MeshId meshId, const VulkanGPUMesh& mesh) {
+        const auto& buffer = mesh.gpuBuffer;
+
+        VulkanGPUMeshRecord record{
+                .vertexBufferAddr = buffer.vertexBufferAddr,
+                .skinnedVertexBufferAddr = buffer.skinnedVertexBufferAddr,
+                .boundsCenter = (mesh.min + mesh.max) * 0.5f,
+                .vertexFormat = buffer.vertexFormat,
+                .boundsExtent = (mesh.max - mesh.min) * 0.5f,
+                .lodCount = buffer.lodCount,
+                .lods = {},
+                .indexBlock = buffer.indexAllocation.isValid() ? buffer.indexAllocation.block : 0,
+                .reserved = 0,
+        };
+        for (uint32_t i = 0; i < buffer.lodCount; ++i) {
+            // an empty mesh keeps zero counts and draws nothing
+            record.lods[i] = glm::uvec2(buffer.getFirstIndex(i), buffer.indexAllocation.isValid() ? buffer.lods[i].indexCount : 0);
+        }
+
+        const auto meshIndex = static_cast<uint32_t>(m_meshRecords.size());
+        reserveMeshes(m_meshRecords.size() + 1);
+        // past every index an in flight frame can read, so written in place
+        static_cast<VulkanGPUMeshRecord*>(m_meshBuffer.vmaAllocationInfo.pMappedData)[meshIndex] = record;
+        m_meshRecords.push_back(record);
+        m_meshIndices.emplace(meshId, meshIndex);
+
+        m_stats.meshes = m_meshRecords.size();
+        return meshIndex;
+    }
+
+    void VulkanGPUScene::resetMeshes() {
+        // frames in flight may still read the old records
+        auto oldBuffer = m_meshBuffer;
+        m_engine->getCurrentFrame().deletionQueue.pushFunction([engine = m_engine, oldBuffer]() mutable {
+            engine->destroyBuffer(oldBuffer);
+        });
+
+        m_meshIndices.clear();
+        m_meshRecords.clear();
+        m_meshCapacity = 0;
+        reserveMeshes(INITIAL_MESH_CAPACITY);
+
+        m_stats.meshes = 0;
+    }
+
+    void VulkanGPUScene::reserveFrame(Frame& frame, size_t objectCount, uint32_t blockCount) {
+        MOE_ASSERT(blockCount <= VulkanGeometryArena::MAX_BLOCKS, "Index block count out of range");
+
+        if (objectCount <= frame.capacity && blockCount == frame.blockCount) {
+            return;
+        }
+
+        size_t capacity = std::max(frame.capacity, INITIAL_OBJECT_CAPACITY);
+        while (capacity < objectCount) {
+            capacity *= 2;
+        }
+
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Dynamic);
+
+        // the frame's fence has been waited on, nothing reads the old buffers anymore
+        if (capacity != frame.capacity) {
+            if (frame.capacity > 0) {
+                m_engine->destroyBuffer(frame.objects);
+            }
+            frame.objects = m_engine->allocateBuffer(
+                    capacity * sizeof(VulkanGPUObjectData),
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                    VMA_MEMORY_USAGE_CPU_TO_GPU);
+        }
+
+        // regions are laid out by capacity and block count, both resize the command buffer
+        if (frame.capacity > 0) {
+            m_engine->destroyBuffer(frame.commands);
+        }
+        frame.commands = m_engine->allocateBuffer(
+                MAX_VIEWS * blockCount * capacity * sizeof(VkDrawIndexedIndirectCommand),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+
+        frame.capacity = capacity;
+        frame.blockCount = blockCount;
+    }
+
+    void VulkanGPUScene::reserveMeshes(size_t meshCount) {
+        if (meshCount <= m_meshCapacity) {
+            return;
+        }
+
+        size_t capacity = std::max(m_meshCapacity, INITIAL_MESH_CAPACITY);
+        while (capacity < meshCount) {
+            capacity *= 2;
+        }
+
+        // frames in flight may still read the old records
+        if (m_meshCapacity > 0) {
+            auto oldBuffer = m_meshBuffer;
+            m_engine->getCurrentFrame().deletionQueue.pushFunction([engine = m_engine, oldBuffer]() mutable {
+                engine->destroyBuffer(oldBuffer);
+            });
+        }
+
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Mesh);
+        m_meshBuffer = m_engine->allocateBuffer(
+                capacity * sizeof(VulkanGPUMeshRecord),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VMA_MEMORY_USAGE_CPU_TO_GPU);
+        std::copy(
+                m_meshRecords.begin(), m_meshRecords.end(),
+                static_cast<VulkanGPUMeshRecord*>(m_meshBuffer.vmaAllocationInfo.pMappedData));
+        m_meshCapacity = capacity;
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "Render/Vulkan/VulkanGeometryArena.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+
+#include <algorithm>
+
+
+namespace moe {
+    namespace Detail {
+        // free space split into enough holes that compaction pays off
+        static constexpr float DEFRAGMENTATION_THRESHOLD = 0.25f;
+
+        static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        static void defragmentationBarrier(
+                VkCommandBuffer cmdBuffer,
+                VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+                VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) {
+            const auto barrier = VkMemoryBarrier2{
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                    .srcStageMask = srcStage,
+                    .srcAccessMask = srcAccess,
+                    .dstStageMask = dstStage,
+                    .dstAccessMask = dstAccess,
+            };
+            const auto dependencyInfo = VkDependencyInfo{
+                    .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .memoryBarrierCount = 1,
+                    .pMemoryBarriers = &barrier,
+            };
+            vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+        }
+    }// namespace Detail
+
+    void VulkanGeometryArena::init(VulkanEngine& engine) {
+        MOE_ASSERT(!m_initialized, "VulkanGeometryArena already initialized");
+
+        m_engine = &engine;
+
+        auto& indexPool = getPool(VulkanGeometryPool::Index);
+        indexPool.blockSize = INDEX_BLOCK_SIZE;
+        indexPool.alignment = sizeof(uint32_t);
+        indexPool.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+        auto& vertexPool = getPool(VulkanGeometryPool::Vertex);
+        vertexPool.blockSize = VERTEX_BLOCK_SIZE;
+        vertexPool.alignment = VERTEX_ALIGNMENT;
+        vertexPool.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        m_initialized = true;
+    }
+
+    void VulkanGeometryArena::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& pool: m_pools) {
+            for (auto& block: pool.blocks) {
+                if (block.allocator.getCapacity() > 0) {
+                    m_engine->destroyBuffer(block.buffer);
+                    block.buffer = {};
+                    block.allocator.reset(0);
+                }
+            }
+        }
+
+        m_pendingUploads.clear();
+        m_pendingReleases.clear();
+        m_emptyBlocks.clear();
+        m_allocationCount = 0;
+
+        m_engine = nullptr;
+        m_initialized = false;
+    }
+
+    void VulkanGeometryArena::update() {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        const uint64_t frameNumber = getFrameNumber();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_pendingReleases.empty() && m_pendingReleases.front().first + FRAMES_IN_FLIGHT <= frameNumber) {
+            release(m_pendingReleases.front().second);
+            m_pendingReleases.pop_front();
+        }
+
+        for (auto blockIt = m_pendingUploads.begin(); blockIt != m_pendingUploads.end();) {
+            auto& uploads = blockIt->second;
+            for (auto it = uploads.begin(); it != uploads.end();) {
+                it = it->second.isReady() ? uploads.erase(it) : std::next(it);
+            }
+            blockIt = uploads.empty() ? m_pendingUploads.erase(blockIt) : std::next(blockIt);
+        }
+
+        // dropped once the block got a range again in the meantime
+        m_emptyBlocks.erase(
+                std::remove_if(m_emptyBlocks.begin(), m_emptyBlocks.end(), [&](const auto& emptyBlock) {
+                    const auto& [pool, block] = emptyBlock;
+                    const auto& allocator = getPool(pool).blocks[block].allocator;
+                    return allocator.getCapacity() == 0 || !allocator.isEmpty() || releaseBlock(pool, block);
+                }),
+                m_emptyBlocks.end());
+    }
+
+    VulkanGeometryAllocation VulkanGeometryArena::allocate(VulkanGeometryPool pool, uint64_t size) {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        if (size == 0) {
+            return {};
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& poolData = getPool(pool);
+        const uint64_t alignedSize = Detail::alignUp(size, poolData.alignment);
+
+        // first fit over the blocks, so ranges gather at the front of the pool
+        for (uint32_t i = 0; i < MAX_BLOCKS; ++i) {
+            auto& block = poolData.blocks[i];
+            if (block.allocator.getCapacity() == 0) {
+                continue;
+            }
+
+            const uint64_t offset = block.allocator.allocate(alignedSize);
+            if (offset != RangeAllocator::INVALID_OFFSET) {
+                m_allocationCount++;
+                return {pool, i, offset, alignedSize};
+            }
+        }
+
+        for (uint32_t i = 0; i < MAX_BLOCKS; ++i) {
+            if (poolData.blocks[i].allocator.getCapacity() > 0) {
+                continue;
+            }
+
+            createBlock(pool, i, std::max(poolData.blockSize, alignedSize));
+            const uint64_t offset = poolData.blocks[i].allocator.allocate(alignedSize);
+            MOE_ASSERT(offset == 0, "Fresh block did not fit the allocation");
+            m_allocationCount++;
+            return {pool, i, offset, alignedSize};
+        }
+
+        MOE_LOG_AND_THROW("Geometry arena out of blocks");
+        return {};
+    }
+
+    void VulkanGeometryArena::upload(const VulkanGeometryAllocation& allocation, const void* data, size_t size) {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+        MOE_ASSERT(allocation.isValid(), "Invalid geometry allocation");
+        MOE_ASSERT(size <= allocation.size, "Upload larger than the allocation");
+
+        const VkBuffer buffer = getBuffer(allocation);
+        auto future = m_engine->getUploadManager().uploadBuffer(buffer, allocation.offset, data, size);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingUploads[buffer].insert_or_assign(allocation.offset, std::move(future));
+    }
+
+    void VulkanGeometryArena::free(const VulkanGeometryAllocation& allocation) {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        if (!allocation.isValid()) {
+            return;
+        }
+
+        m_pendingReleases.emplace_back(getFrameNumber(), allocation);
+    }
+
+    VkBuffer VulkanGeometryArena::getBuffer(const VulkanGeometryAllocation& allocation) const {
+        MOE_ASSERT(allocation.isValid(), "Invalid geometry allocation");
+        return getBlockBuffer(allocation.pool, allocation.block);
+    }
+
+    VkDeviceAddress VulkanGeometryArena::getAddress(const VulkanGeometryAllocation& allocation) const {
+        MOE_ASSERT(allocation.pool == VulkanGeometryPool::Vertex, "Only vertex allocations have a device address");
+
+        if (!allocation.isValid()) {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return getPool(allocation.pool).blocks[allocation.block].buffer.address + allocation.offset;
+    }
+
+    VkBuffer VulkanGeometryArena::getBlockBuffer(VulkanGeometryPool pool, uint32_t block) const {
+        MOE_ASSERT(block < MAX_BLOCKS, "Block index out of range");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto& blockData = getPool(pool).blocks[block];
+        return blockData.allocator.getCapacity() > 0 ? blockData.buffer.buffer : VK_NULL_HANDLE;
+    }
+
+    uint32_t VulkanGeometryArena::getBlockCount(VulkanGeometryPool pool) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto& blocks = getPool(pool).blocks;
+        for (uint32_t i = MAX_BLOCKS; i > 0; --i) {
+            if (blocks[i - 1].allocator.getCapacity() > 0) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    bool VulkanGeometryArena::isDefragmentationNeeded() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& pool: m_pools) {
+            uint64_t freeBefore = 0;
+            for (const auto& block: pool.blocks) {
+                const auto& allocator = block.allocator;
+                if (allocator.getCapacity() == 0) {
+                    continue;
+                }
+
+                if (allocator.getFragmentation() > Detail::DEFRAGMENTATION_THRESHOLD) {
+                    return true;
+                }
+                // a later block could be emptied into the earlier ones and released
+                if (!allocator.isEmpty() && allocator.getUsed() <= freeBefore) {
+                    return true;
+                }
+                freeBefore += allocator.getFree();
+            }
+        }
+        return false;
+    }
+
+    void VulkanGeometryArena::beginDefragmentation(VkCommandBuffer cmdBuffer, uint64_t budget) {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        m_defragmentationBudget = budget;
+        m_movedAllocations = 0;
+        m_movedBytes = 0;
+
+        // earlier frame work on the blocks before the copies read or overwrite them
+        Detail::defragmentationBarrier(
+                cmdBuffer,
+                VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    }
+
+    bool VulkanGeometryArena::move(VkCommandBuffer cmdBuffer, VulkanGeometryAllocation& allocation) {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        if (!allocation.isValid() || allocation.size > m_defragmentationBudget) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (isUploadPending(allocation)) {
+            return false;
+        }
+
+        auto& pool = getPool(allocation.pool);
+
+        // an earlier block anywhere, otherwise lower in its own block
+        VulkanGeometryAllocation target = allocation;
+        target.block = VulkanGeometryAllocation::INVALID_BLOCK;
+        for (uint32_t i = 0; i <= allocation.block; ++i) {
+            auto& allocator = pool.blocks[i].allocator;
+            if (allocator.getCapacity() == 0) {
+                continue;
+            }
+
+            const uint64_t limit = i == allocation.block ? allocation.offset : allocator.getCapacity();
+            const uint64_t offset = allocator.allocateBelow(allocation.size, limit);
+            if (offset != RangeAllocator::INVALID_OFFSET) {
+                target.block = i;
+                target.offset = offset;
+                break;
+            }
+        }
+
+        if (!target.isValid()) {
+            return false;
+        }
+
+        const auto region = VkBufferCopy{
+                .srcOffset = allocation.offset,
+                .dstOffset = target.offset,
+                .size = allocation.size,
+        };
+        vkCmdCopyBuffer(
+                cmdBuffer,
+                pool.blocks[allocation.block].buffer.buffer,
+                pool.blocks[target.block].buffer.buffer,
+                1, &region);
+
+        // the old range is still read by the frames in flight
+        m_allocationCount++;
+        m_pendingReleases.emplace_back(getFrameNumber(), allocation);
+
+        m_defragmentationBudget -= allocation.size;
+        m_movedAllocations++;
+        m_movedBytes += allocation.size;
+
+        allocation = target;
+        return true;
+    }
+
+    void VulkanGeometryArena::endDefragmentation(VkCommandBuffer cmdBuffer) {
+        MOE_ASSERT(m_initialized, "VulkanGeometryArena not initialized");
+
+        if (m_movedAllocations == 0) {
+            return;
+        }
+
+        Detail::defragmentationBarrier(
+                cmdBuffer,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT);
+    }
+
+    VulkanGeometryArena::Stats VulkanGeometryArena::getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Stats stats;
+        for (size_t i = 0; i < m_pools.size(); ++i) {
+            for (const auto& block: m_pools[i].blocks) {
+                if (block.allocator.getCapacity() == 0) {
+                    continue;
+                }
+                stats.blocks[i]++;
+                stats.capacityBytes[i] += block.allocator.getCapacity();
+                stats.usedBytes[i] += block.allocator.getUsed();
+            }
+        }
+        stats.allocations = m_allocationCount;
+        stats.movedAllocations = m_movedAllocations;
+        stats.movedBytes = m_movedBytes;
+        return stats;
+    }
+
+    void VulkanGeometryArena::createBlock(VulkanGeometryPool pool, uint32_t block, uint64_t size) {
+        auto& poolData = getPool(pool);
+        auto& blockData = poolData.blocks[block];
+        MOE_ASSERT(blockData.allocator.getCapacity() == 0, "Block already in use");
+
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Mesh);
+        blockData.buffer = m_engine->allocateBuffer(
+                size,
+                poolData.usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+        blockData.allocator.reset(size);
+
+        Logger::info("Geometry arena: created block {} of pool {}, {} bytes", block, static_cast<uint32_t>(pool), size);
+    }
+
+    void VulkanGeometryArena::release(const VulkanGeometryAllocation& allocation) {
+        auto& block = getPool(allocation.pool).blocks[allocation.block];
+        block.allocator.free(allocation.offset, allocation.size);
+        MOE_ASSERT(m_allocationCount > 0, "Released more allocations than were made");
+        m_allocationCount--;
+
+        // the first block stays, later ones go once empty and no upload can still write into them
+        if (allocation.block == 0 || !block.allocator.isEmpty()) {
+            return;
+        }
+
+        if (!releaseBlock(allocation.pool, allocation.block)) {
+            const auto emptyBlock = std::make_pair(allocation.pool, allocation.block);
+            if (std::find(m_emptyBlocks.begin(), m_emptyBlocks.end(), emptyBlock) == m_emptyBlocks.end()) {
+                m_emptyBlocks.push_back(emptyBlock);
+            }
+        }
+    }
+
+    bool VulkanGeometryArena::releaseBlock(VulkanGeometryPool pool, uint32_t block) {
+        auto& blockData = getPool(pool).blocks[block];
+
+        const auto uploads = m_pendingUploads.find(blockData.buffer.buffer);
+        if (uploads != m_pendingUploads.end()) {
+            for (const auto& [offset, future]: uploads->second) {
+                if (!future.isReady()) {
+                    return false;
+                }
+            }
+            m_pendingUploads.erase(uploads);
+        }
+
+        m_engine->destroyBuffer(blockData.buffer);
+        blockData.buffer = {};
+        blockData.allocator.reset(0);
+        return true;
+    }
+
+    bool VulkanGeometryArena::isUploadPending(const VulkanGeometryAllocation& allocation) {
+        const auto uploads = m_pendingUploads.find(getPool(allocation.pool).blocks[allocation.block].buffer.buffer);
+        if (uploads == m_pendingUploads.end()) {
+            return false;
+        }
+
+        const auto it = uploads->second.find(allocation.offset);
+        if (it == uploads->second.end()) {
+            return false;
+        }
+        if (it->second.isReady()) {
+            uploads->second.erase(it);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t VulkanGeometryArena::getFrameNumber() const {
+        return static_cast<uint64_t>(m_engine->m_frameNumber);
+    }
+}// namespace moe
\ No newline at end of file
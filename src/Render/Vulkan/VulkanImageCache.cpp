@@ -10,6 +10,8 @@ namespace moe {
         m_initialized = true;
 
         initDefaults();
+
+        m_streamer.init(engine, *this);
     }
 
     Optional<VulkanAllocatedImage> VulkanImageCache::getImage(ImageId id) {
@@ -19,6 +21,11 @@ namespace moe {
             return m_images[id];
         }
 
+        if (m_streamer.isStreamed(id)) {
+            // still decoding, hand out the placeholder
+            return m_images[m_defaults.whiteImage];
+        }
+
         Logger::warn("ImageId {} not found in image cache", id);
         return {std::nullopt};
     }
@@ -38,6 +45,8 @@ namespace moe {
     ImageId VulkanImageCache::loadImageFromFile(StringView filename, VkFormat format, VkImageUsageFlags usage, bool mipmap) {
         MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
 
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Texture);
+
         auto image = m_engine->loadImageFromFile(filename, format, usage, mipmap);
         if (!image) {
             Logger::error("Failed to load image from file: {}", filename);
@@ -50,6 +59,8 @@ namespace moe {
     ImageId VulkanImageCache::loadImageFromMemory(Span<uint8_t> imageData, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, bool mipmap) {
         MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
 
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Texture);
+
         auto image = m_engine->loadImageFromMemory(imageData, extent, format, usage, mipmap);
         if (!image) {
             Logger::error("Failed to load image from memory");
@@ -59,9 +70,65 @@ namespace moe {
         return addImage(std::move(image.value()));
     }
 
+    ImageId VulkanImageCache::loadStreamedImageFromFile(StringView filename, VkFormat format, VkImageUsageFlags usage) {
+        MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
+
+        if (!m_streamer.isEnabled()) {
+            return loadImageFromFile(filename, format, usage, true);
+        }
+
+        ImageId id = m_idAllocator.allocateId();
+        m_engine->getBindlessSet().addImage(id, m_images[m_defaults.whiteImage].imageView);
+        m_streamer.addImageFromFile(id, filename, format, usage);
+
+        Logger::debug("Added streamed image with id {}: {}", id, filename);
+        return id;
+    }
+
+    ImageId VulkanImageCache::loadStreamedImageFromMemory(Span<uint8_t> imageData, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage) {
+        MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
+
+        if (!m_streamer.isEnabled()) {
+            return loadImageFromMemory(imageData, extent, format, usage, true);
+        }
+
+        if (imageData.empty()) {
+            Logger::error("Image data is empty");
+            return NULL_IMAGE_ID;
+        }
+
+        ImageId id = m_idAllocator.allocateId();
+        m_engine->getBindlessSet().addImage(id, m_images[m_defaults.whiteImage].imageView);
+        m_streamer.addImageFromMemory(
+                id,
+                Vector<uint8_t>(imageData.begin(), imageData.end()),
+                extent, format, usage);
+
+        Logger::debug("Added streamed image with id {}", id);
+        return id;
+    }
+
+    Optional<VulkanAllocatedImage> VulkanImageCache::swapImage(ImageId id, VulkanAllocatedImage&& image) {
+        MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
+
+        Optional<VulkanAllocatedImage> previous;
+        auto it = m_images.find(id);
+        if (it != m_images.end()) {
+            previous = it->second;
+            it->second = std::move(image);
+        } else {
+            it = m_images.emplace(id, std::move(image)).first;
+        }
+
+        m_engine->getBindlessSet().addImage(id, it->second.imageView);
+        return previous;
+    }
+
     ImageId VulkanImageCache::loadCubeMapFromFiles(Array<StringView, 6> filenames, VkFormat format, VkImageUsageFlags usage, bool mipmap) {
         MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
 
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Texture);
+
         Array<void*, 6> rawImages;
         Array<VkLoaders::UniqueRawImage, 6> _rawImageRefs;
         int width, height, channels;
@@ -102,7 +169,16 @@ namespace moe {
     void VulkanImageCache::disposeImage(ImageId id) {
         MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
 
+        bool streamed = m_streamer.isStreamed(id);
+        m_streamer.removeImage(id);
+
         auto it = m_images.find(id);
+        if (it == m_images.end() && streamed) {
+            // never became resident
+            m_idAllocator.recycleId(id);
+            return;
+        }
+
         if (it != m_images.end()) {
             m_engine->destroyImage(it->second);
             m_images.erase(it);
@@ -119,6 +195,8 @@ namespace moe {
     void VulkanImageCache::destroy() {
         MOE_ASSERT(m_initialized, "VulkanImageCache not initialized");
 
+        m_streamer.destroy();
+
         for (auto& image: m_images) {
             m_engine->destroyImage(image.second);
         }
@@ -130,6 +208,8 @@ namespace moe {
     void VulkanImageCache::initDefaults() {
         Logger::debug("Initializing default images...");
 
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Texture);
+
         {
             MOE_ASSERT(m_defaults.whiteImage == NULL_IMAGE_ID, "Default images already initialized");
             MOE_ASSERT(m_defaults.blackImage == NULL_IMAGE_ID, "Default images already initialized");
@@ -0,0 +1,81 @@
+#include "Render/Vulkan/VulkanInstanceBuffer.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+
+
+namespace moe {
+    void VulkanInstanceBuffer::init(VulkanEngine& engine) {
+        MOE_ASSERT(!m_initialized, "VulkanInstanceBuffer already initialized");
+
+        m_engine = &engine;
+        m_frames.resize(FRAMES_IN_FLIGHT);
+        for (auto& frame: m_frames) {
+            reserve(frame, INITIAL_CAPACITY);
+        }
+
+        m_initialized = true;
+    }
+
+    void VulkanInstanceBuffer::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanInstanceBuffer not initialized");
+
+        for (auto& frame: m_frames) {
+            m_engine->destroyBuffer(frame.buffer);
+        }
+        m_frames.clear();
+
+        m_engine = nullptr;
+        m_initialized = false;
+    }
+
+    void VulkanInstanceBuffer::update(Span<const VulkanRenderPacket> packets, size_t frameIndex) {
+        MOE_ASSERT(m_initialized, "VulkanInstanceBuffer not initialized");
+        MOE_ASSERT(frameIndex < m_frames.size(), "Frame index out of range");
+
+        m_currentFrame = frameIndex;
+        auto& frame = m_frames[frameIndex];
+        reserve(frame, packets.size());
+
+        m_stats.instances = packets.size();
+        m_stats.capacity = frame.capacity;
+
+        auto* instances = static_cast<VulkanGPUInstanceData*>(frame.buffer.vmaAllocationInfo.pMappedData);
+        const size_t chunkCount = (packets.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        parallelForInline(chunkCount, [&](size_t chunk) {
+            const size_t begin = chunk * CHUNK_SIZE;
+            const size_t end = std::min(begin + CHUNK_SIZE, packets.size());
+            for (size_t i = begin; i < end; ++i) {
+                // written whole, the mapping is write combined
+                instances[i] = VulkanGPUInstanceData{
+                        .transform = packets[i].transform,
+                        .inverseTransform = glm::inverse(packets[i].transform),
+                };
+            }
+        });
+    }
+
+    void VulkanInstanceBuffer::reserve(Frame& frame, size_t instanceCount) {
+        if (instanceCount <= frame.capacity) {
+            return;
+        }
+
+        size_t capacity = std::max(frame.capacity, INITIAL_CAPACITY);
+        while (capacity < instanceCount) {
+            capacity *= 2;
+        }
+
+        if (frame.capacity > 0) {
+            m_engine->destroyBuffer(frame.buffer);
+        }
+
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::Dynamic);
+        frame.buffer = m_engine->allocateBuffer(
+                capacity * sizeof(VulkanGPUInstanceData),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VMA_MEMORY_USAGE_CPU_TO_GPU);
+        frame.capacity = capacity;
+    }
+}// namespace moe
\ No newline at end of file
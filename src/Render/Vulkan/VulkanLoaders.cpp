@@ -1,11 +1,23 @@
 #include "Render/Vulkan/VulkanLoaders.hpp"
 #include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanMeshAttributes.hpp"
+#include "Render/Vulkan/VulkanMeshOptimizer.hpp"
 #include "Render/Vulkan/VulkanScene.hpp"
+#include "Render/Vulkan/VulkanVertexKernels.hpp"
 
 #include "Core/FileReader.hpp"
+#include "Core/Resource/Cached.hpp"
+#include "Core/Resource/ImageKernels.hpp"
+#include "Core/Task/Utils.hpp"
 
+#include <json.hpp>
 #include <tiny_gltf.h>
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
@@ -93,30 +105,62 @@ namespace moe {
                 Glb
             };
 
-            ModelType selectModelType(std::filesystem::path path) {
+            Optional<ModelType> selectModelType(std::filesystem::path path) {
                 auto ext = path.extension().string();
                 if (ext == ".gltf") {
                     return ModelType::Gltf;
                 } else if (ext == ".glb") {
                     return ModelType::Glb;
-                } else {
-                    Logger::error("Unsupported glTF file extension: {}", ext);
-                    MOE_ASSERT(false, "Unsupported glTF file extension");
                 }
+
+                Logger::error("Unsupported glTF file extension: {}", ext);
+                return std::nullopt;
+            }
+
+            // keeps the encoded image so that decoding can run in parallel after parsing
+            bool deferImageData(
+                    tinygltf::Image* /*image*/, const int imageIndex,
+                    std::string* /*err*/, std::string* /*warn*/,
+                    int /*reqWidth*/, int /*reqHeight*/,
+                    const unsigned char* bytes, int size,
+                    void* userData) {
+                auto& deferredImages = *static_cast<Vector<Vector<uint8_t>>*>(userData);
+                if (deferredImages.size() <= static_cast<size_t>(imageIndex)) {
+                    deferredImages.resize(imageIndex + 1);
+                }
+                deferredImages[imageIndex].assign(bytes, bytes + size);
+                return true;
             }
 
-            ModelType loadGltfFile(tinygltf::Model& model, std::filesystem::path path, std::filesystem::path parentDir) {
+            // nullopt when the file cannot be read or parsed
+            Optional<ModelType> loadGltfFile(
+                    tinygltf::Model& model,
+                    std::filesystem::path path,
+                    std::filesystem::path parentDir,
+                    Vector<Vector<uint8_t>>* deferredImages = nullptr) {
                 tinygltf::TinyGLTF loader;
                 std::string err;
                 std::string warn;
 
+                if (deferredImages) {
+                    loader.SetImageLoader(deferImageData, deferredImages);
+                }
+
+                auto modelType = selectModelType(path);
+                if (!modelType) {
+                    return std::nullopt;
+                }
+
                 size_t bufSize = 0;
                 auto fileBuf =
                         FileReader::s_instance->readFile(path.string(), bufSize);
+                if (!fileBuf) {
+                    Logger::error("Failed to read glTF file: {}", path.string());
+                    return std::nullopt;
+                }
 
-                ModelType modelType = selectModelType(path);
                 bool success;
-                if (modelType == ModelType::Gltf) {
+                if (*modelType == ModelType::Gltf) {
                     success = loader.LoadASCIIFromString(
                             &model,
                             &err,
@@ -139,8 +183,8 @@ namespace moe {
                 }
 
                 if (!success) {
-                    Logger::error("Failed to load glTF: {}", err);
-                    MOE_ASSERT(false, "Failed to load glTF");
+                    Logger::error("Failed to load glTF {}: {}", path.string(), err);
+                    return std::nullopt;
                 }
 
                 return modelType;
@@ -188,6 +232,33 @@ namespace moe {
                 return getPackedBufferSpan<T>(model, accessor);
             }
 
+            // float attribute as a strided stream, unlike getPackedBufferSpan interleaved buffer views are fine
+            VertexKernels::Stream getAttributeStream(
+                    const tinygltf::Model& model,
+                    const tinygltf::Primitive& primitive,
+                    const StringView attributeName,
+                    int expectedType) {
+                const auto accessorIndex = findAttributeAccessor(primitive, attributeName);
+                if (accessorIndex == -1) {
+                    return {};
+                }
+
+                const auto& accessor = model.accessors[accessorIndex];
+                MOE_ASSERT(accessor.type == expectedType, "Unexpected accessor type");
+                MOE_ASSERT(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT, "Unsupported accessor component type");
+
+                const auto& bv = model.bufferViews[accessor.bufferView];
+                const int bs = accessor.ByteStride(bv);
+                MOE_ASSERT(bs > 0, "Invalid accessor byte stride");
+
+                const auto& buf = model.buffers[bv.buffer];
+                return {
+                        &buf.data.at(0) + bv.byteOffset + accessor.byteOffset,
+                        static_cast<size_t>(bs),
+                        accessor.count,
+                };
+            }
+
             glm::vec4 getColor(const tinygltf::Material& gltfMaterial) {
                 auto& color = gltfMaterial.pbrMetallicRoughness.baseColorFactor;
                 if (color.size() == 4) {
@@ -197,64 +268,12 @@ namespace moe {
                     return glm::vec4(1.0f);
                 }
             }
-            bool hasDiffuseTexture(const tinygltf::Material& material) {
-                const auto textureIndex = material.pbrMetallicRoughness.baseColorTexture.index;
-                return textureIndex != -1;
-            }
-
-            bool hasNormalMapTexture(const tinygltf::Material& material) {
-                const auto textureIndex = material.normalTexture.index;
-                return textureIndex != -1;
-            }
-
-            bool hasMetallicRoughnessTexture(const tinygltf::Material& material) {
-                const auto textureIndex = material.pbrMetallicRoughness.metallicRoughnessTexture.index;
-                return textureIndex != -1;
-            }
-
-            bool hasEmissiveTexture(const tinygltf::Material& material) {
-                const auto textureIndex = material.emissiveTexture.index;
-                return textureIndex != -1;
-            }
 
-            std::filesystem::path getDiffuseTexturePath(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material,
-                    const std::filesystem::path& fileDir) {
-                const auto textureIndex = material.pbrMetallicRoughness.baseColorTexture.index;
-                const auto& textureId = model.textures[textureIndex];
-                const auto& image = model.images[textureId.source];
-                return fileDir / image.uri;
-            }
-
-            std::filesystem::path getNormalMapTexturePath(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material,
-                    const std::filesystem::path& fileDir) {
-                const auto textureIndex = material.normalTexture.index;
-                const auto& textureId = model.textures[textureIndex];
-                const auto& image = model.images[textureId.source];
-                return fileDir / image.uri;
-            }
-
-            std::filesystem::path getMetallicRoughnessTexturePath(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material,
-                    const std::filesystem::path& fileDir) {
-                const auto textureIndex = material.pbrMetallicRoughness.metallicRoughnessTexture.index;
-                const auto& textureId = model.textures[textureIndex];
-                const auto& image = model.images[textureId.source];
-                return fileDir / image.uri;
-            }
-
-            std::filesystem::path getEmissiveTexturePath(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material,
-                    const std::filesystem::path& fileDir) {
-                const auto textureIndex = material.emissiveTexture.index;
-                const auto& textureId = model.textures[textureIndex];
-                const auto& image = model.images[textureId.source];
-                return fileDir / image.uri;
+            int getTextureImage(const tinygltf::Model& model, int textureIndex) {
+                if (textureIndex == -1) {
+                    return VulkanCookedScene::NO_REFERENCE;
+                }
+                return model.textures[textureIndex].source;
             }
 
             float getEmissiveStrength(const tinygltf::Material& material) {
@@ -266,220 +285,107 @@ namespace moe {
                 return 1.0f;
             }
 
-            ImageId loadImageOrReuse(
-                    VulkanImageCache& imageCache,
-                    const std::filesystem::path& imagePath,
-                    UnorderedMap<String, ImageId>& loadedTextures) {
-                if (loadedTextures.find(imagePath.string()) != loadedTextures.end()) {
-                    Logger::debug("Reusing loaded texture: {}", imagePath.string());
-                    return loadedTextures[imagePath.string()];
-                } else {
-                    ImageId imageId =
-                            imageCache.loadImageFromFile(imagePath.string(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_USAGE_SAMPLED_BIT, true);
-                    loadedTextures[imagePath.string()] = imageId;
-                    return imageId;
-                }
-            }
-
-            void loadMaterialImagesText(
-                    VulkanImageCache& imageCache,
-                    const tinygltf::Model& gltfModel,
-                    const tinygltf::Material& gltfMaterial,
-                    const std::filesystem::path& parentPath,
-                    UnorderedMap<String, ImageId>& loadedTextures,
-                    VulkanCPUMaterial& outMaterial) {
-                if (hasDiffuseTexture(gltfMaterial)) {
-                    const auto diffusePath = getDiffuseTexturePath(gltfModel, gltfMaterial, parentPath);
-                    outMaterial.diffuseTexture = loadImageOrReuse(imageCache, diffusePath, loadedTextures);
-                } else {
-                    outMaterial.diffuseTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
-                }
-
-                if (hasNormalMapTexture(gltfMaterial)) {
-                    const auto normalMapPath = getNormalMapTexturePath(gltfModel, gltfMaterial, parentPath);
-                    outMaterial.normalTexture = loadImageOrReuse(imageCache, normalMapPath, loadedTextures);
-                } else {
-                    outMaterial.normalTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::FlatNormal);
-                }
+            VulkanCookedScene::Material cookMaterial(const tinygltf::Model& model, const tinygltf::Material& gltfMaterial) {
+                VulkanCookedScene::Material material{};
+                material.baseColor = getColor(gltfMaterial);
+                material.metallic = static_cast<float>(gltfMaterial.pbrMetallicRoughness.metallicFactor);
+                material.roughness = static_cast<float>(gltfMaterial.pbrMetallicRoughness.roughnessFactor);
+                material.emissive = getEmissiveStrength(gltfMaterial);
+                material.emissiveColor = cvtTinyGltfVec4(gltfMaterial.emissiveFactor);
 
-                if (hasMetallicRoughnessTexture(gltfMaterial)) {
-                    const auto metalRoughnessPath =
-                            getMetallicRoughnessTexturePath(gltfModel, gltfMaterial, parentPath);
-                    outMaterial.metallicRoughnessTexture = loadImageOrReuse(imageCache, metalRoughnessPath, loadedTextures);
-                } else {
-                    outMaterial.metallicRoughnessTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
-                }
+                material.textures[VulkanCookedScene::Diffuse] =
+                        getTextureImage(model, gltfMaterial.pbrMetallicRoughness.baseColorTexture.index);
+                material.textures[VulkanCookedScene::Normal] =
+                        getTextureImage(model, gltfMaterial.normalTexture.index);
+                material.textures[VulkanCookedScene::MetallicRoughness] =
+                        getTextureImage(model, gltfMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index);
+                material.textures[VulkanCookedScene::Emissive] =
+                        getTextureImage(model, gltfMaterial.emissiveTexture.index);
 
-                if (hasEmissiveTexture(gltfMaterial)) {
-                    const auto emissivePath =
-                            getEmissiveTexturePath(gltfModel, gltfMaterial, parentPath);
-                    outMaterial.emissiveTexture = loadImageOrReuse(imageCache, emissivePath, loadedTextures);
-                } else {
-                    // if the object is not emissive, use white texture
-                    outMaterial.emissiveTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
-                }
+                return material;
             }
 
-            ImageId loadImageOrReuse(
-                    VulkanImageCache& imageCache,
-                    const tinygltf::Model& model,
-                    int imageIndex,
-                    UnorderedMap<int, ImageId>& loadedTextures) {
-                const auto& gltfImage = model.images[imageIndex];
-                auto& imageName = gltfImage.name;
-                auto imageData = Span<uint8_t>{
-                        const_cast<uint8_t*>(gltfImage.image.data()),
-                        gltfImage.image.size(),
-                };
-                VkExtent2D extent{
-                        static_cast<uint32_t>(gltfImage.width),
-                        static_cast<uint32_t>(gltfImage.height),
-                };
+            struct DecodedImage {
+                UniqueRawImage pixels;
+                uint32_t width{0};
+                uint32_t height{0};
+                bool opaque{false};
+            };
 
-                if (loadedTextures.find(imageIndex) != loadedTextures.end()) {
-                    Logger::debug("Reusing loaded texture: {}, index {}", imageName, imageIndex);
-                    return loadedTextures[imageIndex];
-                } else {
-                    ImageId imageId =
-                            imageCache.loadImageFromMemory(
-                                    imageData,
-                                    extent,
-                                    VK_FORMAT_R8G8B8A8_SRGB,
-                                    VK_IMAGE_USAGE_SAMPLED_BIT,
-                                    true);
-                    loadedTextures[imageIndex] = imageId;
-                    return imageId;
+            DecodedImage decodeImage(const tinygltf::Image& gltfImage, Span<const uint8_t> encoded) {
+                if (encoded.empty()) {
+                    Logger::warn("glTF image '{}' has no data", gltfImage.name);
+                    return {};
                 }
-            }
-
-            int getDiffuseTextureImage(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material) {
-                const auto textureIndex = material.pbrMetallicRoughness.baseColorTexture.index;
-                const auto& texture = model.textures[textureIndex];
-                return texture.source;
-            }
-
-            int getNormalMapTextureImage(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material) {
-                const auto textureIndex = material.normalTexture.index;
-                const auto& texture = model.textures[textureIndex];
-                return texture.source;
-            }
 
-            int getMetallicRoughnessTextureImage(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material) {
-                const auto textureIndex = material.pbrMetallicRoughness.metallicRoughnessTexture.index;
-                const auto& texture = model.textures[textureIndex];
-                return texture.source;
-            }
+                int width, height, channels;
+                UniqueRawImage pixels(
+                        stbi_load_from_memory(
+                                encoded.data(), static_cast<int>(encoded.size()),
+                                &width, &height, &channels, 4));
+                if (!pixels) {
+                    // an empty image cooks to no pixels, materials using it get the default texture
+                    Logger::error("Failed to decode glTF image '{}': {}", gltfImage.name, stbi_failure_reason());
+                    return {};
+                }
 
-            int getEmissiveTextureImage(
-                    const tinygltf::Model& model,
-                    const tinygltf::Material& material) {
-                const auto textureIndex = material.emissiveTexture.index;
-                const auto& texture = model.textures[textureIndex];
-                return texture.source;
+                const bool opaque = ImageKernels::isOpaque(pixels.get(), static_cast<size_t>(width) * height);
+                return {std::move(pixels), static_cast<uint32_t>(width), static_cast<uint32_t>(height), opaque};
             }
 
-            void loadMaterialImagesBinary(
-                    VulkanImageCache& imageCache,
-                    const tinygltf::Model& gltfModel,
-                    const tinygltf::Material& gltfMaterial,
-                    UnorderedMap<int, ImageId>& loadedTextures,
-                    VulkanCPUMaterial& outMaterial) {
-                if (hasDiffuseTexture(gltfMaterial)) {
-                    const auto diffuseImage =
-                            getDiffuseTextureImage(
-                                    gltfModel,
-                                    gltfMaterial);
-                    outMaterial.diffuseTexture =
-                            loadImageOrReuse(imageCache, gltfModel, diffuseImage, loadedTextures);
-                } else {
-                    outMaterial.diffuseTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
+            // external images are streamed later, this decodes them once at cooking only to look at their alpha
+            bool isImageFileOpaque(const std::filesystem::path& path) {
+                int width, height, channels;
+                auto pixels = loadImage(path.string(), &width, &height, &channels, 4);
+                if (!pixels) {
+                    return false;
                 }
-
-                if (hasNormalMapTexture(gltfMaterial)) {
-                    const auto normalMapImage =
-                            getNormalMapTextureImage(
-                                    gltfModel,
-                                    gltfMaterial);
-                    outMaterial.normalTexture =
-                            loadImageOrReuse(imageCache, gltfModel, normalMapImage, loadedTextures);
-                } else {
-                    outMaterial.normalTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::FlatNormal);
+                // no alpha channel in the file at all
+                if (channels == 1 || channels == 3) {
+                    return true;
                 }
+                return ImageKernels::isOpaque(pixels.get(), static_cast<size_t>(width) * height);
+            }
 
-                if (hasMetallicRoughnessTexture(gltfMaterial)) {
-                    const auto metalRoughnessImage =
-                            getMetallicRoughnessTextureImage(
-                                    gltfModel,
-                                    gltfMaterial);
-                    outMaterial.metallicRoughnessTexture =
-                            loadImageOrReuse(imageCache, gltfModel, metalRoughnessImage, loadedTextures);
-                } else {
-                    outMaterial.metallicRoughnessTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
+            VulkanCookedScene::Image cookImage(
+                    VulkanCookedScene::Builder& builder,
+                    const tinygltf::Image& gltfImage,
+                    ModelType modelType,
+                    const DecodedImage& decoded) {
+                VulkanCookedScene::Image image{};
+                image.opaque = decoded.opaque ? 1 : 0;
+                if (modelType == ModelType::Gltf) {
+                    // external images are streamed from their own files
+                    image.path = builder.addString(gltfImage.uri);
+                    return image;
                 }
 
-                if (hasEmissiveTexture(gltfMaterial)) {
-                    const auto emissiveImage =
-                            getEmissiveTextureImage(
-                                    gltfModel,
-                                    gltfMaterial);
-                    outMaterial.emissiveTexture =
-                            loadImageOrReuse(imageCache, gltfModel, emissiveImage, loadedTextures);
-                } else {
-                    // if the object is not emissive, use white texture
-                    outMaterial.emissiveTexture = imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
+                if (!decoded.pixels) {
+                    return image;
                 }
-            }
 
-            VulkanCPUMaterial loadMaterialText(
-                    VulkanImageCache& imageCache,
-                    const tinygltf::Model& gltfModel,
-                    const tinygltf::Material& gltfMaterial,
-                    const std::filesystem::path& parentPath,
-                    UnorderedMap<String, ImageId>& loadedTextures) {
-                VulkanCPUMaterial material{};
-                material.baseColor = getColor(gltfMaterial);
-                material.metallic = static_cast<float>(gltfMaterial.pbrMetallicRoughness.metallicFactor);
-                material.roughness = static_cast<float>(gltfMaterial.pbrMetallicRoughness.roughnessFactor);
-                material.emissive = getEmissiveStrength(gltfMaterial);
-                material.emissiveColor = cvtTinyGltfVec4(gltfMaterial.emissiveFactor);
+                const size_t byteCount = static_cast<size_t>(decoded.width) * decoded.height * 4;
+                image.width = decoded.width;
+                image.height = decoded.height;
+                image.pixels = {builder.pixels.size(), byteCount};
+                builder.pixels.insert(builder.pixels.end(), decoded.pixels.get(), decoded.pixels.get() + byteCount);
 
-                loadMaterialImagesText(
-                        imageCache,
-                        gltfModel,
-                        gltfMaterial,
-                        parentPath,
-                        loadedTextures,
-                        material);
-
-                return material;
+                return image;
             }
 
-            VulkanCPUMaterial loadMaterialBinary(
-                    VulkanImageCache& imageCache,
-                    const tinygltf::Model& gltfModel,
-                    const tinygltf::Material& gltfMaterial,
-                    UnorderedMap<int, ImageId>& loadedTextures) {
-                VulkanCPUMaterial material{};
-                material.baseColor = getColor(gltfMaterial);
-                material.metallic = static_cast<float>(gltfMaterial.pbrMetallicRoughness.metallicFactor);
-                material.roughness = static_cast<float>(gltfMaterial.pbrMetallicRoughness.roughnessFactor);
-                material.emissive = getEmissiveStrength(gltfMaterial);
-                material.emissiveColor = cvtTinyGltfVec4(gltfMaterial.emissiveFactor);
-
-                loadMaterialImagesBinary(
-                        imageCache,
-                        gltfModel,
-                        gltfMaterial,
-                        loadedTextures,
-                        material);
+            // glTF leaves normals and tangents optional: without normals the client has to use flat normals and
+            // ignore any tangents, without tangents it has to derive mikktspace tangents itself
+            MeshAttributes::RepairOptions attributeRepairOptions(const tinygltf::Primitive& primitive) {
+                MeshAttributes::RepairOptions options{};
+                if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES) {
+                    return options;
+                }
 
-                return material;
+                const bool hasNormals = hasAccessor(primitive, GLTF_NORMALS_ACCESSOR);
+                options.generateNormals = !hasNormals;
+                options.normalMode = MeshAttributes::NormalMode::Flat;
+                options.generateTangents = !hasNormals || !hasAccessor(primitive, GLTF_TANGENTS_ACCESSOR);
+                return options;
             }
 
             VulkanCPUMesh loadPrimitive(
@@ -489,86 +395,53 @@ namespace moe {
 
                 if (primitive.indices != -1) {// load indices
                     const auto& indexAccessor = model.accessors[primitive.indices];
+                    MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
+                    mesh.indices.resize(indexAccessor.count);
+
                     switch (indexAccessor.componentType) {
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                            MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
-                            {
-                                const auto indices = getPackedBufferSpan<std::uint32_t>(model, indexAccessor);
-                                mesh.indices.assign(indices.begin(), indices.end());
-                            }
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                            const auto indices = getPackedBufferSpan<std::uint32_t>(model, indexAccessor);
+                            std::memcpy(mesh.indices.data(), indices.data(), indices.size() * sizeof(uint32_t));
                             break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                            MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
-                            {
-                                const auto indices = getPackedBufferSpan<std::uint16_t>(model, indexAccessor);
-                                mesh.indices.assign(indices.begin(), indices.end());
-                            }
+                        }
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                            const auto indices = getPackedBufferSpan<std::uint16_t>(model, indexAccessor);
+                            VertexKernels::widenIndices(indices.data(), mesh.indices.data(), indices.size());
                             break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                            MOE_ASSERT(indexAccessor.type == TINYGLTF_TYPE_SCALAR, "Invalid index accessor type");
-                            {
-                                const auto indices = getPackedBufferSpan<std::uint8_t>(model, indexAccessor);
-                                mesh.indices.reserve(indices.size());
-                                for (auto i: indices) {
-                                    mesh.indices.push_back(i);
-                                }
-                            }
+                        }
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                            const auto indices = getPackedBufferSpan<std::uint8_t>(model, indexAccessor);
+                            VertexKernels::widenIndices(indices.data(), mesh.indices.data(), indices.size());
                             break;
+                        }
                         default:
                             MOE_ASSERT(false, "Unsupported index component type");
                     }
                 }
 
-                // load positions
-                const auto positions =
-                        getPackedBufferSpan<glm::vec3>(model, primitive, GLTF_POSITIONS_ACCESSOR);
-                mesh.vertices.resize(positions.size());
-                for (std::size_t i = 0; i < positions.size(); ++i) {
-                    mesh.vertices[i].pos = positions[i];
-                }
+                // positions, normals, tangents and uvs are interleaved in a single pass
+                VertexKernels::VertexStreams streams{};
+                streams.positions = getAttributeStream(model, primitive, GLTF_POSITIONS_ACCESSOR, TINYGLTF_TYPE_VEC3);
+                streams.normals = getAttributeStream(model, primitive, GLTF_NORMALS_ACCESSOR, TINYGLTF_TYPE_VEC3);
+                streams.tangents = getAttributeStream(model, primitive, GLTF_TANGENTS_ACCESSOR, TINYGLTF_TYPE_VEC4);
+                streams.uvs = getAttributeStream(model, primitive, GLTF_UVS_ACCESSOR, TINYGLTF_TYPE_VEC2);
+                MOE_ASSERT(!streams.positions.empty(), "Accessor not found");
+
+                const auto numVertices = streams.positions.count;
+                MOE_ASSERT(streams.normals.empty() || streams.normals.count == numVertices, "Invalid number of normals");
+                MOE_ASSERT(streams.tangents.empty() || streams.tangents.count == numVertices, "Invalid number of tangents");
+                MOE_ASSERT(streams.uvs.empty() || streams.uvs.count == numVertices, "Invalid number of uvs");
+
+                mesh.vertices.resize(numVertices);
+                VertexKernels::interleaveVertices(mesh.vertices.data(), streams, numVertices);
 
                 {
                     // get min and max pos
-                    const auto posAccessorIndex = findAttributeAccessor(primitive, GLTF_POSITIONS_ACCESSOR);
-                    MOE_ASSERT(posAccessorIndex != -1, "Accessor not found");
-                    const auto& posAccessor = model.accessors[posAccessorIndex];
+                    const auto& posAccessor = model.accessors[findAttributeAccessor(primitive, GLTF_POSITIONS_ACCESSOR)];
                     mesh.min = cvtTinyGltfVec3(posAccessor.minValues);
                     mesh.max = cvtTinyGltfVec3(posAccessor.maxValues);
                 }
 
-                const auto numVertices = positions.size();
-
-                // load normals
-                if (hasAccessor(primitive, GLTF_NORMALS_ACCESSOR)) {
-                    const auto normals =
-                            getPackedBufferSpan<glm::vec3>(model, primitive, GLTF_NORMALS_ACCESSOR);
-                    MOE_ASSERT(normals.size() == numVertices, "Invalid number of normals");
-                    for (std::size_t i = 0; i < normals.size(); ++i) {
-                        mesh.vertices[i].normal = normals[i];
-                        // ! TEMP
-                    }
-                }
-
-                // load tangents
-                if (hasAccessor(primitive, GLTF_TANGENTS_ACCESSOR)) {
-                    const auto tangents =
-                            getPackedBufferSpan<glm::vec4>(model, primitive, GLTF_TANGENTS_ACCESSOR);
-                    MOE_ASSERT(tangents.size() == numVertices, "Invalid number of tangents");
-                    for (std::size_t i = 0; i < tangents.size(); ++i) {
-                        mesh.vertices[i].tangent = tangents[i];
-                    }
-                }
-
-                // load uvs
-                if (hasAccessor(primitive, GLTF_UVS_ACCESSOR)) {
-                    const auto uvs = getPackedBufferSpan<glm::vec2>(model, primitive, GLTF_UVS_ACCESSOR);
-                    MOE_ASSERT(uvs.size() == numVertices, "Invalid number of uvs");
-                    for (std::size_t i = 0; i < uvs.size(); ++i) {
-                        mesh.vertices[i].uv_x = uvs[i].x;// TEMP
-                        mesh.vertices[i].uv_y = uvs[i].y;// TEMP
-                    }
-                }
-
                 if (hasAccessor(primitive, GLTF_JOINTS_ACCESSOR)) {
                     MOE_ASSERT(hasAccessor(primitive, GLTF_WEIGHTS_ACCESSOR), "Joints accessor found without weights accessor");
 
@@ -754,11 +627,10 @@ namespace moe {
                 return skeleton;
             }
 
-            UnorderedMap<String, AnimationId> loadAnimations(
+            UnorderedMap<String, VulkanSkeletonAnimation> decodeAnimations(
                     const VulkanSkeleton& skeleton,
                     const UnorderedMap<int, JointId>& gltfNodeIdxToJointId,
-                    const tinygltf::Model& gltfModel,
-                    VulkanEngine& engine) {
+                    const tinygltf::Model& gltfModel) {
                 UnorderedMap<String, VulkanSkeletonAnimation> animations(gltfModel.animations.size());
                 for (const auto& gltfAnimation: gltfModel.animations) {
                     Logger::debug("Loading animation: {}", gltfAnimation.name);
@@ -848,108 +720,658 @@ namespace moe {
                     }
                 }
 
-                UnorderedMap<String, AnimationId> animationNameToId{animations.size()};
-                for (auto& [name, animation]: animations) {
-                    AnimationId id = engine.m_caches.animationCache.load(std::move(animation)).first;
-                    animationNameToId[name] = id;
+                return animations;
+            }
+
+            VulkanCookedScene::Skeleton cookSkeleton(VulkanCookedScene::Builder& builder, const VulkanSkeleton& skeleton) {
+                VulkanCookedScene::Skeleton cooked{};
+                cooked.joints = {builder.joints.size(), skeleton.joints.size()};
+
+                for (JointId jointId = 0; jointId < skeleton.joints.size(); ++jointId) {
+                    const auto& children = skeleton.hierarchy[jointId].children;
+
+                    VulkanCookedScene::Joint joint{};
+                    joint.localTransform = skeleton.joints[jointId].localTransform;
+                    joint.inverseBindMatrix = skeleton.inverseBindMatrices[jointId];
+                    joint.children = {builder.jointChildren.size(), children.size()};
+                    joint.name = builder.addString(skeleton.jointNames[jointId]);
+
+                    builder.jointChildren.insert(builder.jointChildren.end(), children.begin(), children.end());
+                    builder.joints.push_back(joint);
                 }
 
-                return animationNameToId;
+                return cooked;
             }
 
-            void loadNode(VulkanSceneNode& node, const tinygltf::Node& gltfNode, const tinygltf::Model& model) {
-                node.localTransform = loadTransform(gltfNode);
-                // MOE_ASSERT(gltfNode.mesh != -1, "Node is not a mesh");
+            template<typename T>
+            VulkanCookedScene::KeyRange cookKeys(
+                    Vector<T>& outKeys, Vector<float>& outTimes,
+                    const Vector<T>& keys, const Vector<float>& times) {
+                MOE_ASSERT(keys.size() == times.size(), "Animation key and time count mismatch");
+
+                VulkanCookedScene::KeyRange range{outKeys.size(), outTimes.size(), keys.size()};
+                outKeys.insert(outKeys.end(), keys.begin(), keys.end());
+                outTimes.insert(outTimes.end(), times.begin(), times.end());
+                return range;
+            }
 
-                if (isMesh(gltfNode)) {
-                    node.resourceInternalId = static_cast<GLTFInternalId>(gltfNode.mesh);
-                    //Logger::debug("Loaded mesh: {}", gltfNode.name);
-                } else {
-                    node.resourceInternalId = NULL_SCENE_RESOURCE_INTERNAL_ID;
-                    //Logger::debug("Loaded empty node: {}", gltfNode.name);
+            VulkanCookedScene::Animation cookAnimation(VulkanCookedScene::Builder& builder, const VulkanSkeletonAnimation& animation) {
+                VulkanCookedScene::Animation cooked{};
+                cooked.tracks = {builder.tracks.size(), animation.tracks.size()};
+                cooked.name = builder.addString(animation.name);
+
+                for (const auto& track: animation.tracks) {
+                    VulkanCookedScene::Track cookedTrack{};
+                    cookedTrack.translations = cookKeys(
+                            builder.translationKeys, builder.keyTimes,
+                            track.translations, track.keyTimes.translations);
+                    cookedTrack.rotations = cookKeys(
+                            builder.rotationKeys, builder.keyTimes,
+                            track.rotations, track.keyTimes.rotations);
+                    cookedTrack.scales = cookKeys(
+                            builder.scaleKeys, builder.keyTimes,
+                            track.scales, track.keyTimes.scales);
+                    builder.tracks.push_back(cookedTrack);
                 }
 
-                node.children.reserve(gltfNode.children.size());
-                for (std::size_t childIdx = 0; childIdx < gltfNode.children.size(); ++childIdx) {
-                    const auto& childNode = model.nodes[gltfNode.children[childIdx]];
+                return cooked;
+            }
 
-                    auto childPtr = std::make_unique<VulkanSceneNode>();
-                    auto& child = *static_cast<VulkanSceneNode*>(childPtr.get());
-                    loadNode(child, childNode, model);
+            void cookNode(
+                    VulkanCookedScene::Builder& builder,
+                    const tinygltf::Model& model,
+                    const tinygltf::Node& gltfNode,
+                    uint32_t parent,
+                    const glm::mat4& parentTransform = glm::mat4(1.0f)) {
+                const auto nodeIdx = static_cast<uint32_t>(builder.nodes.size());
+
+                VulkanCookedScene::Node node{};
+                node.localTransform = parentTransform * loadTransform(gltfNode);
+                node.parent = parent;
+                node.mesh = isMesh(gltfNode)
+                                    ? static_cast<SceneResourceInternalId>(gltfNode.mesh)
+                                    : NULL_SCENE_RESOURCE_INTERNAL_ID;
+                builder.nodes.push_back(node);
+
+                for (const auto& childIdx: gltfNode.children) {
+                    cookNode(builder, model, model.nodes[childIdx], nodeIdx);
+                }
+            }
 
-                    node.children.push_back(std::move(childPtr));
+            void cookSceneNodes(VulkanCookedScene::Builder& builder, const tinygltf::Model& model) {
+                auto& scene = model.scenes[model.defaultScene];
+
+                for (const auto& rootIdx: scene.nodes) {
+                    const auto& gltfNode = model.nodes[rootIdx];
+
+                    // ! the original imlementation from edbr.
+                    // ! preserve for now
+                    // HACK: load mesh with skin (for now only one assumed)
+                    if (gltfNode.children.size() == 2) {
+                        const auto& c1 = model.nodes[gltfNode.children[0]];
+                        const auto& c2 = model.nodes[gltfNode.children[1]];
+                        if ((c1.mesh != -1 && c1.skin != -1) || (c2.mesh != -1 && c2.skin != -1)) {
+                            const auto& meshNode = (c1.mesh != -1) ? c1 : c2;
+
+                            // sometimes the armature node can have scaling
+                            // this is BAD, but we can't avoid it for models
+                            cookNode(builder, model, meshNode, VulkanCookedScene::NO_PARENT, loadTransform(gltfNode));
+                            continue;
+                        }
+                    }
+
+                    cookNode(builder, model, gltfNode, VulkanCookedScene::NO_PARENT);
                 }
             }
 
-            Optional<VulkanScene> loadSceneFromFile(VulkanEngine& engine, StringView filename) {
-                auto& meshCache = engine.m_caches.meshCache;
-                auto& materialCache = engine.m_caches.materialCache;
-                auto& imageCache = engine.m_caches.imageCache;
+            // word-wise FNV-1a, only used to tell source revisions apart
+            uint64_t hashBytes(Span<const uint8_t> data, uint64_t hash) {
+                constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+                size_t i = 0;
+                for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+                    uint64_t word;
+                    std::memcpy(&word, data.data() + i, sizeof(word));
+                    hash = (hash ^ word) * FNV_PRIME;
+                }
+                for (; i < data.size(); ++i) {
+                    hash = (hash ^ data[i]) * FNV_PRIME;
+                }
+                return (hash ^ data.size()) * FNV_PRIME;
+            }
+
+            // glTF uris are percent encoded, e.g. "my%20mesh.bin"
+            String decodeUri(StringView uri) {
+                auto hexValue = [](char c) -> int {
+                    if (c >= '0' && c <= '9') return c - '0';
+                    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                    return -1;
+                };
+
+                String decoded;
+                decoded.reserve(uri.size());
+                for (size_t i = 0; i < uri.size(); ++i) {
+                    if (uri[i] == '%' && i + 2 < uri.size()) {
+                        const int hi = hexValue(uri[i + 1]);
+                        const int lo = hexValue(uri[i + 2]);
+                        if (hi >= 0 && lo >= 0) {
+                            decoded.push_back(static_cast<char>((hi << 4) | lo));
+                            i += 2;
+                            continue;
+                        }
+                    }
+                    decoded.push_back(uri[i]);
+                }
+                return decoded;
+            }
+
+            // the external buffers a text glTF references, in buffer order; embedded data: uris are part of the file
+            Vector<String> externalBufferUris(Span<const uint8_t> gltfText) {
+                // no exceptions, a malformed file hashes as just its own bytes and fails later when parsed for real
+                const auto json = nlohmann::json::parse(gltfText.begin(), gltfText.end(), nullptr, false);
+                if (json.is_discarded() || !json.is_object()) {
+                    return {};
+                }
+                const auto buffers = json.find("buffers");
+                if (buffers == json.end() || !buffers->is_array()) {
+                    return {};
+                }
+
+                Vector<String> uris;
+                for (const auto& buffer: *buffers) {
+                    if (!buffer.is_object()) {
+                        continue;
+                    }
+                    const auto uri = buffer.find("uri");
+                    if (uri == buffer.end() || !uri->is_string()) {
+                        continue;
+                    }
+                    const auto& value = uri->get_ref<const std::string&>();
+                    if (value.rfind("data:", 0) == 0) {
+                        continue;
+                    }
+                    uris.push_back(decodeUri(value));
+                }
+                return uris;
+            }
+
+            uint64_t hashSourceFiles(StringView filename, Span<const uint8_t> parameters) {
+                constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
 
                 const std::filesystem::path path = filename;
-                const auto parentPath = path.parent_path();
+                uint64_t hash = hashBytes(parameters, FNV_OFFSET_BASIS);
 
-                tinygltf::Model model;
-                auto modelType = loadGltfFile(model, path, parentPath);
+                size_t fileSize = 0;
+                auto fileBuf = FileReader::s_instance->readFile(path.string(), fileSize);
+                if (!fileBuf) {
+                    Logger::warn("Failed to read glTF source file: {}", path.string());
+                    return hash;
+                }
+                const Span<const uint8_t> file(fileBuf->data(), fileSize);
+                hash = hashBytes(file, hash);
 
-                //Logger::debug("GLTF file contains {} scenes", model.scenes.size());
-                auto& scene = model.scenes[model.defaultScene];
-                UnorderedMap<GLTFInternalId, MaterialId> materialMap;
+                // glb buffers are embedded, a text glTF names its buffers relative to itself.
+                // only the referenced files count, unrelated .bin files in the same directory do not invalidate it
+                if (selectModelType(path) != ModelType::Gltf) {
+                    return hash;
+                }
+                for (const auto& uri: externalBufferUris(file)) {
+                    const auto source = path.parent_path() / uri;
+                    size_t bufferSize = 0;
+                    auto buffer = FileReader::s_instance->readFile(source.string(), bufferSize);
+                    if (!buffer) {
+                        Logger::warn("Failed to read glTF source file: {}", source.string());
+                        continue;
+                    }
+                    hash = hashBytes(Span<const uint8_t>(buffer->data(), bufferSize), hash);
+                }
 
-                if (modelType == ModelType::Gltf) {
-                    UnorderedMap<String, ImageId> loadedTextures;
-                    for (GLTFInternalId i = 0; i < model.materials.size(); ++i) {
-                        auto& mat = model.materials[i];
-                        MaterialId id = materialCache.loadMaterial(loadMaterialText(imageCache, model, mat, parentPath, loadedTextures));
-                        materialMap[i] = id;
+                return hash;
+            }
+
+            Asset::Asset(StringView filename)
+                : m_filename(filename), m_model(std::make_unique<tinygltf::Model>()) {
+                const std::filesystem::path path = m_filename;
+                const auto modelType = loadGltfFile(*m_model, path, path.parent_path(), &m_encodedImages);
+                if (!modelType) {
+                    return;
+                }
+                m_loaded = true;
+                m_binary = *modelType == ModelType::Glb;
+                m_encodedImages.resize(m_model->images.size());
+
+                m_firstPrimitives.reserve(m_model->meshes.size());
+                size_t primitiveCount = 0;
+                for (const auto& mesh: m_model->meshes) {
+                    m_firstPrimitives.push_back(primitiveCount);
+                    primitiveCount += mesh.primitives.size();
+                }
+
+                m_primitives.resize(primitiveCount);
+                m_decodeOnce = std::make_unique<std::once_flag[]>(primitiveCount);
+            }
+
+            Asset::~Asset() = default;
+
+            Span<const uint8_t> Asset::getEncodedImage(size_t imageIdx) const {
+                const auto& encoded = m_encodedImages[imageIdx];
+                return Span<const uint8_t>(encoded.data(), encoded.size());
+            }
+
+            const VulkanCPUMesh& Asset::getPrimitive(size_t primitiveIdx) const {
+                MOE_ASSERT(primitiveIdx < m_primitives.size(), "Primitive index out of range");
+
+                std::call_once(m_decodeOnce[primitiveIdx], [this, primitiveIdx]() {
+                    auto meshIt = std::upper_bound(m_firstPrimitives.begin(), m_firstPrimitives.end(), primitiveIdx);
+                    const auto meshIdx = static_cast<size_t>(meshIt - m_firstPrimitives.begin()) - 1;
+                    const auto& mesh = m_model->meshes[meshIdx];
+                    m_primitives[primitiveIdx] = loadPrimitive(*m_model, mesh.primitives[primitiveIdx - m_firstPrimitives[meshIdx]]);
+                });
+                return m_primitives[primitiveIdx];
+            }
+
+            namespace Detail {
+                // only weak references, an asset is released with its last consumer
+                struct AssetCache {
+                    struct Entry {
+                        WeakPtr<const Asset> asset;
+                        // held while the file is parsed, so a second consumer waits instead of parsing again
+                        SharedPtr<std::mutex> parseMutex{std::make_shared<std::mutex>()};
+                    };
+
+                    std::mutex mutex;
+                    UnorderedMap<String, Entry> entries;
+
+                    static AssetCache& get() {
+                        static AssetCache instance;
+                        return instance;
                     }
-                } else {
-                    UnorderedMap<int, ImageId> loadedTextures;
-                    for (GLTFInternalId i = 0; i < model.materials.size(); ++i) {
-                        auto& mat = model.materials[i];
-                        MaterialId id = materialCache.loadMaterial(loadMaterialBinary(imageCache, model, mat, loadedTextures));
-                        materialMap[i] = id;
+                };
+            }// namespace Detail
+
+            SharedPtr<const Asset> acquireAsset(StringView filename) {
+                auto& cache = Detail::AssetCache::get();
+                const String key = std::filesystem::path(filename).lexically_normal().string();
+
+                SharedPtr<std::mutex> parseMutex;
+                {
+                    std::lock_guard lock(cache.mutex);
+                    auto& entry = cache.entries[key];
+                    if (auto asset = entry.asset.lock()) {
+                        return asset;
                     }
+                    parseMutex = entry.parseMutex;
                 }
 
-                VulkanScene vkScene{};
+                std::lock_guard parseLock(*parseMutex);
+                {
+                    std::lock_guard lock(cache.mutex);
+                    if (auto asset = cache.entries[key].asset.lock()) {
+                        return asset;
+                    }
+                }
+
+                auto asset = std::make_shared<const Asset>(filename);
+                if (!asset->isLoaded()) {
+                    // not cached, a later call tries again
+                    return nullptr;
+                }
+                Logger::debug("Parsed glTF asset: {}", filename);
+
+                std::lock_guard lock(cache.mutex);
+                // entries of released assets nobody is parsing are dropped on the way
+                for (auto it = cache.entries.begin(); it != cache.entries.end();) {
+                    if (it->first != key && it->second.asset.expired() && it->second.parseMutex.use_count() == 1) {
+                        it = cache.entries.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                cache.entries[key].asset = asset;
+                return asset;
+            }
+
+            SceneCooker::SceneCooker(StringView filename)
+                : m_filename(filename) {
+                // the cooker version is part of the key, so changing the cooking invalidates old files too
+                const uint32_t version = VulkanCookedScene::VERSION;
+                m_hash = hashSourceFiles(
+                        m_filename,
+                        Span<const uint8_t>(reinterpret_cast<const uint8_t*>(&version), sizeof(version)));
+            }
+
+            Optional<VulkanCookedScene> SceneCooker::generate() {
+                // shared with other consumers of the file, e.g. a collider built from the same scene
+                const auto asset = acquireAsset(m_filename);
+                if (!asset) {
+                    return std::nullopt;
+                }
+                const auto& model = asset->getModel();
+                const auto modelType = asset->isBinary() ? ModelType::Glb : ModelType::Gltf;
+
+                VulkanCookedScene::Builder builder;
+
+                builder.materials.reserve(model.materials.size());
+                for (const auto& material: model.materials) {
+                    builder.materials.push_back(cookMaterial(model, material));
+                }
+
+                // primitives (decoded and optimized) and embedded images are processed in parallel, each into its own slot,
+                // then appended to the builder in file order so the cooked output does not depend on scheduling
+                Vector<const tinygltf::Primitive*> primitives;
                 for (const auto& mesh: model.meshes) {
+                    for (const auto& primitive: mesh.primitives) {
+                        primitives.push_back(&primitive);
+                    }
+                }
+                const size_t imageCount = model.images.size();
+
+                // embedded images are decoded anyway, external ones are only opened when their alpha matters
+                Vector<uint8_t> diffuseImages(imageCount, 0);
+                for (const auto& material: builder.materials) {
+                    const int32_t diffuse = material.textures[VulkanCookedScene::Diffuse];
+                    if (diffuse >= 0 && static_cast<size_t>(diffuse) < imageCount) {
+                        diffuseImages[diffuse] = 1;
+                    }
+                }
+
+                Vector<VulkanCPUMesh> decodedPrimitives(primitives.size());
+                Vector<MeshAttributes::RepairReport> repairReports(primitives.size());
+                Vector<MeshOptimizer::Report> optimizeReports(primitives.size());
+                Vector<DecodedImage> decodedImages(imageCount);
+
+                auto decodeStart = std::chrono::steady_clock::now();
+                parallelForInline(
+                        primitives.size() + imageCount,
+                        [&](size_t item) {
+                            if (item < primitives.size()) {
+                                decodedPrimitives[item] = asset->getPrimitive(item);
+                                repairReports[item] = MeshAttributes::repairMesh(
+                                        decodedPrimitives[item], attributeRepairOptions(*primitives[item]));
+                                optimizeReports[item] = MeshOptimizer::optimizeMesh(decodedPrimitives[item]);
+                                MeshOptimizer::buildLodChain(decodedPrimitives[item]);
+                                MeshOptimizer::buildMeshlets(decodedPrimitives[item]);
+                            } else {
+                                const size_t imageIdx = item - primitives.size();
+                                if (modelType == ModelType::Glb) {
+                                    decodedImages[imageIdx] = decodeImage(model.images[imageIdx], asset->getEncodedImage(imageIdx));
+                                } else if (diffuseImages[imageIdx]) {
+                                    const std::filesystem::path path = m_filename;
+                                    decodedImages[imageIdx].opaque =
+                                            isImageFileOpaque(path.parent_path() / model.images[imageIdx].uri);
+                                }
+                            }
+                        });
+                Logger::debug(
+                        "Decoded {} primitives and {} images of {} in {:.2f} ms ({} vertex kernels)",
+                        primitives.size(), imageCount, m_filename,
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart).count(),
+                        VertexKernels::backendName());
+
+                size_t generatedNormals = 0, generatedTangents = 0;
+                MeshAttributes::RepairReport repairReport{};
+                for (const auto& report: repairReports) {
+                    generatedNormals += report.generatedNormals;
+                    generatedTangents += report.generatedTangents;
+                    repairReport += report;
+                }
+                if (generatedNormals > 0 || generatedTangents > 0 || repairReport.repairedVectors > 0) {
+                    Logger::info(
+                            "Repaired vertex attributes of {}: normals generated for {} and tangents for {} of {} primitives, "
+                            "{} vectors renormalized, {} vertices split",
+                            m_filename, generatedNormals, generatedTangents, primitives.size(),
+                            repairReport.repairedVectors, repairReport.splitVertices);
+                }
+
+                MeshOptimizer::Report optimizeReport{};
+                for (const auto& report: optimizeReports) {
+                    optimizeReport += report;
+                }
+                Logger::info(
+                        "Optimized meshes of {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} duplicate vertices welded",
+                        m_filename,
+                        optimizeReport.before.acmr(), optimizeReport.after.acmr(),
+                        optimizeReport.before.atvr(), optimizeReport.after.atvr(),
+                        optimizeReport.weldedVertices);
+
+                size_t lodCount = 0, meshletCount = 0;
+                for (const auto& cpuMesh: decodedPrimitives) {
+                    lodCount += cpuMesh.lods.size();
+                    meshletCount += cpuMesh.meshlets.size();
+                }
+                Logger::debug(
+                        "Built {} lods and {} meshlets for {} primitives of {}",
+                        lodCount, meshletCount, primitives.size(), m_filename);
+
+                builder.images.reserve(model.images.size());
+                for (size_t imageIdx = 0; imageIdx < model.images.size(); ++imageIdx) {
+                    builder.images.push_back(cookImage(builder, model.images[imageIdx], modelType, decodedImages[imageIdx]));
+                }
+                Vector<DecodedImage>{}.swap(decodedImages);
+
+                size_t vertexCount = 0, indexCount = 0, skinningDataCount = 0;
+                for (const auto& cpuMesh: decodedPrimitives) {
+                    vertexCount += cpuMesh.vertices.size();
+                    indexCount += cpuMesh.indices.size();
+                    skinningDataCount += cpuMesh.skinningData.size();
+                }
+                builder.vertices.reserve(vertexCount);
+                builder.indices.reserve(indexCount);
+                builder.skinningData.reserve(skinningDataCount);
+
+                builder.meshes.reserve(model.meshes.size());
+                builder.primitives.reserve(primitives.size());
+                for (const auto& mesh: model.meshes) {
+                    builder.meshes.push_back({
+                            static_cast<uint32_t>(builder.primitives.size()),
+                            static_cast<uint32_t>(mesh.primitives.size()),
+                    });
+                    for (const auto& primitive: mesh.primitives) {
+                        auto& cpuMesh = decodedPrimitives[builder.primitives.size()];
+                        builder.primitives.push_back(builder.addPrimitive(cpuMesh, primitive.material));
+                        cpuMesh = {};
+                    }
+                }
+
+                // ! fixme: only one skeleton is supported, animations are decoded against the first one
+                UnorderedMap<int, JointId> nodeIdxToJointId;
+                Optional<VulkanSkeleton> firstSkeleton;
+                for (const auto& skin: model.skins) {
+                    auto skeleton = loadSkeleton(nodeIdxToJointId, model, skin);
+                    builder.skeletons.push_back(cookSkeleton(builder, skeleton));
+                    if (!firstSkeleton) {
+                        firstSkeleton = std::move(skeleton);
+                    }
+                }
+
+                if (firstSkeleton) {
+                    for (const auto& [name, animation]: decodeAnimations(*firstSkeleton, nodeIdxToJointId, model)) {
+                        builder.animations.push_back(cookAnimation(builder, animation));
+                    }
+                }
+
+                cookSceneNodes(builder, model);
+
+                Logger::info("Cooked glTF scene: {}", m_filename);
+                return VulkanCookedScene::build(builder);
+            }
+
+            String SceneCooker::paramString() const {
+                // the parameter becomes part of the cache file name
+                String param = fmt::format("gltf_scene_{}", m_filename);
+                std::replace_if(
+                        param.begin(), param.end(),
+                        [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); },
+                        '_');
+                return param;
+            }
+
+            ImageId loadCookedImage(
+                    VulkanImageCache& imageCache,
+                    const VulkanCookedScene& cooked,
+                    const VulkanCookedScene::Image& image,
+                    const std::filesystem::path& parentPath) {
+                if (image.pixels.count > 0) {
+                    auto pixels = cooked.slice(cooked.pixels, image.pixels);
+                    return imageCache.loadStreamedImageFromMemory(
+                            Span<uint8_t>{const_cast<uint8_t*>(pixels.data()), pixels.size()},
+                            VkExtent2D{image.width, image.height},
+                            VK_FORMAT_R8G8B8A8_SRGB,
+                            VK_IMAGE_USAGE_SAMPLED_BIT);
+                }
+
+                if (image.path.count > 0) {
+                    const auto imagePath = parentPath / String(cooked.string(image.path));
+                    return imageCache.loadStreamedImageFromFile(imagePath.string(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_USAGE_SAMPLED_BIT);
+                }
+
+                return imageCache.getDefaultImage(VulkanImageCache::DefaultResourceType::White);
+            }
+
+            Vector<MaterialId> registerMaterials(
+                    VulkanEngine& engine,
+                    const VulkanCookedScene& cooked,
+                    const std::filesystem::path& parentPath) {
+                auto& materialCache = engine.m_caches.materialCache;
+                auto& imageCache = engine.m_caches.imageCache;
+
+                // images are loaded on first use and shared by every material referencing them
+                Vector<Optional<ImageId>> imageIds(cooked.images.size());
+                auto getImage = [&](int32_t imageIdx, VulkanImageCache::DefaultResourceType fallback) {
+                    if (imageIdx == VulkanCookedScene::NO_REFERENCE) {
+                        return imageCache.getDefaultImage(fallback);
+                    }
+
+                    auto& imageId = imageIds[imageIdx];
+                    if (!imageId) {
+                        imageId = loadCookedImage(imageCache, cooked, cooked.images[imageIdx], parentPath);
+                    }
+                    return *imageId;
+                };
+
+                Vector<MaterialId> materialIds;
+                materialIds.reserve(cooked.materials.size());
+                for (const auto& cookedMaterial: cooked.materials) {
+                    VulkanCPUMaterial material{};
+                    material.baseColor = cookedMaterial.baseColor;
+                    material.metallic = cookedMaterial.metallic;
+                    material.roughness = cookedMaterial.roughness;
+                    material.emissive = cookedMaterial.emissive;
+                    material.emissiveColor = cookedMaterial.emissiveColor;
+
+                    material.diffuseTexture = getImage(
+                            cookedMaterial.textures[VulkanCookedScene::Diffuse],
+                            VulkanImageCache::DefaultResourceType::White);
+                    material.normalTexture = getImage(
+                            cookedMaterial.textures[VulkanCookedScene::Normal],
+                            VulkanImageCache::DefaultResourceType::FlatNormal);
+                    material.metallicRoughnessTexture = getImage(
+                            cookedMaterial.textures[VulkanCookedScene::MetallicRoughness],
+                            VulkanImageCache::DefaultResourceType::White);
+                    // if the object is not emissive, use white texture
+                    material.emissiveTexture = getImage(
+                            cookedMaterial.textures[VulkanCookedScene::Emissive],
+                            VulkanImageCache::DefaultResourceType::White);
+
+                    materialIds.push_back(materialCache.loadMaterial(material));
+                }
+
+                return materialIds;
+            }
+
+            UnorderedMap<String, AnimationId> registerAnimations(VulkanEngine& engine, const VulkanCookedScene& cooked) {
+                UnorderedMap<String, AnimationId> animationNameToId{cooked.animations.size()};
+                for (const auto& cookedAnimation: cooked.animations) {
+                    AnimationId id = engine.m_caches.animationCache.load(cooked.makeAnimation(cookedAnimation)).first;
+                    animationNameToId[String(cooked.string(cookedAnimation.name))] = id;
+                }
+
+                return animationNameToId;
+            }
+
+            void instantiateNodes(VulkanScene& vkScene, const VulkanCookedScene& cooked) {
+                // cooked nodes are in pre-order already, the hierarchy keeps their order and indices
+                vkScene.hierarchy.reserve(cooked.nodes.size());
+                for (const auto& cookedNode: cooked.nodes) {
+                    const auto parent = cookedNode.parent == VulkanCookedScene::NO_PARENT
+                                                ? TransformHierarchy::NO_PARENT
+                                                : static_cast<TransformHierarchy::NodeIndex>(cookedNode.parent);
+                    vkScene.addNode(parent, cookedNode.localTransform, cookedNode.mesh);
+                }
+            }
+
+            Optional<VulkanGPUMesh> uploadPrimitive(
+                    VulkanEngine& engine,
+                    const VulkanCookedScene& cooked,
+                    const VulkanCookedScene::Primitive& primitive) {
+                if (primitive.indices.count == 0 || primitive.vertices.count == 0) {
+                    return std::nullopt;
+                }
+
+                // straight from the cache file buffer into staging
+                auto buffer = engine.uploadMesh(
+                        cooked.slice(cooked.indices, primitive.indices),
+                        cooked.slice(cooked.vertices, primitive.vertices),
+                        cooked.slice(cooked.skinningData, primitive.skinningData),
+                        cooked.slice(cooked.lods, primitive.lods));
+                return VulkanGPUMesh{
+                        .gpuBuffer = std::move(buffer),
+                        .min = primitive.min,
+                        .max = primitive.max,
+                };
+            }
+
+            // main thread only, primitives holds the uploaded mesh of every cooked primitive
+            VulkanScene registerScene(
+                    VulkanEngine& engine,
+                    const VulkanCookedScene& cooked,
+                    const std::filesystem::path& parentPath,
+                    Vector<Optional<VulkanGPUMesh>>& primitives) {
+                auto& meshCache = engine.m_caches.meshCache;
+                auto& materialCache = engine.m_caches.materialCache;
+
+                auto materialIds = registerMaterials(engine, cooked, parentPath);
+
+                VulkanScene vkScene{};
+                vkScene.meshes.reserve(cooked.meshes.size());
+                for (const auto& mesh: cooked.meshes) {
                     VulkanSceneMesh vkMesh{};
-                    vkMesh.primitives.resize(mesh.primitives.size());
-                    vkMesh.primitiveMaterials.resize(mesh.primitives.size());
+                    vkMesh.primitives.resize(mesh.primitiveCount);
+                    vkMesh.primitiveMaterials.resize(mesh.primitiveCount);
 
-                    for (int i = 0; i < mesh.primitives.size(); ++i) {
-                        const auto& primitive = mesh.primitives[i];
-                        auto cpuMesh = loadPrimitive(model, primitive);
-                        if (cpuMesh.indices.empty() || cpuMesh.vertices.empty()) {
+                    for (uint32_t i = 0; i < mesh.primitiveCount; ++i) {
+                        const auto primitiveIdx = mesh.firstPrimitive + i;
+                        auto& uploaded = primitives[primitiveIdx];
+                        if (!uploaded.has_value()) {
                             continue;
                         }
 
-                        auto meshId = meshCache.loadMesh(cpuMesh);
-                        // cpuMesh.discard();
-                        // discard the data to prevent extra memory usage
-                        // ! fixme: after being discarded, other modules (e.g. physics) can't access the data
-                        // ! find a proper place to perform this operation
+                        vkMesh.primitives[i] = meshCache.addMesh(std::move(*uploaded));
 
-                        MaterialId materialId = materialCache.getDefaultMaterial(VulkanMaterialCache::DefaultResourceType::White);
-
-                        if (primitive.material != -1) {
-                            materialId = materialMap.at(primitive.material);
+                        // cutout and translucent materials discard texels, they must not hide what is behind them
+                        const auto& primitive = cooked.primitives[primitiveIdx];
+                        if (cooked.isOccluder(primitive)) {
+                            engine.getOcclusionCuller().setMeshOccluder(
+                                    vkMesh.primitives[i],
+                                    cooked.slice(cooked.vertices, primitive.vertices),
+                                    cooked.slice(cooked.indices, primitive.indices),
+                                    cooked.slice(cooked.lods, primitive.lods));
                         }
 
-                        vkMesh.primitives[i] = meshId;
-                        vkMesh.primitiveMaterials[i] = materialId;
+                        const auto material = primitive.material;
+                        vkMesh.primitiveMaterials[i] =
+                                material != VulkanCookedScene::NO_REFERENCE
+                                        ? materialIds[material]
+                                        : materialCache.getDefaultMaterial(VulkanMaterialCache::DefaultResourceType::White);
                     }
 
-                    vkScene.meshes.push_back(vkMesh);
+                    vkScene.meshes.push_back(std::move(vkMesh));
                 }
 
-                // ! fixme: only one skeleton is supported
-                UnorderedMap<int, JointId> nodeIdxToJointId;
-                vkScene.skeletons.reserve(model.skins.size());
-                for (const auto& skin: model.skins) {
-                    auto skeleton = loadSkeleton(nodeIdxToJointId, model, skin);
-                    vkScene.skeletons.push_back(std::move(skeleton));
+                vkScene.skeletons.reserve(cooked.skeletons.size());
+                for (const auto& skeleton: cooked.skeletons) {
+                    vkScene.skeletons.push_back(cooked.makeSkeleton(skeleton));
                 }
 
                 Logger::debug("Loaded {} skeletons", vkScene.skeletons.size());
@@ -958,48 +1380,142 @@ namespace moe {
                     Logger::warn("Only one skeleton is supported, but {} skeletons found", vkScene.skeletons.size());
                 }
 
-                if (!vkScene.skeletons.empty()) {
-                    vkScene.animations = loadAnimations(vkScene.skeletons[0], nodeIdxToJointId, model, engine);
+                if (!cooked.animations.empty()) {
+                    vkScene.animations = registerAnimations(engine, cooked);
                     Logger::debug("Loaded {} animations", vkScene.animations.size());
                 }
 
                 // todo: joint animation lighting
 
-                vkScene.children.reserve(scene.nodes.size());
-                for (std::size_t nodeIdx = 0; nodeIdx < scene.nodes.size(); ++nodeIdx) {
-                    const auto& gltfNode = model.nodes[scene.nodes[nodeIdx]];
+                instantiateNodes(vkScene, cooked);
 
-                    // ! the original imlementation from edbr.
-                    // ! preserve for now
-                    // HACK: load mesh with skin (for now only one assumed)
-                    if (gltfNode.children.size() == 2) {
-                        const auto& c1 = model.nodes[gltfNode.children[0]];
-                        const auto& c2 = model.nodes[gltfNode.children[1]];
-                        if ((c1.mesh != -1 && c1.skin != -1) || (c2.mesh != -1 && c2.skin != -1)) {
-                            const auto& meshNode = (c1.mesh != -1) ? c1 : c2;
+                return vkScene;
+            }
 
-                            auto& nodePtr = vkScene.children[nodeIdx];
-                            nodePtr = std::make_unique<VulkanSceneNode>();
-                            auto& node = *static_cast<VulkanSceneNode*>(nodePtr.get());
-                            loadNode(node, meshNode, model);
+            Optional<VulkanCookedScene> loadCookedScene(StringView filename, const SceneLoadOptions& options) {
+                auto cooked = Cached<SceneCooker>(filename).get();
+                if (!cooked) {
+                    Logger::error("Failed to load glTF scene: {}", filename);
+                    return cooked;
+                }
 
-                            // sometimes the armature node can have scaling
-                            // this is BAD, but we can't avoid it for models
-                            const auto parentTransform = loadTransform(gltfNode);
-                            node.localTransform = parentTransform * node.localTransform;
+                if (options.mergeStaticGeometry) {
+                    StaticBatching::Report report{};
+                    cooked = StaticBatching::mergeStaticGeometry(*cooked, options.staticBatching, &report);
+                    Logger::info(
+                            "Merged {} static primitive instances of {} into {} batches",
+                            report.mergedInstances, filename, report.batches);
+                }
+                return cooked;
+            }
 
-                            continue;
-                        }
+            Optional<VulkanScene> loadSceneFromFile(VulkanEngine& engine, StringView filename, const SceneLoadOptions& options) {
+                auto cooked = loadCookedScene(filename, options);
+                if (!cooked) {
+                    return std::nullopt;
+                }
+
+                Vector<Optional<VulkanGPUMesh>> primitives;
+                primitives.reserve(cooked->primitives.size());
+                for (const auto& primitive: cooked->primitives) {
+                    primitives.push_back(uploadPrimitive(engine, *cooked, primitive));
+                }
+
+                const auto parentPath = std::filesystem::path(filename).parent_path();
+                return registerScene(engine, *cooked, parentPath, primitives);
+            }
+
+            struct AsyncSceneLoad {
+                enum class Stage {
+                    Loading,
+                    Uploading,
+                    Registering,
+                    Done,
+                };
+
+                Stage stage{Stage::Loading};
+                Optional<Future<void, ThreadPoolScheduler>> pending;
+
+                String filename;
+                std::filesystem::path parentPath;
+                SceneLoadOptions options;
+
+                // written by the load task, read-only while uploading; nullopt when the file could not be loaded
+                Optional<VulkanCookedScene> cooked;
+
+                // one slot per cooked primitive, so workers never share one
+                Vector<Optional<VulkanGPUMesh>> primitives;
+            };
+
+            Future<void, ThreadPoolScheduler> uploadScene(VulkanEngine& engine, const SharedPtr<AsyncSceneLoad>& load) {
+                if (!load->cooked) {
+                    return parallelFor(0, [](size_t) {});
+                }
+
+                load->primitives.resize(load->cooked->primitives.size());
+                return parallelFor(
+                        load->primitives.size(),
+                        [&engine, load](size_t primitiveIdx) {
+                            // allocation and queueing an upload are both thread safe
+                            load->primitives[primitiveIdx] =
+                                    uploadPrimitive(engine, *load->cooked, load->cooked->primitives[primitiveIdx]);
+                        });
+            }
+
+            SharedPtr<AsyncSceneLoad> loadSceneFromFileAsync(VulkanEngine& engine, StringView filename, const SceneLoadOptions& options) {
+                auto load = std::make_shared<AsyncSceneLoad>();
+                load->filename = String(filename);
+                load->parentPath = std::filesystem::path(load->filename).parent_path();
+                load->options = options;
+
+                load->pending = async([load]() {
+                    load->cooked = loadCookedScene(load->filename, load->options);
+                });
+
+                return load;
+            }
+
+            SceneLoadResult pollSceneLoad(VulkanEngine& engine, const SharedPtr<AsyncSceneLoad>& load, bool block) {
+                MOE_ASSERT(load->stage != AsyncSceneLoad::Stage::Done, "Scene load already finished");
+
+                auto& uploadManager = engine.getUploadManager();
+
+                if (load->stage == AsyncSceneLoad::Stage::Loading) {
+                    if (!block && !load->pending->isReady()) {
+                        return {};
                     }
+                    load->pending->get();
 
-                    auto nodePtr = std::make_unique<VulkanSceneNode>();
-                    auto& node = *static_cast<VulkanSceneNode*>(nodePtr.get());
-                    loadNode(node, gltfNode, model);
+                    if (!load->cooked) {
+                        load->stage = AsyncSceneLoad::Stage::Done;
+                        return SceneLoadResult::failed(fmt::format("Failed to load glTF scene: {}", load->filename));
+                    }
 
-                    vkScene.children.push_back(std::move(nodePtr));
+                    load->pending = uploadScene(engine, load);
+                    load->stage = AsyncSceneLoad::Stage::Uploading;
                 }
 
-                return vkScene;
+                if (load->stage == AsyncSceneLoad::Stage::Uploading) {
+                    if (!block && !load->pending->isReady()) {
+                        return {};
+                    }
+                    load->pending->get();
+
+                    // every mesh upload of the scene is queued by now
+                    load->pending = uploadManager.fence();
+                    uploadManager.flush();
+                    load->stage = AsyncSceneLoad::Stage::Registering;
+                }
+
+                if (block) {
+                    uploadManager.waitIdle();
+                } else if (!load->pending->isReady()) {
+                    return {};
+                }
+                load->pending->get();
+
+                load->stage = AsyncSceneLoad::Stage::Done;
+                return SceneLoadResult::loaded(registerScene(engine, *load->cooked, load->parentPath, load->primitives));
             }
         }// namespace GLTF
     }// namespace VkLoaders
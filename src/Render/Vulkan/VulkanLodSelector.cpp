@@ -0,0 +1,74 @@
+#include "Render/Vulkan/VulkanLodSelector.hpp"
+#include "Render/Vulkan/VulkanCamera.hpp"
+#include "Render/Vulkan/VulkanMeshCache.hpp"
+
+#include <algorithm>
+
+
+namespace moe {
+    void VulkanLodSelector::update(const VulkanMeshCache& meshCache, const VulkanCamera& camera, VkExtent2D viewportExtent) {
+        m_meshCache = &meshCache;
+
+        m_cameraPos = camera.getPosition();
+        m_nearZ = camera.getNearZ();
+        // pixels covered by a unit-size object at unit distance
+        m_pixelsPerUnit =
+                static_cast<float>(viewportExtent.height) /
+                (2.0f * std::tan(glm::radians(camera.getFovDeg()) * 0.5f));
+
+        m_stats = {};
+    }
+
+    uint32_t VulkanLodSelector::select(MeshId meshId, const glm::mat4& transform, uint32_t currentLod, Stats& stats) const {
+        MOE_ASSERT(m_meshCache != nullptr, "VulkanLodSelector used before update");
+
+        // per packet, no copy of the mesh
+        const auto* mesh = m_meshCache->findMesh(meshId);
+        if (!mesh) {
+            return 0;
+        }
+
+        const auto& buffer = mesh->gpuBuffer;
+        stats.packets++;
+        stats.fullDetailTriangles += buffer.getLod(0).indexCount / 3;
+
+        if (!m_enabled || buffer.lodCount <= 1) {
+            stats.selectedTriangles += buffer.getLod(0).indexCount / 3;
+            return 0;
+        }
+
+        const glm::vec3 localCenter = (mesh->min + mesh->max) * 0.5f;
+        const glm::vec3 localExtent = (mesh->max - mesh->min) * 0.5f;
+        const float maxScale = std::max({
+                glm::length(glm::vec3(transform[0])),
+                glm::length(glm::vec3(transform[1])),
+                glm::length(glm::vec3(transform[2])),
+        });
+
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+        const float radius = glm::length(localExtent) * maxScale;
+        // nearest point of the bounding sphere, the error is never underestimated
+        const float distance = std::max(glm::length(center - m_cameraPos) - radius, m_nearZ);
+
+        const float pixelsPerObjectUnit = m_pixelsPerUnit * maxScale / distance;
+
+        // errors grow with the lod index, take the coarsest one that is still below the threshold
+        uint32_t lod = 0;
+        while (lod + 1 < buffer.lodCount &&
+               buffer.lods[lod + 1].error * pixelsPerObjectUnit <= m_errorThresholdPixels) {
+            ++lod;
+        }
+
+        currentLod = std::min(currentLod, buffer.lodCount - 1);
+        while (lod > currentLod &&
+               buffer.lods[lod].error * pixelsPerObjectUnit > m_errorThresholdPixels * HYSTERESIS) {
+            --lod;
+        }
+
+        if (lod > 0) {
+            stats.reducedPackets++;
+        }
+        stats.selectedTriangles += buffer.lods[lod].indexCount / 3;
+        return lod;
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "Render/Vulkan/VulkanMemoryTracker.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+
+#include "imgui.h"
+
+namespace moe {
+    namespace Detail {
+        thread_local VulkanMemoryCategory g_currentMemoryCategory = VulkanMemoryCategory::Other;
+
+        constexpr double toMiB(size_t bytes) {
+            return static_cast<double>(bytes) / (1024.0 * 1024.0);
+        }
+    }// namespace Detail
+
+    VulkanMemoryTracker::ScopedCategory::ScopedCategory(VulkanMemoryCategory category)
+        : m_previous(Detail::g_currentMemoryCategory) {
+        Detail::g_currentMemoryCategory = category;
+    }
+
+    VulkanMemoryTracker::ScopedCategory::~ScopedCategory() {
+        Detail::g_currentMemoryCategory = m_previous;
+    }
+
+    void VulkanMemoryTracker::init(VulkanEngine& engine) {
+        MOE_ASSERT(!m_initialized, "VulkanMemoryTracker already initialized");
+
+        m_engine = &engine;
+        m_initialized = true;
+    }
+
+    void VulkanMemoryTracker::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanMemoryTracker not initialized");
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+            auto& stats = m_categories[i];
+            if (stats.allocationCount > 0) {
+                Logger::debug(
+                        "{} allocation(s) ({:.2f} MiB) still alive in category '{}'",
+                        stats.allocationCount,
+                        Detail::toMiB(stats.liveBytes),
+                        categoryName(static_cast<VulkanMemoryCategory>(i)));
+            }
+        }
+
+        m_allocations.clear();
+        m_categories = {};
+        m_budgetHandlers = {};
+
+        m_engine = nullptr;
+        m_initialized = false;
+    }
+
+    VulkanMemoryCategory VulkanMemoryTracker::currentCategory() {
+        return Detail::g_currentMemoryCategory;
+    }
+
+    StringView VulkanMemoryTracker::categoryName(VulkanMemoryCategory category) {
+        switch (category) {
+            case VulkanMemoryCategory::Other:
+                return "Other";
+            case VulkanMemoryCategory::Mesh:
+                return "Mesh";
+            case VulkanMemoryCategory::Texture:
+                return "Texture";
+            case VulkanMemoryCategory::StreamedTexture:
+                return "Streamed Texture";
+            case VulkanMemoryCategory::Font:
+                return "Font";
+            case VulkanMemoryCategory::RenderTarget:
+                return "Render Target";
+            case VulkanMemoryCategory::Dynamic:
+                return "Dynamic";
+            case VulkanMemoryCategory::Staging:
+                return "Staging";
+            default:
+                return "Unknown";
+        }
+    }
+
+    void VulkanMemoryTracker::trackAllocation(VmaAllocation allocation, VulkanMemoryCategory category) {
+        if (!m_initialized || allocation == VK_NULL_HANDLE) {
+            return;
+        }
+
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(m_engine->m_allocator, allocation, &info);
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_allocations[allocation] = {category, static_cast<size_t>(info.size)};
+
+        auto& stats = m_categories[static_cast<size_t>(category)];
+        stats.liveBytes += info.size;
+        stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+        stats.allocationCount++;
+    }
+
+    void VulkanMemoryTracker::untrackAllocation(VmaAllocation allocation) {
+        if (!m_initialized) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_allocations.find(allocation);
+        if (it == m_allocations.end()) {
+            return;
+        }
+
+        auto& stats = m_categories[static_cast<size_t>(it->second.category)];
+        stats.liveBytes -= it->second.size;
+        stats.allocationCount--;
+        m_allocations.erase(it);
+    }
+
+    size_t VulkanMemoryTracker::getBudget() const {
+        if (m_budget != 0) {
+            return m_budget;
+        }
+
+        size_t budget = 0;
+        for (auto& heap: queryHeapBudgets()) {
+            if (heap.deviceLocal) {
+                budget += heap.budget;
+            }
+        }
+        return budget;
+    }
+
+    void VulkanMemoryTracker::setBudgetHandler(VulkanMemoryCategory category, BudgetHandler&& handler) {
+        MOE_ASSERT(category < VulkanMemoryCategory::Staging, "Staging memory is transient and has no budget");
+        m_budgetHandlers[static_cast<size_t>(category)] = std::move(handler);
+    }
+
+    VulkanMemoryTracker::CategoryStats VulkanMemoryTracker::getCategoryStats(VulkanMemoryCategory category) const {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return m_categories[static_cast<size_t>(category)];
+    }
+
+    size_t VulkanMemoryTracker::getResidentBytes() const {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        size_t total = 0;
+        for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+            if (static_cast<VulkanMemoryCategory>(i) != VulkanMemoryCategory::Staging) {
+                total += m_categories[i].liveBytes;
+            }
+        }
+        return total;
+    }
+
+    Vector<VulkanMemoryTracker::HeapBudget> VulkanMemoryTracker::queryHeapBudgets() const {
+        MOE_ASSERT(m_initialized, "VulkanMemoryTracker not initialized");
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_engine->m_allocator, &memoryProperties);
+
+        Array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+        vmaGetHeapBudgets(m_engine->m_allocator, budgets.data());
+
+        Vector<HeapBudget> heaps;
+        heaps.reserve(memoryProperties->memoryHeapCount);
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i) {
+            heaps.push_back({
+                    (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+                    static_cast<size_t>(budgets[i].usage),
+                    static_cast<size_t>(budgets[i].budget),
+            });
+        }
+        return heaps;
+    }
+
+    void VulkanMemoryTracker::update() {
+        MOE_ASSERT(m_initialized, "VulkanMemoryTracker not initialized");
+
+        size_t budget = getBudget();
+
+        Array<CategoryStats, CATEGORY_COUNT> categories;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            categories = m_categories;
+        }
+
+        size_t resident = 0;
+        for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+            if (static_cast<VulkanMemoryCategory>(i) != VulkanMemoryCategory::Staging) {
+                resident += categories[i].liveBytes;
+            }
+        }
+
+        for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+            auto& handler = m_budgetHandlers[i];
+            if (!handler) {
+                continue;
+            }
+
+            // everything else is taken as fixed; the category gets whatever is left
+            size_t others = resident - categories[i].liveBytes;
+            handler(budget > others ? budget - others : 0);
+        }
+
+        bool overBudget = resident > budget;
+        if (overBudget && !m_overBudgetReported) {
+            Logger::warn(
+                    "GPU memory over budget: {:.2f} MiB resident, {:.2f} MiB budget",
+                    Detail::toMiB(resident),
+                    Detail::toMiB(budget));
+        }
+        m_overBudgetReported = overBudget;
+    }
+
+    void VulkanMemoryTracker::drawOverlay(bool* open) {
+        MOE_ASSERT(m_initialized, "VulkanMemoryTracker not initialized");
+
+        if (!ImGui::Begin("GPU Memory", open)) {
+            ImGui::End();
+            return;
+        }
+
+        size_t budget = getBudget();
+        size_t resident = getResidentBytes();
+        ImGui::Text("Resident: %.2f / %.2f MiB", Detail::toMiB(resident), Detail::toMiB(budget));
+        ImGui::ProgressBar(
+                budget > 0 ? static_cast<float>(static_cast<double>(resident) / static_cast<double>(budget)) : 0.0f);
+
+        if (ImGui::BeginTable("Categories", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("Live (MiB)");
+            ImGui::TableSetupColumn("Peak (MiB)");
+            ImGui::TableSetupColumn("Count");
+            ImGui::TableHeadersRow();
+
+            for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+                auto category = static_cast<VulkanMemoryCategory>(i);
+                auto stats = getCategoryStats(category);
+                auto name = categoryName(category);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", Detail::toMiB(stats.liveBytes));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", Detail::toMiB(stats.peakBytes));
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", stats.allocationCount);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Separator();
+        auto heaps = queryHeapBudgets();
+        for (size_t i = 0; i < heaps.size(); ++i) {
+            ImGui::Text(
+                    "Heap %zu%s: %.2f / %.2f MiB",
+                    i,
+                    heaps[i].deviceLocal ? " (device local)" : "",
+                    Detail::toMiB(heaps[i].usage),
+                    Detail::toMiB(heaps[i].budget));
+        }
+
+        ImGui::End();
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "Render/Vulkan/VulkanMeshAttributes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace moe {
+    namespace MeshAttributes {
+        namespace Detail {
+            constexpr float EPSILON = 1e-12f;
+            // deviation from unit length that still counts as normalized
+            constexpr float UNIT_TOLERANCE = 1e-3f;
+
+            bool isFinite(const glm::vec3& v) {
+                return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+            }
+
+            bool isUsable(const glm::vec3& v) {
+                return isFinite(v) && glm::dot(v, v) > EPSILON;
+            }
+
+            bool isTriangleList(const VulkanCPUMesh& mesh) {
+                if (mesh.indices.empty() || mesh.indices.size() % 3 != 0) {
+                    return false;
+                }
+                return std::all_of(mesh.indices.begin(), mesh.indices.end(), [&mesh](uint32_t index) {
+                    return index < mesh.vertices.size();
+                });
+            }
+
+            glm::vec3 anyPerpendicular(const glm::vec3& n) {
+                glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                return glm::normalize(glm::cross(axis, n));
+            }
+
+            glm::vec3 faceNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+                return glm::cross(p1 - p0, p2 - p0);
+            }
+
+            // interior angle at p0, the weight mikktspace and most dccs use for smooth normals
+            float cornerAngle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+                glm::vec3 a = p1 - p0;
+                glm::vec3 b = p2 - p0;
+                float la = glm::dot(a, a);
+                float lb = glm::dot(b, b);
+                if (la <= EPSILON || lb <= EPSILON) {
+                    return 0.0f;
+                }
+                float c = glm::dot(a, b) / std::sqrt(la * lb);
+                return std::acos(std::clamp(c, -1.0f, 1.0f));
+            }
+
+            // vertex -> id of the first vertex with a bitwise equal position
+            Vector<uint32_t> positionGroups(const VulkanCPUMesh& mesh) {
+                Vector<uint32_t> order(mesh.vertices.size());
+                std::iota(order.begin(), order.end(), 0u);
+                auto less = [&mesh](uint32_t a, uint32_t b) {
+                    const auto& pa = mesh.vertices[a].pos;
+                    const auto& pb = mesh.vertices[b].pos;
+                    if (pa.x != pb.x) return pa.x < pb.x;
+                    if (pa.y != pb.y) return pa.y < pb.y;
+                    if (pa.z != pb.z) return pa.z < pb.z;
+                    return a < b;
+                };
+                std::sort(order.begin(), order.end(), less);
+
+                Vector<uint32_t> groups(mesh.vertices.size());
+                for (size_t i = 0; i < order.size(); ++i) {
+                    bool same = i > 0 && mesh.vertices[order[i]].pos == mesh.vertices[order[i - 1]].pos;
+                    groups[order[i]] = same ? groups[order[i - 1]] : order[i];
+                }
+                return groups;
+            }
+
+            uint32_t duplicateVertex(VulkanCPUMesh& mesh, uint32_t vertex) {
+                auto copy = mesh.vertices[vertex];
+                mesh.vertices.push_back(copy);
+                if (!mesh.skinningData.empty()) {
+                    auto skin = mesh.skinningData[vertex];
+                    mesh.skinningData.push_back(skin);
+                }
+                return static_cast<uint32_t>(mesh.vertices.size() - 1);
+            }
+        }// namespace Detail
+
+        bool generateIndices(VulkanCPUMesh& mesh) {
+            if (!mesh.indices.empty() || mesh.vertices.empty() || mesh.vertices.size() % 3 != 0) {
+                return false;
+            }
+            mesh.indices.resize(mesh.vertices.size());
+            std::iota(mesh.indices.begin(), mesh.indices.end(), 0u);
+            return true;
+        }
+
+        void generateNormals(VulkanCPUMesh& mesh, NormalMode mode) {
+            if (!Detail::isTriangleList(mesh)) {
+                return;
+            }
+
+            if (mode == NormalMode::Flat) {
+                // one vertex per corner; coplanar duplicates are merged again by MeshOptimizer::optimizeMesh
+                Vector<Vertex> vertices;
+                vertices.reserve(mesh.indices.size());
+                Vector<SkinningData> skinningData;
+                skinningData.reserve(mesh.skinningData.empty() ? 0 : mesh.indices.size());
+
+                for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+                    const auto& p0 = mesh.vertices[mesh.indices[i + 0]].pos;
+                    const auto& p1 = mesh.vertices[mesh.indices[i + 1]].pos;
+                    const auto& p2 = mesh.vertices[mesh.indices[i + 2]].pos;
+                    glm::vec3 n = Detail::faceNormal(p0, p1, p2);
+                    n = Detail::isUsable(n) ? glm::normalize(n) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+                    for (size_t k = 0; k < 3; ++k) {
+                        uint32_t index = mesh.indices[i + k];
+                        auto vertex = mesh.vertices[index];
+                        vertex.normal = n;
+                        vertices.push_back(vertex);
+                        if (!mesh.skinningData.empty()) {
+                            skinningData.push_back(mesh.skinningData[index]);
+                        }
+                    }
+                }
+
+                mesh.vertices = std::move(vertices);
+                mesh.skinningData = std::move(skinningData);
+                std::iota(mesh.indices.begin(), mesh.indices.end(), 0u);
+                return;
+            }
+
+            // smooth: accumulate into the position group so uv seams do not show up as lighting seams
+            auto groups = Detail::positionGroups(mesh);
+            Vector<glm::vec3> accumulated(mesh.vertices.size(), glm::vec3(0.0f));
+
+            for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+                uint32_t tri[3] = {mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+                const auto& p0 = mesh.vertices[tri[0]].pos;
+                const auto& p1 = mesh.vertices[tri[1]].pos;
+                const auto& p2 = mesh.vertices[tri[2]].pos;
+                glm::vec3 n = Detail::faceNormal(p0, p1, p2);
+                if (!Detail::isUsable(n)) {
+                    continue;
+                }
+                n = glm::normalize(n);
+
+                accumulated[groups[tri[0]]] += n * Detail::cornerAngle(p0, p1, p2);
+                accumulated[groups[tri[1]]] += n * Detail::cornerAngle(p1, p2, p0);
+                accumulated[groups[tri[2]]] += n * Detail::cornerAngle(p2, p0, p1);
+            }
+
+            for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+                const auto& n = accumulated[groups[i]];
+                mesh.vertices[i].normal = Detail::isUsable(n) ? glm::normalize(n) : glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+        }
+
+        void generateTangents(VulkanCPUMesh& mesh) {
+            if (!Detail::isTriangleList(mesh)) {
+                return;
+            }
+
+            struct Corner {
+                glm::vec3 tangent;// normalized, in the normal plane of the corner's vertex, or zero
+                float sign;
+                float weight;
+            };
+
+            Vector<Corner> corners(mesh.indices.size(), Corner{glm::vec3(0.0f), 1.0f, 0.0f});
+
+            for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+                const auto& v0 = mesh.vertices[mesh.indices[i + 0]];
+                const auto& v1 = mesh.vertices[mesh.indices[i + 1]];
+                const auto& v2 = mesh.vertices[mesh.indices[i + 2]];
+
+                glm::vec3 e1 = v1.pos - v0.pos;
+                glm::vec3 e2 = v2.pos - v0.pos;
+                float du1 = v1.uv_x - v0.uv_x;
+                float dv1 = v1.uv_y - v0.uv_y;
+                float du2 = v2.uv_x - v0.uv_x;
+                float dv2 = v2.uv_y - v0.uv_y;
+
+                // the magnitude of the uv gradient does not matter once normalized, only its direction
+                float det = du1 * dv2 - du2 * dv1;
+                if (std::abs(det) <= Detail::EPSILON) {
+                    continue;
+                }
+                float orientation = det > 0.0f ? 1.0f : -1.0f;
+                glm::vec3 t = (e1 * dv2 - e2 * dv1) * orientation;
+                glm::vec3 b = (e2 * du1 - e1 * du2) * orientation;
+
+                const Vertex* vertices[3] = {&v0, &v1, &v2};
+                for (size_t k = 0; k < 3; ++k) {
+                    const auto& n = vertices[k]->normal;
+                    glm::vec3 projected = t - n * glm::dot(n, t);
+                    if (!Detail::isUsable(projected)) {
+                        continue;
+                    }
+
+                    auto& corner = corners[i + k];
+                    corner.tangent = glm::normalize(projected);
+                    corner.sign = glm::dot(glm::cross(n, corner.tangent), b) < 0.0f ? -1.0f : 1.0f;
+                    corner.weight = Detail::cornerAngle(
+                            vertices[k]->pos, vertices[(k + 1) % 3]->pos, vertices[(k + 2) % 3]->pos);
+                }
+            }
+
+            // a vertex used with both handednesses is split, the mirrored corners get their own copy
+            size_t originalCount = mesh.vertices.size();
+            Vector<uint8_t> signs(originalCount, 0);// bit 0: positive, bit 1: negative
+            for (size_t i = 0; i < mesh.indices.size(); ++i) {
+                if (corners[i].weight > 0.0f) {
+                    signs[mesh.indices[i]] |= corners[i].sign > 0.0f ? 1 : 2;
+                }
+            }
+
+            Vector<uint32_t> mirrored(originalCount, std::numeric_limits<uint32_t>::max());
+            for (size_t i = 0; i < mesh.indices.size(); ++i) {
+                uint32_t index = mesh.indices[i];
+                if (signs[index] != 3 || corners[i].sign > 0.0f || corners[i].weight <= 0.0f) {
+                    continue;
+                }
+                if (mirrored[index] == std::numeric_limits<uint32_t>::max()) {
+                    mirrored[index] = Detail::duplicateVertex(mesh, index);
+                }
+                mesh.indices[i] = mirrored[index];
+            }
+
+            Vector<glm::vec3> accumulated(mesh.vertices.size(), glm::vec3(0.0f));
+            Vector<float> handedness(mesh.vertices.size(), 1.0f);
+            for (size_t i = 0; i < mesh.indices.size(); ++i) {
+                const auto& corner = corners[i];
+                if (corner.weight <= 0.0f) {
+                    continue;
+                }
+                accumulated[mesh.indices[i]] += corner.tangent * corner.weight;
+                handedness[mesh.indices[i]] = corner.sign;
+            }
+
+            for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+                auto& vertex = mesh.vertices[i];
+                const auto& n = vertex.normal;
+                glm::vec3 t = accumulated[i] - n * glm::dot(n, accumulated[i]);
+                // no usable uv gradient (missing or collapsed uvs), any tangent keeps the basis orthonormal
+                t = Detail::isUsable(t) ? glm::normalize(t) : Detail::anyPerpendicular(n);
+                vertex.tangent = glm::vec4(t, handedness[i]);
+            }
+        }
+
+        size_t normalizeAttributes(VulkanCPUMesh& mesh, bool tangents) {
+            size_t repaired = 0;
+            for (auto& vertex: mesh.vertices) {
+                float normalLength = glm::length(vertex.normal);
+                if (!Detail::isUsable(vertex.normal)) {
+                    vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+                    repaired++;
+                } else if (std::abs(normalLength - 1.0f) > Detail::UNIT_TOLERANCE) {
+                    vertex.normal /= normalLength;
+                    repaired++;
+                }
+
+                if (!tangents) {
+                    continue;
+                }
+
+                glm::vec3 t = glm::vec3(vertex.tangent);
+                glm::vec3 orthogonal = t - vertex.normal * glm::dot(vertex.normal, t);
+                float tangentLength = glm::length(t);
+                if (!Detail::isUsable(orthogonal)) {
+                    t = Detail::anyPerpendicular(vertex.normal);
+                    repaired++;
+                } else if (std::abs(tangentLength - 1.0f) > Detail::UNIT_TOLERANCE) {
+                    t /= tangentLength;
+                    repaired++;
+                }
+
+                float w = vertex.tangent.w < 0.0f ? -1.0f : 1.0f;
+                if (w != vertex.tangent.w) {
+                    repaired++;
+                }
+                vertex.tangent = glm::vec4(t, w);
+            }
+            return repaired;
+        }
+
+        RepairReport repairMesh(VulkanCPUMesh& mesh, const RepairOptions& options) {
+            RepairReport report;
+            size_t originalCount = mesh.vertices.size();
+
+            report.generatedIndices = generateIndices(mesh);
+            if (options.generateNormals && Detail::isTriangleList(mesh)) {
+                generateNormals(mesh, options.normalMode);
+                report.generatedNormals = true;
+            }
+            // tangents are built against the final normals, so those have to be valid first
+            bool buildTangents = options.generateTangents && Detail::isTriangleList(mesh);
+            report.repairedVectors = normalizeAttributes(mesh, !buildTangents);
+            if (buildTangents) {
+                generateTangents(mesh);
+                report.generatedTangents = true;
+            }
+
+            report.splitVertices = mesh.vertices.size() - originalCount;
+            return report;
+        }
+    }// namespace MeshAttributes
+}// namespace moe
\ No newline at end of file
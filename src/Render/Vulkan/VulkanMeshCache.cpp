@@ -2,8 +2,32 @@
 #include "Render/Vulkan/VulkanEngine.hpp"
 #include "Render/Vulkan/VulkanLoaders.hpp"
 
+#include <algorithm>
+
 
 namespace moe {
+    namespace Detail {
+        static Array<VulkanGeometryAllocation*, 4> getAllocations(VulkanGPUMeshBuffer& buffer) {
+            return {
+                    &buffer.vertexAllocation,
+                    &buffer.indexAllocation,
+                    &buffer.skinningDataAllocation,
+                    &buffer.skinnedVertexAllocation,
+            };
+        }
+
+        // handles and addresses from the current ranges
+        static void refreshMeshBuffer(const VulkanGeometryArena& arena, VulkanGPUMeshBuffer& buffer) {
+            buffer.vertexBufferAddr = arena.getAddress(buffer.vertexAllocation);
+            buffer.skinningDataBufferAddr = arena.getAddress(buffer.skinningDataAllocation);
+            buffer.skinnedVertexBufferAddr = arena.getAddress(buffer.skinnedVertexAllocation);
+            if (buffer.indexAllocation.isValid()) {
+                buffer.indexBuffer = arena.getBuffer(buffer.indexAllocation);
+                buffer.firstIndex = VulkanGeometryArena::getFirstIndex(buffer.indexAllocation);
+            }
+        }
+    }// namespace Detail
+
     void VulkanMeshCache::init(VulkanEngine& engine) {
         m_engine = &engine;
         m_initialized = true;
@@ -11,18 +35,27 @@ namespace moe {
         defaults.rectMeshId = loadMesh(getDefaultRectMesh());
     }
 
-    MeshId VulkanMeshCache::loadMesh(VulkanCPUMesh cpuMesh) {
+    MeshId VulkanMeshCache::loadMesh(VulkanCPUMesh cpuMesh, bool occluder) {
+        MOE_ASSERT(m_initialized, "VulkanMeshCache not initialized");
+
+        auto buffer = m_engine->uploadMesh(cpuMesh.indices, cpuMesh.vertices, cpuMesh.skinningData, cpuMesh.lods);
+        MeshId id = addMesh(VulkanGPUMesh{
+                .gpuBuffer = std::move(buffer),
+                .min = cpuMesh.min,
+                .max = cpuMesh.max,
+        });
+
+        if (occluder && cpuMesh.skinningData.empty()) {
+            m_engine->getOcclusionCuller().setMeshOccluder(id, cpuMesh.vertices, cpuMesh.indices, cpuMesh.lods);
+        }
+        return id;
+    }
+
+    MeshId VulkanMeshCache::addMesh(VulkanGPUMesh&& mesh) {
         MOE_ASSERT(m_initialized, "VulkanMeshCache not initialized");
 
-        auto buffer = m_engine->uploadMesh(cpuMesh.indices, cpuMesh.vertices, cpuMesh.skinningData);
         MeshId id = m_idAllocator.allocateId();
-        m_meshes.emplace(
-                id,
-                VulkanGPUMesh{
-                        .gpuBuffer = std::move(buffer),
-                        .min = cpuMesh.min,
-                        .max = cpuMesh.max,
-                });
+        m_meshes.emplace(id, std::move(mesh));
 
         return id;
     }
@@ -37,16 +70,85 @@ namespace moe {
         return std::nullopt;
     }
 
-    void VulkanMeshCache::destroy() {
+    const VulkanGPUMesh* VulkanMeshCache::findMesh(MeshId id) const {
+        MOE_ASSERT(m_initialized, "VulkanMeshCache not initialized");
+
+        auto it = m_meshes.find(id);
+        return it != m_meshes.end() ? &it->second : nullptr;
+    }
+
+    void VulkanMeshCache::disposeMesh(MeshId id) {
+        MOE_ASSERT(m_initialized, "VulkanMeshCache not initialized");
+
+        auto it = m_meshes.find(id);
+        if (it == m_meshes.end()) {
+            return;
+        }
+
+        auto& arena = m_engine->getGeometryArena();
+        for (const auto* allocation: Detail::getAllocations(it->second.gpuBuffer)) {
+            arena.free(*allocation);
+        }
+        m_meshes.erase(it);
+        m_idAllocator.recycleId(id);
+        // the id is reused by the next mesh
+        m_engine->getOcclusionCuller().removeOccluder(id);
+
+        m_version++;
+        m_defragmentationPending = true;
+
+        Logger::debug("Disposed mesh with id {}", id);
+    }
+
+    void VulkanMeshCache::update(VkCommandBuffer cmdBuffer) {
+        MOE_ASSERT(m_initialized, "VulkanMeshCache not initialized");
+
+        if (!m_defragmentationPending) {
+            return;
+        }
+
+        auto& arena = m_engine->getGeometryArena();
+        if (!arena.isDefragmentationNeeded()) {
+            m_defragmentationPending = false;
+            return;
+        }
+
+        // back to front, so the tails of the blocks are emptied first and later blocks can be released
+        Vector<Pair<VulkanGPUMeshBuffer*, VulkanGeometryAllocation*>> ranges;
         for (auto& [id, mesh]: m_meshes) {
-            m_engine->destroyBuffer(mesh.gpuBuffer.vertexBuffer);
-            m_engine->destroyBuffer(mesh.gpuBuffer.indexBuffer);
-            if (mesh.gpuBuffer.hasSkinningData) {
-                m_engine->destroyBuffer(mesh.gpuBuffer.skinningDataBuffer);
-                m_engine->destroyBuffer(mesh.gpuBuffer.skinnedVertexBuffer);
+            for (auto* allocation: Detail::getAllocations(mesh.gpuBuffer)) {
+                if (allocation->isValid()) {
+                    ranges.emplace_back(&mesh.gpuBuffer, allocation);
+                }
+            }
+        }
+        std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) {
+            if (a.second->block != b.second->block) {
+                return a.second->block > b.second->block;
+            }
+            return a.second->offset > b.second->offset;
+        });
+
+        size_t moved = 0;
+        arena.beginDefragmentation(cmdBuffer);
+        for (auto& [buffer, allocation]: ranges) {
+            if (arena.move(cmdBuffer, *allocation)) {
+                Detail::refreshMeshBuffer(arena, *buffer);
+                moved++;
             }
         }
+        arena.endDefragmentation(cmdBuffer);
 
+        if (moved > 0) {
+            m_version++;
+        } else {
+            // compact as far as it goes, or blocked by pending uploads until the next disposal
+            m_defragmentationPending = false;
+        }
+    }
+
+    void VulkanMeshCache::destroy() {
+        // the geometry arena releases every range with its blocks
         m_idAllocator.reset();
         m_meshes.clear();
 
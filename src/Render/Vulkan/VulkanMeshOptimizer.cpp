@@ -0,0 +1,819 @@
+#include "Render/Vulkan/VulkanMeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace moe {
+    namespace MeshOptimizer {
+        namespace Detail {
+            constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+            // vertex -> triangles, compressed rows
+            struct Adjacency {
+                Vector<uint32_t> offsets;
+                Vector<uint32_t> triangles;
+
+                Adjacency(Span<const uint32_t> indices, size_t vertexCount)
+                    : offsets(vertexCount + 1, 0), triangles(indices.size()) {
+                    for (auto index: indices) {
+                        offsets[index + 1]++;
+                    }
+                    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+                    Vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                    for (size_t i = 0; i < indices.size(); ++i) {
+                        triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+                    }
+                }
+
+                Span<const uint32_t> of(uint32_t vertex) const {
+                    return Span<const uint32_t>(triangles.data() + offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+                }
+            };
+
+            struct FifoCache {
+                Vector<uint32_t> timestamps;
+                uint32_t time;
+                uint32_t size;
+
+                FifoCache(size_t vertexCount, uint32_t cacheSize)
+                    : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+                // returns true on a miss
+                bool access(uint32_t vertex) {
+                    if (time - timestamps[vertex] > size) {
+                        timestamps[vertex] = time++;
+                        return true;
+                    }
+                    return false;
+                }
+            };
+
+            uint64_t hashVertex(const uint8_t* data, size_t size) {
+                uint64_t hash = 0xcbf29ce484222325ull;
+                for (size_t i = 0; i < size; i += sizeof(uint32_t)) {
+                    uint32_t word;
+                    std::memcpy(&word, data + i, sizeof(word));
+                    hash = (hash ^ word) * 0x100000001b3ull;
+                }
+                return hash;
+            }
+
+            bool isOptimizable(const VulkanCPUMesh& mesh) {
+                if (mesh.indices.empty() || mesh.indices.size() % 3 != 0) {
+                    return false;
+                }
+                return std::all_of(mesh.indices.begin(), mesh.indices.end(), [&mesh](uint32_t index) {
+                    return index < mesh.vertices.size();
+                });
+            }
+
+            // symmetric 4x4 error quadric of the plane(s) ax + by + cz + d = 0
+            struct Quadric {
+                double a2{0}, ab{0}, ac{0}, ad{0};
+                double b2{0}, bc{0}, bd{0};
+                double c2{0}, cd{0};
+                double d2{0};
+                double weight{0};
+
+                static Quadric fromPlane(double a, double b, double c, double d, double weight) {
+                    Quadric q;
+                    q.weight = weight;
+                    q.a2 = a * a * weight, q.ab = a * b * weight, q.ac = a * c * weight, q.ad = a * d * weight;
+                    q.b2 = b * b * weight, q.bc = b * c * weight, q.bd = b * d * weight;
+                    q.c2 = c * c * weight, q.cd = c * d * weight;
+                    q.d2 = d * d * weight;
+                    return q;
+                }
+
+                Quadric& operator+=(const Quadric& o) {
+                    a2 += o.a2, ab += o.ab, ac += o.ac, ad += o.ad;
+                    b2 += o.b2, bc += o.bc, bd += o.bd;
+                    c2 += o.c2, cd += o.cd;
+                    d2 += o.d2;
+                    weight += o.weight;
+                    return *this;
+                }
+
+                // weighted mean squared distance to the accumulated planes
+                double evaluate(const glm::vec3& p) const {
+                    const double x = p.x, y = p.y, z = p.z;
+                    const double sum = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+                                       b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+                                       c2 * z * z + 2 * cd * z +
+                                       d2;
+                    return weight > 0.0 ? std::max(sum, 0.0) / weight : 0.0;
+                }
+            };
+
+            struct Collapse {
+                uint32_t from;
+                uint32_t to;
+                double cost;
+            };
+
+            uint64_t edgeKey(uint32_t a, uint32_t b) {
+                return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+            }
+
+            // moving from onto to must not turn any remaining triangle of from upside down (or close to it)
+            bool flipsTriangles(
+                    const Adjacency& adjacency, const Vector<uint32_t>& indices, Span<const Vertex> vertices,
+                    uint32_t from, uint32_t to) {
+                const glm::vec3& target = vertices[to].pos;
+                for (auto triangle: adjacency.of(from)) {
+                    const uint32_t* corners = indices.data() + triangle * 3;
+                    if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                        continue;// collapses away
+                    }
+
+                    glm::vec3 p[3], q[3];
+                    for (size_t corner = 0; corner < 3; ++corner) {
+                        p[corner] = vertices[corners[corner]].pos;
+                        q[corner] = corners[corner] == from ? target : p[corner];
+                    }
+
+                    const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    const glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                    if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            uint32_t skipDeadEnd(
+                    Vector<uint32_t>& deadEnds, const Vector<uint32_t>& liveTriangles,
+                    uint32_t& cursor, size_t vertexCount) {
+                while (!deadEnds.empty()) {
+                    uint32_t vertex = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[vertex] > 0) {
+                        return vertex;
+                    }
+                }
+
+                for (; cursor < vertexCount; ++cursor) {
+                    if (liveTriangles[cursor] > 0) {
+                        return cursor;
+                    }
+                }
+                return INVALID_INDEX;
+            }
+        }// namespace Detail
+
+        CacheStats analyzeVertexCache(Span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+            CacheStats stats{};
+            stats.triangleCount = indices.size() / 3;
+            stats.vertexCount = vertexCount;
+
+            Detail::FifoCache cache(vertexCount, cacheSize);
+            for (auto index: indices) {
+                stats.cacheMisses += cache.access(index) ? 1 : 0;
+            }
+            return stats;
+        }
+
+        size_t weldVertices(VulkanCPUMesh& mesh) {
+            const size_t vertexCount = mesh.vertices.size();
+            const bool hasSkinning = !mesh.skinningData.empty();
+            if (vertexCount == 0) {
+                return 0;
+            }
+
+            // vertex and skinning data side by side, so one memcmp decides equality
+            const size_t keySize = sizeof(Vertex) + (hasSkinning ? sizeof(SkinningData) : 0);
+            Vector<uint8_t> keys(vertexCount * keySize);
+            for (size_t i = 0; i < vertexCount; ++i) {
+                std::memcpy(keys.data() + i * keySize, &mesh.vertices[i], sizeof(Vertex));
+                if (hasSkinning) {
+                    std::memcpy(keys.data() + i * keySize + sizeof(Vertex), &mesh.skinningData[i], sizeof(SkinningData));
+                }
+            }
+
+            // open addressing, at most half full
+            size_t tableSize = 1;
+            while (tableSize < vertexCount * 2) {
+                tableSize <<= 1;
+            }
+            Vector<uint32_t> table(tableSize, Detail::INVALID_INDEX);
+
+            Vector<uint32_t> remap(vertexCount);
+            uint32_t uniqueCount = 0;
+            for (uint32_t i = 0; i < vertexCount; ++i) {
+                const uint8_t* key = keys.data() + i * keySize;
+                size_t slot = Detail::hashVertex(key, keySize) & (tableSize - 1);
+                while (table[slot] != Detail::INVALID_INDEX &&
+                       std::memcmp(keys.data() + table[slot] * keySize, key, keySize) != 0) {
+                    slot = (slot + 1) & (tableSize - 1);
+                }
+
+                if (table[slot] == Detail::INVALID_INDEX) {
+                    table[slot] = i;
+                    remap[i] = uniqueCount;
+                    // compact in place, unique vertices keep their relative order
+                    mesh.vertices[uniqueCount] = mesh.vertices[i];
+                    if (hasSkinning) {
+                        mesh.skinningData[uniqueCount] = mesh.skinningData[i];
+                    }
+                    ++uniqueCount;
+                } else {
+                    remap[i] = remap[table[slot]];
+                }
+            }
+
+            for (auto& index: mesh.indices) {
+                index = remap[index];
+            }
+            mesh.vertices.resize(uniqueCount);
+            if (hasSkinning) {
+                mesh.skinningData.resize(uniqueCount);
+            }
+
+            return vertexCount - uniqueCount;
+        }
+
+        void optimizeVertexCache(Span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+            const size_t triangleCount = indices.size() / 3;
+            if (triangleCount == 0) {
+                return;
+            }
+
+            Detail::Adjacency adjacency(indices, vertexCount);
+
+            Vector<uint32_t> liveTriangles(vertexCount);
+            for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+                liveTriangles[vertex] = static_cast<uint32_t>(adjacency.of(vertex).size());
+            }
+
+            Detail::FifoCache cache(vertexCount, cacheSize);
+            Vector<bool> emitted(triangleCount, false);
+            Vector<uint32_t> deadEnds;
+            Vector<uint32_t> candidates;
+
+            Vector<uint32_t> output;
+            output.reserve(indices.size());
+
+            uint32_t cursor = 0;
+            uint32_t fanning = Detail::skipDeadEnd(deadEnds, liveTriangles, cursor, vertexCount);
+            while (fanning != Detail::INVALID_INDEX) {
+                candidates.clear();
+
+                for (auto triangle: adjacency.of(fanning)) {
+                    if (emitted[triangle]) {
+                        continue;
+                    }
+                    emitted[triangle] = true;
+
+                    for (size_t corner = 0; corner < 3; ++corner) {
+                        uint32_t vertex = indices[triangle * 3 + corner];
+                        output.push_back(vertex);
+                        deadEnds.push_back(vertex);
+                        candidates.push_back(vertex);
+                        liveTriangles[vertex]--;
+                        cache.access(vertex);
+                    }
+                }
+
+                // prefer the candidate that stays in the cache while its remaining triangles are emitted,
+                // and among those the one that entered the cache first
+                uint32_t next = Detail::INVALID_INDEX;
+                int64_t bestPriority = -1;
+                for (auto vertex: candidates) {
+                    if (liveTriangles[vertex] == 0) {
+                        continue;
+                    }
+
+                    int64_t priority = 0;
+                    const int64_t age = cache.time - cache.timestamps[vertex];
+                    if (age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= cacheSize) {
+                        priority = age;
+                    }
+                    if (priority > bestPriority) {
+                        bestPriority = priority;
+                        next = vertex;
+                    }
+                }
+
+                fanning = next != Detail::INVALID_INDEX
+                                  ? next
+                                  : Detail::skipDeadEnd(deadEnds, liveTriangles, cursor, vertexCount);
+            }
+
+            MOE_ASSERT(output.size() == indices.size(), "Vertex cache optimization lost triangles");
+            std::copy(output.begin(), output.end(), indices.begin());
+        }
+
+        void optimizeOverdraw(Span<uint32_t> indices, Span<const Vertex> vertices, uint32_t cacheSize, float threshold) {
+            const size_t triangleCount = indices.size() / 3;
+            if (triangleCount < 2) {
+                return;
+            }
+
+            // a cluster starts wherever the cache simulation misses all three corners,
+            // so reordering whole clusters keeps the in-cluster locality
+            Vector<uint32_t> clusterStarts;
+            {
+                Detail::FifoCache cache(vertices.size(), cacheSize);
+                for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+                    uint32_t misses = 0;
+                    for (size_t corner = 0; corner < 3; ++corner) {
+                        misses += cache.access(indices[triangle * 3 + corner]) ? 1 : 0;
+                    }
+                    if (misses == 3 || triangle == 0) {
+                        clusterStarts.push_back(triangle);
+                    }
+                }
+            }
+            if (clusterStarts.size() < 2) {
+                return;
+            }
+            clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+            const size_t clusterCount = clusterStarts.size() - 1;
+
+            glm::vec3 meshCentroid{0.0f};
+            float meshArea = 0.0f;
+
+            Vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3{0.0f});
+            Vector<glm::vec3> clusterNormals(clusterCount, glm::vec3{0.0f});
+            for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+                float clusterArea = 0.0f;
+                for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle) {
+                    const glm::vec3& p0 = vertices[indices[triangle * 3 + 0]].pos;
+                    const glm::vec3& p1 = vertices[indices[triangle * 3 + 1]].pos;
+                    const glm::vec3& p2 = vertices[indices[triangle * 3 + 2]].pos;
+
+                    // area weighted, the cross product is twice the area times the normal
+                    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                    float area = glm::length(normal);
+
+                    clusterCentroids[cluster] += (p0 + p1 + p2) * (area / 3.0f);
+                    clusterNormals[cluster] += normal;
+                    clusterArea += area;
+                }
+
+                meshCentroid += clusterCentroids[cluster];
+                meshArea += clusterArea;
+
+                if (clusterArea > 0.0f) {
+                    clusterCentroids[cluster] /= clusterArea;
+                }
+                float normalLength = glm::length(clusterNormals[cluster]);
+                if (normalLength > 0.0f) {
+                    clusterNormals[cluster] /= normalLength;
+                }
+            }
+            if (meshArea > 0.0f) {
+                meshCentroid /= meshArea;
+            }
+
+            // clusters far out along their own normal are likely to occlude the rest, draw them first
+            Vector<float> sortKeys(clusterCount);
+            for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+                sortKeys[cluster] = glm::dot(clusterCentroids[cluster] - meshCentroid, clusterNormals[cluster]);
+            }
+
+            Vector<uint32_t> order(clusterCount);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) {
+                return sortKeys[a] > sortKeys[b];
+            });
+
+            Vector<uint32_t> reordered;
+            reordered.reserve(indices.size());
+            for (auto cluster: order) {
+                reordered.insert(
+                        reordered.end(),
+                        indices.begin() + clusterStarts[cluster] * 3,
+                        indices.begin() + clusterStarts[cluster + 1] * 3);
+            }
+
+            const float acmrBefore = analyzeVertexCache(indices, vertices.size(), cacheSize).acmr();
+            const float acmrAfter = analyzeVertexCache(reordered, vertices.size(), cacheSize).acmr();
+            if (acmrAfter <= acmrBefore * threshold) {
+                std::copy(reordered.begin(), reordered.end(), indices.begin());
+            }
+        }
+
+        void optimizeVertexFetch(VulkanCPUMesh& mesh) {
+            const size_t vertexCount = mesh.vertices.size();
+            const bool hasSkinning = !mesh.skinningData.empty();
+
+            Vector<uint32_t> remap(vertexCount, Detail::INVALID_INDEX);
+            uint32_t nextVertex = 0;
+            for (auto& index: mesh.indices) {
+                if (remap[index] == Detail::INVALID_INDEX) {
+                    remap[index] = nextVertex++;
+                }
+                index = remap[index];
+            }
+
+            Vector<Vertex> vertices(nextVertex);
+            Vector<SkinningData> skinningData(hasSkinning ? nextVertex : 0);
+            for (size_t i = 0; i < vertexCount; ++i) {
+                if (remap[i] == Detail::INVALID_INDEX) {
+                    continue;
+                }
+                vertices[remap[i]] = mesh.vertices[i];
+                if (hasSkinning) {
+                    skinningData[remap[i]] = mesh.skinningData[i];
+                }
+            }
+
+            mesh.vertices = std::move(vertices);
+            mesh.skinningData = std::move(skinningData);
+        }
+
+        Report optimizeMesh(VulkanCPUMesh& mesh) {
+            Report report{};
+            if (!Detail::isOptimizable(mesh)) {
+                return report;
+            }
+
+            report.before = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+
+            report.weldedVertices = weldVertices(mesh);
+
+            Span<uint32_t> indices(mesh.indices.data(), mesh.indices.size());
+            optimizeVertexCache(indices, mesh.vertices.size());
+            optimizeOverdraw(indices, mesh.vertices);
+            optimizeVertexFetch(mesh);
+
+            report.after = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+            return report;
+        }
+
+        Vector<uint32_t> simplify(
+                Span<const uint32_t> indices, Span<const Vertex> vertices,
+                size_t targetIndexCount, float targetError,
+                float* outError) {
+            Vector<uint32_t> result(indices.begin(), indices.end());
+            const size_t vertexCount = vertices.size();
+            const double maxCost = static_cast<double>(targetError) * targetError;
+
+            Vector<Detail::Quadric> quadrics(vertexCount);
+            for (size_t i = 0; i + 2 < result.size(); i += 3) {
+                const glm::vec3& p0 = vertices[result[i + 0]].pos;
+                const glm::vec3& p1 = vertices[result[i + 1]].pos;
+                const glm::vec3& p2 = vertices[result[i + 2]].pos;
+
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                const float doubleArea = glm::length(normal);
+                if (doubleArea <= 0.0f) {
+                    continue;
+                }
+                normal /= doubleArea;
+
+                // area weighted, so large faces dominate the error
+                auto quadric = Detail::Quadric::fromPlane(
+                        normal.x, normal.y, normal.z, -glm::dot(normal, p0),
+                        0.5 * doubleArea);
+                for (size_t corner = 0; corner < 3; ++corner) {
+                    quadrics[result[i + corner]] += quadric;
+                }
+            }
+
+            // an edge used by a single triangle is a border or a seam between split vertices, moving it would open a crack
+            Vector<bool> locked(vertexCount, false);
+            {
+                UnorderedMap<uint64_t, uint32_t> edgeUses;
+                edgeUses.reserve(result.size());
+                for (size_t i = 0; i < result.size(); i += 3) {
+                    for (size_t corner = 0; corner < 3; ++corner) {
+                        edgeUses[Detail::edgeKey(result[i + corner], result[i + (corner + 1) % 3])]++;
+                    }
+                }
+                for (const auto& [key, uses]: edgeUses) {
+                    if (uses == 1) {
+                        locked[key >> 32] = true;
+                        locked[key & 0xffffffffu] = true;
+                    }
+                }
+            }
+
+            double largestCost = 0.0;
+            Vector<uint32_t> remap(vertexCount);
+            Vector<bool> touched(vertexCount);
+            Vector<Detail::Collapse> collapses;
+
+            while (result.size() > targetIndexCount) {
+                collapses.clear();
+                for (size_t i = 0; i < result.size(); i += 3) {
+                    for (size_t corner = 0; corner < 3; ++corner) {
+                        const uint32_t a = result[i + corner];
+                        const uint32_t b = result[i + (corner + 1) % 3];
+                        if (!locked[a]) {
+                            collapses.push_back({a, b, quadrics[a].evaluate(vertices[b].pos)});
+                        }
+                        if (!locked[b]) {
+                            collapses.push_back({b, a, quadrics[b].evaluate(vertices[a].pos)});
+                        }
+                    }
+                }
+                std::sort(collapses.begin(), collapses.end(), [](const Detail::Collapse& l, const Detail::Collapse& r) {
+                    return l.cost < r.cost;
+                });
+
+                Detail::Adjacency adjacency(result, vertexCount);
+                std::iota(remap.begin(), remap.end(), 0);
+                std::fill(touched.begin(), touched.end(), false);
+
+                // a collapse removes about two triangles, stop the pass once enough are gone
+                const size_t collapseGoal = (result.size() - targetIndexCount) / 6 + 1;
+                size_t collapseCount = 0;
+                for (const auto& collapse: collapses) {
+                    if (collapse.cost > maxCost || collapseCount >= collapseGoal) {
+                        break;
+                    }
+                    if (touched[collapse.from] || touched[collapse.to]) {
+                        continue;
+                    }
+                    if (Detail::flipsTriangles(adjacency, result, vertices, collapse.from, collapse.to)) {
+                        continue;
+                    }
+
+                    // the flip test above assumed the neighbourhood of from stays put for the rest of the pass
+                    for (auto triangle: adjacency.of(collapse.from)) {
+                        for (size_t corner = 0; corner < 3; ++corner) {
+                            touched[result[triangle * 3 + corner]] = true;
+                        }
+                    }
+
+                    remap[collapse.from] = collapse.to;
+                    quadrics[collapse.to] += quadrics[collapse.from];
+                    largestCost = std::max(largestCost, collapse.cost);
+                    ++collapseCount;
+                }
+
+                if (collapseCount == 0) {
+                    break;
+                }
+
+                size_t writeIndex = 0;
+                for (size_t i = 0; i < result.size(); i += 3) {
+                    const uint32_t a = remap[result[i + 0]];
+                    const uint32_t b = remap[result[i + 1]];
+                    const uint32_t c = remap[result[i + 2]];
+                    if (a == b || b == c || c == a) {
+                        continue;
+                    }
+                    result[writeIndex++] = a;
+                    result[writeIndex++] = b;
+                    result[writeIndex++] = c;
+                }
+                result.resize(writeIndex);
+            }
+
+            if (outError) {
+                *outError = static_cast<float>(std::sqrt(largestCost));
+            }
+            return result;
+        }
+
+        uint32_t buildLodChain(VulkanCPUMesh& mesh, uint32_t maxLods) {
+            mesh.lods.clear();
+            mesh.lods.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0.0f});
+            if (!Detail::isOptimizable(mesh)) {
+                return 1;
+            }
+
+            const float maxStepError = glm::length(mesh.max - mesh.min) * MAX_LOD_STEP_ERROR;
+
+            // every level is simplified from the previous one, errors add up
+            Vector<uint32_t> current = mesh.indices;
+            float accumulatedError = 0.0f;
+            while (mesh.lods.size() < std::min(maxLods, MAX_MESH_LODS)) {
+                size_t targetIndexCount = static_cast<size_t>(static_cast<float>(current.size() / 3) * LOD_REDUCTION_RATIO) * 3;
+                if (targetIndexCount < MIN_LOD_TRIANGLES * 3) {
+                    break;
+                }
+
+                float stepError = 0.0f;
+                auto next = simplify(current, mesh.vertices, targetIndexCount, maxStepError, &stepError);
+                // not worth a level if the error bound stopped the reduction early
+                if (next.empty() || static_cast<float>(next.size()) > static_cast<float>(current.size()) * 0.85f) {
+                    break;
+                }
+
+                optimizeVertexCache(Span<uint32_t>(next.data(), next.size()), mesh.vertices.size());
+                accumulatedError += stepError;
+
+                mesh.lods.push_back({
+                        static_cast<uint32_t>(mesh.indices.size()),
+                        static_cast<uint32_t>(next.size()),
+                        accumulatedError,
+                });
+                mesh.indices.insert(mesh.indices.end(), next.begin(), next.end());
+                current = std::move(next);
+            }
+
+            return static_cast<uint32_t>(mesh.lods.size());
+        }
+
+        void buildMeshlets(
+                Span<const uint32_t> indices, Span<const Vertex> vertices,
+                Vector<VulkanMeshlet>& outMeshlets,
+                Vector<uint32_t>& outMeshletVertices,
+                Vector<uint8_t>& outMeshletTriangles,
+                uint32_t maxVertices, uint32_t maxTriangles) {
+            MOE_ASSERT(maxVertices > 2 && maxVertices <= 256, "Meshlet vertices must be addressable with 8 bits");
+            MOE_ASSERT(maxTriangles > 0, "Meshlets need at least one triangle");
+
+            const size_t triangleCount = indices.size() / 3;
+            Detail::Adjacency adjacency(indices, vertices.size());
+            Vector<bool> emitted(triangleCount, false);
+            // position of a vertex in the current meshlet, INVALID_INDEX when it is not part of it
+            Vector<uint32_t> localIndex(vertices.size(), Detail::INVALID_INDEX);
+
+            VulkanMeshlet meshlet{};
+            meshlet.vertexOffset = static_cast<uint32_t>(outMeshletVertices.size());
+            meshlet.triangleOffset = static_cast<uint32_t>(outMeshletTriangles.size());
+            // sum of the meshlet's vertex positions, ties go to the triangle nearest to its centroid for round clusters
+            glm::vec3 positionSum(0.0f);
+
+            auto finishMeshlet = [&]() {
+                if (meshlet.triangleCount == 0) {
+                    return;
+                }
+                auto meshletVertices = Span<const uint32_t>(outMeshletVertices).subspan(meshlet.vertexOffset, meshlet.vertexCount);
+                auto meshletTriangles = Span<const uint8_t>(outMeshletTriangles).subspan(meshlet.triangleOffset, meshlet.triangleCount * 3);
+                computeMeshletBounds(meshlet, meshletVertices, meshletTriangles, vertices);
+                for (auto vertex: meshletVertices) {
+                    localIndex[vertex] = Detail::INVALID_INDEX;
+                }
+                outMeshlets.push_back(meshlet);
+
+                meshlet = {};
+                positionSum = glm::vec3(0.0f);
+                meshlet.vertexOffset = static_cast<uint32_t>(outMeshletVertices.size());
+                meshlet.triangleOffset = static_cast<uint32_t>(outMeshletTriangles.size());
+            };
+
+            auto newVertexCount = [&](uint32_t triangle) {
+                uint32_t count = 0;
+                for (size_t corner = 0; corner < 3; ++corner) {
+                    count += localIndex[indices[triangle * 3 + corner]] == Detail::INVALID_INDEX ? 1 : 0;
+                }
+                return count;
+            };
+
+            auto distanceToCentroid = [&](uint32_t triangle) {
+                const glm::vec3 centroid = positionSum / static_cast<float>(meshlet.vertexCount);
+                const glm::vec3 triangleCenter =
+                        (vertices[indices[triangle * 3 + 0]].pos +
+                         vertices[indices[triangle * 3 + 1]].pos +
+                         vertices[indices[triangle * 3 + 2]].pos) /
+                        3.0f;
+                return glm::length(triangleCenter - centroid);
+            };
+
+            auto appendTriangle = [&](uint32_t triangle) {
+                for (size_t corner = 0; corner < 3; ++corner) {
+                    const uint32_t vertex = indices[triangle * 3 + corner];
+                    if (localIndex[vertex] == Detail::INVALID_INDEX) {
+                        localIndex[vertex] = meshlet.vertexCount++;
+                        outMeshletVertices.push_back(vertex);
+                        positionSum += vertices[vertex].pos;
+                    }
+                    outMeshletTriangles.push_back(static_cast<uint8_t>(localIndex[vertex]));
+                }
+                meshlet.triangleCount++;
+                emitted[triangle] = true;
+            };
+
+            size_t seed = 0;
+            while (true) {
+                // unemitted triangle touching the meshlet that adds the fewest vertices
+                uint32_t best = Detail::INVALID_INDEX;
+                uint32_t bestCost = 4;
+                float bestDistance = std::numeric_limits<float>::max();
+                for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+                    for (auto triangle: adjacency.of(outMeshletVertices[meshlet.vertexOffset + i])) {
+                        if (emitted[triangle]) {
+                            continue;
+                        }
+                        const uint32_t cost = newVertexCount(triangle);
+                        if (cost > bestCost) {
+                            continue;
+                        }
+                        const float distance = distanceToCentroid(triangle);
+                        if (cost < bestCost || distance < bestDistance || (distance == bestDistance && triangle < best)) {
+                            best = triangle;
+                            bestCost = cost;
+                            bestDistance = distance;
+                        }
+                    }
+                }
+
+                if (best == Detail::INVALID_INDEX) {
+                    while (seed < triangleCount && emitted[seed]) {
+                        ++seed;
+                    }
+                    if (seed == triangleCount) {
+                        break;
+                    }
+                    best = static_cast<uint32_t>(seed);
+                    bestCost = newVertexCount(best);
+                }
+
+                if (meshlet.vertexCount + bestCost > maxVertices || meshlet.triangleCount + 1 > maxTriangles) {
+                    // the rejected triangle borders this meshlet, seeding the next one with it keeps them adjacent
+                    finishMeshlet();
+                }
+                appendTriangle(best);
+            }
+            finishMeshlet();
+        }
+
+        void computeMeshletBounds(
+                VulkanMeshlet& meshlet,
+                Span<const uint32_t> meshletVertices, Span<const uint8_t> meshletTriangles,
+                Span<const Vertex> vertices) {
+            glm::vec3 min = vertices[meshletVertices[0]].pos;
+            glm::vec3 max = min;
+            for (auto vertex: meshletVertices) {
+                min = glm::min(min, vertices[vertex].pos);
+                max = glm::max(max, vertices[vertex].pos);
+            }
+            meshlet.aabbMin = min;
+            meshlet.aabbMax = max;
+
+            meshlet.center = (min + max) * 0.5f;
+            meshlet.radius = 0.0f;
+            for (auto vertex: meshletVertices) {
+                meshlet.radius = std::max(meshlet.radius, glm::length(vertices[vertex].pos - meshlet.center));
+            }
+
+            // unit triangle normals, degenerate triangles do not constrain the cone
+            Vector<glm::vec3> normals;
+            Vector<glm::vec3> corners;
+            normals.reserve(meshletTriangles.size() / 3);
+            corners.reserve(meshletTriangles.size() / 3);
+            glm::vec3 axis(0.0f);
+            for (size_t i = 0; i + 2 < meshletTriangles.size(); i += 3) {
+                const glm::vec3& p0 = vertices[meshletVertices[meshletTriangles[i + 0]]].pos;
+                const glm::vec3& p1 = vertices[meshletVertices[meshletTriangles[i + 1]]].pos;
+                const glm::vec3& p2 = vertices[meshletVertices[meshletTriangles[i + 2]]].pos;
+
+                const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                const float length = glm::length(normal);
+                if (length <= 0.0f) {
+                    continue;
+                }
+                normals.push_back(normal / length);
+                corners.push_back(p0);
+                axis += normals.back();
+            }
+
+            meshlet.coneApex = meshlet.center;
+            meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+            meshlet.coneCutoff = 1.0f;
+
+            const float axisLength = glm::length(axis);
+            if (normals.empty() || axisLength <= 0.0f) {
+                return;
+            }
+            axis /= axisLength;
+
+            float minDot = 1.0f;
+            for (const auto& normal: normals) {
+                minDot = std::min(minDot, glm::dot(normal, axis));
+            }
+            // a cone wider than ~84 degrees is practically never culled, keep the test disabled
+            if (minDot <= 0.1f) {
+                return;
+            }
+
+            // slide the apex back along the axis until every triangle plane is in front of it
+            float maxT = 0.0f;
+            for (size_t i = 0; i < normals.size(); ++i) {
+                const float t = glm::dot(meshlet.center - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+                maxT = std::max(maxT, t);
+            }
+
+            meshlet.coneApex = meshlet.center - axis * maxT;
+            meshlet.coneAxis = axis;
+            meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+
+        size_t buildMeshlets(VulkanCPUMesh& mesh) {
+            mesh.meshlets.clear();
+            mesh.meshletVertices.clear();
+            mesh.meshletTriangles.clear();
+            if (!Detail::isOptimizable(mesh)) {
+                return 0;
+            }
+
+            Span<const uint32_t> indices = mesh.indices;
+            if (!mesh.lods.empty()) {
+                indices = indices.subspan(mesh.lods[0].firstIndex, mesh.lods[0].indexCount);
+            }
+
+            buildMeshlets(indices, mesh.vertices, mesh.meshlets, mesh.meshletVertices, mesh.meshletTriangles);
+            return mesh.meshlets.size();
+        }
+    }// namespace MeshOptimizer
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "Render/Vulkan/VulkanOcclusionCuller.hpp"
+#include "Render/Vulkan/VulkanCamera.hpp"
+#include "Render/Vulkan/VulkanMeshCache.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+
+namespace moe {
+    void VulkanOcclusionCuller::setOccluder(MeshId meshId, Span<const glm::vec3> positions, Span<const uint32_t> indices) {
+        MOE_ASSERT(indices.size() % 3 == 0, "Occluder indices must form triangles");
+
+        Occluder occluder;
+        occluder.positions.assign(positions.begin(), positions.end());
+        occluder.indices.assign(indices.begin(), indices.end());
+
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+        for (const auto& position: positions) {
+            min = glm::min(min, position);
+            max = glm::max(max, position);
+        }
+        occluder.center = positions.empty() ? glm::vec3(0.0f) : (min + max) * 0.5f;
+        occluder.radius = positions.empty() ? 0.0f : glm::length(max - min) * 0.5f;
+
+        m_occluders[meshId] = std::move(occluder);
+    }
+
+    void VulkanOcclusionCuller::setMeshOccluder(
+            MeshId meshId, Span<const Vertex> vertices, Span<const uint32_t> indices, Span<const VulkanMeshLod> lods) {
+        if (vertices.empty() || indices.empty()) {
+            return;
+        }
+
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+        for (const auto& vertex: vertices) {
+            min = glm::min(min, vertex.pos);
+            max = glm::max(max, vertex.pos);
+        }
+        const float maxError = glm::length(max - min) * MAX_PROXY_ERROR;
+
+        // lods go from fine to coarse, lod 0 is always within the bound
+        VulkanMeshLod lod{0, static_cast<uint32_t>(indices.size()), 0.0f};
+        for (size_t i = lods.size(); i > 0; --i) {
+            if (i == 1 || lods[i - 1].error <= maxError) {
+                lod = lods[i - 1];
+                break;
+            }
+        }
+        MOE_ASSERT(static_cast<size_t>(lod.firstIndex) + lod.indexCount <= indices.size(), "Lod out of range");
+
+        if (lod.indexCount == 0 || lod.indexCount / 3 > MAX_PROXY_TRIANGLES) {
+            return;
+        }
+
+        // only the vertices the lod references
+        Vector<uint32_t> remap(vertices.size(), std::numeric_limits<uint32_t>::max());
+        Vector<glm::vec3> positions;
+        Vector<uint32_t> proxyIndices;
+        proxyIndices.reserve(lod.indexCount);
+        for (const uint32_t index: indices.subspan(lod.firstIndex, lod.indexCount)) {
+            MOE_ASSERT(index < vertices.size(), "Index out of range");
+            if (remap[index] == std::numeric_limits<uint32_t>::max()) {
+                remap[index] = static_cast<uint32_t>(positions.size());
+                positions.push_back(vertices[index].pos);
+            }
+            proxyIndices.push_back(remap[index]);
+        }
+
+        setOccluder(meshId, positions, proxyIndices);
+    }
+
+    void VulkanOcclusionCuller::update(const VulkanCamera& camera, VkExtent2D viewportExtent) {
+        const float aspect = static_cast<float>(viewportExtent.width) / static_cast<float>(viewportExtent.height);
+        const glm::mat4 projection = camera.projectionMatrix(aspect);
+        m_viewProjection = projection * camera.viewMatrix();
+        m_cameraPos = camera.getPosition();
+        // w is the view depth only with a perspective divide
+        m_perspective = projection[2][3] != 0.0f;
+
+        const auto height = static_cast<uint32_t>(static_cast<float>(m_bufferWidth) / aspect + 0.5f);
+        m_buffer.resize(m_bufferWidth, std::max<uint32_t>(height, 1));
+
+        m_stats = {};
+    }
+
+    size_t VulkanOcclusionCuller::setupOccluders(const Vector<VulkanRenderPacket>& packets, size_t visibleCount) {
+        // nearest and largest first, until the budget is used up
+        m_candidates.clear();
+        for (size_t i = 0; i < visibleCount; ++i) {
+            const auto& packet = packets[i];
+            if (packet.skinned) {
+                continue;
+            }
+            const auto it = m_occluders.find(packet.meshId);
+            if (it == m_occluders.end() || it->second.indices.empty()) {
+                continue;
+            }
+
+            const auto& occluder = it->second;
+            const auto& transform = packet.transform;
+            const float scale = std::max({
+                    glm::length(glm::vec3(transform[0])),
+                    glm::length(glm::vec3(transform[1])),
+                    glm::length(glm::vec3(transform[2])),
+            });
+            const glm::vec3 center = glm::vec3(transform * glm::vec4(occluder.center, 1.0f));
+            const float distance = std::max(glm::length(center - m_cameraPos), 1e-3f);
+            m_candidates.push_back({i, &occluder, occluder.radius * scale / distance});
+        }
+        std::sort(m_candidates.begin(), m_candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+            return lhs.score > rhs.score;
+        });
+
+        size_t triangleCount = 0;
+        size_t occluderCount = 0;
+        m_triangleOffsets.clear();
+        for (const auto& candidate: m_candidates) {
+            const size_t count = candidate.occluder->indices.size() / 3;
+            if (triangleCount + count > MAX_OCCLUDER_TRIANGLES) {
+                // a smaller one further down may still fit
+                continue;
+            }
+            m_candidates[occluderCount++] = candidate;
+            m_triangleOffsets.push_back(triangleCount);
+            triangleCount += count;
+        }
+        m_candidates.resize(occluderCount);
+
+        m_stats.occluders = occluderCount;
+        m_stats.occluderTriangles = triangleCount;
+        if (occluderCount == 0) {
+            return 0;
+        }
+
+        // every occluder projects into its own slice, clipped triangles leave holes that are compacted after
+        m_triangles.resize(triangleCount);
+        m_triangleCounts.resize(occluderCount);
+        parallelForInline(occluderCount, [&](size_t i) {
+            const auto& candidate = m_candidates[i];
+            m_triangleCounts[i] = m_buffer.setupTriangles(
+                    m_viewProjection * packets[candidate.packet].transform,
+                    candidate.occluder->positions,
+                    candidate.occluder->indices,
+                    m_triangles.data() + m_triangleOffsets[i]);
+        });
+
+        size_t setupCount = 0;
+        for (size_t i = 0; i < occluderCount; ++i) {
+            if (m_triangleOffsets[i] != setupCount) {
+                std::copy_n(m_triangles.begin() + m_triangleOffsets[i], m_triangleCounts[i], m_triangles.begin() + setupCount);
+            }
+            setupCount += m_triangleCounts[i];
+        }
+        return setupCount;
+    }
+
+    size_t VulkanOcclusionCuller::cull(const VulkanMeshCache& meshCache, Vector<VulkanRenderPacket>& packets, size_t visibleCount) {
+        MOE_ASSERT(visibleCount <= packets.size(), "visibleCount out of range");
+        if (!m_enabled || !m_perspective || visibleCount == 0 || m_occluders.empty()) {
+            return visibleCount;
+        }
+
+        const size_t triangleCount = setupOccluders(packets, visibleCount);
+        m_stats.rasterizedTriangles = triangleCount;
+        if (triangleCount == 0) {
+            return visibleCount;
+        }
+
+        // every band of tile rows is written by one task only
+        m_buffer.clear();
+        const Span<const OcclusionBuffer::Triangle> triangles(m_triangles.data(), triangleCount);
+        const size_t tileRows = m_buffer.getTileRows();
+        const size_t bandCount = std::min(tileRows, (ThreadPoolScheduler::getInstance().workerCount() + 1) * BANDS_PER_THREAD);
+        parallelForInline(bandCount, [&](size_t band) {
+            m_buffer.rasterize(
+                    triangles,
+                    static_cast<uint32_t>(tileRows * band / bandCount),
+                    static_cast<uint32_t>(tileRows * (band + 1) / bandCount));
+        });
+
+        m_visible.resize(visibleCount);
+        std::atomic_size_t tested{0};
+        std::atomic_size_t occluded{0};
+
+        const size_t chunkCount = (visibleCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        parallelForInline(chunkCount, [&](size_t chunk) {
+            const size_t begin = chunk * CHUNK_SIZE;
+            const size_t end = std::min(begin + CHUNK_SIZE, visibleCount);
+
+            size_t chunkTested = 0;
+            size_t chunkOccluded = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const auto& packet = packets[i];
+                const auto* mesh = packet.skinned ? nullptr : meshCache.findMesh(packet.meshId);
+                if (!mesh) {
+                    m_visible[i] = 1;
+                    continue;
+                }
+
+                const bool visible = m_buffer.isBoxVisible(
+                        m_viewProjection * packet.transform,
+                        (mesh->min + mesh->max) * 0.5f,
+                        (mesh->max - mesh->min) * 0.5f);
+                m_visible[i] = visible ? 1 : 0;
+                chunkTested++;
+                chunkOccluded += visible ? 0 : 1;
+            }
+
+            tested.fetch_add(chunkTested, std::memory_order_relaxed);
+            occluded.fetch_add(chunkOccluded, std::memory_order_relaxed);
+        });
+
+        m_stats.testedPackets = tested.load();
+        m_stats.occludedPackets = occluded.load();
+        if (m_stats.occludedPackets == 0) {
+            return visibleCount;
+        }
+
+        // stable partition of the visible prefix, the frustum culled tail stays where it is
+        m_culled.clear();
+        size_t remaining = 0;
+        for (size_t i = 0; i < visibleCount; ++i) {
+            if (m_visible[i]) {
+                if (remaining != i) {
+                    packets[remaining] = packets[i];
+                }
+                remaining++;
+            } else {
+                m_culled.push_back(packets[i]);
+            }
+        }
+        std::copy(m_culled.begin(), m_culled.end(), packets.begin() + remaining);
+
+        return remaining;
+    }
+}// namespace moe
\ No newline at end of file
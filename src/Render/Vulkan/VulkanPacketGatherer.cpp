@@ -0,0 +1,95 @@
+#include "Render/Vulkan/VulkanPacketGatherer.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+
+
+namespace moe {
+    void VulkanPacketGatherer::countSubmissions(size_t commandCount, const Function<RenderableId(size_t)>& renderableOf) {
+        m_submissions.clear();
+        m_renderables.clear();
+        for (size_t command = 0; command < commandCount; ++command) {
+            const RenderableId id = renderableOf(command);
+            if (m_submissions[id]++ == 0) {
+                m_renderables.push_back(id);
+            }
+        }
+    }
+
+    void VulkanPacketGatherer::gather(
+            size_t commandCount,
+            const Function<void(size_t, Output&)>& fn,
+            Vector<VulkanRenderPacket>& packets,
+            VulkanLodSelector* lodSelector) {
+        // the calling thread gathers chunks too
+        const size_t threadCount = ThreadPoolScheduler::getInstance().workerCount() + 1;
+        size_t chunkCount = 1;
+        if (m_enabled) {
+            chunkCount = std::clamp<size_t>(commandCount / MIN_COMMANDS_PER_CHUNK, 1, threadCount * CHUNKS_PER_THREAD);
+        }
+
+        if (m_outputs.size() < chunkCount) {
+            m_outputs.resize(chunkCount);
+        }
+
+        // chunk 0 gathers straight into the merged array, its packets are already at offset 0
+        const size_t initialCapacity = packets.capacity();
+        packets.clear();
+        std::swap(m_outputs[0].packets, packets);
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            m_outputs[chunk].packets.clear();
+            m_outputs[chunk].lodStats = {};
+        }
+
+        parallelForInline(chunkCount, [&](size_t chunk) {
+            const size_t begin = commandCount * chunk / chunkCount;
+            const size_t end = commandCount * (chunk + 1) / chunkCount;
+
+            auto& output = m_outputs[chunk];
+            for (size_t command = begin; command < end; ++command) {
+                fn(command, output);
+            }
+        });
+
+        std::swap(m_outputs[0].packets, packets);
+
+        // exclusive prefix sum of the chunk sizes, every chunk is then copied to its offset on its own
+        m_offsets.resize(chunkCount + 1);
+        m_offsets[0] = 0;
+        m_offsets[1] = packets.size();
+
+        VulkanLodStats lodStats = m_outputs[0].lodStats;
+        size_t maxChunkPackets = packets.size();
+        for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+            const size_t chunkPackets = m_outputs[chunk].packets.size();
+            m_offsets[chunk + 1] = m_offsets[chunk] + chunkPackets;
+            lodStats += m_outputs[chunk].lodStats;
+            maxChunkPackets = std::max(maxChunkPackets, chunkPackets);
+        }
+
+        const size_t packetCount = m_offsets[chunkCount];
+        packets.resize(packetCount);
+        if (chunkCount > 1) {
+            parallelForInline(chunkCount - 1, [&](size_t index) {
+                const size_t chunk = index + 1;
+                const auto& chunkPackets = m_outputs[chunk].packets;
+                std::copy(chunkPackets.begin(), chunkPackets.end(), packets.begin() + m_offsets[chunk]);
+            });
+        }
+
+        if (lodSelector != nullptr) {
+            lodSelector->addStats(lodStats);
+        }
+
+        m_stats.commands = commandCount;
+        m_stats.chunks = chunkCount;
+        m_stats.packets = packetCount;
+        m_stats.maxChunkPackets = maxChunkPackets;
+        m_stats.peakPackets = std::max(m_stats.peakPackets, packetCount);
+        m_stats.capacity = packets.capacity();
+        if (packets.capacity() > initialCapacity) {
+            m_stats.reallocations++;
+        }
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "Render/Vulkan/VulkanPacketSorter.hpp"
+#include "Render/Vulkan/VulkanCamera.hpp"
+
+#include <algorithm>
+
+
+namespace moe {
+    namespace Detail {
+        static constexpr uint32_t RADIX_BITS = 8;
+        static constexpr uint32_t RADIX_BUCKETS = 1u << RADIX_BITS;
+        static constexpr uint32_t RADIX_DIGITS = 64 / RADIX_BITS;
+
+        constexpr uint64_t fieldMask(uint32_t bits) {
+            return (uint64_t{1} << bits) - 1;
+        }
+
+        // stable lsd radix sort of (key, index) pairs, the sorted pairs end up in keys / indices.
+        // digits every key agrees on are skipped, so sorting by a few distinct materials costs a few passes
+        static size_t radixSort(
+                uint64_t* keys, uint32_t* indices,
+                uint64_t* keysScratch, uint32_t* indicesScratch,
+                size_t count) {
+            // all histograms in one read of the keys
+            uint32_t histograms[RADIX_DIGITS][RADIX_BUCKETS] = {};
+            for (size_t i = 0; i < count; ++i) {
+                const uint64_t key = keys[i];
+                for (uint32_t d = 0; d < RADIX_DIGITS; ++d) {
+                    histograms[d][(key >> (d * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+                }
+            }
+
+            uint64_t* srcKeys = keys;
+            uint32_t* srcIndices = indices;
+            uint64_t* dstKeys = keysScratch;
+            uint32_t* dstIndices = indicesScratch;
+
+            size_t passes = 0;
+            for (uint32_t d = 0; d < RADIX_DIGITS; ++d) {
+                auto& histogram = histograms[d];
+                const uint32_t shift = d * RADIX_BITS;
+                if (histogram[(srcKeys[0] >> shift) & (RADIX_BUCKETS - 1)] == count) {
+                    continue;
+                }
+
+                uint32_t offsets[RADIX_BUCKETS];
+                uint32_t sum = 0;
+                for (uint32_t b = 0; b < RADIX_BUCKETS; ++b) {
+                    offsets[b] = sum;
+                    sum += histogram[b];
+                }
+
+                for (size_t i = 0; i < count; ++i) {
+                    const uint64_t key = srcKeys[i];
+                    const uint32_t dst = offsets[(key >> shift) & (RADIX_BUCKETS - 1)]++;
+                    dstKeys[dst] = key;
+                    dstIndices[dst] = srcIndices[i];
+                }
+
+                std::swap(srcKeys, dstKeys);
+                std::swap(srcIndices, dstIndices);
+                passes++;
+            }
+
+            if (srcKeys != keys) {
+                std::copy(srcKeys, srcKeys + count, keys);
+                std::copy(srcIndices, srcIndices + count, indices);
+            }
+            return passes;
+        }
+    }// namespace Detail
+
+    void VulkanPacketSorter::update(const VulkanCamera& camera) {
+        m_cameraPos = camera.getPosition();
+        m_invFarZ = 1.0f / camera.getFarZ();
+
+        m_stats = {};
+    }
+
+    uint64_t VulkanPacketSorter::makeKey(const VulkanRenderPacket& packet, Pass pass) const {
+        // skinned packets read another vertex buffer, group them apart
+        const uint64_t pipeline = packet.skinned ? 1 : 0;
+
+        const float distance = glm::length(glm::vec3(packet.transform[3]) - m_cameraPos) * m_invFarZ;
+        const uint64_t depth = static_cast<uint64_t>(
+                std::clamp(distance, 0.0f, 1.0f) * static_cast<float>(Detail::fieldMask(DEPTH_BITS)));
+
+        uint64_t key = static_cast<uint64_t>(pass) & Detail::fieldMask(PASS_BITS);
+        key = (key << PIPELINE_BITS) | (pipeline & Detail::fieldMask(PIPELINE_BITS));
+        key = (key << MATERIAL_BITS) | (packet.materialId & Detail::fieldMask(MATERIAL_BITS));
+        key = (key << MESH_BITS) | (packet.meshId & Detail::fieldMask(MESH_BITS));
+        key = (key << DEPTH_BITS) | depth;
+        return key;
+    }
+
+    void VulkanPacketSorter::sort(Span<VulkanRenderPacket> packets, Pass pass) {
+        const size_t count = packets.size();
+        if (!m_enabled || count <= 1) {
+            return;
+        }
+        MOE_ASSERT(count <= std::numeric_limits<uint32_t>::max(), "Too many render packets to sort");
+
+        // resize only allocates while the packet count grows
+        m_keys.resize(count);
+        m_keysScratch.resize(count);
+        m_indices.resize(count);
+        m_indicesScratch.resize(count);
+
+        bool sorted = true;
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t key = makeKey(packets[i], pass);
+            packets[i].sortKey = key;
+            m_keys[i] = key;
+            m_indices[i] = static_cast<uint32_t>(i);
+            sorted = sorted && (i == 0 || m_keys[i - 1] <= key);
+        }
+
+        m_stats.sortedPackets += count;
+        if (sorted) {
+            return;
+        }
+
+        m_stats.radixPasses += Detail::radixSort(
+                m_keys.data(), m_indices.data(),
+                m_keysScratch.data(), m_indicesScratch.data(),
+                count);
+
+        m_packetsScratch.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_packetsScratch[i] = packets[m_indices[i]];
+        }
+        std::copy(m_packetsScratch.begin(), m_packetsScratch.begin() + count, packets.begin());
+    }
+}// namespace moe
\ No newline at end of file
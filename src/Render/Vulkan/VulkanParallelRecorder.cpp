@@ -0,0 +1,154 @@
+#include "Render/Vulkan/VulkanParallelRecorder.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanInitializers.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <thread>
+
+
+namespace moe {
+    void VulkanParallelRecorder::init(VulkanEngine& engine) {
+        MOE_ASSERT(!m_initialized, "VulkanParallelRecorder already initialized");
+
+        m_engine = &engine;
+
+        // the calling thread records chunks too
+        const size_t slotCount = ThreadPoolScheduler::getInstance().workerCount() + 1;
+        // buffers are only reset together with their pool
+        const auto poolInfo = VkInit::commandPoolCreateInfo(engine.m_graphicsQueueFamilyIndex, 0);
+
+        m_slots.reserve(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) {
+            auto slot = std::make_unique<Slot>();
+            for (auto& frame: slot->frames) {
+                MOE_VK_CHECK_MSG(
+                        vkCreateCommandPool(engine.m_device, &poolInfo, nullptr, &frame.pool),
+                        "Failed to create secondary command pool");
+            }
+            m_slots.push_back(std::move(slot));
+        }
+
+        m_stats = {};
+        m_stats.slots = slotCount;
+
+        m_initialized = true;
+    }
+
+    void VulkanParallelRecorder::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanParallelRecorder not initialized");
+
+        // destroying a pool frees its buffers
+        for (auto& slot: m_slots) {
+            for (auto& frame: slot->frames) {
+                vkDestroyCommandPool(m_engine->m_device, frame.pool, nullptr);
+            }
+        }
+        m_slots.clear();
+
+        m_engine = nullptr;
+        m_initialized = false;
+    }
+
+    void VulkanParallelRecorder::beginFrame(size_t frameIndex) {
+        MOE_ASSERT(m_initialized, "VulkanParallelRecorder not initialized");
+        MOE_ASSERT(frameIndex < Constants::FRAMES_IN_FLIGHT, "Frame index out of range");
+
+        m_currentFrame = frameIndex;
+        for (auto& slot: m_slots) {
+            auto& frame = slot->frames[frameIndex];
+            if (frame.used > 0) {
+                MOE_VK_CHECK(vkResetCommandPool(m_engine->m_device, frame.pool, 0));
+                frame.used = 0;
+            }
+        }
+
+        m_stats.passes = 0;
+        m_stats.chunks = 0;
+    }
+
+    size_t VulkanParallelRecorder::getChunkCount(size_t itemCount) const {
+        if (!m_enabled || !m_initialized) {
+            return 1;
+        }
+        return std::clamp<size_t>(itemCount / m_minItemsPerChunk, 1, m_slots.size());
+    }
+
+    void VulkanParallelRecorder::record(
+            VkCommandBuffer cmdBuffer,
+            const RenderingFormats& formats,
+            size_t chunkCount,
+            const Function<void(VkCommandBuffer, size_t)>& fn) {
+        MOE_ASSERT(m_initialized, "VulkanParallelRecorder not initialized");
+
+        if (chunkCount == 0) {
+            return;
+        }
+
+        const auto inheritanceRendering = VkCommandBufferInheritanceRenderingInfo{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+                .colorAttachmentCount = static_cast<uint32_t>(formats.colorFormats.size()),
+                .pColorAttachmentFormats = formats.colorFormats.data(),
+                .depthAttachmentFormat = formats.depthFormat,
+                .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+                .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+        };
+        const auto inheritance = VkCommandBufferInheritanceInfo{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                .pNext = &inheritanceRendering,
+        };
+        auto beginInfo = VkInit::commandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+        beginInfo.pInheritanceInfo = &inheritance;
+
+        Vector<VkCommandBuffer> secondaries(chunkCount, VK_NULL_HANDLE);
+        parallelForInline(chunkCount, [&](size_t chunk) {
+            auto& slot = acquireSlot();
+            std::lock_guard<std::mutex> lock(slot.mutex, std::adopt_lock);
+
+            VkCommandBuffer secondary = nextCommandBuffer(slot);
+            MOE_VK_CHECK(vkBeginCommandBuffer(secondary, &beginInfo));
+            fn(secondary, chunk);
+            MOE_VK_CHECK(vkEndCommandBuffer(secondary));
+
+            secondaries[chunk] = secondary;
+        });
+
+        // in chunk order, so the draw order matches inline recording
+        vkCmdExecuteCommands(cmdBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+
+        m_stats.passes++;
+        m_stats.chunks += chunkCount;
+        m_stats.commandBuffers = 0;
+        for (const auto& slot: m_slots) {
+            for (const auto& frame: slot->frames) {
+                m_stats.commandBuffers += frame.buffers.size();
+            }
+        }
+    }
+
+    VulkanParallelRecorder::Slot& VulkanParallelRecorder::acquireSlot() {
+        // at most one thread per slot records at a time, a free slot shows up quickly
+        for (;;) {
+            for (auto& slot: m_slots) {
+                if (slot->mutex.try_lock()) {
+                    return *slot;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    VkCommandBuffer VulkanParallelRecorder::nextCommandBuffer(Slot& slot) {
+        auto& frame = slot.frames[m_currentFrame];
+        if (frame.used == frame.buffers.size()) {
+            auto allocInfo = VkInit::commandBufferAllocateInfo(frame.pool);
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+            VkCommandBuffer buffer;
+            MOE_VK_CHECK(vkAllocateCommandBuffers(m_engine->m_device, &allocInfo, &buffer));
+            frame.buffers.push_back(buffer);
+        }
+        return frame.buffers[frame.used++];
+    }
+}// namespace moe
\ No newline at end of file
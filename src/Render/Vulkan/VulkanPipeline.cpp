@@ -127,6 +127,10 @@ namespace moe {
         rasterizer.frontFace = frontFace;
     }
 
+    void VulkanPipelineBuilder::setDepthClamp(bool enabled) {
+        rasterizer.depthClampEnable = enabled ? VK_TRUE : VK_FALSE;
+    }
+
     void VulkanPipelineBuilder::disableMultisampling() {
         multisampling.sampleShadingEnable = VK_FALSE;
         multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
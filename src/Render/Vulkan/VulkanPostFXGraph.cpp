@@ -109,6 +109,7 @@ void VulkanPostFXGraph::buildGraph() {
         compiledStage.outputExtent = stage.outputExtent;
 
         nameToImageIndex[stage.name] = index;
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::RenderTarget);
         auto imageId =
                 engine->m_caches.imageCache.addImage(engine->allocateImage(
                         stage.outputExtent, stage.outputFormat,
@@ -47,6 +47,7 @@ namespace moe {
         VkImageCreateInfo drawImageInfo = VkInit::imageCreateInfo(drawImage.imageFormat, drawImageUsage, drawExtent);
         drawImageInfo.samples = engine->isMultisamplingEnabled() ? VK_SAMPLE_COUNT_4_BIT : VK_SAMPLE_COUNT_1_BIT;
 
+        VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::RenderTarget);
         drawImage = engine->allocateImage(drawImageInfo);
 
         VkImageUsageFlags depthImageUsage{};
@@ -1,72 +1,67 @@
 #include "Render/Vulkan/VulkanScene.hpp"
+#include "Render/Vulkan/VulkanLodSelector.hpp"
 
 namespace moe {
-    void VulkanRenderNode::updateTransform(const glm::mat4& parentTransform) {
-        worldTransform = parentTransform * localTransform;
-        for (auto& child: children) {
-            child->updateTransform(worldTransform);
+    TransformHierarchy::NodeIndex VulkanScene::addNode(
+            TransformHierarchy::NodeIndex parent,
+            const glm::mat4& localTransform,
+            SceneResourceInternalId mesh) {
+        MOE_ASSERT(mesh == NULL_SCENE_RESOURCE_INTERNAL_ID || mesh < meshes.size(), "Node mesh out of range");
+
+        const auto node = hierarchy.addNode(parent, localTransform);
+        nodeMeshes.push_back(mesh);
+        nodeLodOffsets.push_back(static_cast<uint32_t>(primitiveLods.size()));
+        if (mesh != NULL_SCENE_RESOURCE_INTERNAL_ID) {
+            primitiveLods.resize(primitiveLods.size() + meshes[mesh].primitives.size(), 0);
         }
+        return node;
+    }
+
+    void VulkanScene::updateTransforms() {
+        hierarchy.update();
     }
 
-    void VulkanSceneNode::gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) {
-        MOE_ASSERT(drawContext.sceneMeshes != nullptr, "drawContext.sceneMeshes is null");
+    void VulkanScene::gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) {
+        MOE_ASSERT(!hierarchy.isDirty(), "Scene gathered before its transforms were updated");
+        MOE_ASSERT(drawContext.lodSelector == nullptr || drawContext.lodStats != nullptr, "drawContext.lodStats is null");
+
+        const bool skinned = drawContext.jointMatrixStartIndex != INVALID_JOINT_MATRIX_START_INDEX;
 
-        if (resourceInternalId != NULL_SCENE_RESOURCE_INTERNAL_ID) {
-            auto& sceneMesh = drawContext.sceneMeshes->at(resourceInternalId);
+        for (size_t node = 0; node < nodeMeshes.size(); ++node) {
+            const auto meshIndex = nodeMeshes[node];
+            if (meshIndex == NULL_SCENE_RESOURCE_INTERNAL_ID) {
+                continue;
+            }
+
+            const auto& sceneMesh = meshes[meshIndex];
+            auto* lods = primitiveLods.data() + nodeLodOffsets[node];
+
+            // every primitive of a node shares its instance transform
+            glm::mat4 transform;
+            TransformKernels::multiply(drawContext.transform, hierarchy.getWorldMatrix(node), transform);
 
-            for (int i = 0; i < sceneMesh.primitives.size(); ++i) {
+            for (size_t i = 0; i < sceneMesh.primitives.size(); ++i) {
                 VulkanRenderPacket packet{
                         .meshId = sceneMesh.primitives[i],
                         .materialId = sceneMesh.primitiveMaterials[i],
-                        .transform = worldTransform,
+                        .transform = transform,
                         .sortKey = 0,
+                        .skinned = skinned,
+                        .jointMatrixStartIndex = drawContext.jointMatrixStartIndex,
                 };
 
-                if (drawContext.jointMatrixStartIndex != INVALID_JOINT_MATRIX_START_INDEX) {
-                    packet.skinned = true;
-                    packet.jointMatrixStartIndex = drawContext.jointMatrixStartIndex;
-                } else {
-                    packet.skinned = false;
-                    packet.jointMatrixStartIndex = INVALID_JOINT_MATRIX_START_INDEX;
+                if (drawContext.lodSelector != nullptr && drawContext.instanced) {
+                    // the node's lod belongs to no instance in particular
+                    packet.lod = drawContext.lodSelector->select(
+                            packet.meshId, transform, VulkanLodSelector::NO_CURRENT_LOD, *drawContext.lodStats);
+                } else if (drawContext.lodSelector != nullptr) {
+                    lods[i] = static_cast<uint8_t>(
+                            drawContext.lodSelector->select(packet.meshId, transform, lods[i], *drawContext.lodStats));
+                    packet.lod = lods[i];
                 }
 
                 packets.push_back(packet);
             }
         }
-
-        VulkanDrawContext localCtx{
-                .lastContext = &drawContext,
-                .sceneMeshes = drawContext.sceneMeshes,
-                .jointMatrixStartIndex = drawContext.jointMatrixStartIndex,
-        };
-
-        packets.reserve(packets.size() + children.size());
-        for (auto& child: children) {
-            child->gatherRenderPackets(packets, localCtx);
-        }
-    }
-
-    void VulkanScene::gatherRenderPackets(Vector<VulkanRenderPacket>& packets, const VulkanDrawContext& drawContext) {
-        if (drawContext.isNull()) {
-            VulkanDrawContext localCtx{
-                    .lastContext = nullptr,
-                    .sceneMeshes = &meshes,
-                    .jointMatrixStartIndex = drawContext.jointMatrixStartIndex,
-            };
-            gatherRenderPackets(packets, localCtx);
-            return;
-        }
-
-        VulkanDrawContext localCtx{
-                .lastContext = &drawContext,
-                .sceneMeshes = &meshes,
-                .jointMatrixStartIndex = drawContext.jointMatrixStartIndex,
-        };
-
-        packets.reserve(packets.size() + children.size());
-
-        for (auto& child: children) {
-            child->gatherRenderPackets(packets, drawContext);
-        }
     }
 }// namespace moe
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "Render/Vulkan/VulkanStaticBatcher.hpp"
+#include "Render/Vulkan/VulkanMeshOptimizer.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace moe {
+    namespace StaticBatching {
+        namespace Detail {
+            struct Instance {
+                uint32_t node;
+                uint32_t primitive;
+                int32_t material;
+                glm::ivec3 cell;
+                uint32_t vertexCount;
+            };
+
+            struct Batch {
+                size_t firstInstance;
+                size_t instanceCount;
+            };
+
+            bool sameGroup(const Instance& a, const Instance& b) {
+                return a.material == b.material && a.cell == b.cell;
+            }
+
+            bool hasGeometry(const VulkanCookedScene::Primitive& primitive) {
+                return primitive.indices.count > 0 && primitive.vertices.count > 0;
+            }
+
+            // skinned primitives are deformed every frame, a mesh is merged all or nothing
+            bool isBatchable(const VulkanCookedScene& cooked, const VulkanCookedScene::Mesh& mesh) {
+                bool anyGeometry = false;
+                for (uint32_t i = 0; i < mesh.primitiveCount; ++i) {
+                    const auto& primitive = cooked.primitives[mesh.firstPrimitive + i];
+                    if (primitive.skinningData.count > 0) {
+                        return false;
+                    }
+                    anyGeometry |= hasGeometry(primitive);
+                }
+                return anyGeometry;
+            }
+
+            Span<const uint32_t> fullDetailIndices(const VulkanCookedScene& cooked, const VulkanCookedScene::Primitive& primitive) {
+                auto indices = cooked.slice(cooked.indices, primitive.indices);
+                auto lods = cooked.slice(cooked.lods, primitive.lods);
+                if (lods.empty()) {
+                    return indices;
+                }
+                return indices.subspan(lods[0].firstIndex, lods[0].indexCount);
+            }
+
+            glm::ivec3 cellOf(const VulkanCookedScene::Primitive& primitive, const glm::mat4& transform, float cellSize) {
+                glm::vec3 center = glm::vec3(transform * glm::vec4((primitive.min + primitive.max) * 0.5f, 1.0f));
+                return glm::ivec3(glm::floor(center / cellSize));
+            }
+
+            void appendInstance(
+                    VulkanCPUMesh& batch,
+                    const VulkanCookedScene& cooked,
+                    const VulkanCookedScene::Primitive& primitive,
+                    const glm::mat4& transform) {
+                const auto linear = glm::mat3(transform);
+                const auto normalMatrix = glm::transpose(glm::inverse(linear));
+                // a mirroring transform flips both the winding and the tangent frame handedness
+                const bool mirrored = glm::determinant(linear) < 0.0f;
+
+                const auto baseVertex = static_cast<uint32_t>(batch.vertices.size());
+                for (auto vertex: cooked.slice(cooked.vertices, primitive.vertices)) {
+                    vertex.pos = glm::vec3(transform * glm::vec4(vertex.pos, 1.0f));
+                    vertex.normal = glm::normalize(normalMatrix * vertex.normal);
+                    glm::vec3 tangent = glm::normalize(linear * glm::vec3(vertex.tangent));
+                    vertex.tangent = glm::vec4(tangent, mirrored ? -vertex.tangent.w : vertex.tangent.w);
+
+                    batch.min = glm::min(batch.min, vertex.pos);
+                    batch.max = glm::max(batch.max, vertex.pos);
+                    batch.vertices.push_back(vertex);
+                }
+
+                auto indices = fullDetailIndices(cooked, primitive);
+                for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                    batch.indices.push_back(baseVertex + indices[i]);
+                    batch.indices.push_back(baseVertex + indices[mirrored ? i + 2 : i + 1]);
+                    batch.indices.push_back(baseVertex + indices[mirrored ? i + 1 : i + 2]);
+                }
+            }
+        }// namespace Detail
+
+        VulkanCookedScene mergeStaticGeometry(const VulkanCookedScene& cooked, const Options& options, Report* outReport) {
+            MOE_ASSERT(options.cellSize > 0.0f, "Static batching cell size must be positive");
+
+            auto builder = cooked.toBuilder();
+
+            // nodes are pre-order, a parent's world transform is always ready before its children
+            Vector<glm::mat4> worldTransforms(cooked.nodes.size());
+            for (size_t nodeIdx = 0; nodeIdx < cooked.nodes.size(); ++nodeIdx) {
+                const auto& node = cooked.nodes[nodeIdx];
+                worldTransforms[nodeIdx] = node.parent == VulkanCookedScene::NO_PARENT
+                                                   ? node.localTransform
+                                                   : worldTransforms[node.parent] * node.localTransform;
+            }
+
+            Vector<bool> batchable(cooked.meshes.size());
+            for (size_t meshIdx = 0; meshIdx < cooked.meshes.size(); ++meshIdx) {
+                batchable[meshIdx] = Detail::isBatchable(cooked, cooked.meshes[meshIdx]);
+            }
+
+            Vector<Detail::Instance> instances;
+            Vector<uint32_t> mergedReferences(cooked.meshes.size(), 0);
+            for (size_t nodeIdx = 0; nodeIdx < cooked.nodes.size(); ++nodeIdx) {
+                auto& node = builder.nodes[nodeIdx];
+                if (node.mesh == NULL_SCENE_RESOURCE_INTERNAL_ID || !batchable[node.mesh]) {
+                    continue;
+                }
+
+                mergedReferences[node.mesh]++;
+                const auto& mesh = cooked.meshes[node.mesh];
+                for (uint32_t i = 0; i < mesh.primitiveCount; ++i) {
+                    const auto primitiveIdx = mesh.firstPrimitive + i;
+                    const auto& primitive = cooked.primitives[primitiveIdx];
+                    if (!Detail::hasGeometry(primitive)) {
+                        continue;
+                    }
+                    instances.push_back({
+                            static_cast<uint32_t>(nodeIdx),
+                            primitiveIdx,
+                            primitive.material,
+                            Detail::cellOf(primitive, worldTransforms[nodeIdx], options.cellSize),
+                            static_cast<uint32_t>(primitive.vertices.count),
+                    });
+                }
+                // the node stays for the hierarchy, its geometry now lives in the batches
+                node.mesh = NULL_SCENE_RESOURCE_INTERNAL_ID;
+            }
+
+            // grouped by material, then cell; node order inside a group keeps the output deterministic
+            std::stable_sort(instances.begin(), instances.end(), [](const Detail::Instance& a, const Detail::Instance& b) {
+                if (a.material != b.material) return a.material < b.material;
+                if (a.cell.x != b.cell.x) return a.cell.x < b.cell.x;
+                if (a.cell.y != b.cell.y) return a.cell.y < b.cell.y;
+                return a.cell.z < b.cell.z;
+            });
+
+            Vector<Detail::Batch> batches;
+            size_t batchVertices = 0;
+            for (size_t i = 0; i < instances.size(); ++i) {
+                const bool newGroup = batches.empty() || !Detail::sameGroup(instances[i - 1], instances[i]);
+                if (newGroup || batchVertices + instances[i].vertexCount > options.maxVerticesPerBatch) {
+                    batches.push_back({i, 0});
+                    batchVertices = 0;
+                }
+                batches.back().instanceCount++;
+                batchVertices += instances[i].vertexCount;
+            }
+
+            Vector<VulkanCPUMesh> batchMeshes(batches.size());
+            parallelForInline(batches.size(), [&](size_t batchIdx) {
+                const auto& batch = batches[batchIdx];
+                auto& batchMesh = batchMeshes[batchIdx];
+                batchMesh.min = glm::vec3(std::numeric_limits<float>::max());
+                batchMesh.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+                for (size_t i = batch.firstInstance; i < batch.firstInstance + batch.instanceCount; ++i) {
+                    const auto& instance = instances[i];
+                    Detail::appendInstance(batchMesh, cooked, cooked.primitives[instance.primitive], worldTransforms[instance.node]);
+                }
+
+                if (options.buildLods) {
+                    MeshOptimizer::buildLodChain(batchMesh);
+                }
+                MeshOptimizer::buildMeshlets(batchMesh);
+            });
+
+            // every instance of a batchable mesh got merged, its primitives keep their slot but are not uploaded
+            Report report{};
+            for (size_t meshIdx = 0; meshIdx < cooked.meshes.size(); ++meshIdx) {
+                if (mergedReferences[meshIdx] == 0) {
+                    continue;
+                }
+                const auto& mesh = cooked.meshes[meshIdx];
+                for (uint32_t i = 0; i < mesh.primitiveCount; ++i) {
+                    auto& primitive = builder.primitives[mesh.firstPrimitive + i];
+                    report.releasedPrimitives += Detail::hasGeometry(primitive) ? 1 : 0;
+                    primitive.vertices.count = 0;
+                    primitive.indices.count = 0;
+                }
+            }
+
+            for (size_t batchIdx = 0; batchIdx < batches.size(); ++batchIdx) {
+                const auto material = instances[batches[batchIdx].firstInstance].material;
+
+                VulkanCookedScene::Mesh mesh{};
+                mesh.firstPrimitive = static_cast<uint32_t>(builder.primitives.size());
+                mesh.primitiveCount = 1;
+                builder.primitives.push_back(builder.addPrimitive(batchMeshes[batchIdx], material));
+
+                VulkanCookedScene::Node node{};
+                node.mesh = static_cast<SceneResourceInternalId>(builder.meshes.size());
+                builder.meshes.push_back(mesh);
+                builder.nodes.push_back(node);
+
+                batchMeshes[batchIdx] = {};
+            }
+
+            report.mergedInstances = instances.size();
+            report.batches = batches.size();
+            if (outReport != nullptr) {
+                *outReport = report;
+            }
+
+            return VulkanCookedScene::build(builder);
+        }
+    }// namespace StaticBatching
+}// namespace moe
\ No newline at end of file
@@ -11,6 +11,11 @@ namespace moe {
         m_swapCount = swapCount;
         m_engine = &engine;
 
+        // per-frame data unless the caller tagged it otherwise
+        auto category = VulkanMemoryTracker::currentCategory();
+        VulkanMemoryTracker::ScopedCategory memoryCategory(
+                category == VulkanMemoryCategory::Other ? VulkanMemoryCategory::Dynamic : category);
+
         m_buffer = engine.allocateBuffer(
                 bufferSize * swapCount,
                 usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
@@ -137,6 +142,10 @@ namespace moe {
         m_swapCount = swapCount;
         m_engine = &engine;
 
+        auto category = VulkanMemoryTracker::currentCategory();
+        VulkanMemoryTracker::ScopedCategory memoryCategory(
+                category == VulkanMemoryCategory::Other ? VulkanMemoryCategory::RenderTarget : category);
+
         m_images.resize(swapCount);
         for (size_t i = 0; i < swapCount; i++) {
             auto image = engine.allocateImage(
@@ -0,0 +1,533 @@
+#include "Render/Vulkan/VulkanTextureStreamer.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanInitializers.hpp"
+#include "Render/Vulkan/VulkanUtils.hpp"
+
+#include "Core/FileReader.hpp"
+#include "Core/Resource/ImageLoader.hpp"
+#include "Core/Task/Utils.hpp"
+
+namespace moe {
+    namespace Detail {
+        static ImageKernels::ColorSpace colorSpaceFromFormat(VkFormat format) {
+            return format == VK_FORMAT_R8G8B8A8_SRGB
+                           ? ImageKernels::ColorSpace::Srgb
+                           : ImageKernels::ColorSpace::Linear;
+        }
+    }// namespace Detail
+
+    void VulkanTextureStreamer::init(VulkanEngine& engine, VulkanImageCache& imageCache) {
+        MOE_ASSERT(!m_initialized, "VulkanTextureStreamer already initialized");
+
+        m_engine = &engine;
+        m_imageCache = &imageCache;
+
+        // streamed mips are the only texture memory that can be given back without reloading
+        engine.getMemoryTracker().setBudgetHandler(
+                VulkanMemoryCategory::StreamedTexture,
+                [this](size_t categoryBudget) {
+                    m_budgetLimit = categoryBudget;
+                });
+
+        m_initialized = true;
+    }
+
+    void VulkanTextureStreamer::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanTextureStreamer not initialized");
+
+        // ! note: the images themselves are owned by the image cache.
+        // pending decodes only hold their own data, so they can be dropped safely
+        m_images.clear();
+        m_residentBytes = 0;
+
+        m_engine->getMemoryTracker().setBudgetHandler(VulkanMemoryCategory::StreamedTexture, nullptr);
+
+        m_engine = nullptr;
+        m_imageCache = nullptr;
+        m_initialized = false;
+    }
+
+    void VulkanTextureStreamer::addImageFromFile(ImageId id, StringView filename, VkFormat format, VkImageUsageFlags usage) {
+        MOE_ASSERT(m_initialized, "VulkanTextureStreamer not initialized");
+        MOE_ASSERT(VkUtils::getBytesPerPixelFromFormat(format) == 4, "Streamed images must be rgba8");
+
+        Source source;
+        source.filename = String(filename);
+        source.colorSpace = Detail::colorSpaceFromFormat(format);
+
+        addStreamed(id, format, usage, std::move(source));
+    }
+
+    void VulkanTextureStreamer::addImageFromMemory(ImageId id, Vector<uint8_t>&& rgba, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage) {
+        MOE_ASSERT(m_initialized, "VulkanTextureStreamer not initialized");
+        MOE_ASSERT(VkUtils::getBytesPerPixelFromFormat(format) == 4, "Streamed images must be rgba8");
+        MOE_ASSERT(rgba.size() == static_cast<size_t>(extent.width) * extent.height * 4, "Image data size mismatch");
+
+        // ! note: there is nothing to decode again from, so the base level is the source
+        Source source;
+        source.pixels = std::make_shared<const Vector<uint8_t>>(std::move(rgba));
+        source.extent = extent;
+        source.colorSpace = Detail::colorSpaceFromFormat(format);
+
+        addStreamed(id, format, usage, std::move(source));
+    }
+
+    void VulkanTextureStreamer::addStreamed(ImageId id, VkFormat format, VkImageUsageFlags usage, Source&& source) {
+        MOE_ASSERT(!isStreamed(id), "Image is already streamed");
+
+        StreamedImage image;
+        image.format = format;
+        image.usage = usage;
+        image.source = std::move(source);
+        // the first decode builds the whole chain to learn its layout, only the tail is kept resident
+        image.pendingLoad.emplace(loadLevels(image.source, 0));
+
+        m_images.emplace(id, std::move(image));
+    }
+
+    VulkanTextureStreamer::MipChainFuture VulkanTextureStreamer::loadLevels(const Source& source, uint32_t maxLevels) {
+        return async([source, maxLevels]() {
+            if (source.pixels) {
+                return std::make_shared<ImageKernels::MipChain>(
+                        ImageKernels::buildMipChain(
+                                source.pixels->data(),
+                                source.extent.width, source.extent.height,
+                                source.colorSpace, false, maxLevels));
+            }
+
+            size_t fileSize = 0;
+            auto fileBuf = FileReader::s_instance->readFile(source.filename, fileSize);
+            if (!fileBuf) {
+                Logger::error("Failed to read streamed image file: {}", source.filename);
+                return SharedPtr<ImageKernels::MipChain>(nullptr);
+            }
+
+            Vector<uint8_t> rgba;
+            int width, height, channels;
+            if (!moe::Detail::loadImageFromMemory(fileBuf->data(), fileSize, rgba, width, height, channels, 4)) {
+                Logger::error("Failed to decode streamed image: {}", source.filename);
+                return SharedPtr<ImageKernels::MipChain>(nullptr);
+            }
+
+            return std::make_shared<ImageKernels::MipChain>(
+                    ImageKernels::buildMipChain(
+                            rgba.data(),
+                            static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                            source.colorSpace, false, maxLevels));
+        });
+    }
+
+    bool VulkanTextureStreamer::isResident(ImageId id) const {
+        auto it = m_images.find(id);
+        return it != m_images.end() && it->second.residentLevel != NOT_RESIDENT;
+    }
+
+    void VulkanTextureStreamer::removeImage(ImageId id) {
+        auto it = m_images.find(id);
+        if (it == m_images.end()) {
+            return;
+        }
+
+        // the gpu image is disposed by the image cache
+        if (it->second.residentLevel != NOT_RESIDENT) {
+            m_residentBytes -= residentSize(it->second, it->second.residentLevel);
+        }
+        m_images.erase(it);
+    }
+
+    void VulkanTextureStreamer::requestScreenSize(ImageId id, float screenPixels) {
+        auto it = m_images.find(id);
+        if (it == m_images.end()) {
+            return;
+        }
+
+        auto& image = it->second;
+        if (image.lastRequestedFrame != m_frame) {
+            image.requestedScreenSize = 0.0f;
+            image.lastRequestedFrame = m_frame;
+        }
+        image.requestedScreenSize = std::max(image.requestedScreenSize, screenPixels);
+    }
+
+    void VulkanTextureStreamer::gatherFeedback(
+            const Vector<VulkanRenderPacket>& packets,
+            const VulkanMeshCache& meshCache,
+            VulkanMaterialCache& materialCache,
+            const VulkanCamera& camera,
+            VkExtent2D viewportExtent) {
+        if (m_images.empty()) {
+            return;
+        }
+
+        const glm::vec3 cameraPos = camera.getPosition();
+        const float nearZ = camera.getNearZ();
+        // pixels covered by a unit-size object at unit distance
+        const float pixelsPerUnit =
+                static_cast<float>(viewportExtent.height) /
+                (2.0f * std::tan(glm::radians(camera.getFovDeg()) * 0.5f));
+
+        for (const auto& packet: packets) {
+            auto mesh = meshCache.getMesh(packet.meshId);
+            auto material = materialCache.getMaterial(packet.materialId);
+            if (!mesh || !material) {
+                continue;
+            }
+
+            const glm::vec3 localCenter = (mesh->min + mesh->max) * 0.5f;
+            const glm::vec3 localExtent = (mesh->max - mesh->min) * 0.5f;
+            const float maxScale = std::max({
+                    glm::length(glm::vec3(packet.transform[0])),
+                    glm::length(glm::vec3(packet.transform[1])),
+                    glm::length(glm::vec3(packet.transform[2])),
+            });
+
+            const glm::vec3 center = glm::vec3(packet.transform * glm::vec4(localCenter, 1.0f));
+            const float radius = glm::length(localExtent) * maxScale;
+            const float distance = std::max(glm::length(center - cameraPos) - radius, nearZ);
+
+            const float screenPixels = 2.0f * radius / distance * pixelsPerUnit;
+
+            requestScreenSize(material->diffuseTexture, screenPixels);
+            requestScreenSize(material->normalTexture, screenPixels);
+            requestScreenSize(material->metallicRoughnessTexture, screenPixels);
+            requestScreenSize(material->emissiveTexture, screenPixels);
+        }
+    }
+
+    void VulkanTextureStreamer::pollPendingLoads() {
+        for (auto& [id, image]: m_images) {
+            if (!image.pendingLoad || !image.pendingLoad->isReady()) {
+                continue;
+            }
+
+            auto chain = image.pendingLoad->get();
+            image.pendingLoad.reset();
+
+            if (!chain || chain->levels.empty()) {
+                // keeps showing the placeholder, or the levels that are already resident
+                Logger::error("Streamed image {} failed to decode", id);
+                image.failed = true;
+                continue;
+            }
+
+            if (image.levels.empty()) {
+                image.levels = chain->levels;
+
+                uint32_t tail = static_cast<uint32_t>(image.levels.size()) - 1;
+                for (uint32_t level = 0; level < image.levels.size(); ++level) {
+                    const auto& lv = image.levels[level];
+                    if (std::max(lv.width, lv.height) <= MIP_TAIL_MAX_SIZE) {
+                        tail = level;
+                        break;
+                    }
+                }
+                image.tailLevel = tail;
+            }
+
+            image.loaded = std::move(chain);
+        }
+    }
+
+    uint32_t VulkanTextureStreamer::wantedLevel(const StreamedImage& image) const {
+        if (image.lastRequestedFrame != m_frame || image.requestedScreenSize <= 0.0f) {
+            return image.tailLevel;
+        }
+
+        const auto& base = image.levels.front();
+        const float baseSize = static_cast<float>(std::max(base.width, base.height));
+        const float level = std::log2(baseSize / image.requestedScreenSize) - m_mipBias;
+
+        auto clampLevel = [&](float value) {
+            if (value <= 0.0f) {
+                return 0u;
+            }
+            return std::min(static_cast<uint32_t>(value), image.tailLevel);
+        };
+
+        // a size hovering around a mip boundary must not flip the level every frame
+        const uint32_t finer = clampLevel(level + MIP_DEAD_BAND);
+        if (finer < image.residentLevel) {
+            return finer;
+        }
+        const uint32_t coarser = clampLevel(level - MIP_DEAD_BAND);
+        if (coarser > image.residentLevel) {
+            return coarser;
+        }
+        return image.residentLevel;
+    }
+
+    bool VulkanTextureStreamer::hasLoadedLevels(const StreamedImage& image, uint32_t level) {
+        // the levels below the resident one are uploaded, the rest are copied from the resident image
+        const size_t required =
+                image.residentLevel == NOT_RESIDENT ? image.levels.size() : image.residentLevel;
+        return level >= required || (image.loaded && image.loaded->levels.size() >= required);
+    }
+
+    size_t VulkanTextureStreamer::residentSize(const StreamedImage& image, uint32_t level) {
+        // levels are stored back to back, everything from level to the end is resident
+        const auto& last = image.levels.back();
+        return last.offset + last.size - image.levels[level].offset;
+    }
+
+    void VulkanTextureStreamer::update(VkCommandBuffer cmd, DeletionQueue& deletionQueue) {
+        MOE_ASSERT(m_initialized, "VulkanTextureStreamer not initialized");
+
+        m_stats.promotions = 0;
+        m_stats.demotions = 0;
+        m_stats.uploadedBytes = 0;
+
+        pollPendingLoads();
+
+        const size_t budget = std::min(m_vramBudget, m_budgetLimit);
+
+        struct Candidate {
+            ImageId id;
+            StreamedImage* image;
+            uint32_t wanted;
+        };
+
+        Vector<Candidate> promotions;
+        Vector<Candidate> evictable;
+        // changed within MIN_RESIDENT_FRAMES, only demoted when already over budget
+        Vector<Candidate> recent;
+
+        for (auto& [id, image]: m_images) {
+            if (image.levels.empty()) {
+                continue;
+            }
+
+            // the tail is mandatory and ignores both budgets
+            if (image.residentLevel == NOT_RESIDENT) {
+                if (hasLoadedLevels(image, image.tailLevel)) {
+                    setResidentLevel(id, image, image.tailLevel, cmd, deletionQueue);
+                }
+                continue;
+            }
+
+            uint32_t wanted = wantedLevel(image);
+            if (wanted < image.residentLevel) {
+                promotions.push_back({id, &image, wanted});
+                continue;
+            }
+
+            // nothing to promote, the decoded levels are not needed anymore
+            image.loaded.reset();
+            if (wanted > image.residentLevel) {
+                auto& list = m_frame - image.residentSinceFrame >= MIN_RESIDENT_FRAMES ? evictable : recent;
+                list.push_back({id, &image, wanted});
+            }
+        }
+
+        // least useful first: not seen for the longest time, then the most over-resident
+        auto leastUseful = [](const Candidate& a, const Candidate& b) {
+            if (a.image->lastRequestedFrame != b.image->lastRequestedFrame) {
+                return a.image->lastRequestedFrame < b.image->lastRequestedFrame;
+            }
+            return (a.wanted - a.image->residentLevel) > (b.wanted - b.image->residentLevel);
+        };
+        std::sort(evictable.begin(), evictable.end(), leastUseful);
+        std::sort(recent.begin(), recent.end(), leastUseful);
+        size_t nextVictim = 0;
+        size_t nextRecentVictim = 0;
+
+        auto evictUntil = [&](Vector<Candidate>& victims, size_t& next, size_t requiredBytes) {
+            while (m_residentBytes + requiredBytes > budget && next < victims.size()) {
+                auto& victim = victims[next++];
+                setResidentLevel(victim.id, *victim.image, victim.wanted, cmd, deletionQueue);
+                m_stats.demotions++;
+            }
+            return m_residentBytes + requiredBytes <= budget;
+        };
+
+        // over budget already (e.g. the budget was lowered, or other allocations took the headroom)
+        if (!evictUntil(evictable, nextVictim, 0)) {
+            evictUntil(recent, nextRecentVictim, 0);
+        }
+
+        // biggest quality gap first
+        std::sort(promotions.begin(), promotions.end(), [](const Candidate& a, const Candidate& b) {
+            return (a.image->residentLevel - a.wanted) > (b.image->residentLevel - b.wanted);
+        });
+
+        for (auto& candidate: promotions) {
+            auto& image = *candidate.image;
+            uint32_t level = candidate.wanted;
+
+            if (!hasLoadedLevels(image, level)) {
+                // decoded again from the source, promoted once it is ready
+                image.loaded.reset();
+                if (!image.pendingLoad && !image.failed) {
+                    image.pendingLoad.emplace(loadLevels(image.source, image.residentLevel));
+                }
+                continue;
+            }
+
+            // fall back to less detailed levels when the full request does not fit
+            while (level < image.residentLevel) {
+                size_t extra = residentSize(image, level) - residentSize(image, image.residentLevel);
+                if (m_stats.uploadedBytes + extra <= m_uploadBudgetPerFrame &&
+                    evictUntil(evictable, nextVictim, extra)) {
+                    break;
+                }
+                level++;
+            }
+
+            if (level < image.residentLevel) {
+                setResidentLevel(candidate.id, image, level, cmd, deletionQueue);
+                image.loaded.reset();
+                m_stats.promotions++;
+            }
+        }
+
+        m_stats.streamedImages = m_images.size();
+        m_stats.pendingDecodes = 0;
+        m_stats.fullResidencyBytes = 0;
+        for (auto& [id, image]: m_images) {
+            if (image.pendingLoad) {
+                m_stats.pendingDecodes++;
+            }
+            if (!image.levels.empty()) {
+                m_stats.fullResidencyBytes += residentSize(image, 0);
+            }
+        }
+        m_stats.residentBytes = m_residentBytes;
+        m_stats.budgetBytes = budget;
+
+        m_frame++;
+    }
+
+    void VulkanTextureStreamer::setResidentLevel(
+            ImageId id, StreamedImage& image, uint32_t level,
+            VkCommandBuffer cmd, DeletionQueue& deletionQueue) {
+        const uint32_t previous = image.residentLevel;
+        const uint32_t levelCount = static_cast<uint32_t>(image.levels.size());
+        const auto& base = image.levels[level];
+
+        // levels [level, uploadEnd) come from the decoded data, the rest from the previous image
+        const uint32_t uploadEnd = previous == NOT_RESIDENT ? levelCount : std::max(level, previous);
+        MOE_ASSERT(uploadEnd == level || (image.loaded && image.loaded->levels.size() >= uploadEnd), "Streamed levels are not loaded");
+
+        VkImageCreateInfo imageInfo = VkInit::imageCreateInfo(
+                image.format,
+                image.usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VkExtent3D{base.width, base.height, 1});
+        imageInfo.mipLevels = levelCount - level;
+        VulkanAllocatedImage newImage;
+        {
+            VulkanMemoryTracker::ScopedCategory memoryCategory(VulkanMemoryCategory::StreamedTexture);
+            newImage = m_engine->allocateImage(imageInfo);
+        }
+
+        VkUtils::transitionImage(
+                cmd, newImage.image,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        size_t uploadSize = 0;
+        for (uint32_t i = level; i < uploadEnd; ++i) {
+            uploadSize += image.levels[i].size;
+        }
+
+        Optional<VulkanAllocatedBuffer> stagingBuffer;
+        if (uploadSize > 0) {
+            stagingBuffer = m_engine->allocateBuffer(uploadSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+            auto* mapped = static_cast<uint8_t*>(stagingBuffer->vmaAllocationInfo.pMappedData);
+
+            Vector<VkBufferImageCopy> copyRegions;
+            copyRegions.reserve(uploadEnd - level);
+            size_t offset = 0;
+            for (uint32_t i = level; i < uploadEnd; ++i) {
+                const auto& mip = image.levels[i];
+                const auto data = image.loaded->levelData(i);
+                std::memcpy(mapped + offset, data.data(), data.size());
+
+                VkBufferImageCopy copyRegion{};
+                copyRegion.bufferOffset = offset;
+                copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                copyRegion.imageSubresource.mipLevel = i - level;
+                copyRegion.imageSubresource.baseArrayLayer = 0;
+                copyRegion.imageSubresource.layerCount = 1;
+                copyRegion.imageExtent = {mip.width, mip.height, 1};
+
+                copyRegions.push_back(copyRegion);
+                offset += mip.size;
+            }
+
+            vkCmdCopyBufferToImage(
+                    cmd,
+                    stagingBuffer->buffer,
+                    newImage.image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    static_cast<uint32_t>(copyRegions.size()),
+                    copyRegions.data());
+        }
+
+        Optional<VulkanAllocatedImage> oldImage;
+        if (previous != NOT_RESIDENT) {
+            oldImage = m_imageCache->getImage(id);
+            MOE_ASSERT(oldImage.has_value(), "Resident streamed image is missing from the image cache");
+        }
+
+        if (oldImage && uploadEnd < levelCount) {
+            // the levels both images share never leave the gpu
+            VkUtils::transitionImage(
+                    cmd, oldImage->image,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+            Vector<VkImageCopy> copyRegions;
+            copyRegions.reserve(levelCount - uploadEnd);
+            for (uint32_t i = uploadEnd; i < levelCount; ++i) {
+                const auto& mip = image.levels[i];
+
+                VkImageCopy copyRegion{};
+                copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                copyRegion.srcSubresource.mipLevel = i - previous;
+                copyRegion.srcSubresource.layerCount = 1;
+                copyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                copyRegion.dstSubresource.mipLevel = i - level;
+                copyRegion.dstSubresource.layerCount = 1;
+                copyRegion.extent = {mip.width, mip.height, 1};
+
+                copyRegions.push_back(copyRegion);
+            }
+
+            vkCmdCopyImage(
+                    cmd,
+                    oldImage->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    newImage.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    static_cast<uint32_t>(copyRegions.size()),
+                    copyRegions.data());
+
+            // this frame's bindless set still points at the old image
+            VkUtils::transitionImage(
+                    cmd, oldImage->image,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+
+        VkUtils::transitionImage(
+                cmd, newImage.image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        // ! note: the bindless write reaches each frame's set once that frame has retired,
+        // ! and this frame's deletion queue runs FRAMES_IN_FLIGHT frames later, after the last frame sampling the old image
+        m_imageCache->swapImage(id, std::move(newImage));
+
+        deletionQueue.pushFunction([engine = m_engine, oldImage, stagingBuffer]() mutable {
+            if (oldImage) {
+                engine->destroyImage(*oldImage);
+            }
+            if (stagingBuffer) {
+                engine->destroyBuffer(*stagingBuffer);
+            }
+        });
+
+        if (previous != NOT_RESIDENT) {
+            m_residentBytes -= residentSize(image, previous);
+        }
+        m_residentBytes += residentSize(image, level);
+        m_stats.uploadedBytes += uploadSize;
+
+        image.residentLevel = level;
+        image.residentSinceFrame = m_frame;
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,546 @@
+#include "Render/Vulkan/VulkanUploadManager.hpp"
+#include "Render/Vulkan/VulkanEngine.hpp"
+#include "Render/Vulkan/VulkanInitializers.hpp"
+
+namespace moe {
+    namespace Detail {
+        constexpr size_t alignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }// namespace Detail
+
+    void VulkanUploadManager::init(VulkanEngine& engine, bool useTransferQueue, size_t stagingRingSize) {
+        MOE_ASSERT(!m_initialized, "VulkanUploadManager already initialized");
+        MOE_ASSERT(stagingRingSize % STAGING_ALIGNMENT == 0, "Staging ring size must be aligned");
+
+        m_engine = &engine;
+
+        m_ownershipTransfer =
+                useTransferQueue &&
+                engine.m_transferQueue != VK_NULL_HANDLE &&
+                engine.m_transferQueueFamilyIndex != engine.m_graphicsQueueFamilyIndex;
+        m_queue = m_ownershipTransfer ? engine.m_transferQueue : engine.m_graphicsQueue;
+        m_queueFamilyIndex = m_ownershipTransfer ? engine.m_transferQueueFamilyIndex : engine.m_graphicsQueueFamilyIndex;
+
+        auto poolInfo = VkInit::commandPoolCreateInfo(m_queueFamilyIndex, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        MOE_VK_CHECK(vkCreateCommandPool(engine.m_device, &poolInfo, nullptr, &m_commandPool));
+
+        VkSemaphoreTypeCreateInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo = VkInit::semaphoreCreateInfo();
+        semaphoreInfo.pNext = &timelineInfo;
+        MOE_VK_CHECK(vkCreateSemaphore(engine.m_device, &semaphoreInfo, nullptr, &m_timeline));
+        m_timelineValue = 0;
+
+        m_ringSize = stagingRingSize;
+        m_ring = engine.allocateBuffer(m_ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        MOE_ASSERT(m_ring.vmaAllocationInfo.pMappedData != nullptr, "Failed to map staging ring");
+        m_ringHead = 0;
+        m_ringTail = 0;
+
+        m_recording = {};
+        m_stats = {};
+
+        Logger::info(
+                "Upload manager using {} queue, {} MiB staging ring",
+                m_ownershipTransfer ? "dedicated transfer" : "graphics",
+                m_ringSize / (1024 * 1024));
+
+        m_initialized = true;
+    }
+
+    void VulkanUploadManager::destroy() {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+
+        waitIdle();
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+
+        // ! note: acquires that were never recorded are dropped, the device is going away anyway
+        m_pendingAcquireBuffers.clear();
+        m_pendingAcquireImages.clear();
+
+        vkDestroyCommandPool(m_engine->m_device, m_commandPool, nullptr);
+        m_commandPool = VK_NULL_HANDLE;
+        m_freeCommandBuffers.clear();
+
+        vkDestroySemaphore(m_engine->m_device, m_timeline, nullptr);
+        m_timeline = VK_NULL_HANDLE;
+
+        m_engine->destroyBuffer(m_ring);
+        m_ring = {};
+
+        m_engine = nullptr;
+        m_initialized = false;
+    }
+
+    VulkanUploadManager::UploadFuture VulkanUploadManager::uploadBuffer(VkBuffer dst, size_t dstOffset, const void* data, size_t size) {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+        MOE_ASSERT(size > 0, "Upload size must be greater than 0");
+
+        auto promise = std::make_shared<Promise<void, ThreadPoolScheduler>>();
+        auto future = promise->getFuture();
+
+        Vector<UploadPromise> completed;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+
+            size_t srcOffset;
+            VkBuffer src = stageLocked(data, size, srcOffset, completed);
+
+            m_recording.bufferCopies.push_back({
+                    src,
+                    dst,
+                    VkBufferCopy{srcOffset, dstOffset, size},
+            });
+            m_recording.promises.push_back(std::move(promise));
+            m_stats.uploadedBytes += size;
+        }
+
+        for (auto& completedPromise: completed) {
+            completedPromise->setValue();
+        }
+
+        return future;
+    }
+
+    VulkanUploadManager::UploadFuture VulkanUploadManager::uploadImage(
+            VkImage image, uint32_t mipLevels, uint32_t layerCount,
+            const void* data, size_t size,
+            Span<const ImageRegion> regions) {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+        MOE_ASSERT(size > 0, "Upload size must be greater than 0");
+        MOE_ASSERT(!regions.empty(), "Image upload has no regions");
+
+        auto promise = std::make_shared<Promise<void, ThreadPoolScheduler>>();
+        auto future = promise->getFuture();
+
+        Vector<UploadPromise> completed;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+
+            size_t srcOffset;
+            VkBuffer src = stageLocked(data, size, srcOffset, completed);
+
+            ImageCopy copy{src, image, mipLevels, layerCount, {}};
+            copy.regions.reserve(regions.size());
+            for (auto& region: regions) {
+                VkBufferImageCopy copyRegion{};
+                copyRegion.bufferOffset = srcOffset + region.dataOffset;
+                copyRegion.bufferRowLength = 0;
+                copyRegion.bufferImageHeight = 0;
+
+                copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                copyRegion.imageSubresource.mipLevel = region.mipLevel;
+                copyRegion.imageSubresource.baseArrayLayer = region.arrayLayer;
+                copyRegion.imageSubresource.layerCount = 1;
+                copyRegion.imageExtent = region.extent;
+
+                copy.regions.push_back(copyRegion);
+            }
+
+            m_recording.imageCopies.push_back(std::move(copy));
+            m_recording.promises.push_back(std::move(promise));
+            m_stats.uploadedBytes += size;
+        }
+
+        for (auto& completedPromise: completed) {
+            completedPromise->setValue();
+        }
+
+        return future;
+    }
+
+    VulkanUploadManager::UploadFuture VulkanUploadManager::uploadImage(VkImage image, const ImageKernels::MipChain& mipChain) {
+        MOE_ASSERT(!mipChain.levels.empty(), "Mip chain has no levels");
+
+        Vector<ImageRegion> regions;
+        regions.reserve(mipChain.levels.size());
+        for (size_t level = 0; level < mipChain.levels.size(); ++level) {
+            const auto& mip = mipChain.levels[level];
+            regions.push_back({
+                    mip.offset,
+                    static_cast<uint32_t>(level),
+                    0,
+                    {mip.width, mip.height, 1},
+            });
+        }
+
+        return uploadImage(
+                image, static_cast<uint32_t>(mipChain.levels.size()), 1,
+                mipChain.data.data(), mipChain.data.size(),
+                regions);
+    }
+
+    VulkanUploadManager::UploadFuture VulkanUploadManager::fence() {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+
+        auto promise = std::make_shared<Promise<void, ThreadPoolScheduler>>();
+        auto future = promise->getFuture();
+
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            // batches retire in submission order, so the newest one covers everything before it
+            if (!m_recording.empty()) {
+                m_recording.promises.push_back(std::move(promise));
+            } else if (!m_inFlight.empty()) {
+                m_inFlight.back().promises.push_back(std::move(promise));
+            }
+        }
+
+        if (promise) {
+            promise->setValue();
+        }
+
+        return future;
+    }
+
+    void VulkanUploadManager::flush() {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+
+        Vector<UploadPromise> completed;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            submitLocked();
+            pollLocked(completed);
+        }
+
+        for (auto& promise: completed) {
+            promise->setValue();
+        }
+    }
+
+    void VulkanUploadManager::waitIdle() {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+
+        Vector<UploadPromise> completed;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            submitLocked();
+            if (!m_inFlight.empty()) {
+                waitForBatchLocked(m_inFlight.back());
+            }
+            pollLocked(completed);
+        }
+
+        for (auto& promise: completed) {
+            promise->setValue();
+        }
+    }
+
+    void VulkanUploadManager::update(VkCommandBuffer cmd) {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+
+        Vector<UploadPromise> completed;
+        Vector<VkBufferMemoryBarrier2> acquireBuffers;
+        Vector<VkImageMemoryBarrier2> acquireImages;
+        bool submitted;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            submitLocked();
+            pollLocked(completed);
+
+            acquireBuffers.swap(m_pendingAcquireBuffers);
+            acquireImages.swap(m_pendingAcquireImages);
+
+            // the acquires below must not run before the release halves on the transfer queue
+            const bool acquired = !acquireBuffers.empty() || !acquireImages.empty();
+            m_frameWaitValue = m_ownershipTransfer && acquired ? m_timelineValue : 0;
+
+            submitted = m_submittedSinceUpdate;
+            m_submittedSinceUpdate = false;
+        }
+
+        if (m_ownershipTransfer) {
+            // the frame submission waits on the timeline for the release half, see getFrameWait()
+            if (!acquireBuffers.empty() || !acquireImages.empty()) {
+                VkDependencyInfo dependency{};
+                dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+                dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(acquireBuffers.size());
+                dependency.pBufferMemoryBarriers = acquireBuffers.data();
+                dependency.imageMemoryBarrierCount = static_cast<uint32_t>(acquireImages.size());
+                dependency.pImageMemoryBarriers = acquireImages.data();
+
+                vkCmdPipelineBarrier2(cmd, &dependency);
+            }
+        } else if (submitted) {
+            // batches were submitted earlier on the same queue, a global barrier makes their writes visible
+            VkMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+
+            VkDependencyInfo dependency{};
+            dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependency.memoryBarrierCount = 1;
+            dependency.pMemoryBarriers = &barrier;
+
+            vkCmdPipelineBarrier2(cmd, &dependency);
+        }
+
+        for (auto& promise: completed) {
+            promise->setValue();
+        }
+    }
+
+    Optional<VkSemaphoreSubmitInfo> VulkanUploadManager::getFrameWait() const {
+        MOE_ASSERT(m_initialized, "VulkanUploadManager not initialized");
+
+        // only written by update(), on the same thread as the frame submission
+        if (m_frameWaitValue == 0) {
+            return {std::nullopt};
+        }
+
+        auto waitInfo = VkInit::semaphoreSubmitInfo(m_timeline, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        waitInfo.value = m_frameWaitValue;
+        return waitInfo;
+    }
+
+    VulkanUploadManager::Stats VulkanUploadManager::getStats() const {
+        std::lock_guard<std::mutex> lk(m_mutex);
+
+        Stats stats = m_stats;
+        stats.ringSize = m_ringSize;
+        stats.ringUsedBytes = static_cast<size_t>(m_ringHead - m_ringTail);
+        stats.batchesInFlight = m_inFlight.size();
+        return stats;
+    }
+
+    VkBuffer VulkanUploadManager::stageLocked(const void* data, size_t size, size_t& outOffset, Vector<UploadPromise>& completed) {
+        if (auto offset = allocateRingLocked(size, completed)) {
+            // ! note: the copy happens under the lock, concurrent producers serialize here
+            std::memcpy(static_cast<uint8_t*>(m_ring.vmaAllocationInfo.pMappedData) + *offset, data, size);
+            outOffset = *offset;
+            return m_ring.buffer;
+        }
+
+        Logger::debug("Upload of {} bytes exceeds the staging ring, using a dedicated staging buffer", size);
+        auto staging = m_engine->allocateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        std::memcpy(staging.vmaAllocationInfo.pMappedData, data, size);
+        m_recording.dedicatedStaging.push_back(staging);
+
+        outOffset = 0;
+        return staging.buffer;
+    }
+
+    Optional<size_t> VulkanUploadManager::allocateRingLocked(size_t size, Vector<UploadPromise>& completed) {
+        const size_t alignedSize = Detail::alignUp(size, STAGING_ALIGNMENT);
+        if (alignedSize > m_ringSize) {
+            return {std::nullopt};
+        }
+
+        while (true) {
+            // allocations never wrap around the end of the ring, the remainder is skipped instead
+            size_t offset = static_cast<size_t>(m_ringHead % m_ringSize);
+            size_t padding = offset + alignedSize > m_ringSize ? m_ringSize - offset : 0;
+
+            if (m_ringHead + padding + alignedSize - m_ringTail <= m_ringSize) {
+                m_ringHead += padding;
+                size_t result = static_cast<size_t>(m_ringHead % m_ringSize);
+                m_ringHead += alignedSize;
+                m_recording.ringEnd = m_ringHead;
+                return result;
+            }
+
+            // ring is full: push out what has been recorded, then wait for the oldest batch
+            submitLocked();
+            MOE_ASSERT(!m_inFlight.empty(), "Staging ring exhausted with nothing in flight");
+            waitForBatchLocked(m_inFlight.front());
+            pollLocked(completed);
+        }
+    }
+
+    void VulkanUploadManager::submitLocked() {
+        if (m_recording.empty()) {
+            return;
+        }
+
+        auto& batch = m_recording;
+        auto device = m_engine->m_device;
+
+        if (m_freeCommandBuffers.empty()) {
+            VkCommandBuffer commandBuffer;
+            auto allocInfo = VkInit::commandBufferAllocateInfo(m_commandPool);
+            MOE_VK_CHECK(vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer));
+            m_freeCommandBuffers.push_back(commandBuffer);
+        }
+        batch.commandBuffer = m_freeCommandBuffers.back();
+        m_freeCommandBuffers.pop_back();
+
+        auto cmd = batch.commandBuffer;
+        MOE_VK_CHECK(vkResetCommandBuffer(cmd, 0));
+        auto beginInfo = VkInit::commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        MOE_VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+        auto imageBarrier = [](const ImageCopy& copy, VkImageLayout oldLayout, VkImageLayout newLayout) {
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = copy.dst;
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, copy.mipLevels, 0, copy.layerCount};
+            return barrier;
+        };
+
+        // ! undefined -> transfer dst, all images at once
+        if (!batch.imageCopies.empty()) {
+            Vector<VkImageMemoryBarrier2> barriers;
+            barriers.reserve(batch.imageCopies.size());
+            for (auto& copy: batch.imageCopies) {
+                auto barrier = imageBarrier(copy, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+                barrier.srcAccessMask = VK_ACCESS_2_NONE;
+                barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+                barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+                barriers.push_back(barrier);
+            }
+
+            VkDependencyInfo dependency{};
+            dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependency.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+            dependency.pImageMemoryBarriers = barriers.data();
+            vkCmdPipelineBarrier2(cmd, &dependency);
+        }
+
+        // ! copies
+        for (auto& copy: batch.bufferCopies) {
+            vkCmdCopyBuffer(cmd, copy.src, copy.dst, 1, &copy.region);
+        }
+        for (auto& copy: batch.imageCopies) {
+            vkCmdCopyBufferToImage(
+                    cmd,
+                    copy.src,
+                    copy.dst,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    static_cast<uint32_t>(copy.regions.size()),
+                    copy.regions.data());
+        }
+
+        // ! transfer dst -> shader read only; on a dedicated queue this is the release half of the ownership transfer
+        {
+            const uint32_t graphicsFamily = m_engine->m_graphicsQueueFamilyIndex;
+
+            Vector<VkBufferMemoryBarrier2> bufferBarriers;
+            Vector<VkImageMemoryBarrier2> imageBarriers;
+            imageBarriers.reserve(batch.imageCopies.size());
+
+            if (m_ownershipTransfer) {
+                bufferBarriers.reserve(batch.bufferCopies.size());
+                for (auto& copy: batch.bufferCopies) {
+                    VkBufferMemoryBarrier2 barrier{};
+                    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+                    barrier.srcQueueFamilyIndex = m_queueFamilyIndex;
+                    barrier.dstQueueFamilyIndex = graphicsFamily;
+                    barrier.buffer = copy.dst;
+                    barrier.offset = copy.region.dstOffset;
+                    barrier.size = copy.region.size;
+
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+                    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+                    bufferBarriers.push_back(barrier);
+
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+                    barrier.srcAccessMask = VK_ACCESS_2_NONE;
+                    barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                    barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+                    m_pendingAcquireBuffers.push_back(barrier);
+                }
+            }
+
+            for (auto& copy: batch.imageCopies) {
+                auto barrier = imageBarrier(copy, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+                barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+                if (m_ownershipTransfer) {
+                    barrier.srcQueueFamilyIndex = m_queueFamilyIndex;
+                    barrier.dstQueueFamilyIndex = graphicsFamily;
+                    imageBarriers.push_back(barrier);
+
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+                    barrier.srcAccessMask = VK_ACCESS_2_NONE;
+                    barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                    barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+                    m_pendingAcquireImages.push_back(barrier);
+                } else {
+                    barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                    barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+                    imageBarriers.push_back(barrier);
+                }
+            }
+
+            if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+                VkDependencyInfo dependency{};
+                dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+                dependency.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+                dependency.pBufferMemoryBarriers = bufferBarriers.data();
+                dependency.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+                dependency.pImageMemoryBarriers = imageBarriers.data();
+                vkCmdPipelineBarrier2(cmd, &dependency);
+            }
+        }
+
+        MOE_VK_CHECK(vkEndCommandBuffer(cmd));
+
+        batch.timelineValue = ++m_timelineValue;
+
+        auto commandSubmitInfo = VkInit::commandBufferSubmitInfo(cmd);
+        auto signalInfo = VkInit::semaphoreSubmitInfo(m_timeline, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        signalInfo.value = batch.timelineValue;
+        auto submitInfo = VkInit::submitInfo(&commandSubmitInfo, nullptr, &signalInfo);
+
+        if (m_ownershipTransfer) {
+            MOE_VK_CHECK(vkQueueSubmit2(m_queue, 1, &submitInfo, VK_NULL_HANDLE));
+        } else {
+            // shared with the frame and immediate submissions
+            std::lock_guard<std::mutex> queueLock(m_engine->m_graphicsQueueMutex);
+            MOE_VK_CHECK(vkQueueSubmit2(m_queue, 1, &submitInfo, VK_NULL_HANDLE));
+        }
+
+        m_stats.submittedBatches++;
+        m_submittedSinceUpdate = true;
+
+        m_inFlight.push_back(std::move(m_recording));
+        m_recording = {};
+        m_recording.ringEnd = m_ringHead;
+    }
+
+    void VulkanUploadManager::pollLocked(Vector<UploadPromise>& completed) {
+        uint64_t completedValue = 0;
+        MOE_VK_CHECK(vkGetSemaphoreCounterValue(m_engine->m_device, m_timeline, &completedValue));
+
+        while (!m_inFlight.empty() && m_inFlight.front().timelineValue <= completedValue) {
+            auto& batch = m_inFlight.front();
+
+            m_ringTail = std::max(m_ringTail, batch.ringEnd);
+
+            for (auto& staging: batch.dedicatedStaging) {
+                m_engine->destroyBuffer(staging);
+            }
+            m_freeCommandBuffers.push_back(batch.commandBuffer);
+
+            for (auto& promise: batch.promises) {
+                completed.push_back(std::move(promise));
+            }
+
+            m_inFlight.pop_front();
+        }
+    }
+
+    void VulkanUploadManager::waitForBatchLocked(const Batch& batch) {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_timeline;
+        waitInfo.pValues = &batch.timelineValue;
+
+        MOE_VK_CHECK(vkWaitSemaphores(m_engine->m_device, &waitInfo, UINT64_MAX));
+    }
+}// namespace moe
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "Render/Vulkan/VulkanVertexKernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MOE_VERTEX_KERNELS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MOE_VERTEX_KERNELS_NEON
+#endif
+
+namespace moe {
+    namespace VertexKernels {
+        namespace Detail {
+            static_assert(sizeof(Vertex) == 48, "interleaveVertices assumes the 3 x vec4 Vertex layout");
+            static_assert(offsetof(Vertex, uv_x) == 12 && offsetof(Vertex, normal) == 16, "Unexpected Vertex layout");
+            static_assert(offsetof(Vertex, uv_y) == 28 && offsetof(Vertex, tangent) == 32, "Unexpected Vertex layout");
+
+            inline const float* element(const Stream& stream, size_t i) {
+                return reinterpret_cast<const float*>(stream.data + i * stream.stride);
+            }
+
+            inline void loadFloats(float* dst, const Stream& stream, size_t i, size_t components) {
+                if (stream.empty()) {
+                    std::memset(dst, 0, components * sizeof(float));
+                    return;
+                }
+                std::memcpy(dst, element(stream, i), components * sizeof(float));
+            }
+
+            // a vec3 can be read as a full vec4 when 4 more bytes follow it inside the stream
+            inline size_t overreadSafeCount(const Stream& stream, size_t count) {
+                if (stream.empty() || count == 0) {
+                    return count;
+                }
+                return stream.stride >= 4 * sizeof(float) ? count : count - 1;
+            }
+        }// namespace Detail
+
+        namespace Scalar {
+            void interleaveVertices(Vertex* dst, const VertexStreams& streams, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    float uv[2];
+                    Detail::loadFloats(uv, streams.uvs, i, 2);
+
+                    float lanes[12];
+                    Detail::loadFloats(lanes + 0, streams.positions, i, 3);
+                    lanes[3] = uv[0];
+                    Detail::loadFloats(lanes + 4, streams.normals, i, 3);
+                    lanes[7] = uv[1];
+                    Detail::loadFloats(lanes + 8, streams.tangents, i, 4);
+
+                    std::memcpy(dst + i, lanes, sizeof(lanes));
+                }
+            }
+
+            void widenIndices(const uint16_t* src, uint32_t* dst, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = src[i];
+                }
+            }
+
+            void widenIndices(const uint8_t* src, uint32_t* dst, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = src[i];
+                }
+            }
+        }// namespace Scalar
+
+        StringView backendName() {
+#if defined(MOE_VERTEX_KERNELS_SSE2)
+            return "sse2";
+#elif defined(MOE_VERTEX_KERNELS_NEON)
+            return "neon";
+#else
+            return "scalar";
+#endif
+        }
+
+#if defined(MOE_VERTEX_KERNELS_SSE2)
+        namespace Detail {
+            inline __m128 loadVec3(const Stream& stream, size_t i, bool overread) {
+                if (stream.empty()) {
+                    return _mm_setzero_ps();
+                }
+                const float* src = element(stream, i);
+                return overread ? _mm_loadu_ps(src) : _mm_set_ps(0.0f, src[2], src[1], src[0]);
+            }
+        }// namespace Detail
+
+        void interleaveVertices(Vertex* dst, const VertexStreams& streams, size_t count) {
+            // lanes xyz come from the attribute, lane w from the uv
+            const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+            const size_t safe = std::min(
+                    Detail::overreadSafeCount(streams.positions, count),
+                    Detail::overreadSafeCount(streams.normals, count));
+
+            auto* out = reinterpret_cast<float*>(dst);
+            for (size_t i = 0; i < count; ++i, out += 12) {
+                const bool overread = i < safe;
+
+                __m128 uv = streams.uvs.empty()
+                                    ? _mm_setzero_ps()
+                                    : _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(Detail::element(streams.uvs, i))));
+                __m128 u = _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(0, 0, 0, 0));
+                __m128 v = _mm_shuffle_ps(uv, uv, _MM_SHUFFLE(1, 1, 1, 1));
+
+                __m128 position = Detail::loadVec3(streams.positions, i, overread);
+                __m128 normal = Detail::loadVec3(streams.normals, i, overread);
+                __m128 tangent = streams.tangents.empty()
+                                         ? _mm_setzero_ps()
+                                         : _mm_loadu_ps(Detail::element(streams.tangents, i));
+
+                _mm_storeu_ps(out + 0, _mm_or_ps(_mm_and_ps(xyzMask, position), _mm_andnot_ps(xyzMask, u)));
+                _mm_storeu_ps(out + 4, _mm_or_ps(_mm_and_ps(xyzMask, normal), _mm_andnot_ps(xyzMask, v)));
+                _mm_storeu_ps(out + 8, tangent);
+            }
+        }
+
+        void widenIndices(const uint16_t* src, uint32_t* dst, size_t count) {
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(s, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(s, zero));
+            }
+            Scalar::widenIndices(src + i, dst + i, count - i);
+        }
+
+        void widenIndices(const uint8_t* src, uint32_t* dst, size_t count) {
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i lo = _mm_unpacklo_epi8(s, zero);
+                __m128i hi = _mm_unpackhi_epi8(s, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+            }
+            Scalar::widenIndices(src + i, dst + i, count - i);
+        }
+#elif defined(MOE_VERTEX_KERNELS_NEON)
+        namespace Detail {
+            inline float32x4_t loadVec3(const Stream& stream, size_t i, bool overread) {
+                if (stream.empty()) {
+                    return vdupq_n_f32(0.0f);
+                }
+                const float* src = element(stream, i);
+                if (overread) {
+                    return vld1q_f32(src);
+                }
+                float lanes[4]{src[0], src[1], src[2], 0.0f};
+                return vld1q_f32(lanes);
+            }
+        }// namespace Detail
+
+        void interleaveVertices(Vertex* dst, const VertexStreams& streams, size_t count) {
+            const size_t safe = std::min(
+                    Detail::overreadSafeCount(streams.positions, count),
+                    Detail::overreadSafeCount(streams.normals, count));
+
+            auto* out = reinterpret_cast<float*>(dst);
+            for (size_t i = 0; i < count; ++i, out += 12) {
+                const bool overread = i < safe;
+
+                float32x2_t uv = streams.uvs.empty()
+                                         ? vdup_n_f32(0.0f)
+                                         : vld1_f32(Detail::element(streams.uvs, i));
+
+                float32x4_t position = vcopyq_lane_f32(Detail::loadVec3(streams.positions, i, overread), 3, uv, 0);
+                float32x4_t normal = vcopyq_lane_f32(Detail::loadVec3(streams.normals, i, overread), 3, uv, 1);
+                float32x4_t tangent = streams.tangents.empty()
+                                              ? vdupq_n_f32(0.0f)
+                                              : vld1q_f32(Detail::element(streams.tangents, i));
+
+                vst1q_f32(out + 0, position);
+                vst1q_f32(out + 4, normal);
+                vst1q_f32(out + 8, tangent);
+            }
+        }
+
+        void widenIndices(const uint16_t* src, uint32_t* dst, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                uint16x8_t s = vld1q_u16(src + i);
+                vst1q_u32(dst + i, vmovl_u16(vget_low_u16(s)));
+                vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(s)));
+            }
+            Scalar::widenIndices(src + i, dst + i, count - i);
+        }
+
+        void widenIndices(const uint8_t* src, uint32_t* dst, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                uint16x8_t s = vmovl_u8(vld1_u8(src + i));
+                vst1q_u32(dst + i, vmovl_u16(vget_low_u16(s)));
+                vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(s)));
+            }
+            Scalar::widenIndices(src + i, dst + i, count - i);
+        }
+#else
+        void interleaveVertices(Vertex* dst, const VertexStreams& streams, size_t count) {
+            Scalar::interleaveVertices(dst, streams, count);
+        }
+
+        void widenIndices(const uint16_t* src, uint32_t* dst, size_t count) {
+            Scalar::widenIndices(src, dst, count);
+        }
+
+        void widenIndices(const uint8_t* src, uint32_t* dst, size_t count) {
+            Scalar::widenIndices(src, dst, count);
+        }
+#endif
+    }// namespace VertexKernels
+}// namespace moe
\ No newline at end of file
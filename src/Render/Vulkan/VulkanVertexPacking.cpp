@@ -0,0 +1,200 @@
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
+
+#include "Core/Task/Utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace moe {
+    namespace VertexPacking {
+        namespace Detail {
+            constexpr float UNORM16_MAX = 65535.0f;
+            constexpr uint32_t TANGENT_SIGN_BIT = 1u << 31;
+
+            // vertices per task when packing large buffers
+            constexpr size_t PACK_BATCH_SIZE = 4096;
+
+            bool isFinite(const glm::vec3& v) {
+                return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+            }
+
+            uint32_t quantizeUnorm16(float value, float offset, float scale) {
+                if (scale <= 0.0f) {
+                    return 0;
+                }
+                const float q = std::round((value - offset) / scale);
+                return static_cast<uint32_t>(std::clamp(q, 0.0f, UNORM16_MAX));
+            }
+
+            glm::vec2 signNotZero(const glm::vec2& v) {
+                return {v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f};
+            }
+        }// namespace Detail
+
+        glm::vec2 octEncode(const glm::vec3& n) {
+            const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            if (l1 <= 0.0f) {
+                return glm::vec2(0.0f);// decodes to +z
+            }
+
+            glm::vec2 p = glm::vec2(n.x, n.y) / l1;
+            if (n.z < 0.0f) {
+                p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * Detail::signNotZero(p);
+            }
+            return p;
+        }
+
+        glm::vec3 octDecode(const glm::vec2& p) {
+            glm::vec3 n(p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y));
+            const float t = std::max(-n.z, 0.0f);
+            n.x += n.x >= 0.0f ? -t : t;
+            n.y += n.y >= 0.0f ? -t : t;
+            return glm::normalize(n);
+        }
+
+        bool canPack(Span<const Vertex> vertices, Span<const SkinningData> skinningData) {
+            for (const auto& vertex: vertices) {
+                if (!Detail::isFinite(vertex.pos) || !Detail::isFinite(vertex.normal) ||
+                    !Detail::isFinite(glm::vec3(vertex.tangent)) ||
+                    !(std::abs(vertex.uv_x) <= MAX_PACKED_UV) || !(std::abs(vertex.uv_y) <= MAX_PACKED_UV)) {
+                    return false;
+                }
+            }
+            for (const auto& skin: skinningData) {
+                for (glm::length_t i = 0; i < 4; ++i) {
+                    if (skin.jointIds[i] >= MAX_PACKED_JOINTS || !std::isfinite(skin.weights[i])) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        PackedVertexHeader makeHeader(Span<const Vertex> vertices) {
+            PackedVertexHeader header{};
+            header.vertexCount = static_cast<uint32_t>(vertices.size());
+            if (vertices.empty()) {
+                return header;
+            }
+
+            glm::vec3 min = vertices[0].pos;
+            glm::vec3 max = vertices[0].pos;
+            for (const auto& vertex: vertices) {
+                min = glm::min(min, vertex.pos);
+                max = glm::max(max, vertex.pos);
+            }
+
+            header.positionOffset = min;
+            // a flat axis keeps a zero scale, every vertex then quantizes to 0 and decodes to the offset
+            header.positionScale = (max - min) / Detail::UNORM16_MAX;
+            return header;
+        }
+
+        PackedVertex packVertex(const Vertex& vertex, const PackedVertexHeader& header) {
+            PackedVertex packed{};
+
+            const uint32_t x = Detail::quantizeUnorm16(vertex.pos.x, header.positionOffset.x, header.positionScale.x);
+            const uint32_t y = Detail::quantizeUnorm16(vertex.pos.y, header.positionOffset.y, header.positionScale.y);
+            const uint32_t z = Detail::quantizeUnorm16(vertex.pos.z, header.positionOffset.z, header.positionScale.z);
+            packed.positionXY = x | (y << 16);
+            packed.positionZ = z | (vertex.tangent.w < 0.0f ? Detail::TANGENT_SIGN_BIT : 0u);
+
+            packed.normal = glm::packSnorm2x16(octEncode(vertex.normal));
+            packed.tangent = glm::packSnorm2x16(octEncode(glm::vec3(vertex.tangent)));
+            packed.uv = glm::packHalf2x16(glm::vec2(vertex.uv_x, vertex.uv_y));
+
+            return packed;
+        }
+
+        Vertex unpackVertex(const PackedVertex& vertex, const PackedVertexHeader& header) {
+            Vertex unpacked{};
+
+            const glm::vec3 q(
+                    static_cast<float>(vertex.positionXY & 0xffffu),
+                    static_cast<float>(vertex.positionXY >> 16),
+                    static_cast<float>(vertex.positionZ & 0xffffu));
+            unpacked.pos = header.positionOffset + q * header.positionScale;
+
+            unpacked.normal = octDecode(glm::unpackSnorm2x16(vertex.normal));
+            unpacked.tangent = glm::vec4(
+                    octDecode(glm::unpackSnorm2x16(vertex.tangent)),
+                    (vertex.positionZ & Detail::TANGENT_SIGN_BIT) ? -1.0f : 1.0f);
+
+            const glm::vec2 uv = glm::unpackHalf2x16(vertex.uv);
+            unpacked.uv_x = uv.x;
+            unpacked.uv_y = uv.y;
+
+            return unpacked;
+        }
+
+        PackedSkinningData packSkinningData(const SkinningData& skinningData) {
+            PackedSkinningData packed{};
+
+            float sum = 0.0f;
+            for (glm::length_t i = 0; i < 4; ++i) {
+                packed.jointIds |= (static_cast<uint32_t>(skinningData.jointIds[i]) & 0xffu) << (i * 8);
+                sum += std::max(skinningData.weights[i], 0.0f);
+            }
+
+            uint32_t weights[4]{};
+            if (sum > 0.0f) {
+                int32_t remainder = static_cast<int32_t>(Detail::UNORM16_MAX);
+                glm::length_t largest = 0;
+                for (glm::length_t i = 0; i < 4; ++i) {
+                    const float w = std::max(skinningData.weights[i], 0.0f) / sum;
+                    weights[i] = static_cast<uint32_t>(std::round(w * Detail::UNORM16_MAX));
+                    remainder -= static_cast<int32_t>(weights[i]);
+                    if (skinningData.weights[i] > skinningData.weights[largest]) {
+                        largest = i;
+                    }
+                }
+                // rounding error goes to the dominant joint, the weights then sum to exactly one on the gpu
+                weights[largest] = static_cast<uint32_t>(static_cast<int32_t>(weights[largest]) + remainder);
+            }
+
+            packed.weights[0] = weights[0] | (weights[1] << 16);
+            packed.weights[1] = weights[2] | (weights[3] << 16);
+            return packed;
+        }
+
+        SkinningData unpackSkinningData(const PackedSkinningData& skinningData) {
+            SkinningData unpacked{};
+            for (glm::length_t i = 0; i < 4; ++i) {
+                unpacked.jointIds[i] = static_cast<JointId>((skinningData.jointIds >> (i * 8)) & 0xffu);
+
+                const uint32_t word = skinningData.weights[i / 2];
+                const uint32_t weight = (i % 2 == 0) ? (word & 0xffffu) : (word >> 16);
+                unpacked.weights[i] = static_cast<float>(weight) / Detail::UNORM16_MAX;
+            }
+            return unpacked;
+        }
+
+        Vector<uint8_t> packVertexBuffer(Span<const Vertex> vertices) {
+            const auto header = makeHeader(vertices);
+
+            Vector<uint8_t> buffer(sizeof(PackedVertexHeader) + vertices.size() * sizeof(PackedVertex));
+            std::memcpy(buffer.data(), &header, sizeof(PackedVertexHeader));
+
+            auto* packed = reinterpret_cast<PackedVertex*>(buffer.data() + sizeof(PackedVertexHeader));
+            const size_t batchCount = (vertices.size() + Detail::PACK_BATCH_SIZE - 1) / Detail::PACK_BATCH_SIZE;
+            parallelForInline(batchCount, [&](size_t batch) {
+                const size_t begin = batch * Detail::PACK_BATCH_SIZE;
+                const size_t end = std::min(begin + Detail::PACK_BATCH_SIZE, vertices.size());
+                for (size_t i = begin; i < end; ++i) {
+                    packed[i] = packVertex(vertices[i], header);
+                }
+            });
+
+            return buffer;
+        }
+
+        Vector<PackedSkinningData> packSkinningBuffer(Span<const SkinningData> skinningData) {
+            Vector<PackedSkinningData> packed(skinningData.size());
+            for (size_t i = 0; i < skinningData.size(); ++i) {
+                packed[i] = packSkinningData(skinningData[i]);
+            }
+            return packed;
+        }
+    }// namespace VertexPacking
+}// namespace moe
\ No newline at end of file
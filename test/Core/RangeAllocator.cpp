@@ -0,0 +1,229 @@
+#include "Core/RangeAllocator.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    constexpr uint64_t INVALID = RangeAllocator::INVALID_OFFSET;
+
+    // the maximal free runs of a bitmap of used units, by offset
+    Vector<Pair<uint64_t, uint64_t>> freeRuns(const Vector<uint8_t>& used) {
+        Vector<Pair<uint64_t, uint64_t>> runs;
+        for (uint64_t i = 0; i < used.size();) {
+            if (used[i]) {
+                ++i;
+                continue;
+            }
+            const uint64_t begin = i;
+            while (i < used.size() && !used[i]) {
+                ++i;
+            }
+            runs.emplace_back(begin, i - begin);
+        }
+        return runs;
+    }
+
+    // the range allocate() has to pick: the smallest run that fits, the lowest of equal ones
+    uint64_t expectedBestFit(const Vector<Pair<uint64_t, uint64_t>>& runs, uint64_t size) {
+        uint64_t offset = INVALID;
+        uint64_t best = 0;
+        for (const auto& [begin, length]: runs) {
+            if (length >= size && (offset == INVALID || length < best)) {
+                offset = begin;
+                best = length;
+            }
+        }
+        return offset;
+    }
+
+    // the range allocateBelow() has to pick: the lowest run that fits and ends at or before the limit
+    uint64_t expectedLowestFit(const Vector<Pair<uint64_t, uint64_t>>& runs, uint64_t size, uint64_t limit) {
+        for (const auto& [begin, length]: runs) {
+            if (begin + size > limit) {
+                break;
+            }
+            if (length >= size) {
+                return begin;
+            }
+        }
+        return INVALID;
+    }
+
+    // free ranges are fully coalesced, so they are exactly the free runs of the bitmap
+    void checkMatches(const RangeAllocator& allocator, const Vector<uint8_t>& used) {
+        const auto runs = freeRuns(used);
+        uint64_t usedCount = 0;
+        for (auto unit: used) {
+            usedCount += unit;
+        }
+        uint64_t largest = 0;
+        for (const auto& run: runs) {
+            largest = std::max(largest, run.second);
+        }
+
+        CHECK(allocator.getUsed() == usedCount);
+        CHECK(allocator.getFree() == used.size() - usedCount);
+        CHECK(allocator.getFreeRangeCount() == runs.size());
+        CHECK(allocator.getLargestFreeRange() == largest);
+        CHECK(allocator.isEmpty() == (usedCount == 0));
+    }
+
+    void mark(Vector<uint8_t>& used, uint64_t offset, uint64_t size, uint8_t value) {
+        for (uint64_t i = offset; i < offset + size; ++i) {
+            REQUIRE(used[i] != value);
+            used[i] = value;
+        }
+    }
+}// namespace
+
+TEST_CASE("range allocator matches a bitmap under random traffic", "[rangeallocator]") {
+    constexpr uint64_t CAPACITY = 4096;
+    constexpr size_t STEPS = 20000;
+
+    RangeAllocator allocator(CAPACITY);
+    Vector<uint8_t> used(CAPACITY, 0);
+    // (offset, size) of the live allocations
+    Vector<Pair<uint64_t, uint64_t>> live;
+
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<uint64_t> smallSize(1, 16);
+    std::uniform_int_distribution<uint64_t> largeSize(17, 512);
+    std::uniform_int_distribution<int> action(0, 99);
+
+    for (size_t step = 0; step < STEPS; ++step) {
+        const int roll = action(rng);
+        const uint64_t size = roll % 8 == 0 ? largeSize(rng) : smallSize(rng);
+        const auto runs = freeRuns(used);
+
+        if (roll < 45) {
+            const uint64_t offset = allocator.allocate(size);
+            REQUIRE(offset == expectedBestFit(runs, size));
+            if (offset != INVALID) {
+                mark(used, offset, size, 1);
+                live.emplace_back(offset, size);
+            }
+        } else if (roll < 55) {
+            const uint64_t limit = std::uniform_int_distribution<uint64_t>(0, CAPACITY)(rng);
+            const uint64_t offset = allocator.allocateBelow(size, limit);
+            REQUIRE(offset == expectedLowestFit(runs, size, limit));
+            if (offset != INVALID) {
+                REQUIRE(offset + size <= limit);
+                mark(used, offset, size, 1);
+                live.emplace_back(offset, size);
+            }
+        } else if (!live.empty()) {
+            const size_t index = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng);
+            const auto [offset, liveSize] = live[index];
+            live[index] = live.back();
+            live.pop_back();
+
+            allocator.free(offset, liveSize);
+            mark(used, offset, liveSize, 0);
+        }
+
+        checkMatches(allocator, used);
+    }
+
+    for (const auto& [offset, size]: live) {
+        allocator.free(offset, size);
+    }
+    CHECK(allocator.isEmpty());
+    CHECK(allocator.getFreeRangeCount() == 1);
+    CHECK(allocator.getLargestFreeRange() == CAPACITY);
+}
+
+TEST_CASE("range allocator takes an exact fit whole", "[rangeallocator]") {
+    RangeAllocator allocator(100);
+    const uint64_t a = allocator.allocate(30);
+    const uint64_t b = allocator.allocate(20);
+    const uint64_t c = allocator.allocate(50);
+    REQUIRE(a == 0);
+    REQUIRE(b == 30);
+    REQUIRE(c == 50);
+    CHECK(allocator.getFreeRangeCount() == 0);
+
+    // holes of 30 and 50, each request takes its exact fit rather than the lowest hole that is large enough
+    allocator.free(a, 30);
+    allocator.free(c, 50);
+    CHECK(allocator.getFreeRangeCount() == 2);
+    CHECK(allocator.allocate(50) == 50);
+    CHECK(allocator.getFreeRangeCount() == 1);
+    CHECK(allocator.allocate(30) == 0);
+    CHECK(allocator.getFreeRangeCount() == 0);
+    CHECK(allocator.getFree() == 0);
+}
+
+TEST_CASE("range allocator fails on a full arena", "[rangeallocator]") {
+    RangeAllocator allocator(64);
+    CHECK(allocator.allocate(0) == INVALID);
+    CHECK(allocator.allocate(65) == INVALID);
+    CHECK(allocator.allocate(64) == 0);
+
+    CHECK(allocator.getFree() == 0);
+    CHECK(allocator.getFragmentation() == 0.0f);
+    CHECK(allocator.allocate(1) == INVALID);
+    CHECK(allocator.allocateBelow(1, 64) == INVALID);
+
+    allocator.free(0, 64);
+    CHECK(allocator.isEmpty());
+    CHECK(allocator.allocate(64) == 0);
+
+    RangeAllocator empty;
+    CHECK(empty.allocate(1) == INVALID);
+    CHECK(empty.getFreeRangeCount() == 0);
+}
+
+TEST_CASE("range allocator merges a freed range with both neighbours", "[rangeallocator]") {
+    RangeAllocator allocator(40);
+    const uint64_t a = allocator.allocate(10);
+    const uint64_t b = allocator.allocate(10);
+    const uint64_t c = allocator.allocate(10);
+    const uint64_t d = allocator.allocate(10);
+    REQUIRE(allocator.getFree() == 0);
+
+    // free neighbours on both sides of b, then b joins them into one range
+    allocator.free(a, 10);
+    allocator.free(c, 10);
+    CHECK(allocator.getFreeRangeCount() == 2);
+    CHECK(allocator.getLargestFreeRange() == 10);
+
+    allocator.free(b, 10);
+    CHECK(allocator.getFreeRangeCount() == 1);
+    CHECK(allocator.getLargestFreeRange() == 30);
+    CHECK(allocator.getFragmentation() == 0.0f);
+
+    // the left neighbour only
+    allocator.free(d, 10);
+    CHECK(allocator.getFreeRangeCount() == 1);
+    CHECK(allocator.getLargestFreeRange() == 40);
+    CHECK(allocator.isEmpty());
+}
+
+TEST_CASE("range allocator allocates below a limit only where the range fits", "[rangeallocator]") {
+    RangeAllocator allocator(100);
+    REQUIRE(allocator.allocate(100) == 0);
+    // holes [10, 30) and [50, 55)
+    allocator.free(10, 20);
+    allocator.free(50, 5);
+
+    // larger than every hole, and a hole that fits but ends past the limit
+    CHECK(allocator.allocateBelow(25, 100) == INVALID);
+    CHECK(allocator.allocateBelow(5, 14) == INVALID);
+    // a failed call leaves the holes alone
+    CHECK(allocator.getFreeRangeCount() == 2);
+    CHECK(allocator.getFree() == 25);
+
+    // lowest first, where allocate() takes the best fit
+    CHECK(allocator.allocateBelow(5, 100) == 10);
+    CHECK(allocator.allocate(5) == 50);
+    CHECK(allocator.getFreeRangeCount() == 1);
+
+    // the rest of the first hole, [15, 30)
+    CHECK(allocator.allocateBelow(15, 29) == INVALID);
+    CHECK(allocator.allocateBelow(15, 30) == 15);
+    CHECK(allocator.getFree() == 0);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Core/RefCounted.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+namespace {
+    struct Counted : public moe::RefCounted<Counted> {
+        explicit Counted(int* destroyed)
+            : destroyed(destroyed) {}
+
+        ~Counted() { ++*destroyed; }
+
+        int* destroyed;
+    };
+
+    struct AtomicCounted : public moe::AtomicRefCounted<AtomicCounted> {
+        explicit AtomicCounted(int* destroyed)
+            : destroyed(destroyed) {}
+
+        ~AtomicCounted() { ++*destroyed; }
+
+        int* destroyed;
+    };
+
+    int g_deleterCalls = 0;
+}// namespace
+
+TEST_CASE("Ref copies share one count and destroy on the last release", "[core][ref]") {
+    int destroyed = 0;
+    {
+        auto ref1 = moe::Ref<Counted>(new Counted(&destroyed));
+        REQUIRE(ref1->getRefCount() == 1);
+        {
+            auto ref2 = ref1;
+            auto ref3 = ref2;
+            REQUIRE(ref1->getRefCount() == 3);
+            REQUIRE(ref2 == ref3);
+        }
+        REQUIRE(ref1->getRefCount() == 1);
+        REQUIRE(destroyed == 0);
+    }
+    REQUIRE(destroyed == 1);
+}
+
+TEST_CASE("Ref moves hand over ownership without touching the count", "[core][ref]") {
+    int destroyed = 0;
+    auto ref1 = moe::Ref<Counted>(new Counted(&destroyed));
+    auto ref2 = std::move(ref1);
+    REQUIRE(ref2->getRefCount() == 1);
+
+    ref2.reset();
+    REQUIRE(destroyed == 1);
+}
+
+TEST_CASE("intoRef adopts an object that is already managed", "[core][ref]") {
+    int destroyed = 0;
+    auto ref1 = moe::Ref<Counted>(new Counted(&destroyed));
+    {
+        auto ref2 = ref1->intoRef();
+        REQUIRE(ref1->getRefCount() == 2);
+    }
+    REQUIRE(ref1->getRefCount() == 1);
+}
+
+TEST_CASE("A custom deleter replaces delete", "[core][ref]") {
+    int destroyed = 0;
+    g_deleterCalls = 0;
+
+    Counted counted(&destroyed);
+    counted.setDeleter([](void*) { ++g_deleterCalls; });
+    counted.retain();
+    counted.release();
+
+    REQUIRE(g_deleterCalls == 1);
+    REQUIRE(destroyed == 0);
+}
+
+TEST_CASE("AtomicRefCounted survives concurrent retain and release", "[core][ref]") {
+    int destroyed = 0;
+    auto ref = moe::Ref<AtomicCounted>(new AtomicCounted(&destroyed));
+
+    constexpr int THREADS = 4;
+    constexpr int ITERATIONS = 10000;
+    moe::Vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&ref]() {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                auto copy = ref;
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    REQUIRE(ref->getRefCount() == 1);
+    ref.reset();
+    REQUIRE(destroyed == 1);
+}
\ No newline at end of file
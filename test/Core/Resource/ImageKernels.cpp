@@ -0,0 +1,218 @@
+#include "Core/Resource/ImageKernels.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    Vector<uint8_t> randomBytes(size_t count, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, 255);
+        Vector<uint8_t> bytes(count);
+        for (auto& byte: bytes) {
+            byte = static_cast<uint8_t>(dist(rng));
+        }
+        return bytes;
+    }
+
+    // odd counts leave a tail after every vector width
+    constexpr size_t PIXEL_COUNTS[] = {1, 3, 4, 7, 15, 16, 33, 257, 4099};
+}// namespace
+
+TEST_CASE("expandRGBToRGBA matches the scalar path", "[image]") {
+    for (auto count: PIXEL_COUNTS) {
+        const auto rgb = randomBytes(count * 3, static_cast<uint32_t>(count));
+        Vector<uint8_t> simd(count * 4);
+        Vector<uint8_t> scalar(count * 4);
+
+        ImageKernels::expandRGBToRGBA(rgb.data(), simd.data(), count, 0x7f);
+        ImageKernels::Scalar::expandRGBToRGBA(rgb.data(), scalar.data(), count, 0x7f);
+
+        REQUIRE(simd == scalar);
+        REQUIRE(simd[0] == rgb[0]);
+        REQUIRE(simd[3] == 0x7f);
+    }
+}
+
+TEST_CASE("isOpaque finds any pixel below full alpha", "[image]") {
+    for (auto count: PIXEL_COUNTS) {
+        Vector<uint8_t> rgba = randomBytes(count * 4, static_cast<uint32_t>(count) + 2);
+        for (size_t i = 0; i < count; ++i) {
+            rgba[i * 4 + 3] = 0xff;
+        }
+        REQUIRE(ImageKernels::isOpaque(rgba.data(), count));
+
+        // a single cutout texel, the last one included
+        for (size_t i: {size_t{0}, count / 2, count - 1}) {
+            auto cutout = rgba;
+            cutout[i * 4 + 3] = 0xfe;
+            REQUIRE(!ImageKernels::isOpaque(cutout.data(), count));
+        }
+    }
+    REQUIRE(ImageKernels::isOpaque(nullptr, 0));
+}
+
+TEST_CASE("premultiplyAlpha matches the scalar path", "[image]") {
+    for (auto colorSpace: {ImageKernels::ColorSpace::Linear, ImageKernels::ColorSpace::Srgb}) {
+        for (auto count: PIXEL_COUNTS) {
+            auto simd = randomBytes(count * 4, static_cast<uint32_t>(count) + 1);
+            auto scalar = simd;
+
+            ImageKernels::premultiplyAlpha(simd.data(), count, colorSpace);
+            ImageKernels::Scalar::premultiplyAlpha(scalar.data(), count, colorSpace);
+
+            REQUIRE(simd == scalar);
+        }
+    }
+}
+
+TEST_CASE("premultiplyAlpha keeps opaque pixels and clears transparent ones", "[image]") {
+    uint8_t pixels[] = {
+            10, 200, 255, 255,
+            10, 200, 255, 0,
+            255, 255, 255, 128};
+    ImageKernels::premultiplyAlpha(pixels, 3, ImageKernels::ColorSpace::Linear);
+
+    REQUIRE(pixels[0] == 10);
+    REQUIRE(pixels[1] == 200);
+    REQUIRE(pixels[2] == 255);
+    REQUIRE(pixels[4] == 0);
+    REQUIRE(pixels[5] == 0);
+    REQUIRE(pixels[6] == 0);
+    REQUIRE(pixels[8] == 128);
+    REQUIRE(pixels[11] == 128);
+}
+
+TEST_CASE("renormalizeNormals produces unit vectors and matches the scalar path", "[image]") {
+    for (auto count: PIXEL_COUNTS) {
+        auto simd = randomBytes(count * 4, static_cast<uint32_t>(count) + 2);
+        auto scalar = simd;
+
+        ImageKernels::renormalizeNormals(simd.data(), count);
+        ImageKernels::Scalar::renormalizeNormals(scalar.data(), count);
+        REQUIRE(simd == scalar);
+
+        for (size_t i = 0; i < count; ++i) {
+            const float x = simd[i * 4 + 0] * (2.0f / 255.0f) - 1.0f;
+            const float y = simd[i * 4 + 1] * (2.0f / 255.0f) - 1.0f;
+            const float z = simd[i * 4 + 2] * (2.0f / 255.0f) - 1.0f;
+            // one unorm8 step per component
+            REQUIRE(std::abs(std::sqrt(x * x + y * y + z * z) - 1.0f) < 0.02f);
+        }
+    }
+}
+
+TEST_CASE("downsampleBox matches the scalar path for even and odd sizes", "[image]") {
+    const uint32_t sizes[][2] = {{1, 1}, {2, 2}, {3, 5}, {16, 16}, {17, 9}, {64, 1}, {1, 64}, {130, 66}};
+    for (auto colorSpace: {ImageKernels::ColorSpace::Linear, ImageKernels::ColorSpace::Srgb}) {
+        for (const auto& size: sizes) {
+            const uint32_t width = size[0];
+            const uint32_t height = size[1];
+            const auto src = randomBytes(size_t(width) * height * 4, width * 131 + height);
+            const size_t dstPixels = size_t(std::max(1u, width / 2)) * std::max(1u, height / 2);
+
+            Vector<uint8_t> simd(dstPixels * 4);
+            Vector<uint8_t> scalar(dstPixels * 4);
+            ImageKernels::downsampleBox(src.data(), width, height, simd.data(), colorSpace);
+            ImageKernels::Scalar::downsampleBox(src.data(), width, height, scalar.data(), colorSpace);
+
+            REQUIRE(simd == scalar);
+        }
+    }
+}
+
+TEST_CASE("downsampleBox averages srgb colors in linear space", "[image]") {
+    // black and white columns, alpha stays linear
+    const uint8_t src[] = {
+            0, 0, 0, 0, 255, 255, 255, 255,
+            0, 0, 0, 0, 255, 255, 255, 255};
+    uint8_t linear[4];
+    uint8_t srgb[4];
+    ImageKernels::downsampleBox(src, 2, 2, linear, ImageKernels::ColorSpace::Linear);
+    ImageKernels::downsampleBox(src, 2, 2, srgb, ImageKernels::ColorSpace::Srgb);
+
+    REQUIRE((linear[0] == 127 || linear[0] == 128));
+    // 0.5 linear encodes to 188
+    REQUIRE(srgb[0] >= 187);
+    REQUIRE(srgb[0] <= 188);
+    REQUIRE((srgb[3] == 127 || srgb[3] == 128));
+}
+
+TEST_CASE("buildMipChain lays out every level down to 1x1", "[image]") {
+    REQUIRE(ImageKernels::mipLevelCount(1, 1) == 1);
+    REQUIRE(ImageKernels::mipLevelCount(256, 64) == 9);
+    REQUIRE(ImageKernels::mipLevelCount(5, 3) == 3);
+
+    const auto src = randomBytes(37 * 20 * 4, 7);
+    const auto chain = ImageKernels::buildMipChain(src.data(), 37, 20, ImageKernels::ColorSpace::Srgb);
+
+    REQUIRE(chain.levels.size() == ImageKernels::mipLevelCount(37, 20));
+    REQUIRE(chain.levels.front().width == 37);
+    REQUIRE(chain.levels.back().width == 1);
+    REQUIRE(chain.levels.back().height == 1);
+
+    size_t offset = 0;
+    for (const auto& level: chain.levels) {
+        REQUIRE(level.offset == offset);
+        REQUIRE(level.size == size_t(level.width) * level.height * 4);
+        offset += level.size;
+    }
+    REQUIRE(chain.data.size() == offset);
+    REQUIRE(std::equal(src.begin(), src.end(), chain.levelData(0).begin()));
+
+    const auto limited = ImageKernels::buildMipChain(src.data(), 37, 20, ImageKernels::ColorSpace::Linear, false, 2);
+    REQUIRE(limited.levels.size() == 2);
+}
+
+TEST_CASE("image kernel benchmarks", "[image][benchmark][.]") {
+    constexpr uint32_t SIZE = 2048;
+    constexpr size_t PIXELS = size_t(SIZE) * SIZE;
+    const auto rgb = randomBytes(PIXELS * 3, 1);
+    const auto rgba = randomBytes(PIXELS * 4, 2);
+    Vector<uint8_t> dst(PIXELS * 4);
+    Vector<uint8_t> work(PIXELS * 4);
+
+    BENCHMARK("expandRGBToRGBA 2048^2 " + String(ImageKernels::backendName())) {
+        ImageKernels::expandRGBToRGBA(rgb.data(), dst.data(), PIXELS);
+        return dst[0];
+    };
+    BENCHMARK("expandRGBToRGBA 2048^2 scalar") {
+        ImageKernels::Scalar::expandRGBToRGBA(rgb.data(), dst.data(), PIXELS);
+        return dst[0];
+    };
+
+    BENCHMARK_ADVANCED("premultiplyAlpha srgb 2048^2 " + String(ImageKernels::backendName()))(Catch::Benchmark::Chronometer meter) {
+        work = rgba;
+        meter.measure([&] { ImageKernels::premultiplyAlpha(work.data(), PIXELS, ImageKernels::ColorSpace::Srgb); });
+    };
+    BENCHMARK_ADVANCED("premultiplyAlpha srgb 2048^2 scalar")(Catch::Benchmark::Chronometer meter) {
+        work = rgba;
+        meter.measure([&] { ImageKernels::Scalar::premultiplyAlpha(work.data(), PIXELS, ImageKernels::ColorSpace::Srgb); });
+    };
+
+    BENCHMARK_ADVANCED("renormalizeNormals 2048^2 " + String(ImageKernels::backendName()))(Catch::Benchmark::Chronometer meter) {
+        work = rgba;
+        meter.measure([&] { ImageKernels::renormalizeNormals(work.data(), PIXELS); });
+    };
+    BENCHMARK_ADVANCED("renormalizeNormals 2048^2 scalar")(Catch::Benchmark::Chronometer meter) {
+        work = rgba;
+        meter.measure([&] { ImageKernels::Scalar::renormalizeNormals(work.data(), PIXELS); });
+    };
+
+    BENCHMARK("downsampleBox srgb 2048^2 " + String(ImageKernels::backendName())) {
+        ImageKernels::downsampleBox(rgba.data(), SIZE, SIZE, dst.data(), ImageKernels::ColorSpace::Srgb);
+        return dst[0];
+    };
+    BENCHMARK("downsampleBox srgb 2048^2 scalar") {
+        ImageKernels::Scalar::downsampleBox(rgba.data(), SIZE, SIZE, dst.data(), ImageKernels::ColorSpace::Srgb);
+        return dst[0];
+    };
+
+    BENCHMARK("buildMipChain srgb 2048^2") {
+        return ImageKernels::buildMipChain(rgba.data(), SIZE, SIZE, ImageKernels::ColorSpace::Srgb).levels.size();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "Math/Frustum.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    // camera at the origin looking down -z, 0.1 .. 100
+    glm::mat4 makeViewProjection() {
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return projection * view;
+    }
+
+    bool isPointInside(const glm::mat4& viewProjection, const glm::vec3& point) {
+        const glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+        return clip.x >= -clip.w && clip.x <= clip.w &&
+               clip.y >= -clip.w && clip.y <= clip.w &&
+               clip.z >= 0.0f && clip.z <= clip.w;
+    }
+
+    // transforms embedded in a larger struct, like the render packets the culler reads them from
+    struct Instance {
+        uint32_t id;
+        glm::mat4 transform;
+        uint64_t padding;
+    };
+
+    struct Scene {
+        Vector<Instance> instances;
+        Vector<FrustumKernels::Box> boxes;
+
+        Scene(size_t count, uint32_t seed) : instances(count), boxes(count) {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> size(0.1f, 5.0f);
+            std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+
+            for (size_t i = 0; i < count; ++i) {
+                glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position(rng), position(rng), position(rng)));
+                transform = glm::rotate(transform, angle(rng), glm::vec3(unit(rng), unit(rng), 1.0f));
+                transform = glm::scale(transform, glm::vec3(size(rng), size(rng), size(rng)));
+                instances[i].id = static_cast<uint32_t>(i);
+                instances[i].transform = transform;
+
+                boxes[i] = {};
+                boxes[i].center = glm::vec3(unit(rng), unit(rng), unit(rng));
+                boxes[i].extent = glm::vec3(size(rng), size(rng), size(rng));
+            }
+        }
+
+        const uint8_t* transforms() const {
+            return reinterpret_cast<const uint8_t*>(instances.data()) + offsetof(Instance, transform);
+        }
+    };
+}// namespace
+
+TEST_CASE("frustum planes classify points and boxes", "[frustum]") {
+    const glm::mat4 viewProjection = makeViewProjection();
+    const Frustum frustum = Frustum::fromViewProjection(viewProjection);
+    const glm::vec3 small(0.1f);
+
+    REQUIRE(frustum.intersectsBox(glm::vec3(0.0f, 0.0f, -10.0f), small));
+    // behind the camera, before the near plane and beyond the far plane
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(0.0f, 0.0f, 10.0f), small));
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(0.0f, 0.0f, -0.01f), glm::vec3(0.001f)));
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(0.0f, 0.0f, -120.0f), small));
+    // outside the sides
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(-50.0f, 0.0f, -10.0f), small));
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(50.0f, 0.0f, -10.0f), small));
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(0.0f, 50.0f, -10.0f), small));
+    REQUIRE_FALSE(frustum.intersectsBox(glm::vec3(0.0f, -50.0f, -10.0f), small));
+    // straddling a plane
+    REQUIRE(frustum.intersectsBox(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(1.0f, 1.0f, 10.0f)));
+    REQUIRE(frustum.intersectsBox(glm::vec3(-50.0f, 0.0f, -10.0f), glm::vec3(45.0f, 1.0f, 1.0f)));
+
+    // the transformed overload matches transforming the box first
+    const glm::mat4 transform = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f)), glm::vec3(2.0f));
+    REQUIRE(frustum.intersectsBox(transform, glm::vec3(0.0f), glm::vec3(1.0f)));
+    REQUIRE_FALSE(frustum.intersectsBox(transform, glm::vec3(0.0f, 0.0f, 60.0f), glm::vec3(1.0f)));
+}
+
+TEST_CASE("frustum box tests are conservative", "[frustum]") {
+    const glm::mat4 viewProjection = makeViewProjection();
+    const Frustum frustum = Frustum::fromViewProjection(viewProjection);
+    const Scene scene(20000, 1);
+
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < scene.boxes.size(); ++i) {
+        const auto& box = scene.boxes[i];
+        const auto& transform = scene.instances[i].transform;
+        const bool visible = frustum.intersectsBox(transform, box.center, box.extent);
+        visibleCount += visible ? 1 : 0;
+
+        // no corner or center of a culled box may be inside
+        if (!visible) {
+            REQUIRE_FALSE(isPointInside(viewProjection, glm::vec3(transform * glm::vec4(box.center, 1.0f))));
+            for (int corner = 0; corner < 8; ++corner) {
+                const glm::vec3 sign((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+                const glm::vec3 local = box.center + box.extent * sign;
+                REQUIRE_FALSE(isPointInside(viewProjection, glm::vec3(transform * glm::vec4(local, 1.0f))));
+            }
+        }
+    }
+    // the scene is neither fully culled nor fully visible
+    REQUIRE(visibleCount > 0);
+    REQUIRE(visibleCount < scene.boxes.size());
+}
+
+TEST_CASE("frustum kernels match the scalar path", "[frustum]") {
+    const Frustum frustum = Frustum::fromViewProjection(makeViewProjection());
+    INFO("backend: " << FrustumKernels::backendName());
+
+    // not a multiple of the lane count, the tail goes through the scalar path
+    for (size_t count: {0, 1, 3, 4, 7, 1023, 10001}) {
+        const Scene scene(count, static_cast<uint32_t>(count) + 2);
+
+        Vector<uint8_t> simd(count, 0xff);
+        Vector<uint8_t> scalar(count, 0xff);
+        FrustumKernels::cullBoxes(frustum, scene.transforms(), sizeof(Instance), scene.boxes.data(), simd.data(), count);
+        FrustumKernels::Scalar::cullBoxes(frustum, scene.transforms(), sizeof(Instance), scene.boxes.data(), scalar.data(), count);
+
+        for (size_t i = 0; i < count; ++i) {
+            REQUIRE(simd[i] <= 1);
+            REQUIRE(simd[i] == scalar[i]);
+        }
+    }
+}
+
+TEST_CASE("frustum kernels benchmark", "[frustum][benchmark][.]") {
+    const Frustum frustum = Frustum::fromViewProjection(makeViewProjection());
+    const size_t count = 100000;
+    const Scene scene(count, 3);
+    Vector<uint8_t> visible(count);
+
+    BENCHMARK("cullBoxes, 100k boxes") {
+        FrustumKernels::cullBoxes(frustum, scene.transforms(), sizeof(Instance), scene.boxes.data(), visible.data(), count);
+        return visible[count - 1];
+    };
+
+    BENCHMARK("Scalar::cullBoxes, 100k boxes") {
+        FrustumKernels::Scalar::cullBoxes(frustum, scene.transforms(), sizeof(Instance), scene.boxes.data(), visible.data(), count);
+        return visible[count - 1];
+    };
+}
\ No newline at end of file
@@ -0,0 +1,383 @@
+#include "Math/OcclusionBuffer.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    constexpr uint32_t WIDTH = 64;
+    constexpr uint32_t HEIGHT = 32;
+
+    // camera at the origin looking down -z, 90 degrees vertically, the aspect of the buffer
+    glm::mat4 makeViewProjection(uint32_t width = WIDTH, uint32_t height = HEIGHT) {
+        const float aspect = static_cast<float>(width) / static_cast<float>(height);
+        const glm::mat4 projection = glm::perspective(glm::radians(90.0f), aspect, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return projection * view;
+    }
+
+    // two triangles spanning [x0, x1] x [y0, y1] at depth z
+    struct Quad {
+        Vector<glm::vec3> positions;
+        Vector<uint32_t> indices{0, 1, 2, 0, 2, 3};
+
+        Quad(float x0, float y0, float x1, float y1, float z)
+            : positions{{x0, y0, z}, {x1, y0, z}, {x1, y1, z}, {x0, y1, z}} {}
+    };
+
+    Vector<OcclusionBuffer::Triangle> setup(
+            const OcclusionBuffer& buffer, const glm::mat4& mvp,
+            Span<const glm::vec3> positions, Span<const uint32_t> indices) {
+        Vector<OcclusionBuffer::Triangle> triangles(indices.size() / 3);
+        triangles.resize(buffer.setupTriangles(mvp, positions, indices, triangles.data()));
+        return triangles;
+    }
+
+    void rasterizeAll(OcclusionBuffer& buffer, Span<const OcclusionBuffer::Triangle> triangles) {
+        buffer.rasterize(triangles, 0, buffer.getTileRows());
+    }
+
+    void addQuad(OcclusionBuffer& buffer, const glm::mat4& mvp, const Quad& quad) {
+        const auto triangles = setup(buffer, mvp, quad.positions, quad.indices);
+        rasterizeAll(buffer, triangles);
+    }
+
+    // random occluder triangles in front of the camera
+    Vector<glm::vec3> makeTriangleSoup(size_t count, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> center(-8.0f, 8.0f);
+        std::uniform_real_distribution<float> depth(-20.0f, -2.0f);
+        std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+
+        Vector<glm::vec3> positions;
+        positions.reserve(count * 3);
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3 c{center(rng), center(rng), depth(rng)};
+            for (int k = 0; k < 3; ++k) {
+                positions.push_back(c + glm::vec3(offset(rng), offset(rng), offset(rng) * 0.25f));
+            }
+        }
+        return positions;
+    }
+
+    Vector<uint32_t> makeSequentialIndices(size_t count) {
+        Vector<uint32_t> indices(count);
+        for (size_t i = 0; i < count; ++i) {
+            indices[i] = static_cast<uint32_t>(i);
+        }
+        return indices;
+    }
+}// namespace
+
+TEST_CASE("occlusion buffer rounds its size up to whole tiles", "[occlusion]") {
+    OcclusionBuffer buffer;
+    buffer.resize(30, 15);
+    REQUIRE(buffer.getWidth() == 32);
+    REQUIRE(buffer.getHeight() == 16);
+    REQUIRE(buffer.getTileRows() == 4);
+
+    buffer.resize(0, 0);
+    REQUIRE(buffer.getWidth() == OcclusionBuffer::TILE_WIDTH);
+    REQUIRE(buffer.getHeight() == OcclusionBuffer::TILE_HEIGHT);
+
+    buffer.resize(WIDTH, HEIGHT);
+    buffer.clear();
+    for (uint32_t y = 0; y < HEIGHT; ++y) {
+        for (uint32_t x = 0; x < WIDTH; ++x) {
+            REQUIRE(buffer.getDepth(x, y) == 0.0f);
+        }
+    }
+}
+
+TEST_CASE("occlusion triangle setup projects and clips", "[occlusion]") {
+    OcclusionBuffer buffer;
+    buffer.resize(WIDTH, HEIGHT);
+
+    SECTION("vertices map to pixel coordinates") {
+        // w = 2 everywhere
+        glm::mat4 mvp(1.0f);
+        mvp[3][3] = 2.0f;
+        const Vector<glm::vec3> positions{{-2.0f, -2.0f, 0.0f}, {2.0f, -2.0f, 0.0f}, {-2.0f, 2.0f, 0.0f}};
+        const Vector<uint32_t> indices{0, 1, 2};
+
+        const auto triangles = setup(buffer, mvp, positions, indices);
+        REQUIRE(triangles.size() == 1);
+        const auto& triangle = triangles[0];
+        REQUIRE(std::abs(triangle.x[0]) <= 1e-5f);
+        REQUIRE(std::abs(triangle.y[0]) <= 1e-5f);
+        REQUIRE(std::abs(triangle.x[1] - static_cast<float>(WIDTH)) <= 1e-5f);
+        REQUIRE(std::abs(triangle.y[2] - static_cast<float>(HEIGHT)) <= 1e-5f);
+        for (float invW: triangle.invW) {
+            REQUIRE(std::abs(invW - 0.5f) <= 1e-5f);
+        }
+        REQUIRE(triangle.minX == 0);
+        REQUIRE(triangle.minY == 0);
+        REQUIRE(triangle.maxX == static_cast<int32_t>(WIDTH) - 1);
+        REQUIRE(triangle.maxY == static_cast<int32_t>(HEIGHT) - 1);
+    }
+
+    SECTION("bounds are clamped to the buffer") {
+        const Vector<glm::vec3> positions{{-3.0f, -0.5f, 0.0f}, {0.5f, -0.5f, 0.0f}, {0.5f, 3.0f, 0.0f}};
+        const Vector<uint32_t> indices{0, 1, 2};
+
+        const auto triangles = setup(buffer, glm::mat4(1.0f), positions, indices);
+        REQUIRE(triangles.size() == 1);
+        REQUIRE(triangles[0].minX == 0);
+        REQUIRE(triangles[0].maxX == static_cast<int32_t>(WIDTH * 3 / 4) - 1);
+        REQUIRE(triangles[0].minY == static_cast<int32_t>(HEIGHT / 4));
+        REQUIRE(triangles[0].maxY == static_cast<int32_t>(HEIGHT) - 1);
+    }
+
+    SECTION("triangles crossing or behind the near limit are dropped") {
+        const glm::mat4 viewProjection = makeViewProjection();
+        const Vector<glm::vec3> positions{
+                {-1.0f, -1.0f, -5.0f}, {1.0f, -1.0f, -5.0f}, {0.0f, 1.0f, -5.0f},// in front
+                {-1.0f, -1.0f, -5.0f}, {1.0f, -1.0f, -5.0f}, {0.0f, 1.0f, 1.0f}, // crossing
+                {-1.0f, -1.0f, 2.0f}, {1.0f, -1.0f, 2.0f}, {0.0f, 1.0f, 2.0f},   // behind
+        };
+
+        const auto triangles = setup(buffer, viewProjection, positions, makeSequentialIndices(positions.size()));
+        REQUIRE(triangles.size() == 1);
+        REQUIRE(std::abs(triangles[0].invW[0] - 0.2f) <= 1e-5f);
+    }
+
+    SECTION("degenerate and off screen triangles are dropped") {
+        const Vector<glm::vec3> positions{
+                {-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.0f},// a line
+                {1.5f, -0.5f, 0.0f}, {2.5f, -0.5f, 0.0f}, {2.0f, 0.5f, 0.0f},// right of the buffer
+                {-0.5f, -3.0f, 0.0f}, {0.5f, -3.0f, 0.0f}, {0.0f, -2.0f, 0.0f},// below it
+                // between two pixel centers
+                {0.0f, 0.0f, 0.0f}, {0.01f, 0.0f, 0.0f}, {0.0f, 0.01f, 0.0f},
+        };
+
+        const auto triangles = setup(buffer, glm::mat4(1.0f), positions, makeSequentialIndices(positions.size()));
+        REQUIRE(triangles.empty());
+    }
+
+    SECTION("trailing indices of an incomplete triangle are ignored") {
+        const Vector<glm::vec3> positions{{-0.5f, -0.5f, 0.0f}, {0.5f, -0.5f, 0.0f}, {0.0f, 0.5f, 0.0f}};
+        const Vector<uint32_t> indices{0, 1, 2, 0, 1};
+
+        const auto triangles = setup(buffer, glm::mat4(1.0f), positions, indices);
+        REQUIRE(triangles.size() == 1);
+    }
+}
+
+TEST_CASE("occlusion rasterization covers pixel centers", "[occlusion]") {
+    OcclusionBuffer buffer;
+    buffer.resize(WIDTH, HEIGHT);
+    buffer.clear();
+
+    SECTION("both windings fill the same pixels") {
+        // the lower left half of the buffer, in ndc
+        const Vector<glm::vec3> positions{{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}};
+        const Vector<uint32_t> counterClockwise{0, 1, 2};
+        const Vector<uint32_t> clockwise{0, 2, 1};
+
+        OcclusionBuffer other;
+        other.resize(WIDTH, HEIGHT);
+        other.clear();
+        rasterizeAll(buffer, setup(buffer, glm::mat4(1.0f), positions, counterClockwise));
+        rasterizeAll(other, setup(other, glm::mat4(1.0f), positions, clockwise));
+
+        for (uint32_t y = 0; y < HEIGHT; ++y) {
+            for (uint32_t x = 0; x < WIDTH; ++x) {
+                REQUIRE(buffer.getDepth(x, y) == other.getDepth(x, y));
+
+                // away from the diagonal edge, where either answer is fine
+                const float edge = (static_cast<float>(x) + 0.5f) / WIDTH + (static_cast<float>(y) + 0.5f) / HEIGHT;
+                if (edge < 0.95f) {
+                    REQUIRE(std::abs(buffer.getDepth(x, y) - 1.0f) <= 1e-5f);
+                } else if (edge > 1.05f) {
+                    REQUIRE(buffer.getDepth(x, y) == 0.0f);
+                }
+            }
+        }
+    }
+
+    SECTION("the nearest triangle wins in any order") {
+        glm::mat4 far(1.0f);
+        far[3][3] = 4.0f;
+        glm::mat4 near(1.0f);
+        near[3][3] = 2.0f;
+        const Quad quad(-4.0f, -4.0f, 4.0f, 4.0f, 0.0f);
+
+        addQuad(buffer, near, quad);
+        addQuad(buffer, far, quad);
+        REQUIRE(std::abs(buffer.getDepth(WIDTH / 2, HEIGHT / 2) - 0.5f) <= 1e-5f);
+
+        buffer.clear();
+        addQuad(buffer, far, quad);
+        addQuad(buffer, near, quad);
+        REQUIRE(std::abs(buffer.getDepth(WIDTH / 2, HEIGHT / 2) - 0.5f) <= 1e-5f);
+    }
+
+    SECTION("depth is 1 / w of the surface at every pixel") {
+        // a plane tilted around y, z = -4 - 0.1 x, covering the whole view
+        const Vector<glm::vec3> positions{
+                {-20.0f, -20.0f, -2.0f}, {20.0f, -20.0f, -6.0f}, {20.0f, 20.0f, -6.0f}, {-20.0f, 20.0f, -2.0f}};
+        const Vector<uint32_t> indices{0, 1, 2, 0, 2, 3};
+        rasterizeAll(buffer, setup(buffer, makeViewProjection(), positions, indices));
+
+        // the view ray through a pixel center meets the plane at view depth 4 / (1 - 0.1 dx)
+        const float aspect = static_cast<float>(WIDTH) / static_cast<float>(HEIGHT);
+        for (uint32_t y = 0; y < HEIGHT; ++y) {
+            for (uint32_t x = 0; x < WIDTH; ++x) {
+                const float dx = ((static_cast<float>(x) + 0.5f) / WIDTH * 2.0f - 1.0f) * aspect;
+                const float expected = (1.0f - 0.1f * dx) / 4.0f;
+                REQUIRE(std::abs(buffer.getDepth(x, y) - expected) <= expected * 1e-4f);
+            }
+        }
+    }
+
+    SECTION("rasterizing in bands matches a single pass") {
+        const auto positions = makeTriangleSoup(200, 7);
+        const auto triangles = setup(buffer, makeViewProjection(), positions, makeSequentialIndices(positions.size()));
+        REQUIRE(!triangles.empty());
+        rasterizeAll(buffer, triangles);
+
+        OcclusionBuffer banded;
+        banded.resize(WIDTH, HEIGHT);
+        banded.clear();
+        for (uint32_t row = 0; row < banded.getTileRows(); row += 3) {
+            banded.rasterize(triangles, row, std::min(row + 3, banded.getTileRows()));
+        }
+
+        for (uint32_t y = 0; y < HEIGHT; ++y) {
+            for (uint32_t x = 0; x < WIDTH; ++x) {
+                REQUIRE(banded.getDepth(x, y) == buffer.getDepth(x, y));
+            }
+        }
+    }
+}
+
+TEST_CASE("occlusion box tests", "[occlusion]") {
+    OcclusionBuffer buffer;
+    buffer.resize(WIDTH, HEIGHT);
+    buffer.clear();
+
+    const glm::mat4 viewProjection = makeViewProjection();
+    const glm::vec3 unitExtent{0.5f};
+
+    SECTION("nothing rasterized hides nothing") {
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, -10.0f), unitExtent));
+    }
+
+    SECTION("a wall hides what is fully behind it") {
+        addQuad(buffer, viewProjection, Quad(-50.0f, -50.0f, 50.0f, 50.0f, -5.0f));
+
+        REQUIRE(!buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, -10.0f), unitExtent));
+        REQUIRE(!buffer.isBoxVisible(viewProjection, glm::vec3(3.0f, -2.0f, -20.0f), glm::vec3(2.0f)));
+        // in front of it
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, -3.0f), unitExtent));
+        // through it
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, -5.0f), unitExtent));
+        // right behind it, within the depth bias
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, -5.5f - 1e-3f), unitExtent));
+    }
+
+    SECTION("boxes reaching the near limit or leaving the screen are kept") {
+        addQuad(buffer, viewProjection, Quad(-50.0f, -50.0f, 50.0f, 50.0f, -5.0f));
+
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, 0.0f), unitExtent));
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, 10.0f), unitExtent));
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(-200.0f, 0.0f, -10.0f), unitExtent));
+    }
+
+    SECTION("a partial occluder hides only what it covers") {
+        // the left half of the view at depth 5, up to pixel column 33 in the middle of a tile
+        addQuad(buffer, viewProjection, Quad(-50.0f, -50.0f, 0.5f, 50.0f, -5.0f));
+
+        REQUIRE(!buffer.isBoxVisible(viewProjection, glm::vec3(-8.0f, 0.0f, -20.0f), glm::vec3(2.0f)));
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(8.0f, 0.0f, -20.0f), glm::vec3(2.0f)));
+        // straddles the edge of the occluder
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(2.0f)));
+
+        // inside the partly covered tile, on either side of the edge
+        const glm::vec3 extent{1.0f, 1.0f, 0.5f};
+        REQUIRE(!buffer.isBoxVisible(viewProjection, glm::vec3(-1.5f, 0.0f, -20.0f), extent));
+        REQUIRE(buffer.isBoxVisible(viewProjection, glm::vec3(4.9f, 0.0f, -20.0f), extent));
+    }
+
+    SECTION("hidden boxes are behind the occluders at every point") {
+        const auto positions = makeTriangleSoup(400, 11);
+        rasterizeAll(buffer, setup(buffer, viewProjection, positions, makeSequentialIndices(positions.size())));
+
+        std::mt19937 rng(13);
+        std::uniform_real_distribution<float> center(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> depth(-30.0f, -3.0f);
+        std::uniform_real_distribution<float> size(0.1f, 1.5f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        size_t hidden = 0;
+        for (int i = 0; i < 2000; ++i) {
+            const glm::vec3 boxCenter{center(rng), center(rng), depth(rng)};
+            const glm::vec3 extent{size(rng), size(rng), size(rng)};
+            if (buffer.isBoxVisible(viewProjection, boxCenter, extent)) {
+                continue;
+            }
+            hidden++;
+
+            for (int sample = 0; sample < 64; ++sample) {
+                const glm::vec3 point = boxCenter + extent * glm::vec3(unit(rng), unit(rng), unit(rng));
+                const glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+                const float x = (clip.x / clip.w + 1.0f) * 0.5f * WIDTH;
+                const float y = (clip.y / clip.w + 1.0f) * 0.5f * HEIGHT;
+                if (x < 0.0f || y < 0.0f || x >= WIDTH || y >= HEIGHT) {
+                    continue;
+                }
+                REQUIRE(buffer.getDepth(static_cast<uint32_t>(x), static_cast<uint32_t>(y)) > 1.0f / clip.w);
+            }
+        }
+        // the soup is dense enough that some are
+        REQUIRE(hidden > 0);
+    }
+}
+
+TEST_CASE("occlusion buffer benchmark", "[occlusion][benchmark][.]") {
+    constexpr uint32_t width = 320;
+    constexpr uint32_t height = 180;
+    const glm::mat4 viewProjection = makeViewProjection(width, height);
+
+    const auto positions = makeTriangleSoup(4096, 3);
+    const auto indices = makeSequentialIndices(positions.size());
+
+    OcclusionBuffer buffer;
+    buffer.resize(width, height);
+    Vector<OcclusionBuffer::Triangle> triangles(indices.size() / 3);
+
+    BENCHMARK("setupTriangles, 4k triangles") {
+        return buffer.setupTriangles(viewProjection, positions, indices, triangles.data());
+    };
+
+    triangles.resize(buffer.setupTriangles(viewProjection, positions, indices, triangles.data()));
+
+    BENCHMARK("clear + rasterize, 4k triangles at 320x180") {
+        buffer.clear();
+        rasterizeAll(buffer, triangles);
+        return buffer.getDepth(width / 2, height / 2);
+    };
+
+    buffer.clear();
+    rasterizeAll(buffer, triangles);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> center(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> depth(-30.0f, -3.0f);
+    Vector<glm::vec3> centers(10000);
+    for (auto& boxCenter: centers) {
+        boxCenter = {center(rng), center(rng), depth(rng)};
+    }
+
+    BENCHMARK("isBoxVisible, 10k boxes") {
+        size_t visible = 0;
+        for (const auto& boxCenter: centers) {
+            visible += buffer.isBoxVisible(viewProjection, boxCenter, glm::vec3(0.5f)) ? 1 : 0;
+        }
+        return visible;
+    };
+}
\ No newline at end of file
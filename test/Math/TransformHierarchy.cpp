@@ -0,0 +1,187 @@
+#include "Math/TransformHierarchy.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    using NodeIndex = TransformHierarchy::NodeIndex;
+
+    // scales close to 1, so products over thousands of levels stay finite
+    glm::mat4 randomLocalMatrix(std::mt19937& rng) {
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+        std::uniform_real_distribution<float> size(0.99f, 1.01f);
+
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(offset(rng), offset(rng), offset(rng)));
+        local = glm::rotate(local, angle(rng), glm::vec3(offset(rng), offset(rng), 1.0f));
+        return glm::scale(local, glm::vec3(size(rng), size(rng), size(rng)));
+    }
+
+    // a spine where every node also has a leaf, the spine node's next child comes after the leaf
+    void buildDeepTree(TransformHierarchy& hierarchy, size_t depth, uint32_t seed) {
+        std::mt19937 rng(seed);
+        NodeIndex spine = hierarchy.addNode(TransformHierarchy::NO_PARENT, randomLocalMatrix(rng));
+        for (size_t level = 1; level < depth; ++level) {
+            hierarchy.addNode(spine, randomLocalMatrix(rng));
+            spine = hierarchy.addNode(spine, randomLocalMatrix(rng));
+        }
+    }
+
+    // one root with many children, every fourth child has a few children of its own
+    void buildWideTree(TransformHierarchy& hierarchy, size_t width, uint32_t seed) {
+        std::mt19937 rng(seed);
+        const NodeIndex root = hierarchy.addNode(TransformHierarchy::NO_PARENT, randomLocalMatrix(rng));
+        for (size_t i = 0; i < width; ++i) {
+            const NodeIndex child = hierarchy.addNode(root, randomLocalMatrix(rng));
+            if (i % 4 == 0) {
+                for (size_t j = 0; j < 3; ++j) {
+                    hierarchy.addNode(child, randomLocalMatrix(rng));
+                }
+            }
+        }
+    }
+
+    // every world matrix recomputed in order on the calling thread, with the same kernel as update()
+    Vector<glm::mat4> serialWorldMatrices(const TransformHierarchy& hierarchy) {
+        Vector<NodeIndex> parents(hierarchy.size());
+        Vector<glm::mat4> locals(hierarchy.size());
+        for (NodeIndex node = 0; node < hierarchy.size(); ++node) {
+            parents[node] = hierarchy.getParent(node);
+            locals[node] = hierarchy.getLocalMatrix(node);
+        }
+
+        Vector<glm::mat4> worlds(hierarchy.size());
+        TransformKernels::updateWorldMatrices(parents.data(), locals.data(), worlds.data(), 0, hierarchy.size());
+        return worlds;
+    }
+
+    bool sameMatrices(Span<const glm::mat4> lhs, Span<const glm::mat4> rhs) {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(glm::mat4)) == 0;
+    }
+}// namespace
+
+TEST_CASE("nodes can only be added in pre-order", "[transform]") {
+    TransformHierarchy hierarchy;
+    CHECK(hierarchy.canAddNode(TransformHierarchy::NO_PARENT));
+    CHECK_FALSE(hierarchy.canAddNode(0));
+
+    // 0 -> 1 -> 2
+    hierarchy.addNode(TransformHierarchy::NO_PARENT, glm::mat4(1.0f));
+    hierarchy.addNode(0, glm::mat4(1.0f));
+    hierarchy.addNode(1, glm::mat4(1.0f));
+
+    // the last node and all of its ancestors are still open
+    CHECK(hierarchy.canAddNode(0));
+    CHECK(hierarchy.canAddNode(1));
+    CHECK(hierarchy.canAddNode(2));
+    CHECK(hierarchy.canAddNode(TransformHierarchy::NO_PARENT));
+    // not added yet
+    CHECK_FALSE(hierarchy.canAddNode(3));
+
+    // 0 -> 3 closes the subtree of 1
+    hierarchy.addNode(0, glm::mat4(1.0f));
+    CHECK(hierarchy.canAddNode(0));
+    CHECK(hierarchy.canAddNode(3));
+    CHECK_FALSE(hierarchy.canAddNode(1));
+    CHECK_FALSE(hierarchy.canAddNode(2));
+
+    CHECK(hierarchy.getSubtreeEnd(0) == 4);
+    CHECK(hierarchy.getSubtreeEnd(1) == 3);
+    CHECK(hierarchy.getSubtreeEnd(2) == 3);
+    CHECK(hierarchy.getSubtreeEnd(3) == 4);
+
+    // a new root closes everything
+    hierarchy.addNode(TransformHierarchy::NO_PARENT, glm::mat4(1.0f));
+    CHECK_FALSE(hierarchy.canAddNode(0));
+    CHECK_FALSE(hierarchy.canAddNode(3));
+    CHECK(hierarchy.canAddNode(4));
+}
+
+TEST_CASE("dirty nodes only recompute their descendants", "[transform]") {
+    // 0 -> {1 -> {2, 3}, 4 -> 5}
+    std::mt19937 rng(7);
+    TransformHierarchy hierarchy;
+    hierarchy.addNode(TransformHierarchy::NO_PARENT, randomLocalMatrix(rng));
+    hierarchy.addNode(0, randomLocalMatrix(rng));
+    hierarchy.addNode(1, randomLocalMatrix(rng));
+    hierarchy.addNode(1, randomLocalMatrix(rng));
+    hierarchy.addNode(0, randomLocalMatrix(rng));
+    hierarchy.addNode(4, randomLocalMatrix(rng));
+
+    REQUIRE(hierarchy.isDirty());
+    CHECK(hierarchy.update() == 6);
+    CHECK_FALSE(hierarchy.isDirty());
+    CHECK(hierarchy.update() == 0);
+    CHECK(sameMatrices(hierarchy.getWorldMatrices(), serialWorldMatrices(hierarchy)));
+
+    SECTION("a subtree") {
+        hierarchy.setLocalMatrix(1, randomLocalMatrix(rng));
+        CHECK(hierarchy.update() == 3);
+    }
+
+    SECTION("a leaf") {
+        hierarchy.setLocalMatrix(5, randomLocalMatrix(rng));
+        CHECK(hierarchy.update() == 1);
+    }
+
+    SECTION("a node inside a dirty subtree is not recomputed twice") {
+        hierarchy.setLocalMatrix(2, randomLocalMatrix(rng));
+        hierarchy.setLocalMatrix(1, randomLocalMatrix(rng));
+        hierarchy.setLocalMatrix(2, randomLocalMatrix(rng));
+        CHECK(hierarchy.update() == 3);
+    }
+
+    SECTION("disjoint subtrees") {
+        hierarchy.setLocalMatrix(5, randomLocalMatrix(rng));
+        hierarchy.setLocalMatrix(1, randomLocalMatrix(rng));
+        CHECK(hierarchy.update() == 4);
+    }
+
+    SECTION("the root") {
+        hierarchy.setLocalTransform(0, glm::vec3(1.0f, 2.0f, 3.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(2.0f));
+        CHECK(hierarchy.update() == 6);
+    }
+
+    CHECK(sameMatrices(hierarchy.getWorldMatrices(), serialWorldMatrices(hierarchy)));
+}
+
+TEST_CASE("parallel update matches a serial pass", "[transform]") {
+    constexpr size_t NODE_COUNT = 4 * TransformHierarchy::MIN_PARALLEL_NODES;
+
+    TransformHierarchy hierarchy;
+    SECTION("deep") {
+        buildDeepTree(hierarchy, NODE_COUNT / 2 + 1, 11);
+    }
+    SECTION("wide") {
+        buildWideTree(hierarchy, NODE_COUNT * 4 / 7, 13);
+    }
+    REQUIRE(hierarchy.size() >= NODE_COUNT);
+
+    CHECK(hierarchy.update() == hierarchy.size());
+    CHECK(sameMatrices(hierarchy.getWorldMatrices(), serialWorldMatrices(hierarchy)));
+
+    // many scattered dirty subtrees, still above the parallel threshold
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<NodeIndex> pick(1, static_cast<NodeIndex>(hierarchy.size() - 1));
+    for (size_t i = 0; i < 2 * TransformHierarchy::MIN_PARALLEL_NODES; ++i) {
+        hierarchy.setLocalMatrix(pick(rng), randomLocalMatrix(rng));
+    }
+    hierarchy.update();
+    CHECK(sameMatrices(hierarchy.getWorldMatrices(), serialWorldMatrices(hierarchy)));
+}
+
+TEST_CASE("transform hierarchy benchmark", "[transform][benchmark][.]") {
+    TransformHierarchy hierarchy;
+    buildWideTree(hierarchy, 1 << 16, 19);
+    hierarchy.update();
+
+    BENCHMARK("update every node of a wide tree") {
+        hierarchy.setLocalMatrix(0, hierarchy.getLocalMatrix(0));
+        return hierarchy.update();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "Render/Vulkan/VulkanCookedScene.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace moe;
+
+namespace {
+    using Scene = VulkanCookedScene;
+
+    enum MaterialIndex : int32_t {
+        OpaqueTextured,
+        Cutout,
+        Translucent,
+        Untextured,
+    };
+
+    // one image per alpha case, diffuse slots point at them. images that were never scanned are not opaque either
+    Scene::Image makeImage(bool opaque) {
+        Scene::Image image;
+        image.width = 4;
+        image.height = 4;
+        image.opaque = opaque ? 1 : 0;
+        return image;
+    }
+
+    const Scene::Image IMAGES[] = {
+            makeImage(true),
+            makeImage(false),
+    };
+
+    Scene::Material makeMaterial(float alpha, int32_t diffuse) {
+        Scene::Material material;
+        material.baseColor = glm::vec4(1.0f, 1.0f, 1.0f, alpha);
+        material.textures[Scene::Diffuse] = diffuse;
+        return material;
+    }
+
+    const Scene::Material MATERIALS[] = {
+            makeMaterial(1.0f, 0),
+            makeMaterial(1.0f, 1),
+            makeMaterial(0.5f, 0),
+            makeMaterial(1.0f, Scene::NO_REFERENCE),
+    };
+
+    Scene makeScene() {
+        Scene scene;
+        scene.materials = MATERIALS;
+        scene.images = IMAGES;
+        return scene;
+    }
+
+    Scene::Primitive makePrimitive(int32_t material, uint64_t skinningCount = 0) {
+        Scene::Primitive primitive;
+        primitive.vertices = {0, 3};
+        primitive.indices = {0, 3};
+        primitive.skinningData = {0, skinningCount};
+        primitive.material = material;
+        return primitive;
+    }
+}// namespace
+
+TEST_CASE("opaque materials are occluders", "[cookedscene]") {
+    const Scene scene = makeScene();
+
+    CHECK(scene.isOccluder(makePrimitive(OpaqueTextured)));
+    CHECK(scene.isOccluder(makePrimitive(Untextured)));
+    CHECK(scene.isOccluder(makePrimitive(Scene::NO_REFERENCE)));
+}
+
+TEST_CASE("cutout and translucent materials are not occluders", "[cookedscene]") {
+    const Scene scene = makeScene();
+
+    // the g-buffer pass discards texels below the alpha threshold, those primitives can not hide anything
+    CHECK_FALSE(scene.isOccluder(makePrimitive(Cutout)));
+    CHECK_FALSE(scene.isOccluder(makePrimitive(Translucent)));
+}
+
+TEST_CASE("skinned primitives are not occluders", "[cookedscene]") {
+    const Scene scene = makeScene();
+
+    CHECK_FALSE(scene.isOccluder(makePrimitive(OpaqueTextured, 3)));
+    CHECK_FALSE(scene.isOccluder(makePrimitive(Scene::NO_REFERENCE, 3)));
+}
\ No newline at end of file
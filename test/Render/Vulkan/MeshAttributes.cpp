@@ -0,0 +1,188 @@
+#include "Render/Vulkan/VulkanMeshAttributes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+using namespace moe;
+
+namespace {
+    constexpr float TOLERANCE = 1e-4f;
+
+    bool near(const glm::vec3& a, const glm::vec3& b) {
+        return std::abs(a.x - b.x) <= TOLERANCE && std::abs(a.y - b.y) <= TOLERANCE && std::abs(a.z - b.z) <= TOLERANCE;
+    }
+
+    Vertex makeVertex(const glm::vec3& pos, float u = 0.0f, float v = 0.0f) {
+        Vertex vertex{};
+        vertex.pos = pos;
+        vertex.uv_x = u;
+        vertex.uv_y = v;
+        vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+        vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        return vertex;
+    }
+
+    glm::vec3 cubeCorner(uint32_t corner) {
+        return {corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f};
+    }
+
+    // the corners around each face of a [-1, 1] cube, corner bits are x, y, z
+    constexpr uint32_t CUBE_FACES[6][4] = {
+            {1, 3, 7, 5},
+            {0, 2, 6, 4},
+            {2, 3, 7, 6},
+            {0, 1, 5, 4},
+            {4, 5, 7, 6},
+            {0, 1, 3, 2},
+    };
+
+    // counter clockwise seen from outside. shared: 8 vertices, otherwise 4 per face with their own uvs
+    VulkanCPUMesh makeCube(bool shared) {
+        VulkanCPUMesh mesh;
+        if (shared) {
+            for (uint32_t corner = 0; corner < 8; ++corner) {
+                mesh.vertices.push_back(makeVertex(cubeCorner(corner)));
+            }
+        }
+
+        for (const auto& face: CUBE_FACES) {
+            uint32_t quad[4];
+            for (uint32_t k = 0; k < 4; ++k) {
+                if (shared) {
+                    quad[k] = face[k];
+                } else {
+                    quad[k] = static_cast<uint32_t>(mesh.vertices.size());
+                    mesh.vertices.push_back(makeVertex(cubeCorner(face[k]), k == 1 || k == 2 ? 1.0f : 0.0f, k >= 2 ? 1.0f : 0.0f));
+                }
+            }
+
+            const glm::vec3 outward = cubeCorner(face[0]) + cubeCorner(face[1]) + cubeCorner(face[2]) + cubeCorner(face[3]);
+            const glm::vec3 p0 = mesh.vertices[quad[0]].pos;
+            if (glm::dot(glm::cross(mesh.vertices[quad[1]].pos - p0, mesh.vertices[quad[2]].pos - p0), outward) < 0.0f) {
+                std::swap(quad[1], quad[3]);
+            }
+            mesh.indices.insert(mesh.indices.end(), {quad[0], quad[1], quad[2], quad[0], quad[2], quad[3]});
+        }
+        return mesh;
+    }
+
+    // two unit quads on z = 0 sharing the edge x = 1, the right one with its u mirrored across that edge:
+    // u runs with +x on the left and against it on the right, v runs with +y on both
+    VulkanCPUMesh makeMirroredQuads() {
+        VulkanCPUMesh mesh;
+        mesh.vertices = {
+                makeVertex({0.0f, 0.0f, 0.0f}, 0.0f, 0.0f),// 0
+                makeVertex({1.0f, 0.0f, 0.0f}, 1.0f, 0.0f),// 1, on the mirror edge
+                makeVertex({1.0f, 1.0f, 0.0f}, 1.0f, 1.0f),// 2, on the mirror edge
+                makeVertex({0.0f, 1.0f, 0.0f}, 0.0f, 1.0f),// 3
+                makeVertex({2.0f, 0.0f, 0.0f}, 0.0f, 0.0f),// 4
+                makeVertex({2.0f, 1.0f, 0.0f}, 0.0f, 1.0f),// 5
+        };
+        mesh.indices = {0, 1, 2, 0, 2, 3, 1, 4, 5, 1, 5, 2};
+        return mesh;
+    }
+}// namespace
+
+TEST_CASE("flat normals split every corner and face outwards", "[meshattributes]") {
+    auto mesh = makeCube(true);
+    MeshAttributes::generateNormals(mesh, MeshAttributes::NormalMode::Flat);
+
+    REQUIRE(mesh.vertices.size() == mesh.indices.size());
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        CHECK(mesh.indices[i] == i);
+
+        const auto& v0 = mesh.vertices[mesh.indices[i + 0]];
+        const auto& v1 = mesh.vertices[mesh.indices[i + 1]];
+        const auto& v2 = mesh.vertices[mesh.indices[i + 2]];
+        // axis aligned faces: the normal is the axis the whole triangle sits on
+        const glm::vec3 centroid = (v0.pos + v1.pos + v2.pos) / 3.0f;
+        glm::vec3 expected(0.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            if (std::abs(centroid[axis]) > 0.99f) {
+                expected[axis] = centroid[axis] > 0.0f ? 1.0f : -1.0f;
+            }
+        }
+        CHECK(near(v0.normal, expected));
+        CHECK(near(v1.normal, expected));
+        CHECK(near(v2.normal, expected));
+    }
+}
+
+TEST_CASE("smooth normals average across uv seams", "[meshattributes]") {
+    // 24 vertices, every corner is split by the per face uvs
+    auto mesh = makeCube(false);
+    const size_t vertexCount = mesh.vertices.size();
+    MeshAttributes::generateNormals(mesh, MeshAttributes::NormalMode::Smooth);
+
+    // nothing is split, the split corners still get one normal: the angle weighted average of three faces
+    REQUIRE(mesh.vertices.size() == vertexCount);
+    for (const auto& vertex: mesh.vertices) {
+        CHECK(near(vertex.normal, glm::normalize(vertex.pos)));
+    }
+}
+
+TEST_CASE("tangents keep their handedness on mirrored uvs", "[meshattributes]") {
+    auto mesh = makeMirroredQuads();
+    const size_t vertexCount = mesh.vertices.size();
+    MeshAttributes::generateTangents(mesh);
+
+    // both vertices on the mirror edge are used with both handednesses
+    REQUIRE(mesh.vertices.size() == vertexCount + 2);
+
+    for (size_t triangle = 0; triangle < 4; ++triangle) {
+        const bool mirrored = triangle >= 2;
+        for (size_t k = 0; k < 3; ++k) {
+            const auto& vertex = mesh.vertices[mesh.indices[triangle * 3 + k]];
+            // the tangent follows +u, the sign makes cross(n, t) * w follow +v
+            CHECK(near(glm::vec3(vertex.tangent), glm::vec3(mirrored ? -1.0f : 1.0f, 0.0f, 0.0f)));
+            CHECK(vertex.tangent.w == (mirrored ? -1.0f : 1.0f));
+            const glm::vec3 bitangent = glm::cross(vertex.normal, glm::vec3(vertex.tangent)) * vertex.tangent.w;
+            CHECK(near(bitangent, glm::vec3(0.0f, 1.0f, 0.0f)));
+        }
+    }
+
+    // the two sides no longer share a vertex
+    for (size_t i = 0; i < 6; ++i) {
+        for (size_t j = 6; j < 12; ++j) {
+            CHECK(mesh.indices[i] != mesh.indices[j]);
+        }
+    }
+}
+
+TEST_CASE("repair reports the vertices it split", "[meshattributes]") {
+    MeshAttributes::RepairOptions options;
+    options.generateNormals = true;
+    options.normalMode = MeshAttributes::NormalMode::Flat;
+    options.generateTangents = true;
+
+    SECTION("flat normals on a shared cube") {
+        auto mesh = makeCube(true);
+        const auto report = MeshAttributes::repairMesh(mesh, options);
+        CHECK(report.generatedNormals);
+        CHECK(report.generatedTangents);
+        CHECK_FALSE(report.generatedIndices);
+        // 12 triangles with a vertex per corner, the uvs are all zero so no tangent splits on top
+        CHECK(mesh.vertices.size() == 36);
+        CHECK(report.splitVertices == 36 - 8);
+    }
+
+    SECTION("smooth normals and mirrored tangents") {
+        options.normalMode = MeshAttributes::NormalMode::Smooth;
+        auto mesh = makeMirroredQuads();
+        const auto report = MeshAttributes::repairMesh(mesh, options);
+        CHECK(report.splitVertices == 2);
+    }
+
+    SECTION("a non-indexed list") {
+        options.generateNormals = false;
+        options.generateTangents = false;
+        VulkanCPUMesh mesh;
+        mesh.vertices = {makeVertex({0.0f, 0.0f, 0.0f}), makeVertex({1.0f, 0.0f, 0.0f}), makeVertex({0.0f, 1.0f, 0.0f})};
+        const auto report = MeshAttributes::repairMesh(mesh, options);
+        CHECK(report.generatedIndices);
+        CHECK(mesh.indices == Vector<uint32_t>{0, 1, 2});
+        CHECK(report.splitVertices == 0);
+        CHECK(report.repairedVectors == 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,441 @@
+#include "Render/Vulkan/VulkanMeshOptimizer.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+
+    Vertex makeVertex(const glm::vec3& pos, const glm::vec3& normal) {
+        Vertex vertex{};
+        vertex.pos = pos;
+        vertex.normal = normal;
+        vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        return vertex;
+    }
+
+    // size x size quads on the z = 0 plane, counter clockwise seen from +z
+    VulkanCPUMesh makeGrid(uint32_t size) {
+        VulkanCPUMesh mesh;
+        for (uint32_t y = 0; y <= size; ++y) {
+            for (uint32_t x = 0; x <= size; ++x) {
+                mesh.vertices.push_back(makeVertex({static_cast<float>(x), static_cast<float>(y), 0.0f}, {0.0f, 0.0f, 1.0f}));
+            }
+        }
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                const uint32_t i = y * (size + 1) + x;
+                mesh.indices.insert(mesh.indices.end(), {i, i + 1, i + size + 2, i, i + size + 2, i + size + 1});
+            }
+        }
+        return mesh;
+    }
+
+    // uv sphere with outward facing triangles
+    VulkanCPUMesh makeSphere(uint32_t rings, uint32_t segments) {
+        VulkanCPUMesh mesh;
+        for (uint32_t ring = 0; ring <= rings; ++ring) {
+            const float theta = PI * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment <= segments; ++segment) {
+                const float phi = 2.0f * PI * static_cast<float>(segment) / static_cast<float>(segments);
+                const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+                mesh.vertices.push_back(makeVertex(normal * 2.0f, normal));
+            }
+        }
+        for (uint32_t ring = 0; ring < rings; ++ring) {
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                const uint32_t i = ring * (segments + 1) + segment;
+                const uint32_t below = i + segments + 1;
+                if (ring != 0) {
+                    mesh.indices.insert(mesh.indices.end(), {i, below, i + 1});
+                }
+                if (ring != rings - 1) {
+                    mesh.indices.insert(mesh.indices.end(), {i + 1, below, below + 1});
+                }
+            }
+        }
+        return mesh;
+    }
+
+    // the same triangle with the same winding compares equal regardless of its first corner
+    using Triangle = std::array<uint32_t, 3>;
+
+    Triangle canonical(uint32_t a, uint32_t b, uint32_t c) {
+        if (b < a && b < c) {
+            return {b, c, a};
+        }
+        if (c < a && c < b) {
+            return {c, a, b};
+        }
+        return {a, b, c};
+    }
+
+    Vector<Triangle> sortedTriangles(Span<const uint32_t> indices) {
+        Vector<Triangle> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            triangles.push_back(canonical(indices[i], indices[i + 1], indices[i + 2]));
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // the same triangles in random order, each starting at a random corner
+    void shuffleTriangles(VulkanCPUMesh& mesh, uint32_t seed) {
+        std::mt19937 rng(seed);
+        Vector<Triangle> triangles;
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const size_t first = std::uniform_int_distribution<size_t>(0, 2)(rng);
+            triangles.push_back({mesh.indices[i + first], mesh.indices[i + (first + 1) % 3], mesh.indices[i + (first + 2) % 3]});
+        }
+        std::shuffle(triangles.begin(), triangles.end(), rng);
+        mesh.indices.clear();
+        for (const auto& triangle: triangles) {
+            mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+        }
+    }
+
+    // stores every vertex's index in uv_x, so triangles can be compared after the vertices were renumbered
+    void tagVertices(VulkanCPUMesh& mesh) {
+        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+            mesh.vertices[i].uv_x = static_cast<float>(i);
+        }
+    }
+
+    Vector<uint32_t> taggedIndices(const VulkanCPUMesh& mesh) {
+        Vector<uint32_t> indices;
+        for (auto index: mesh.indices) {
+            indices.push_back(static_cast<uint32_t>(mesh.vertices[index].uv_x));
+        }
+        return indices;
+    }
+
+    float acmr(Span<const uint32_t> indices, size_t vertexCount) {
+        return MeshOptimizer::analyzeVertexCache(indices, vertexCount).acmr();
+    }
+
+    Vector<Triangle> meshletTriangles(const VulkanCPUMesh& mesh) {
+        Vector<Triangle> triangles;
+        for (const auto& meshlet: mesh.meshlets) {
+            for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+                const auto corner = [&](uint32_t c) {
+                    return mesh.meshletVertices[meshlet.vertexOffset + mesh.meshletTriangles[meshlet.triangleOffset + i * 3 + c]];
+                };
+                triangles.push_back(canonical(corner(0), corner(1), corner(2)));
+            }
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    void checkLayout(const VulkanCPUMesh& mesh, uint32_t maxVertices, uint32_t maxTriangles) {
+        uint32_t vertexOffset = 0;
+        uint32_t triangleOffset = 0;
+        for (const auto& meshlet: mesh.meshlets) {
+            // packed back to back
+            REQUIRE(meshlet.vertexOffset == vertexOffset);
+            REQUIRE(meshlet.triangleOffset == triangleOffset);
+            REQUIRE(meshlet.vertexCount > 0);
+            REQUIRE(meshlet.vertexCount <= maxVertices);
+            REQUIRE(meshlet.triangleCount > 0);
+            REQUIRE(meshlet.triangleCount <= maxTriangles);
+            vertexOffset += meshlet.vertexCount;
+            triangleOffset += meshlet.triangleCount * 3;
+
+            // no vertex twice, every one used
+            Vector<uint32_t> vertices(
+                    mesh.meshletVertices.begin() + meshlet.vertexOffset,
+                    mesh.meshletVertices.begin() + meshlet.vertexOffset + meshlet.vertexCount);
+            std::sort(vertices.begin(), vertices.end());
+            REQUIRE(std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end());
+
+            Vector<bool> used(meshlet.vertexCount, false);
+            for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+                const uint8_t local = mesh.meshletTriangles[meshlet.triangleOffset + i];
+                REQUIRE(local < meshlet.vertexCount);
+                used[local] = true;
+            }
+            REQUIRE(std::all_of(used.begin(), used.end(), [](bool u) { return u; }));
+        }
+        REQUIRE(vertexOffset == mesh.meshletVertices.size());
+        REQUIRE(triangleOffset == mesh.meshletTriangles.size());
+    }
+
+    void checkBounds(const VulkanCPUMesh& mesh) {
+        for (const auto& meshlet: mesh.meshlets) {
+            for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+                const glm::vec3& pos = mesh.vertices[mesh.meshletVertices[meshlet.vertexOffset + i]].pos;
+                REQUIRE(glm::length(pos - meshlet.center) <= meshlet.radius * 1.0001f + 1e-5f);
+                for (int axis = 0; axis < 3; ++axis) {
+                    REQUIRE(pos[axis] >= meshlet.aabbMin[axis]);
+                    REQUIRE(pos[axis] <= meshlet.aabbMax[axis]);
+                }
+            }
+        }
+    }
+
+    // a viewpoint the cone rejects must be behind the plane of every triangle of the meshlet
+    size_t checkCones(const VulkanCPUMesh& mesh, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-20.0f, 20.0f);
+
+        size_t culled = 0;
+        for (int sample = 0; sample < 256; ++sample) {
+            const glm::vec3 viewpoint(dist(rng), dist(rng), dist(rng));
+            for (const auto& meshlet: mesh.meshlets) {
+                if (meshlet.coneCutoff >= 1.0f || !meshlet.isBackfacing(viewpoint)) {
+                    continue;
+                }
+                culled++;
+                for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+                    const auto corner = [&](uint32_t c) -> const glm::vec3& {
+                        return mesh.vertices[mesh.meshletVertices[meshlet.vertexOffset + mesh.meshletTriangles[meshlet.triangleOffset + i * 3 + c]]].pos;
+                    };
+                    const glm::vec3 normal = glm::cross(corner(1) - corner(0), corner(2) - corner(0));
+                    REQUIRE(glm::dot(normal, viewpoint - corner(0)) <= 1e-4f);
+                }
+            }
+        }
+        return culled;
+    }
+}// namespace
+
+TEST_CASE("vertex cache ordering keeps the triangles and lowers acmr", "[meshoptimizer]") {
+    auto mesh = makeSphere(32, 48);
+    shuffleTriangles(mesh, 3);
+    const auto triangles = sortedTriangles(mesh.indices);
+    const float before = acmr(mesh.indices, mesh.vertices.size());
+
+    MeshOptimizer::optimizeVertexCache(Span<uint32_t>(mesh.indices), mesh.vertices.size());
+    CHECK(sortedTriangles(mesh.indices) == triangles);
+    const float after = acmr(mesh.indices, mesh.vertices.size());
+    CHECK(after < before);
+
+    // an already optimized order is not made worse
+    MeshOptimizer::optimizeVertexCache(Span<uint32_t>(mesh.indices), mesh.vertices.size());
+    CHECK(sortedTriangles(mesh.indices) == triangles);
+    CHECK(acmr(mesh.indices, mesh.vertices.size()) <= after);
+}
+
+TEST_CASE("overdraw ordering keeps the triangles within the acmr threshold", "[meshoptimizer]") {
+    auto mesh = makeSphere(32, 48);
+    shuffleTriangles(mesh, 5);
+    MeshOptimizer::optimizeVertexCache(Span<uint32_t>(mesh.indices), mesh.vertices.size());
+    const auto triangles = sortedTriangles(mesh.indices);
+    const float before = acmr(mesh.indices, mesh.vertices.size());
+
+    SECTION("default threshold") {
+        MeshOptimizer::optimizeOverdraw(Span<uint32_t>(mesh.indices), mesh.vertices);
+        CHECK(sortedTriangles(mesh.indices) == triangles);
+        CHECK(acmr(mesh.indices, mesh.vertices.size()) <= before * MeshOptimizer::DEFAULT_OVERDRAW_THRESHOLD);
+    }
+
+    SECTION("no acmr may be lost") {
+        MeshOptimizer::optimizeOverdraw(Span<uint32_t>(mesh.indices), mesh.vertices, MeshOptimizer::DEFAULT_CACHE_SIZE, 1.0f);
+        CHECK(sortedTriangles(mesh.indices) == triangles);
+        CHECK(acmr(mesh.indices, mesh.vertices.size()) <= before);
+    }
+}
+
+TEST_CASE("vertex fetch ordering keeps the triangles and numbers vertices by first use", "[meshoptimizer]") {
+    auto mesh = makeSphere(16, 24);
+    shuffleTriangles(mesh, 9);
+    // unreferenced vertices are dropped
+    mesh.vertices.push_back(makeVertex(glm::vec3(10.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    tagVertices(mesh);
+    const auto triangles = sortedTriangles(mesh.indices);
+    Vector<uint32_t> referenced = mesh.indices;
+    std::sort(referenced.begin(), referenced.end());
+    referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+    const float before = acmr(mesh.indices, mesh.vertices.size());
+
+    MeshOptimizer::optimizeVertexFetch(mesh);
+    CHECK(mesh.vertices.size() == referenced.size());
+    CHECK(sortedTriangles(taggedIndices(mesh)) == triangles);
+    // a renumbering, the cache sees the same sequence
+    CHECK(acmr(mesh.indices, mesh.vertices.size()) == before);
+
+    uint32_t next = 0;
+    for (auto index: mesh.indices) {
+        REQUIRE(index <= next);
+        if (index == next) {
+            ++next;
+        }
+    }
+    CHECK(next == mesh.vertices.size());
+}
+
+TEST_CASE("the full pipeline keeps the triangles and reports its gain", "[meshoptimizer]") {
+    auto mesh = makeSphere(32, 48);
+    shuffleTriangles(mesh, 11);
+    tagVertices(mesh);
+    const auto triangles = sortedTriangles(mesh.indices);
+
+    const auto report = MeshOptimizer::optimizeMesh(mesh);
+    CHECK(sortedTriangles(taggedIndices(mesh)) == triangles);
+    CHECK(report.weldedVertices == 0);
+    CHECK(report.after.triangleCount == report.before.triangleCount);
+    CHECK(report.after.acmr() < report.before.acmr());
+    CHECK(report.after.acmr() == acmr(mesh.indices, mesh.vertices.size()));
+}
+
+TEST_CASE("lod errors grow with every level", "[meshoptimizer]") {
+    auto mesh = makeSphere(48, 64);
+    mesh.min = glm::vec3(-2.0f);
+    mesh.max = glm::vec3(2.0f);
+    const size_t indexCount = mesh.indices.size();
+
+    const uint32_t lodCount = MeshOptimizer::buildLodChain(mesh);
+    REQUIRE(lodCount > 2);
+    REQUIRE(mesh.lods.size() == lodCount);
+    CHECK(mesh.lods[0].firstIndex == 0);
+    CHECK(mesh.lods[0].indexCount == indexCount);
+    CHECK(mesh.lods[0].error == 0.0f);
+
+    for (uint32_t lod = 1; lod < lodCount; ++lod) {
+        const auto& previous = mesh.lods[lod - 1];
+        const auto& current = mesh.lods[lod];
+        CHECK(current.firstIndex == previous.firstIndex + previous.indexCount);
+        CHECK(current.indexCount % 3 == 0);
+        CHECK(current.indexCount < previous.indexCount);
+        CHECK(current.error >= previous.error);
+        // each step stays within its own bound
+        CHECK(current.error - previous.error <= glm::length(mesh.max - mesh.min) * MeshOptimizer::MAX_LOD_STEP_ERROR);
+    }
+    CHECK(mesh.lods.back().firstIndex + mesh.lods.back().indexCount == mesh.indices.size());
+    for (auto index: mesh.indices) {
+        REQUIRE(index < mesh.vertices.size());
+    }
+}
+
+TEST_CASE("meshlets cover every triangle exactly once", "[meshlets]") {
+    SECTION("grid") {
+        auto mesh = makeGrid(40);
+        const size_t count = MeshOptimizer::buildMeshlets(mesh);
+        REQUIRE(count == mesh.meshlets.size());
+        REQUIRE(meshletTriangles(mesh) == sortedTriangles(mesh.indices));
+        checkLayout(mesh, MAX_MESHLET_VERTICES, MAX_MESHLET_TRIANGLES);
+    }
+
+    SECTION("sphere") {
+        auto mesh = makeSphere(32, 48);
+        MeshOptimizer::buildMeshlets(mesh);
+        REQUIRE(meshletTriangles(mesh) == sortedTriangles(mesh.indices));
+        checkLayout(mesh, MAX_MESHLET_VERTICES, MAX_MESHLET_TRIANGLES);
+    }
+
+    SECTION("shuffled triangle soup") {
+        auto mesh = makeSphere(16, 16);
+        shuffleTriangles(mesh, 7);
+
+        MeshOptimizer::buildMeshlets(mesh);
+        REQUIRE(meshletTriangles(mesh) == sortedTriangles(mesh.indices));
+        checkLayout(mesh, MAX_MESHLET_VERTICES, MAX_MESHLET_TRIANGLES);
+    }
+}
+
+TEST_CASE("meshlets respect custom limits", "[meshlets]") {
+    const auto mesh = makeSphere(24, 24);
+
+    VulkanCPUMesh clustered = mesh;
+    MeshOptimizer::buildMeshlets(
+            mesh.indices, mesh.vertices,
+            clustered.meshlets, clustered.meshletVertices, clustered.meshletTriangles,
+            16, 10);
+    REQUIRE(meshletTriangles(clustered) == sortedTriangles(mesh.indices));
+    checkLayout(clustered, 16, 10);
+}
+
+TEST_CASE("meshlets only cluster lod 0", "[meshlets]") {
+    auto mesh = makeGrid(8);
+    const size_t lod0 = mesh.indices.size();
+    // a fake second lod, one triangle
+    mesh.lods = {{0, static_cast<uint32_t>(lod0), 0.0f}, {static_cast<uint32_t>(lod0), 3, 1.0f}};
+    mesh.indices.insert(mesh.indices.end(), {0, 8, 80});
+
+    MeshOptimizer::buildMeshlets(mesh);
+    REQUIRE(meshletTriangles(mesh) == sortedTriangles(Span<const uint32_t>(mesh.indices).subspan(0, lod0)));
+}
+
+TEST_CASE("meshlet building rejects invalid meshes", "[meshlets]") {
+    auto mesh = makeGrid(2);
+    mesh.indices.push_back(0);
+    REQUIRE(MeshOptimizer::buildMeshlets(mesh) == 0);
+
+    mesh = makeGrid(2);
+    mesh.indices[4] = static_cast<uint32_t>(mesh.vertices.size());
+    REQUIRE(MeshOptimizer::buildMeshlets(mesh) == 0);
+    REQUIRE(mesh.meshlets.empty());
+    REQUIRE(mesh.meshletVertices.empty());
+}
+
+TEST_CASE("meshlet bounds contain their vertices", "[meshlets]") {
+    auto grid = makeGrid(40);
+    MeshOptimizer::buildMeshlets(grid);
+    checkBounds(grid);
+
+    auto sphere = makeSphere(32, 48);
+    MeshOptimizer::buildMeshlets(sphere);
+    checkBounds(sphere);
+}
+
+TEST_CASE("meshlet normal cones are conservative", "[meshlets]") {
+    SECTION("flat clusters face +z") {
+        auto mesh = makeGrid(40);
+        MeshOptimizer::buildMeshlets(mesh);
+        for (const auto& meshlet: mesh.meshlets) {
+            REQUIRE(meshlet.coneCutoff < 1e-3f);
+            REQUIRE(meshlet.coneAxis.z > 0.999f);
+            REQUIRE(meshlet.isBackfacing(meshlet.center - glm::vec3(0.0f, 0.0f, 1.0f)));
+            REQUIRE_FALSE(meshlet.isBackfacing(meshlet.center + glm::vec3(0.0f, 0.0f, 1.0f)));
+        }
+        REQUIRE(checkCones(mesh, 1) > 0);
+    }
+
+    SECTION("curved clusters") {
+        auto mesh = makeSphere(32, 48);
+        MeshOptimizer::buildMeshlets(mesh);
+        REQUIRE(checkCones(mesh, 2) > 0);
+    }
+
+    SECTION("a closed cluster disables the test") {
+        // a tetrahedron fits in one meshlet, its normals span the sphere
+        VulkanCPUMesh mesh;
+        const glm::vec3 corners[] = {{1, 1, 1}, {1, -1, -1}, {-1, 1, -1}, {-1, -1, 1}};
+        for (const auto& corner: corners) {
+            mesh.vertices.push_back(makeVertex(corner, glm::normalize(corner)));
+        }
+        mesh.indices = {0, 1, 2, 0, 3, 1, 0, 2, 3, 1, 3, 2};
+        REQUIRE(MeshOptimizer::buildMeshlets(mesh) == 1);
+        REQUIRE(mesh.meshlets[0].coneCutoff == 1.0f);
+    }
+}
+
+TEST_CASE("meshlet building is deterministic", "[meshlets]") {
+    auto first = makeSphere(32, 48);
+    auto second = first;
+    MeshOptimizer::buildMeshlets(first);
+    MeshOptimizer::buildMeshlets(second);
+
+    REQUIRE(first.meshletVertices == second.meshletVertices);
+    REQUIRE(first.meshletTriangles == second.meshletTriangles);
+    REQUIRE(first.meshlets.size() == second.meshlets.size());
+    for (size_t i = 0; i < first.meshlets.size(); ++i) {
+        REQUIRE(std::memcmp(&first.meshlets[i], &second.meshlets[i], sizeof(VulkanMeshlet)) == 0);
+    }
+}
+
+TEST_CASE("meshlet building benchmark", "[meshlets][benchmark][.]") {
+    auto mesh = makeSphere(128, 256);
+
+    BENCHMARK("buildMeshlets, 65k triangles") {
+        return MeshOptimizer::buildMeshlets(mesh);
+    };
+}
\ No newline at end of file
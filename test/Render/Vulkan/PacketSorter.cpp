@@ -0,0 +1,187 @@
+#include "Render/Vulkan/VulkanPacketSorter.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    // the sorter is never updated here, so depth is the distance to the origin over a far plane of 100
+    Vector<VulkanRenderPacket> makePackets(size_t count, uint32_t materials, uint32_t meshes, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32_t> material(0, materials - 1);
+        std::uniform_int_distribution<uint32_t> mesh(0, meshes - 1);
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::bernoulli_distribution skinned(0.1);
+
+        Vector<VulkanRenderPacket> packets(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto& packet = packets[i];
+            packet.materialId = material(rng);
+            packet.meshId = mesh(rng);
+            packet.transform = glm::translate(glm::mat4(1.0f), glm::vec3(position(rng), position(rng), position(rng)));
+            packet.skinned = skinned(rng);
+            // tags the original position, to check stability
+            packet.jointMatrixStartIndex = i;
+        }
+        return packets;
+    }
+
+    Vector<VulkanRenderPacket> referenceSort(const VulkanPacketSorter& sorter, Vector<VulkanRenderPacket> packets) {
+        for (auto& packet: packets) {
+            packet.sortKey = sorter.makeKey(packet, VulkanPacketSorter::Pass::Opaque);
+        }
+        std::stable_sort(packets.begin(), packets.end(), [](const VulkanRenderPacket& lhs, const VulkanRenderPacket& rhs) {
+            return lhs.sortKey < rhs.sortKey;
+        });
+        return packets;
+    }
+
+    void requireSameOrder(const Vector<VulkanRenderPacket>& sorted, const Vector<VulkanRenderPacket>& expected) {
+        REQUIRE(sorted.size() == expected.size());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            REQUIRE(sorted[i].sortKey == expected[i].sortKey);
+            REQUIRE(sorted[i].jointMatrixStartIndex == expected[i].jointMatrixStartIndex);
+        }
+    }
+}// namespace
+
+TEST_CASE("packet sort keys order fields by significance", "[packetsort]") {
+    VulkanPacketSorter sorter;
+
+    VulkanRenderPacket near{};
+    near.materialId = 5;
+    near.meshId = 9;
+    near.transform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+
+    VulkanRenderPacket far = near;
+    far.transform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -50.0f));
+
+    VulkanRenderPacket otherMesh = far;
+    otherMesh.meshId = 10;
+
+    VulkanRenderPacket otherMaterial = near;
+    otherMaterial.materialId = 6;
+    otherMaterial.meshId = 0;
+
+    VulkanRenderPacket skinned = near;
+    skinned.materialId = 0;
+    skinned.skinned = true;
+
+    const auto key = [&](const VulkanRenderPacket& packet) {
+        return sorter.makeKey(packet, VulkanPacketSorter::Pass::Opaque);
+    };
+    // depth < mesh < material < pipeline
+    REQUIRE(key(near) < key(far));
+    REQUIRE(key(far) < key(otherMesh));
+    REQUIRE(key(otherMesh) < key(otherMaterial));
+    REQUIRE(key(otherMaterial) < key(skinned));
+
+    // ids wider than their field wrap instead of spilling into the next one
+    VulkanRenderPacket wide = near;
+    wide.materialId = (1u << VulkanPacketSorter::MATERIAL_BITS) + 5;
+    REQUIRE(key(wide) == key(near));
+
+    // beyond the far plane clamps to the largest depth
+    VulkanRenderPacket beyond = near;
+    beyond.transform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -1000.0f));
+    REQUIRE((key(beyond) & ((uint64_t{1} << VulkanPacketSorter::DEPTH_BITS) - 1)) == (uint64_t{1} << VulkanPacketSorter::DEPTH_BITS) - 1);
+}
+
+TEST_CASE("packet sort matches a stable comparison sort", "[packetsort]") {
+    VulkanPacketSorter sorter;
+
+    SECTION("many distinct keys") {
+        auto packets = makePackets(5000, 300, 1000, 1);
+        const auto expected = referenceSort(sorter, packets);
+        sorter.sort(packets);
+        requireSameOrder(packets, expected);
+    }
+
+    SECTION("few distinct keys keep their relative order") {
+        auto packets = makePackets(5000, 3, 2, 2);
+        // equal depth, so most keys are shared
+        for (auto& packet: packets) {
+            packet.transform = glm::mat4(1.0f);
+        }
+        const auto expected = referenceSort(sorter, packets);
+        sorter.sort(packets);
+        requireSameOrder(packets, expected);
+    }
+
+    SECTION("scratch is reused across sizes") {
+        for (size_t count: {2000, 10, 3000, 2}) {
+            auto packets = makePackets(count, 50, 50, static_cast<uint32_t>(count));
+            const auto expected = referenceSort(sorter, packets);
+            sorter.sort(packets);
+            requireSameOrder(packets, expected);
+        }
+    }
+}
+
+TEST_CASE("packet sort skips digits every key shares", "[packetsort]") {
+    VulkanPacketSorter sorter;
+
+    SECTION("sorted input is left alone") {
+        auto packets = referenceSort(sorter, makePackets(1000, 10, 10, 3));
+        sorter.sort(packets);
+        REQUIRE(sorter.getStats().radixPasses == 0);
+        REQUIRE(sorter.getStats().sortedPackets == 1000);
+    }
+
+    SECTION("only the material digit differs") {
+        auto packets = makePackets(1000, 16, 1, 4);
+        for (auto& packet: packets) {
+            packet.transform = glm::mat4(1.0f);
+            packet.skinned = false;
+        }
+        const auto expected = referenceSort(sorter, packets);
+        sorter.sort(packets);
+        requireSameOrder(packets, expected);
+        // the material field starts at bit 36, 16 materials stay within the fifth byte
+        REQUIRE(sorter.getStats().radixPasses == 1);
+    }
+
+    SECTION("disabled sorter keeps the order") {
+        auto packets = makePackets(100, 10, 10, 5);
+        sorter.setEnabled(false);
+        sorter.sort(packets);
+        for (size_t i = 0; i < packets.size(); ++i) {
+            REQUIRE(packets[i].jointMatrixStartIndex == i);
+        }
+    }
+
+    SECTION("empty and single packet lists") {
+        Vector<VulkanRenderPacket> packets;
+        sorter.sort(packets);
+        packets = makePackets(1, 1, 1, 6);
+        sorter.sort(packets);
+        REQUIRE(packets[0].jointMatrixStartIndex == 0);
+    }
+}
+
+TEST_CASE("packet sort benchmark", "[packetsort][benchmark][.]") {
+    VulkanPacketSorter sorter;
+    const auto packets = makePackets(100000, 500, 2000, 7);
+    Vector<VulkanRenderPacket> scratch;
+
+    BENCHMARK("radix sort, 100k packets") {
+        scratch = packets;
+        sorter.sort(scratch);
+        return scratch[0].sortKey;
+    };
+
+    BENCHMARK("std::stable_sort, 100k packets") {
+        scratch = packets;
+        for (auto& packet: scratch) {
+            packet.sortKey = sorter.makeKey(packet, VulkanPacketSorter::Pass::Opaque);
+        }
+        std::stable_sort(scratch.begin(), scratch.end(), [](const VulkanRenderPacket& lhs, const VulkanRenderPacket& rhs) {
+            return lhs.sortKey < rhs.sortKey;
+        });
+        return scratch[0].sortKey;
+    };
+}
\ No newline at end of file
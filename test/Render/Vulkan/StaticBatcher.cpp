@@ -0,0 +1,202 @@
+#include "Render/Vulkan/VulkanStaticBatcher.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+using namespace moe;
+
+namespace {
+    using Scene = VulkanCookedScene;
+
+    constexpr float TOLERANCE = 1e-5f;
+
+    bool near(const glm::vec3& a, const glm::vec3& b) {
+        return std::abs(a.x - b.x) <= TOLERANCE && std::abs(a.y - b.y) <= TOLERANCE && std::abs(a.z - b.z) <= TOLERANCE;
+    }
+
+    // a unit quad on z = 0, counter clockwise seen from +z, tangent along +x
+    VulkanCPUMesh makeQuad(bool skinned = false) {
+        VulkanCPUMesh mesh;
+        const glm::vec3 corners[4] = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+        for (const auto& corner: corners) {
+            Vertex vertex{};
+            vertex.pos = corner;
+            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+            mesh.vertices.push_back(vertex);
+        }
+        mesh.indices = {0, 1, 2, 0, 2, 3};
+        if (skinned) {
+            mesh.skinningData.resize(mesh.vertices.size());
+        }
+        mesh.min = glm::vec3(0.0f);
+        mesh.max = glm::vec3(1.0f, 1.0f, 0.0f);
+        return mesh;
+    }
+
+    struct SceneBuilder {
+        Scene::Builder builder;
+
+        SceneBuilder() {
+            builder.materials.resize(2);
+        }
+
+        SceneResourceInternalId addMesh(const VulkanCPUMesh& cpuMesh, int32_t material) {
+            Scene::Mesh mesh{};
+            mesh.firstPrimitive = static_cast<uint32_t>(builder.primitives.size());
+            mesh.primitiveCount = 1;
+            builder.primitives.push_back(builder.addPrimitive(cpuMesh, material));
+            builder.meshes.push_back(mesh);
+            return static_cast<SceneResourceInternalId>(builder.meshes.size() - 1);
+        }
+
+        void addNode(SceneResourceInternalId mesh, const glm::mat4& transform) {
+            Scene::Node node{};
+            node.localTransform = transform;
+            node.mesh = mesh;
+            builder.nodes.push_back(node);
+        }
+
+        Scene build() const { return Scene::build(builder); }
+    };
+
+    glm::mat4 translation(float x, float y, float z) {
+        return glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
+    }
+
+    StaticBatching::Options makeOptions() {
+        StaticBatching::Options options;
+        options.cellSize = 32.0f;
+        // keeps the merged geometry as it was appended
+        options.buildLods = false;
+        return options;
+    }
+
+    // the single primitive of the node's mesh
+    const Scene::Primitive& primitiveOf(const Scene& scene, size_t node) {
+        return scene.primitives[scene.meshes[scene.nodes[node].mesh].firstPrimitive];
+    }
+}// namespace
+
+TEST_CASE("static batching groups instances by material and cell", "[staticbatcher]") {
+    SceneBuilder scene;
+    const auto quad = scene.addMesh(makeQuad(), 0);
+    const auto otherMaterial = scene.addMesh(makeQuad(), 1);
+    const auto skinned = scene.addMesh(makeQuad(true), 0);
+    scene.addNode(quad, glm::mat4(1.0f));
+    scene.addNode(quad, translation(5.0f, 0.0f, 0.0f));
+    scene.addNode(quad, translation(100.0f, 0.0f, 0.0f));
+    scene.addNode(otherMaterial, translation(2.0f, 0.0f, 0.0f));
+    scene.addNode(skinned, glm::mat4(1.0f));
+    const auto cooked = scene.build();
+
+    StaticBatching::Report report;
+    const auto merged = StaticBatching::mergeStaticGeometry(cooked, makeOptions(), &report);
+
+    CHECK(report.mergedInstances == 4);
+    CHECK(report.batches == 3);
+    CHECK(report.releasedPrimitives == 2);
+
+    // merged nodes stay for the hierarchy without geometry, the skinned one is untouched
+    REQUIRE(merged.nodes.size() == cooked.nodes.size() + 3);
+    for (size_t node = 0; node < 4; ++node) {
+        CHECK(merged.nodes[node].mesh == NULL_SCENE_RESOURCE_INTERNAL_ID);
+    }
+    CHECK(merged.nodes[4].mesh == skinned);
+    CHECK(merged.primitives[merged.meshes[skinned].firstPrimitive].vertices.count == 4);
+
+    // material 0 in cell (0, 0, 0) and (3, 0, 0), then material 1
+    const auto& near0 = primitiveOf(merged, 5);
+    const auto& far0 = primitiveOf(merged, 6);
+    const auto& near1 = primitiveOf(merged, 7);
+    CHECK(near0.material == 0);
+    CHECK(far0.material == 0);
+    CHECK(near1.material == 1);
+    CHECK(near0.vertices.count == 8);
+    CHECK(near0.indices.count == 12);
+    CHECK(far0.vertices.count == 4);
+    CHECK(near1.vertices.count == 4);
+
+    // pre-transformed into the scene root, the batch nodes are identity roots
+    CHECK(merged.nodes[5].parent == Scene::NO_PARENT);
+    CHECK(near(far0.min, glm::vec3(100.0f, 0.0f, 0.0f)));
+    CHECK(near(far0.max, glm::vec3(101.0f, 1.0f, 0.0f)));
+    CHECK(near(near0.max, glm::vec3(6.0f, 1.0f, 0.0f)));
+    const auto vertices = merged.slice(merged.vertices, near0.vertices);
+    CHECK(near(vertices[4].pos, glm::vec3(5.0f, 0.0f, 0.0f)));
+}
+
+TEST_CASE("static batching splits groups over the vertex limit", "[staticbatcher]") {
+    SceneBuilder scene;
+    const auto quad = scene.addMesh(makeQuad(), 0);
+    for (int i = 0; i < 5; ++i) {
+        scene.addNode(quad, translation(static_cast<float>(i), 0.0f, 0.0f));
+    }
+    const auto cooked = scene.build();
+
+    auto options = makeOptions();
+    // two quads per batch
+    options.maxVerticesPerBatch = 8;
+
+    StaticBatching::Report report;
+    const auto merged = StaticBatching::mergeStaticGeometry(cooked, options, &report);
+
+    CHECK(report.mergedInstances == 5);
+    CHECK(report.batches == 3);
+    REQUIRE(merged.nodes.size() == 5 + 3);
+    CHECK(primitiveOf(merged, 5).vertices.count == 8);
+    CHECK(primitiveOf(merged, 6).vertices.count == 8);
+    CHECK(primitiveOf(merged, 7).vertices.count == 4);
+}
+
+TEST_CASE("static batching keeps mirrored instances front facing", "[staticbatcher]") {
+    SceneBuilder scene;
+    const auto quad = scene.addMesh(makeQuad(), 0);
+    scene.addNode(quad, glm::scale(glm::mat4(1.0f), glm::vec3(-1.0f, 1.0f, 1.0f)));
+    const auto cooked = scene.build();
+
+    const auto merged = StaticBatching::mergeStaticGeometry(cooked, makeOptions());
+    const auto& primitive = primitiveOf(merged, 1);
+    const auto vertices = merged.slice(merged.vertices, primitive.vertices);
+    const auto indices = merged.slice(merged.indices, primitive.indices);
+    REQUIRE(indices.size() == 6);
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const auto& p0 = vertices[indices[i]].pos;
+        const auto& p1 = vertices[indices[i + 1]].pos;
+        const auto& p2 = vertices[indices[i + 2]].pos;
+        // the winding is flipped back, so the triangle still faces along its normal
+        CHECK(glm::dot(glm::cross(p1 - p0, p2 - p0), vertices[indices[i]].normal) > 0.0f);
+    }
+
+    for (const auto& vertex: vertices) {
+        CHECK(vertex.pos.x <= 0.0f);
+        CHECK(near(vertex.normal, glm::vec3(0.0f, 0.0f, 1.0f)));
+        // the tangent is mirrored with the geometry, the bitangent sign flips to keep +v
+        CHECK(near(glm::vec3(vertex.tangent), glm::vec3(-1.0f, 0.0f, 0.0f)));
+        CHECK(vertex.tangent.w == -1.0f);
+    }
+}
+
+TEST_CASE("static batching releases the merged source primitives", "[staticbatcher]") {
+    SceneBuilder scene;
+    const auto quad = scene.addMesh(makeQuad(), 0);
+    const auto skinned = scene.addMesh(makeQuad(true), 1);
+    scene.addNode(quad, glm::mat4(1.0f));
+    scene.addNode(quad, translation(1.0f, 0.0f, 0.0f));
+    scene.addNode(skinned, glm::mat4(1.0f));
+    const auto cooked = scene.build();
+
+    const auto merged = StaticBatching::mergeStaticGeometry(cooked, makeOptions());
+
+    // the slot stays so primitive indices remain valid, its geometry is no longer uploaded
+    REQUIRE(merged.primitives.size() == cooked.primitives.size() + 1);
+    const auto& released = merged.primitives[merged.meshes[quad].firstPrimitive];
+    CHECK(released.vertices.count == 0);
+    CHECK(released.indices.count == 0);
+
+    const auto& kept = merged.primitives[merged.meshes[skinned].firstPrimitive];
+    CHECK(kept.vertices.count == 4);
+    CHECK(kept.indices.count == 6);
+}
\ No newline at end of file
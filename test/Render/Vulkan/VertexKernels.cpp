@@ -0,0 +1,167 @@
+#include "Render/Vulkan/VulkanVertexKernels.hpp"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    Vector<float> randomFloats(size_t count, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+        Vector<float> floats(count);
+        for (auto& value: floats) {
+            value = dist(rng);
+        }
+        return floats;
+    }
+
+    // one tightly packed array per attribute, the last vec3 has nothing after it
+    struct SeparateStreams {
+        Vector<float> positions;
+        Vector<float> normals;
+        Vector<float> tangents;
+        Vector<float> uvs;
+
+        explicit SeparateStreams(size_t count)
+            : positions(randomFloats(count * 3, 1)),
+              normals(randomFloats(count * 3, 2)),
+              tangents(randomFloats(count * 4, 3)),
+              uvs(randomFloats(count * 2, 4)) {}
+
+        VertexKernels::VertexStreams streams(size_t count) const {
+            auto stream = [count](const Vector<float>& data, size_t components) {
+                return VertexKernels::Stream{
+                        reinterpret_cast<const uint8_t*>(data.data()), components * sizeof(float), count};
+            };
+            return {stream(positions, 3), stream(normals, 3), stream(tangents, 4), stream(uvs, 2)};
+        }
+    };
+
+    bool sameVertices(const Vector<Vertex>& lhs, const Vector<Vertex>& rhs) {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(Vertex)) == 0;
+    }
+
+    // odd counts leave a tail after every vector width
+    constexpr size_t VERTEX_COUNTS[] = {1, 2, 3, 5, 16, 17, 255, 1023};
+}// namespace
+
+TEST_CASE("interleaveVertices matches the scalar path for separate streams", "[vertex]") {
+    for (auto count: VERTEX_COUNTS) {
+        const SeparateStreams source(count);
+        const auto streams = source.streams(count);
+
+        Vector<Vertex> simd(count);
+        Vector<Vertex> scalar(count);
+        VertexKernels::interleaveVertices(simd.data(), streams, count);
+        VertexKernels::Scalar::interleaveVertices(scalar.data(), streams, count);
+
+        REQUIRE(sameVertices(simd, scalar));
+        REQUIRE(simd.back().pos.x == source.positions[(count - 1) * 3]);
+        REQUIRE(simd.back().uv_y == source.uvs[(count - 1) * 2 + 1]);
+        REQUIRE(simd.back().tangent.w == source.tangents[(count - 1) * 4 + 3]);
+    }
+}
+
+TEST_CASE("interleaveVertices reads strided streams from one buffer", "[vertex]") {
+    // pos(3) normal(3) uv(2) tangent(4), like an interleaved glTF buffer view
+    constexpr size_t STRIDE = 12 * sizeof(float);
+
+    for (auto count: VERTEX_COUNTS) {
+        const auto data = randomFloats(count * 12, static_cast<uint32_t>(count));
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+
+        VertexKernels::VertexStreams streams;
+        streams.positions = {bytes, STRIDE, count};
+        streams.normals = {bytes + 3 * sizeof(float), STRIDE, count};
+        streams.uvs = {bytes + 6 * sizeof(float), STRIDE, count};
+        streams.tangents = {bytes + 8 * sizeof(float), STRIDE, count};
+
+        Vector<Vertex> simd(count);
+        Vector<Vertex> scalar(count);
+        VertexKernels::interleaveVertices(simd.data(), streams, count);
+        VertexKernels::Scalar::interleaveVertices(scalar.data(), streams, count);
+
+        REQUIRE(sameVertices(simd, scalar));
+        REQUIRE(simd.back().normal.z == data[(count - 1) * 12 + 5]);
+    }
+}
+
+TEST_CASE("interleaveVertices zeroes missing optional streams", "[vertex]") {
+    constexpr size_t COUNT = 33;
+    const SeparateStreams source(COUNT);
+
+    VertexKernels::VertexStreams streams;
+    streams.positions = source.streams(COUNT).positions;
+
+    Vector<Vertex> simd(COUNT);
+    Vector<Vertex> scalar(COUNT);
+    std::memset(simd.data(), 0xff, simd.size() * sizeof(Vertex));
+    VertexKernels::interleaveVertices(simd.data(), streams, COUNT);
+    VertexKernels::Scalar::interleaveVertices(scalar.data(), streams, COUNT);
+
+    REQUIRE(sameVertices(simd, scalar));
+    for (const auto& vertex: simd) {
+        REQUIRE(vertex.uv_x == 0.0f);
+        REQUIRE(vertex.uv_y == 0.0f);
+        REQUIRE(vertex.normal.x == 0.0f);
+        REQUIRE(vertex.tangent.w == 0.0f);
+    }
+}
+
+TEST_CASE("widenIndices matches the scalar path", "[vertex]") {
+    for (auto count: VERTEX_COUNTS) {
+        Vector<uint16_t> shorts(count);
+        Vector<uint8_t> bytes(count);
+        for (size_t i = 0; i < count; ++i) {
+            shorts[i] = static_cast<uint16_t>(65535 - i * 37);
+            bytes[i] = static_cast<uint8_t>(255 - i * 7);
+        }
+
+        Vector<uint32_t> simd(count);
+        Vector<uint32_t> scalar(count);
+
+        VertexKernels::widenIndices(shorts.data(), simd.data(), count);
+        VertexKernels::Scalar::widenIndices(shorts.data(), scalar.data(), count);
+        REQUIRE(simd == scalar);
+        REQUIRE(simd[0] == 65535);
+
+        VertexKernels::widenIndices(bytes.data(), simd.data(), count);
+        VertexKernels::Scalar::widenIndices(bytes.data(), scalar.data(), count);
+        REQUIRE(simd == scalar);
+        REQUIRE(simd[0] == 255);
+    }
+}
+
+TEST_CASE("vertex kernel benchmarks", "[vertex][benchmark][.]") {
+    constexpr size_t VERTEX_COUNT = 1 << 20;
+    const SeparateStreams source(VERTEX_COUNT);
+    const auto streams = source.streams(VERTEX_COUNT);
+    Vector<Vertex> vertices(VERTEX_COUNT);
+
+    Vector<uint16_t> shorts(VERTEX_COUNT * 3);
+    for (size_t i = 0; i < shorts.size(); ++i) {
+        shorts[i] = static_cast<uint16_t>(i * 2654435761u >> 16);
+    }
+    Vector<uint32_t> indices(shorts.size());
+
+    BENCHMARK("interleaveVertices 1M") {
+        VertexKernels::interleaveVertices(vertices.data(), streams, VERTEX_COUNT);
+        return vertices.back().pos.x;
+    };
+    BENCHMARK("interleaveVertices 1M (scalar)") {
+        VertexKernels::Scalar::interleaveVertices(vertices.data(), streams, VERTEX_COUNT);
+        return vertices.back().pos.x;
+    };
+    BENCHMARK("widenIndices u16 3M") {
+        VertexKernels::widenIndices(shorts.data(), indices.data(), shorts.size());
+        return indices.back();
+    };
+    BENCHMARK("widenIndices u16 3M (scalar)") {
+        VertexKernels::Scalar::widenIndices(shorts.data(), indices.data(), shorts.size());
+        return indices.back();
+    };
+}
\ No newline at end of file
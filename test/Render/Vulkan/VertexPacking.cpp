@@ -0,0 +1,218 @@
+#include "Render/Vulkan/VulkanVertexPacking.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace moe;
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+
+    Vertex makeVertex(const glm::vec3& pos, const glm::vec3& normal, const glm::vec4& tangent, float u, float v) {
+        Vertex vertex{};
+        vertex.pos = pos;
+        vertex.normal = normal;
+        vertex.tangent = tangent;
+        vertex.uv_x = u;
+        vertex.uv_y = v;
+        return vertex;
+    }
+
+    Vertex defaultVertex() {
+        return makeVertex({0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}, 0.5f, 0.5f);
+    }
+
+    glm::vec3 randomUnit(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        while (true) {
+            const glm::vec3 v(dist(rng), dist(rng), dist(rng));
+            const float lengthSquared = glm::dot(v, v);
+            if (lengthSquared > 1e-4f && lengthSquared <= 1.0f) {
+                return glm::normalize(v);
+            }
+        }
+    }
+
+    float angleDegrees(const glm::vec3& a, const glm::vec3& b) {
+        return std::acos(std::clamp(glm::dot(a, b), -1.0f, 1.0f)) * 180.0f / PI;
+    }
+
+    SkinningData makeSkin(JointId j0, JointId j1, JointId j2, JointId j3, const glm::vec4& weights) {
+        SkinningData skin{};
+        skin.jointIds[0] = j0;
+        skin.jointIds[1] = j1;
+        skin.jointIds[2] = j2;
+        skin.jointIds[3] = j3;
+        skin.weights = weights;
+        return skin;
+    }
+
+    uint32_t packedWeightSum(const PackedSkinningData& packed) {
+        return (packed.weights[0] & 0xffffu) + (packed.weights[0] >> 16) +
+               (packed.weights[1] & 0xffffu) + (packed.weights[1] >> 16);
+    }
+}// namespace
+
+TEST_CASE("canPack rejects attributes outside the packed range", "[vertexpacking]") {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+
+    Vector<Vertex> vertices{defaultVertex(), defaultVertex()};
+    REQUIRE(VertexPacking::canPack(vertices));
+
+    SECTION("non-finite position") {
+        vertices[1].pos.y = nan;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices));
+        vertices[1].pos.y = inf;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices));
+    }
+
+    SECTION("non-finite normal or tangent") {
+        vertices[0].normal.x = nan;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices));
+        vertices[0].normal.x = 0.0f;
+        vertices[0].tangent.z = -inf;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices));
+    }
+
+    SECTION("uvs beyond the largest half") {
+        vertices[0].uv_x = VertexPacking::MAX_PACKED_UV;
+        vertices[0].uv_y = -VertexPacking::MAX_PACKED_UV;
+        REQUIRE(VertexPacking::canPack(vertices));
+
+        vertices[0].uv_x = VertexPacking::MAX_PACKED_UV * 1.01f;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices));
+        vertices[0].uv_x = nan;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices));
+    }
+
+    SECTION("joints and weights") {
+        Vector<SkinningData> skins{makeSkin(0, 1, 2, VertexPacking::MAX_PACKED_JOINTS - 1, {0.25f, 0.25f, 0.25f, 0.25f})};
+        REQUIRE(VertexPacking::canPack(vertices, skins));
+
+        skins[0].jointIds[2] = VertexPacking::MAX_PACKED_JOINTS;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices, skins));
+
+        skins[0].jointIds[2] = 2;
+        skins[0].weights[3] = nan;
+        REQUIRE_FALSE(VertexPacking::canPack(vertices, skins));
+    }
+}
+
+TEST_CASE("makeHeader handles empty and flat meshes", "[vertexpacking]") {
+    const auto empty = VertexPacking::makeHeader({});
+    REQUIRE(empty.vertexCount == 0);
+    REQUIRE(empty.positionScale.x == 0.0f);
+
+    // every vertex on the y = 2 plane
+    Vector<Vertex> vertices{defaultVertex(), defaultVertex(), defaultVertex()};
+    vertices[0].pos = {-1.0f, 2.0f, 0.0f};
+    vertices[1].pos = {1.0f, 2.0f, 3.0f};
+    vertices[2].pos = {0.0f, 2.0f, 1.0f};
+
+    const auto header = VertexPacking::makeHeader(vertices);
+    REQUIRE(header.vertexCount == 3);
+    REQUIRE(header.positionScale.y == 0.0f);
+
+    for (const auto& vertex: vertices) {
+        const auto unpacked = VertexPacking::unpackVertex(VertexPacking::packVertex(vertex, header), header);
+        REQUIRE(unpacked.pos.y == 2.0f);
+    }
+    // the bounds themselves are exact
+    REQUIRE(VertexPacking::unpackVertex(VertexPacking::packVertex(vertices[0], header), header).pos.x == -1.0f);
+    REQUIRE(VertexPacking::unpackVertex(VertexPacking::packVertex(vertices[1], header), header).pos.z == 3.0f);
+}
+
+TEST_CASE("octahedral encoding covers the sphere and degenerate vectors", "[vertexpacking]") {
+    // a zero vector decodes to +z instead of nan
+    const auto zero = VertexPacking::octDecode(VertexPacking::octEncode({0.0f, 0.0f, 0.0f}));
+    REQUIRE(zero.z == 1.0f);
+
+    const glm::vec3 axes[] = {
+            {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+    for (const auto& axis: axes) {
+        const auto decoded = VertexPacking::octDecode(VertexPacking::octEncode(axis));
+        REQUIRE(angleDegrees(axis, decoded) < 1e-3f);
+    }
+}
+
+TEST_CASE("packed vertices round trip within the documented error", "[vertexpacking]") {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> uv(-4.0f, 4.0f);
+
+    Vector<Vertex> vertices(10000);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        vertices[i] = makeVertex(
+                {position(rng), position(rng), position(rng)},
+                randomUnit(rng), glm::vec4(randomUnit(rng), sign),
+                uv(rng), uv(rng));
+    }
+
+    const auto buffer = VertexPacking::packVertexBuffer(vertices);
+    REQUIRE(buffer.size() == sizeof(PackedVertexHeader) + vertices.size() * sizeof(PackedVertex));
+
+    PackedVertexHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    REQUIRE(header.vertexCount == vertices.size());
+    const auto* packed = reinterpret_cast<const PackedVertex*>(buffer.data() + sizeof(PackedVertexHeader));
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const auto& original = vertices[i];
+        const auto unpacked = VertexPacking::unpackVertex(packed[i], header);
+
+        // half a step, with some room for the float math
+        REQUIRE(std::abs(unpacked.pos.x - original.pos.x) <= header.positionScale.x * 0.51f);
+        REQUIRE(std::abs(unpacked.pos.y - original.pos.y) <= header.positionScale.y * 0.51f);
+        REQUIRE(std::abs(unpacked.pos.z - original.pos.z) <= header.positionScale.z * 0.51f);
+
+        REQUIRE(angleDegrees(original.normal, unpacked.normal) < 0.05f);
+        REQUIRE(angleDegrees(glm::vec3(original.tangent), glm::vec3(unpacked.tangent)) < 0.05f);
+        REQUIRE(unpacked.tangent.w == original.tangent.w);
+
+        // 11 bit mantissa
+        REQUIRE(std::abs(unpacked.uv_x - original.uv_x) <= std::abs(original.uv_x) / 2048.0f + 1e-7f);
+        REQUIRE(std::abs(unpacked.uv_y - original.uv_y) <= std::abs(original.uv_y) / 2048.0f + 1e-7f);
+    }
+}
+
+TEST_CASE("packed skinning weights are renormalized and sum to one", "[vertexpacking]") {
+    SECTION("unnormalized weights") {
+        const auto skin = makeSkin(3, 7, 255, 0, {2.0f, 1.0f, 0.5f, 0.5f});
+        const auto packed = VertexPacking::packSkinningData(skin);
+        REQUIRE(packedWeightSum(packed) == 65535);
+
+        const auto unpacked = VertexPacking::unpackSkinningData(packed);
+        REQUIRE(unpacked.jointIds[0] == 3);
+        REQUIRE(unpacked.jointIds[2] == 255);
+        REQUIRE(std::abs(unpacked.weights[0] - 0.5f) <= 1.0f / 65535.0f);
+        REQUIRE(std::abs(unpacked.weights[1] - 0.25f) <= 1.0f / 65535.0f);
+    }
+
+    SECTION("rounding error goes to the dominant joint") {
+        const auto skin = makeSkin(0, 1, 2, 0, {1.0f, 1.0f, 1.0f, 0.0f});
+        const auto packed = VertexPacking::packSkinningData(skin);
+        REQUIRE(packedWeightSum(packed) == 65535);
+    }
+
+    SECTION("negative weights count as zero") {
+        const auto skin = makeSkin(0, 1, 2, 3, {1.0f, -1.0f, 0.0f, 0.0f});
+        const auto unpacked = VertexPacking::unpackSkinningData(VertexPacking::packSkinningData(skin));
+        REQUIRE(unpacked.weights[0] == 1.0f);
+        REQUIRE(unpacked.weights[1] == 0.0f);
+    }
+
+    SECTION("all zero weights stay zero") {
+        const auto skin = makeSkin(0, 1, 2, 3, {0.0f, 0.0f, 0.0f, 0.0f});
+        const auto packed = VertexPacking::packSkinningData(skin);
+        REQUIRE(packedWeightSum(packed) == 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "Core/Task/Scheduler.hpp"
+
+#include <catch2/catch_session.hpp>
+
+int main(int argc, char* argv[]) {
+    // parallel kernels run on the pool like they do in the engine
+    moe::ThreadPoolScheduler::init();
+    const int result = Catch::Session().run(argc, argv);
+    moe::ThreadPoolScheduler::shutdown();
+    return result;
+}
\ No newline at end of file